@@ -46,6 +46,7 @@
 #endif  // ESP32
 #include <IRremoteESP8266.h>
 #include <IRsend.h>
+#include <IRutils.h>
 #include <WiFiClient.h>
 #include <WiFiServer.h>
 
@@ -55,49 +56,22 @@ const char* kPassword = "...";  // Put your WIFI Password here.
 WiFiServer server(4998);  // Uses port 4998.
 WiFiClient client;
 
-uint16_t *code_array;
 #define IR_LED 4  // ESP8266 GPIO pin to use. Recommended: 4 (D2).
 
 IRsend irsend(IR_LED);  // Set the GPIO to be used to sending the message.
 
-void sendGCString(String str) {
-  int16_t index;
-  uint16_t count;
-
-  // Find out how many items there are in the string.
-  index = -1;
-  count = 1;
-  do {
-    index = str.indexOf(',', index + 1);
-    count++;
-  } while (index != -1);
-
-  // Now we know how many there are, allocate the memory to store them all.
-  code_array = reinterpret_cast<uint16_t*>(malloc(count * sizeof(uint16_t)));
-  // Check we malloc'ed successfully.
-  if (code_array == NULL) {  // malloc failed, so give up.
-    Serial.printf("\nCan't allocate %d bytes. (%d bytes free)\n",
-                  count * sizeof(uint16_t), ESP.getFreeHeap());
-    Serial.println("Giving up & forcing a reboot.");
-    ESP.restart();  // Reboot.
-    delay(500);  // Wait for the restart to happen.
-    return;  // Should never get here, but just in case.
-  }
-
-  // Now convert the strings to integers and place them in code_array.
-  count = 0;
-  uint16_t start_from = 0;
-  do {
-    index = str.indexOf(',', start_from);
-    code_array[count] = str.substring(start_from, index).toInt();
-    start_from = index + 1;
-    count++;
-  } while (index != -1);
-
+// Send a Global Cache-formatted code.
+// The whole line is read from the TCP connection first, so waiting on the
+// network can't upset the timing of the message. It is then parsed & sent
+// straight from the string, so no array of values is needed.
+// Args:
+//   str: The code. e.g. "38000,1,1,170,170,20,63,..."
+void sendGCString(const String str) {
+  irutils::ValueReader reader(str.c_str());
 #if SEND_GLOBALCACHE
-  irsend.sendGC(code_array, count);  // All done. Send it.
+  if (!irsend.sendGC(&reader))
+    Serial.println("Invalid or incomplete code.");
 #endif  // SEND_GLOBALCACHE
-  free(code_array);  // Free up the memory allocated.
 }
 
 void setup() {
@@ -20,6 +20,9 @@
 #include <IRtimer.h>
 #include <IRutils.h>
 #include <IRac.h>
+#include <IRacPublisher.h>
+#include <IRhtmlRenderer.h>
+#include <IRsendQueue.h>
 
 // ---------------- Start of User Configuration Section ------------------------
 
@@ -71,6 +74,12 @@ const int8_t kDefaultIrLed = 4;  // <=- CHANGE_ME (optional)
 //            Unless you *REALLY* know what you are doing, don't change this.
 const bool kInvertTxOutput = false;
 
+// IR messages are queued, and sent one at a time from `loop()`.
+// Nr. of messages that can be waiting to be sent, over all the channels.
+const uint16_t kIrSendQueueSize = 16;
+// Minimum time between the IR messages sent on each channel. (mSeconds)
+const uint32_t kIrSendGapMs = 40;
+
 // Default GPIO the IR demodulator is connected to/controlled by. GPIO 14 = D5.
 // Note: GPIO 16 won't work on the ESP8266 as it does not have interrupts.
 const int8_t kDefaultIrRx = 14;  // <=- CHANGE_ME (optional)
@@ -133,6 +142,14 @@ const uint32_t kMqttReconnectTime = 5000;  // Delay(ms) between reconnect tries.
 #define MQTT_CLIMATE_STAT "stat"  // Sub-topic for the climate stat topics.
 // Enable sending/receiving climate via JSON. `true` cost ~5k of program space.
 #define MQTT_CLIMATE_JSON false
+// Instead of one message per setting on its own topic, publish the whole
+// climate state as a retained JSON document on the "json" stat topic, & just
+// the settings that changed as a (non-retained) one on "json_delta". Clients
+// can then follow the changes from a single topic, with two messages per
+// change rather than one per changed setting.
+// Note: Home Assistant's MQTT climate (& discovery) uses the per-setting
+//       topics, so leave this off if you use it.
+#define MQTT_CLIMATE_JSON_BATCH false
 
 // Use Home Assistant-style operation modes.
 // TL;DR: Power and Mode are linked together. One changes the other.
@@ -177,7 +194,17 @@ const uint32_t kMqttReconnectTime = 5000;  // Delay(ms) between reconnect tries.
 // Using `true` may mean some incoming IR messages are lost or garbled.
 // i.e. `false` is better if you can get away with it.
 #define DISABLE_CAPTURE_WHILE_TRANSMITTING true
+// Or, keep listening while we send, and ignore the IR messages we hear from
+// ourselves instead. i.e. Echo suppression. Incoming IR messages that arrive
+// between our own aren't lost, unlike the above.
+// Note: Climate (A/C) messages are still sent with capture disabled, as we
+//       can't record what the common A/C code sends.
+// Uses kEchoLogSize * 2 bytes of memory per IR TX GPIO.
+#define IGNORE_OWN_TRANSMISSIONS false
+const uint16_t kEchoLogSize = 512;  // Nr. of marks & spaces to remember.
 // Let's use a larger than normal buffer so we can handle AirCon remote codes.
+// Note: `kRawBufAuto` & `kTimeoutMsAuto` are sized to just the protocols
+//       enabled in the build, if you don't need to capture UNKNOWN messages.
 const uint16_t kCaptureBufferSize = 1024;
 #if DECODE_AC
 // Some A/C units have gaps in their protocols of ~40ms. e.g. Kelvinator
@@ -373,6 +400,8 @@ bool reconnect(void);
 void receivingMQTT(String const topic_name, String const callback_str);
 void callback(char* topic, byte* payload, unsigned int length);
 void sendMQTTDiscovery(const char *topic);
+bool publishClimate(void *context, const String &topic,
+                    const String &payload, const bool retain);
 void doBroadcast(TimerMs *timer, const uint32_t interval,
                  IRac *climates[], const bool retain,
                  const bool force);
@@ -407,39 +436,33 @@ String htmlEnd(void);
 String htmlButton(const String url, const String button,
                   const String text = "");
 String htmlMenu(void);
+void htmlStart(void);
+void htmlFinish(IRhtmlRenderer *html);
+void htmlRootFields(IRhtmlRenderer *html, void *arg, const uint16_t field);
 void handleRoot(void);
 String addJsReloadUrl(const String url, const uint16_t timeout_s,
                       const bool notify);
 void handleExamples(void);
 String htmlOptionItem(const String value, const String text, bool selected);
-String htmlSelectBool(const String name, const bool def);
-String htmlSelectClimateProtocol(const String name, const decode_type_t def);
-String htmlSelectAcStateProtocol(const String name, const decode_type_t def,
-                                 const bool simple);
-String htmlSelectModel(const String name, const int16_t def);
-String htmlSelectMode(const String name, const stdAc::opmode_t def);
-String htmlSelectFanspeed(const String name, const stdAc::fanspeed_t def);
-String htmlSelectSwingv(const String name, const stdAc::swingv_t def);
-String htmlSelectSwingh(const String name, const stdAc::swingh_t def);
+void htmlAirConFields(IRhtmlRenderer *html, void *arg, const uint16_t field);
 void handleAirCon(void);
 void handleAirConSet(void);
 void handleAdmin(void);
+void htmlInfoFields(IRhtmlRenderer *html, void *arg, const uint16_t field);
 void handleInfo(void);
 void handleReset(void);
 void handleReboot(void);
-bool parseStringAndSendAirCon(IRsend *irsend, const decode_type_t irType,
-                              const String str);
-uint16_t countValuesInStr(const String str, char sep);
-uint16_t * newCodeArray(const uint16_t size);
+bool parseStringAndSendAirCon(const uint8_t channel,
+                              const decode_type_t irType, const String str);
 #if SEND_GLOBALCACHE
-bool parseStringAndSendGC(IRsend *irsend, const String str);
+bool parseStringAndSendGC(const uint8_t channel, const String str);
 #endif  // SEND_GLOBALCACHE
 #if SEND_PRONTO
-bool parseStringAndSendPronto(IRsend *irsend, const String str,
+bool parseStringAndSendPronto(const uint8_t channel, const String str,
                               uint16_t repeats);
 #endif  // SEND_PRONTO
 #if SEND_RAW
-bool parseStringAndSendRaw(IRsend *irsend, const String str);
+bool parseStringAndSendRaw(const uint8_t channel, const String str);
 #endif  // SEND_RAW
 void handleIr(void);
 void handleNotFound(void);
@@ -449,9 +472,10 @@ void setup(void);
 void loop(void);
 uint32_t maxSketchSpace(void);
 uint64_t getUInt64fromHex(char const *str);
-bool sendIRCode(IRsend *irsend, decode_type_t const ir_type,
+bool sendIRCode(const uint8_t channel, decode_type_t const ir_type,
                 uint64_t const code, char const * code_str, uint16_t bits,
                 uint16_t repeat);
+void sendQueued(void);
 bool sendInt(const String topic, const int32_t num, const bool retain);
 bool sendBool(const String topic, const bool on, const bool retain);
 bool sendString(const String topic, const String str, const bool retain);
@@ -459,7 +483,7 @@ bool sendFloat(const String topic, const float_t temp, const bool retain);
 void updateClimate(stdAc::state_t *current, const String str,
                    const String prefix, const String payload);
 bool cmpClimate(const stdAc::state_t a, const stdAc::state_t b);
-bool sendClimate(const String topic_prefix, const bool retain,
+bool sendClimate(IRacPublisher *publisher, const bool retain,
                  const bool forceMQTT, const bool forceIR,
                  const bool enableIR = true, IRac *ac = NULL);
 bool decodeCommonAc(const decode_results *decode);
@@ -353,6 +353,9 @@
 #include <IRtimer.h>
 #include <IRutils.h>
 #include <IRac.h>
+#include <IRacPublisher.h>
+#include <IRhtmlRenderer.h>
+#include <IRsendQueue.h>
 #if MQTT_ENABLE
 #include <PubSubClient.h>
 #endif  // MQTT_ENABLE
@@ -386,12 +389,16 @@ char Hostname[kHostnameLength + 1] = "ir_server";  // Default hostname.
 uint16_t *codeArray;
 uint32_t lastReconnectAttempt = 0;  // MQTT last attempt reconnection number
 bool boot = true;
-volatile bool lockIr = false;  // Primitive locking for gating the IR LED.
 uint32_t sendReqCounter = 0;
 bool lastSendSucceeded = false;  // Store the success status of the last send.
 uint32_t lastSendTime = 0;
 int8_t offset;  // The calculated period offset for this chip and library.
 IRsend *IrSendTable[kNrOfIrTxGpios];
+IRsendQueue *sendQueue = NULL;  // The IR messages waiting to be sent.
+#if IR_RX && IGNORE_OWN_TRANSMISSIONS
+// What each IR TX GPIO sent recently, so we can ignore hearing it.
+uint16_t echoLog[kNrOfIrTxGpios][kEchoLogSize];
+#endif  // IR_RX && IGNORE_OWN_TRANSMISSIONS
 int8_t txGpioTable[kNrOfIrTxGpios] = {kDefaultIrLed};
 String lastClimateSource;
 #if IR_RX
@@ -405,8 +412,23 @@ uint32_t irRecvCounter = 0;
 
 // Climate stuff
 IRac *climate[kNrOfIrTxGpios];
+#if MQTT_ENABLE
+// Publishes the changes to each climate state via MQTT.
+IRacPublisher *climatePublisher[kNrOfIrTxGpios];
+#endif  // MQTT_ENABLE
 String channel_re = "(";  // Will be built later.
 uint16_t chan = 0;  // The channel to use for the aircon HTML page.
+// The <option> lists for the menus on the web pages. Made once, in init_vars().
+String htmlSimpleProtocolOptions;
+String htmlAcStateProtocolOptions;
+String htmlClimateProtocolOptions;
+String htmlChannelOptions;
+String htmlModelOptions;
+String htmlBoolOptions;
+String htmlModeOptions;
+String htmlFanspeedOptions;
+String htmlSwingvOptions;
+String htmlSwinghOptions;
 
 TimerMs lastClimateIr = TimerMs();  // When we last sent the IR Climate mesg.
 uint32_t irClimateCounter = 0;  // How many have we sent?
@@ -682,24 +704,134 @@ String htmlOptionItem(const String value, const String text, bool selected) {
   return html;
 }
 
-String htmlSelectAcStateProtocol(const String name, const decode_type_t def,
-                                 const bool simple) {
-  String html = "<select name='" + name + "'>";
-  for (uint8_t i = 1; i <= decode_type_t::kLastDecodeType; i++) {
-    if (simple ^ hasACState((decode_type_t)i)) {
-      switch (i) {
-        case decode_type_t::RAW:
-        case decode_type_t::PRONTO:
-        case decode_type_t::GLOBALCACHE:
-          break;
-        default:
-          html += htmlOptionItem(String(i), typeToString((decode_type_t)i),
-                                i == def);
+// The template for the root web page. See handleRoot() for the fields.
+const char kHtmlRoot[] PROGMEM =
+  "<center><small><i>" _MY_VERSION_ "</i></small></center>"
+  "{0}"
+  "<h3>Send a simple IR message</h3><p>"
+  "<form method='POST' action='/ir' enctype='multipart/form-data'>"
+    D_STR_PROTOCOL ": {1}"
+    " " D_STR_CODE ": 0x<input type='text' name='" KEY_CODE "' min='0' "
+      "value='0' size='16' maxlength='16'> "
+    D_STR_BITS ": "
+    "<select name='" KEY_BITS "'>"
+      "<option selected='selected' value='0'>Default</option>"  // Default
+      "{2}"
+    "</select>"
+    " " D_STR_REPEAT ": <input type='number' name='" KEY_REPEAT "' min='0' "
+      "max='99' value='0' size='2' maxlength='2'>"
+    " <input type='submit' value='Send " D_STR_CODE "'>"
+  "</form>"
+  "<br><hr>"
+  "<h3>Send a complex (Air Conditioner) IR message</h3><p>"
+  "<form method='POST' action='/ir' enctype='multipart/form-data'>"
+    D_STR_PROTOCOL ": {3}"
+    " State " D_STR_CODE ": 0x"
+    "<input type='text' name='" KEY_CODE "' size='{4}' maxlength='{4}'"
+        " value='"
+#if EXAMPLES_ENABLE
+              "190B8050000000E0190B8070000010F0"
+#endif   // EXAMPLES_ENABLE
+              "'>"
+    " <input type='submit' value='Send A/C " D_STR_CODE "'>"
+  "</form>"
+  "<br><hr>"
+  "<h3>Send an IRremote Raw IR message</h3><p>"
+  "<form method='POST' action='/ir' enctype='multipart/form-data'>"
+    "<input type='hidden' name='" KEY_TYPE "' value='30'>"
+    "String: (freq,array data) <input type='text' name='" KEY_CODE "'"
+    " size='132' value='"
+#if EXAMPLES_ENABLE
+        "38000,4420,4420,520,1638,520,1638,520,1638,520,520,520,520,520,"
+        "520,520,520,520,520,520,1638,520,1638,520,1638,520,520,520,"
+        "520,520,520,520,520,520,520,520,520,520,1638,520,520,520,520,520,"
+        "520,520,520,520,520,520,520,520,1638,520,520,520,1638,520,1638,520,"
+        "1638,520,1638,520,1638,520,1638,520"
+#endif   // EXAMPLES_ENABLE
+        "'>"
+    " <input type='submit' value='Send Raw'>"
+  "</form>"
+  "<br><hr>"
+  "<h3>Send a <a href='https://irdb.globalcache.com/'>GlobalCache</a>"
+      " IR message</h3><p>"
+  "<form method='POST' action='/ir' enctype='multipart/form-data'>"
+    "<input type='hidden' name='" KEY_TYPE "' value='31'>"
+    "String: 1:1,1,<input type='text' name='" KEY_CODE "' size='132'"
+    " value='"
+#if EXAMPLES_ENABLE
+        "38000,1,1,170,170,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,"
+        "20,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,20,20,20,20,63,20,"
+        "20,20,20,20,20,20,20,20,20,20,20,20,63,20,20,20,63,20,63,20,63,20,"
+        "63,20,63,20,63,20,1798"
+#endif   // EXAMPLES_ENABLE
+        "'>"
+    " <input type='submit' value='Send GlobalCache'>"
+  "</form>"
+  "<br><hr>"
+  "<h3>Send a <a href='http://www.remotecentral.com/cgi-bin/files/rcfiles.cgi"
+    "?area=pronto&db=discrete'>Pronto code</a> IR message</h3><p>"
+  "<form method='POST' action='/ir' enctype='multipart/form-data'>"
+    "<input type='hidden' name='" KEY_TYPE "' value='25'>"
+    "String (comma separated): <input type='text' name='" KEY_CODE "'"
+    " size='132' value='"
+#if EXAMPLES_ENABLE
+        "0000,0067,0000,0015,0060,0018,0018,0018,0030,0018,0030,0018,"
+        "0030,0018,0018,0018,0030,0018,0018,0018,0018,0018,0030,0018,0018,"
+        "0018,0030,0018,0030,0018,0030,0018,0018,0018,0018,0018,0030,0018,"
+        "0018,0018,0018,0018,0030,0018,0018,03f6"
+#endif   // EXAMPLES_ENABLE
+        "'>"
+    " " D_STR_REPEAT ": <input type='number' name='" KEY_REPEAT "' min='0' "
+        "max='99' value='0' size='2' maxlength='2'>"
+    " <input type='submit' value='Send Pronto'>"
+  "</form>"
+  "<br>";
+
+// Send each chunk of a rendered web page to the client.
+void htmlWrite(const char *data, const uint16_t length) {
+  server.sendContent(data, length);
+}
+
+// Start sending a web page to the client, in chunks, as it is rendered.
+void htmlStart(void) {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/html", "");
+}
+
+// Finish sending a rendered web page to the client.
+void htmlFinish(IRhtmlRenderer *html) {
+  html->print(htmlEnd());
+  html->flush();
+  server.sendContent("");  // An empty chunk marks the end of the page.
+}
+
+// Fill in the fields of kHtmlRoot.
+void htmlRootFields(IRhtmlRenderer *html, void *arg, const uint16_t field) {
+  switch (field) {
+    case 0:
+      html->print(htmlMenu());
+      break;
+    case 1:
+      html->printSelect(KEY_TYPE, htmlSimpleProtocolOptions,
+                        String(decode_type_t::NEC));
+      break;
+    case 2:
+      for (uint8_t i = 0; i < sizeof(kCommonBitSizes); i++) {
+        html->printP(PSTR("<option value='"));
+        html->printNumber(kCommonBitSizes[i]);
+        html->printP(PSTR("'>"));
+        html->printNumber(kCommonBitSizes[i]);
+        html->printP(PSTR("</option>"));
       }
-    }
+      break;
+    case 3:
+      html->printSelect(KEY_TYPE, htmlAcStateProtocolOptions,
+                        String(decode_type_t::KELVINATOR));
+      break;
+    case 4:
+      html->printNumber(kStateSizeMax * 2);
+      break;
   }
-  html += F("</select>");
-  return html;
 }
 
 // Root web page with example usage etc.
@@ -710,106 +842,11 @@ void handleRoot(void) {
     return server.requestAuthentication();
   }
 #endif
-  String html = htmlHeader(F("ESP IR MQTT Server"));
-  html += F("<center><small><i>" _MY_VERSION_ "</i></small></center>");
-  html += htmlMenu();
-  html += F(
-    "<h3>Send a simple IR message</h3><p>"
-    "<form method='POST' action='/ir' enctype='multipart/form-data'>"
-      D_STR_PROTOCOL ": ");
-  html += htmlSelectAcStateProtocol(KEY_TYPE, decode_type_t::NEC, true);
-  html += F(
-      " " D_STR_CODE ": 0x<input type='text' name='" KEY_CODE "' min='0' "
-        "value='0' size='16' maxlength='16'> "
-      D_STR_BITS ": "
-      "<select name='" KEY_BITS "'>"
-        "<option selected='selected' value='0'>Default</option>");  // Default
-  for (uint8_t i = 0; i < sizeof(kCommonBitSizes); i++) {
-    String num = String(kCommonBitSizes[i]);
-    html += F("<option value='");
-    html += num;
-    html += F("'>");
-    html += num;
-    html += F("</option>");
-  }
-  html += F(
-      "</select>"
-      " " D_STR_REPEAT ": <input type='number' name='" KEY_REPEAT "' min='0' "
-        "max='99' value='0' size='2' maxlength='2'>"
-      " <input type='submit' value='Send " D_STR_CODE "'>"
-    "</form>"
-    "<br><hr>"
-    "<h3>Send a complex (Air Conditioner) IR message</h3><p>"
-    "<form method='POST' action='/ir' enctype='multipart/form-data'>"
-      D_STR_PROTOCOL ": ");
-  html += htmlSelectAcStateProtocol(KEY_TYPE, decode_type_t::KELVINATOR, false);
-  html += F(
-      " State " D_STR_CODE ": 0x"
-      "<input type='text' name='" KEY_CODE "' size='");
-  html += String(kStateSizeMax * 2);
-  html += F("' maxlength='");
-  html += String(kStateSizeMax * 2);
-  html += F("'"
-          " value='"
-#if EXAMPLES_ENABLE
-                "190B8050000000E0190B8070000010F0"
-#endif   // EXAMPLES_ENABLE
-                "'>"
-      " <input type='submit' value='Send A/C " D_STR_CODE "'>"
-    "</form>"
-    "<br><hr>"
-    "<h3>Send an IRremote Raw IR message</h3><p>"
-    "<form method='POST' action='/ir' enctype='multipart/form-data'>"
-      "<input type='hidden' name='" KEY_TYPE "' value='30'>"
-      "String: (freq,array data) <input type='text' name='" KEY_CODE "'"
-      " size='132' value='"
-#if EXAMPLES_ENABLE
-          "38000,4420,4420,520,1638,520,1638,520,1638,520,520,520,520,520,"
-          "520,520,520,520,520,520,1638,520,1638,520,1638,520,520,520,"
-          "520,520,520,520,520,520,520,520,520,520,1638,520,520,520,520,520,"
-          "520,520,520,520,520,520,520,520,1638,520,520,520,1638,520,1638,520,"
-          "1638,520,1638,520,1638,520,1638,520"
-#endif   // EXAMPLES_ENABLE
-          "'>"
-      " <input type='submit' value='Send Raw'>"
-    "</form>"
-    "<br><hr>"
-    "<h3>Send a <a href='https://irdb.globalcache.com/'>GlobalCache</a>"
-        " IR message</h3><p>"
-    "<form method='POST' action='/ir' enctype='multipart/form-data'>"
-      "<input type='hidden' name='" KEY_TYPE "' value='31'>"
-      "String: 1:1,1,<input type='text' name='" KEY_CODE "' size='132'"
-      " value='"
-#if EXAMPLES_ENABLE
-          "38000,1,1,170,170,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,"
-          "20,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,20,20,20,20,63,20,"
-          "20,20,20,20,20,20,20,20,20,20,20,20,63,20,20,20,63,20,63,20,63,20,"
-          "63,20,63,20,63,20,1798"
-#endif   // EXAMPLES_ENABLE
-          "'>"
-      " <input type='submit' value='Send GlobalCache'>"
-    "</form>"
-    "<br><hr>"
-    "<h3>Send a <a href='http://www.remotecentral.com/cgi-bin/files/rcfiles.cgi"
-      "?area=pronto&db=discrete'>Pronto code</a> IR message</h3><p>"
-    "<form method='POST' action='/ir' enctype='multipart/form-data'>"
-      "<input type='hidden' name='" KEY_TYPE "' value='25'>"
-      "String (comma separated): <input type='text' name='" KEY_CODE "'"
-      " size='132' value='"
-#if EXAMPLES_ENABLE
-          "0000,0067,0000,0015,0060,0018,0018,0018,0030,0018,0030,0018,"
-          "0030,0018,0018,0018,0030,0018,0018,0018,0018,0018,0030,0018,0018,"
-          "0018,0030,0018,0030,0018,0030,0018,0018,0018,0018,0018,0030,0018,"
-          "0018,0018,0018,0018,0030,0018,0018,03f6"
-#endif   // EXAMPLES_ENABLE
-          "'>"
-      " " D_STR_REPEAT ": <input type='number' name='" KEY_REPEAT "' min='0' "
-          "max='99' value='0' size='2' maxlength='2'>"
-      " <input type='submit' value='Send Pronto'>"
-    "</form>"
-    "<br>");
-  html += htmlEnd();
-  server.send(200, "text/html", html);
+  IRhtmlRenderer html(htmlWrite);
+  htmlStart();
+  html.print(htmlHeader(F("ESP IR MQTT Server")));
+  html.render(kHtmlRoot, htmlRootFields);
+  htmlFinish(&html);
 }
 
 String addJsReloadUrl(const String url, const uint16_t timeout_s,
@@ -893,55 +930,6 @@ void handleExamples(void) {
 }
 #endif  // EXAMPLES_ENABLE
 
-String htmlSelectBool(const String name, const bool def) {
-  String html = "<select name='" + name + "'>";
-  for (uint16_t i = 0; i < 2; i++)
-    html += htmlOptionItem(IRac::boolToString(i), IRac::boolToString(i),
-                           i == def);
-  html += F("</select>");
-  return html;
-}
-
-String htmlSelectClimateProtocol(const String name, const decode_type_t def) {
-  String html = "<select name='" + name + "'>";
-  for (uint8_t i = 1; i <= decode_type_t::kLastDecodeType; i++) {
-    if (IRac::isProtocolSupported((decode_type_t)i)) {
-      html += htmlOptionItem(String(i), typeToString((decode_type_t)i),
-                             i == def);
-    }
-  }
-  html += F("</select>");
-  return html;
-}
-
-String htmlSelectModel(const String name, const int16_t def) {
-  String html = "<select name='" + name + "'>";
-  for (int16_t i = -1; i <= 6; i++) {
-    String num = String(i);
-    String text;
-    if (i == -1)
-      text = F("Default");
-    else if (i == 0)
-      text = F("Unknown");
-    else
-      text = num;
-    html += htmlOptionItem(num, text, i == def);
-  }
-  html += F("</select>");
-  return html;
-}
-
-String htmlSelectUint(const String name, const uint16_t max,
-                      const uint16_t def) {
-  String html = "<select name='" + name + "'>";
-  for (uint16_t i = 0; i < max; i++) {
-    String num = String(i);
-    html += htmlOptionItem(num, num, i == def);
-  }
-  html += F("</select>");
-  return html;
-}
-
 String htmlSelectGpio(const String name, const int16_t def,
                       const int8_t list[], const int16_t length) {
   String html = ": <select name='" + name + "'>";
@@ -955,46 +943,6 @@ String htmlSelectGpio(const String name, const int16_t def,
   return html;
 }
 
-String htmlSelectMode(const String name, const stdAc::opmode_t def) {
-  String html = "<select name='" + name + "'>";
-  for (int8_t i = -1; i <= (int8_t)stdAc::opmode_t::kLastOpmodeEnum; i++) {
-    String mode = IRac::opmodeToString((stdAc::opmode_t)i);
-    html += htmlOptionItem(mode, mode, (stdAc::opmode_t)i == def);
-  }
-  html += F("</select>");
-  return html;
-}
-
-String htmlSelectFanspeed(const String name, const stdAc::fanspeed_t def) {
-  String html = "<select name='" + name + "'>";
-  for (int8_t i = 0; i <= (int8_t)stdAc::fanspeed_t::kLastFanspeedEnum; i++) {
-    String speed = IRac::fanspeedToString((stdAc::fanspeed_t)i);
-    html += htmlOptionItem(speed, speed, (stdAc::fanspeed_t)i == def);
-  }
-  html += F("</select>");
-  return html;
-}
-
-String htmlSelectSwingv(const String name, const stdAc::swingv_t def) {
-  String html = "<select name='" + name + "'>";
-  for (int8_t i = -1; i <= (int8_t)stdAc::swingv_t::kLastSwingvEnum; i++) {
-    String swing = IRac::swingvToString((stdAc::swingv_t)i);
-    html += htmlOptionItem(swing, swing, (stdAc::swingv_t)i == def);
-  }
-  html += F("</select>");
-  return html;
-}
-
-String htmlSelectSwingh(const String name, const stdAc::swingh_t def) {
-  String html = "<select name='" + name + "'>";
-  for (int8_t i = -1; i <= (int8_t)stdAc::swingh_t::kLastSwinghEnum; i++) {
-    String swing = IRac::swinghToString((stdAc::swingh_t)i);
-    html += htmlOptionItem(swing, swing, (stdAc::swingh_t)i == def);
-  }
-  html += F("</select>");
-  return html;
-}
-
 String htmlHeader(const String title, const String h1_text) {
   String html = F("<html><head><title>");
   html += title;
@@ -1025,92 +973,133 @@ String htmlButton(const String url, const String button, const String text) {
   return html;
 }
 
+// The templates for the A/C web page. See htmlAirConFields() for the fields.
+const char kHtmlAirConChannel[] PROGMEM =
+  "<form method='POST' action='/aircon/set' enctype='multipart/form-data'>"
+  "<table>"
+  "<tr><td><b>Climate #</b></td><td>{0}"
+  "<input type='submit' value='Change'>"
+  "</td></tr>"
+  "</table>"
+  "</form>"
+  "<hr>";
+const char kHtmlAirCon[] PROGMEM =
+  "<h3>Current Settings</h3>"
+  "<form method='POST' action='/aircon/set' enctype='multipart/form-data'>"
+  "<input type='hidden' name='" KEY_CHANNEL "' value='{1}'>"
+  "<table style='width:33%'>"
+  "<tr><td>" D_STR_PROTOCOL "</td><td>{2}</td></tr>"
+  "<tr><td>" D_STR_MODEL "</td><td>{3}</td></tr>"
+  "<tr><td>" D_STR_POWER "</td><td>{4}</td></tr>"
+  "<tr><td>" D_STR_MODE "</td><td>{5}</td></tr>"
+  "<tr><td>" D_STR_TEMP "</td><td>"
+      "<input type='number' name='" KEY_TEMP "' min='16' max='90' "
+      "step='0.5' value='{6}'>"
+      "<select name='" KEY_CELSIUS "'>"
+          "<option value='on'{7}>C</option>"
+          "<option value='off'{8}>F</option>"
+      "</select></td></tr>"
+  "<tr><td>" D_STR_FAN "</td><td>{9}</td></tr>"
+  "<tr><td>" D_STR_SWINGV "</td><td>{10}</td></tr>"
+  "<tr><td>" D_STR_SWINGH "</td><td>{11}</td></tr>"
+  "<tr><td>" D_STR_QUIET "</td><td>{12}</td></tr>"
+  "<tr><td>" D_STR_TURBO "</td><td>{13}</td></tr>"
+  "<tr><td>" D_STR_ECONO "</td><td>{14}</td></tr>"
+  "<tr><td>" D_STR_LIGHT "</td><td>{15}</td></tr>"
+  "<tr><td>" D_STR_FILTER "</td><td>{16}</td></tr>"
+  "<tr><td>" D_STR_CLEAN "</td><td>{17}</td></tr>"
+  "<tr><td>" D_STR_BEEP "</td><td>{18}</td></tr>"
+  "<tr><td>Force resend</td><td>{19}</td></tr>"
+  "</table>"
+  "<input type='submit' value='Update & Send'>"
+  "</form>";
+
+// Fill in the fields of the A/C web page templates from a climate state.
+void htmlAirConFields(IRhtmlRenderer *html, void *arg, const uint16_t field) {
+  const stdAc::state_t *state = reinterpret_cast<stdAc::state_t *>(arg);
+  switch (field) {
+    case 0:
+      html->printSelect(KEY_CHANNEL, htmlChannelOptions, String(chan));
+      break;
+    case 1: html->printNumber(chan); break;
+    case 2:
+      html->printSelect(KEY_PROTOCOL, htmlClimateProtocolOptions,
+                        String(state->protocol));
+      break;
+    case 3:
+      html->printSelect(KEY_MODEL, htmlModelOptions, String(state->model));
+      break;
+    case 4:
+      html->printSelect(KEY_POWER, htmlBoolOptions,
+                        IRac::boolToString(state->power));
+      break;
+    case 5:
+      html->printSelect(KEY_MODE, htmlModeOptions,
+                        IRac::opmodeToString(state->mode));
+      break;
+    case 6: html->print(String(state->degrees, 1)); break;
+    case 7:
+      if (state->celsius) html->printP(PSTR(" selected='selected'"));
+      break;
+    case 8:
+      if (!state->celsius) html->printP(PSTR(" selected='selected'"));
+      break;
+    case 9:
+      html->printSelect(KEY_FANSPEED, htmlFanspeedOptions,
+                        IRac::fanspeedToString(state->fanspeed));
+      break;
+    case 10:
+      html->printSelect(KEY_SWINGV, htmlSwingvOptions,
+                        IRac::swingvToString(state->swingv));
+      break;
+    case 11:
+      html->printSelect(KEY_SWINGH, htmlSwinghOptions,
+                        IRac::swinghToString(state->swingh));
+      break;
+    case 12:
+      html->printSelect(KEY_QUIET, htmlBoolOptions,
+                        IRac::boolToString(state->quiet));
+      break;
+    case 13:
+      html->printSelect(KEY_TURBO, htmlBoolOptions,
+                        IRac::boolToString(state->turbo));
+      break;
+    case 14:
+      html->printSelect(KEY_ECONO, htmlBoolOptions,
+                        IRac::boolToString(state->econo));
+      break;
+    case 15:
+      html->printSelect(KEY_LIGHT, htmlBoolOptions,
+                        IRac::boolToString(state->light));
+      break;
+    case 16:
+      html->printSelect(KEY_FILTER, htmlBoolOptions,
+                        IRac::boolToString(state->filter));
+      break;
+    case 17:
+      html->printSelect(KEY_CLEAN, htmlBoolOptions,
+                        IRac::boolToString(state->clean));
+      break;
+    case 18:
+      html->printSelect(KEY_BEEP, htmlBoolOptions,
+                        IRac::boolToString(state->beep));
+      break;
+    case 19:
+      html->printSelect(KEY_RESEND, htmlBoolOptions, IRac::boolToString(false));
+      break;
+  }
+}
+
 // Admin web page
 void handleAirCon(void) {
-  String html = htmlHeader(F("Air Conditioner Control"));
-  html += htmlMenu();
-  if (kNrOfIrTxGpios > 1) {
-    html += "<form method='POST' action='/aircon/set'"
-        " enctype='multipart/form-data'>"
-        "<table>"
-        "<tr><td><b>Climate #</b></td><td>" +
-        htmlSelectUint(KEY_CHANNEL, kNrOfIrTxGpios, chan) +
-        "<input type='submit' value='Change'>"
-        "</td></tr>"
-        "</table>"
-        "</form>"
-        "<hr>";
-  }
-  if (climate[chan] != NULL) {
-    html += "<h3>Current Settings</h3>"
-        "<form method='POST' action='/aircon/set'"
-        " enctype='multipart/form-data'>"
-        "<input type='hidden' name='" KEY_CHANNEL "' value='" + String(chan) +
-            "'>" +
-        "<table style='width:33%'>"
-        "<tr><td>" D_STR_PROTOCOL "</td><td>" +
-            htmlSelectClimateProtocol(KEY_PROTOCOL,
-                                      climate[chan]->next.protocol) +
-            "</td></tr>"
-        "<tr><td>" D_STR_MODEL "</td><td>" +
-            htmlSelectModel(KEY_MODEL, climate[chan]->next.model) +
-            "</td></tr>"
-        "<tr><td>" D_STR_POWER "</td><td>" +
-            htmlSelectBool(KEY_POWER, climate[chan]->next.power) +
-            "</td></tr>"
-        "<tr><td>" D_STR_MODE "</td><td>" +
-            htmlSelectMode(KEY_MODE, climate[chan]->next.mode) +
-            "</td></tr>"
-        "<tr><td>" D_STR_TEMP "</td><td>"
-            "<input type='number' name='" KEY_TEMP "' min='16' max='90' "
-            "step='0.5' value='" + String(climate[chan]->next.degrees, 1) + "'>"
-            "<select name='" KEY_CELSIUS "'>"
-                "<option value='on'" +
-                (climate[chan]->next.celsius ? " selected='selected'" : "") +
-                ">C</option>"
-                "<option value='off'" +
-                (!climate[chan]->next.celsius ? " selected='selected'" : "") +
-                ">F</option>"
-            "</select></td></tr>"
-        "<tr><td>" D_STR_FAN "</td><td>" +
-            htmlSelectFanspeed(KEY_FANSPEED, climate[chan]->next.fanspeed) +
-            "</td></tr>"
-        "<tr><td>" D_STR_SWINGV "</td><td>" +
-            htmlSelectSwingv(KEY_SWINGV, climate[chan]->next.swingv) +
-            "</td></tr>"
-        "<tr><td>" D_STR_SWINGH "</td><td>" +
-            htmlSelectSwingh(KEY_SWINGH, climate[chan]->next.swingh) +
-            "</td></tr>"
-        "<tr><td>" D_STR_QUIET "</td><td>" +
-            htmlSelectBool(KEY_QUIET, climate[chan]->next.quiet) +
-            "</td></tr>"
-        "<tr><td>" D_STR_TURBO "</td><td>" +
-            htmlSelectBool(KEY_TURBO, climate[chan]->next.turbo) +
-            "</td></tr>"
-        "<tr><td>" D_STR_ECONO "</td><td>" +
-            htmlSelectBool(KEY_ECONO, climate[chan]->next.econo) +
-            "</td></tr>"
-        "<tr><td>" D_STR_LIGHT "</td><td>" +
-            htmlSelectBool(KEY_LIGHT, climate[chan]->next.light) +
-            "</td></tr>"
-        "<tr><td>" D_STR_FILTER "</td><td>" +
-            htmlSelectBool(KEY_FILTER, climate[chan]->next.filter) +
-            "</td></tr>"
-        "<tr><td>" D_STR_CLEAN "</td><td>" +
-            htmlSelectBool(KEY_CLEAN, climate[chan]->next.clean) +
-            "</td></tr>"
-        "<tr><td>" D_STR_BEEP "</td><td>" +
-            htmlSelectBool(KEY_BEEP, climate[chan]->next.beep) +
-            "</td></tr>"
-        "<tr><td>Force resend</td><td>" +
-            htmlSelectBool(KEY_RESEND, false) +
-            "</td></tr>"
-        "</table>"
-        "<input type='submit' value='Update & Send'>"
-        "</form>";
-  }
-  html += htmlEnd();
-  server.send(200, "text/html", html);
+  IRhtmlRenderer html(htmlWrite);
+  htmlStart();
+  html.print(htmlHeader(F("Air Conditioner Control")));
+  html.print(htmlMenu());
+  if (kNrOfIrTxGpios > 1) html.render(kHtmlAirConChannel, htmlAirConFields);
+  if (climate[chan] != NULL)
+    html.render(kHtmlAirCon, htmlAirConFields, &climate[chan]->next);
+  htmlFinish(&html);
 }
 
 // Parse the URL args to find the Common A/C arguments.
@@ -1145,9 +1134,10 @@ void handleAirConSet(void) {
         updateClimate(&(ac_ptr->next), server.argName(i), "", server.arg(i));
     }
 #if MQTT_ENABLE
-    sendClimate(genStatTopic(chan), true, false, force_resend, true, ac_ptr);
+    sendClimate(climatePublisher[chan], true, false, force_resend, true,
+                ac_ptr);
 #else  // MQTT_ENABLE
-    sendClimate("", false, false, force_resend, true, ac_ptr);
+    sendClimate(NULL, false, false, force_resend, true, ac_ptr);
 #endif  // MQTT_ENABLE
     lastClimateSource = F("HTTP");
   } else {  // ac_ptr == NULL
@@ -1227,132 +1217,227 @@ uint32_t maxSketchSpace(void) {
 String vccToString(void) { return String(ESP.getVcc() / 1000.0); }
 #endif  // REPORT_VCC
 
-// Info web page
-void handleInfo(void) {
-  String html = htmlHeader(F("IR MQTT server info"));
-  html += htmlMenu();
-  html +=
-    "<h3>General</h3>"
-    "<p>Hostname: " + String(Hostname) + "<br>"
-    "IP address: " + WiFi.localIP().toString() + "<br>"
-    "MAC address: " + WiFi.macAddress() + "<br>"
-    "Booted: " + timeSince(1) + "<br>" +
-    "Version: " _MY_VERSION_ "<br>"
-    "Built: " __DATE__
-      " " __TIME__ "<br>"
-    "Period Offset: " + String(offset) + "us<br>"
-    "IR Lib Version: " _IRREMOTEESP8266_VERSION_ "<br>"
+// The template for the info web page. See htmlInfoFields() for the fields.
+const char kHtmlInfo[] PROGMEM =
+  "<h3>General</h3>"
+  "<p>Hostname: {0}<br>"
+  "IP address: {1}<br>"
+  "MAC address: {2}<br>"
+  "Booted: {3}<br>"
+  "Version: " _MY_VERSION_ "<br>"
+  "Built: " __DATE__
+    " " __TIME__ "<br>"
+  "Period Offset: {4}us<br>"
+  "IR Lib Version: " _IRREMOTEESP8266_VERSION_ "<br>"
 #if defined(ESP8266)
-    "ESP8266 Core Version: " + ESP.getCoreVersion() + "<br>"
-    "Free Sketch Space: " + String(maxSketchSpace() >> 10) + "k<br>"
+  "ESP8266 Core Version: {5}<br>"
+  "Free Sketch Space: {6}k<br>"
 #endif  // ESP8266
 #if defined(ESP32)
-    "ESP32 SDK Version: " + ESP.getSdkVersion() + "<br>"
+  "ESP32 SDK Version: {7}<br>"
 #endif  // ESP32
-    "Cpu Freq: " + String(ESP.getCpuFreqMHz()) + "MHz<br>"
-    "Sanity Check: " + String((_sanity == 0) ? "Ok" : "FAILED") + "<br>"
-    "IR Send GPIO(s): " + listOfTxGpios() + "<br>"
-    + irutils::addBoolToString(kInvertTxOutput,
-                               "Inverting GPIO output", false) + "<br>"
-    "Total send requests: " + String(sendReqCounter) + "<br>"
-    "Last message sent: " + String(lastSendSucceeded ? "Ok" : "FAILED") +
-    " <i>(" + timeSince(lastSendTime) + ")</i><br>"
+  "Cpu Freq: {8}MHz<br>"
+  "Sanity Check: {9}<br>"
+  "IR Send GPIO(s): {10}<br>"
+  "{11}<br>"
+  "Total send requests: {12}<br>"
+  "Last message sent: {13} <i>({14})</i><br>"
 #if IR_RX
-    "IR Recv GPIO: " + gpioToString(rx_gpio) +
+  "IR Recv GPIO: {15}"
 #if IR_RX_PULLUP
-    " (pullup)"
+  " (pullup)"
 #endif  // IR_RX_PULLUP
-    "<br>"
-    "Total IR Received: " + String(irRecvCounter) + "<br>"
-    "Last IR Received: " + lastIrReceived +
-    " <i>(" + timeSince(lastIrReceivedTime) + ")</i><br>"
+  "<br>"
+  "Total IR Received: {16}<br>"
+  "Last IR Received: {17} <i>({18})</i><br>"
 #endif  // IR_RX
-    "Duplicate " D_STR_WIFI " networks: " +
-        String(HIDE_DUPLICATE_NETWORKS ? "Hide" : "Show") + "<br>"
-    "Min " D_STR_WIFI " signal required: "
+  "Duplicate " D_STR_WIFI " networks: {19}<br>"
+  "Min " D_STR_WIFI " signal required: {20}%<br>"
+  "Serial debugging: {21}<br>"
+#if REPORT_VCC
+  "Vcc: {22}V<br>"
+#endif  // REPORT_VCC
+  "</p>"
+#if MQTT_ENABLE
+  "<h4>MQTT Information</h4>"
+  "<p>Server: {23} <i>({24})</i><br>"
+  "Disconnections: {25}<br>"
+  "Buffer Size: {26} bytes<br>"
+  "Client id: {27}<br>"
+  "Command topic(s): {28}<br>"
+  "Acknowledgements topic: {29}<br>"
+#if IR_RX
+  "IR Received topic: {30}<br>"
+#endif  // IR_RX
+  "Log topic: {31}<br>"
+  "LWT topic: {32}<br>"
+  "QoS: {33}<br>"
+  "Last MQTT command seen: (topic) '{34}' (payload) '{35}' <i>({36})</i><br>"
+  "Total published: {37}<br>"
+  "Total received: {38}<br>"
+  "</p>"
+#endif  // MQTT_ENABLE
+  "<h4>Climate Information</h4>"
+  "<p>"
+  "IR Send GPIO: {39}<br>"
+  "Last update source: {40}<br>"
+  "Total sent: {41}<br>"
+  "Last send: {42}<br>"
+#if MQTT_ENABLE
+  "State listen period: {43}<br>"
+  "State broadcast period: {44}<br>"
+  "Last state broadcast: {45}<br>"
+#if MQTT_DISCOVERY_ENABLE
+  "Last discovery sent: {46}<br>"
+  "Discovery topic: {47}<br>"
+#endif  // MQTT_DISCOVERY_ENABLE
+  "Command topics: {48}"
+  "State topics: {49}"
+#endif  // MQTT_ENABLE
+  "</p>"
+  // Page footer
+  "<hr><p><small><center>"
+    "<i>(Note: Page will refresh every 60 " D_STR_SECONDS ".)</i>"
+  "<centre></small></p>";
+
+// Fill in the fields of kHtmlInfo.
+void htmlInfoFields(IRhtmlRenderer *html, void *arg, const uint16_t field) {
+  switch (field) {
+    case 0: html->print(Hostname); break;
+    case 1: html->print(WiFi.localIP().toString()); break;
+    case 2: html->print(WiFi.macAddress()); break;
+    case 3: html->print(timeSince(1)); break;
+    case 4: html->printNumber(offset); break;
+#if defined(ESP8266)
+    case 5: html->print(ESP.getCoreVersion()); break;
+    case 6: html->printNumber(maxSketchSpace() >> 10); break;
+#endif  // ESP8266
+#if defined(ESP32)
+    case 7: html->print(ESP.getSdkVersion()); break;
+#endif  // ESP32
+    case 8: html->printNumber(ESP.getCpuFreqMHz()); break;
+    case 9: html->print((_sanity == 0) ? "Ok" : "FAILED"); break;
+    case 10: html->print(listOfTxGpios()); break;
+    case 11:
+      html->print(irutils::addBoolToString(kInvertTxOutput,
+                                           "Inverting GPIO output", false));
+      break;
+    case 12: html->printNumber(sendReqCounter); break;
+    case 13: html->print(lastSendSucceeded ? "Ok" : "FAILED"); break;
+    case 14: html->print(timeSince(lastSendTime)); break;
+#if IR_RX
+    case 15: html->print(gpioToString(rx_gpio)); break;
+    case 16: html->printNumber(irRecvCounter); break;
+    case 17: html->print(lastIrReceived); break;
+    case 18: html->print(timeSince(lastIrReceivedTime)); break;
+#endif  // IR_RX
+    case 19: html->print(HIDE_DUPLICATE_NETWORKS ? "Hide" : "Show"); break;
+    case 20:
 #ifdef MIN_SIGNAL_STRENGTH
-        + String(static_cast<int>(MIN_SIGNAL_STRENGTH)) +
+      html->printNumber(static_cast<int>(MIN_SIGNAL_STRENGTH));
 #else  // MIN_SIGNAL_STRENGTH
-        "8"
+      html->print('8');
 #endif  // MIN_SIGNAL_STRENGTH
-        "%<br>"
-    "Serial debugging: "
+      break;
+    case 21:
 #if DEBUG
-        + String(isSerialGpioUsedByIr() ? D_STR_OFF : D_STR_ON) +
+      html->print(isSerialGpioUsedByIr() ? D_STR_OFF : D_STR_ON);
 #else  // DEBUG
-        D_STR_OFF
+      html->print(D_STR_OFF);
 #endif  // DEBUG
-        "<br>"
+      break;
 #if REPORT_VCC
-    "Vcc: ";
-    html += vccToString();
-    html += "V<br>"
+    case 22: html->print(vccToString()); break;
 #endif  // REPORT_VCC
-    "</p>"
 #if MQTT_ENABLE
-    "<h4>MQTT Information</h4>"
-    "<p>Server: " + String(MqttServer) + ":" + String(MqttPort) + " <i>(" +
-    (mqtt_client.connected() ? "Connected " + timeSince(lastDisconnectedTime)
-                             : "Disconnected " + timeSince(lastConnectedTime)) +
-    ")</i><br>"
-    "Disconnections: " + String(mqttDisconnectCounter - 1) + "<br>"
-    "Buffer Size: " + String(mqtt_client.getBufferSize()) + " bytes<br>"
-    "Client id: " + MqttClientId + "<br>"
-    "Command topic(s): " + listOfCommandTopics() + "<br>"
-    "Acknowledgements topic: " + MqttAck + "<br>"
+    case 23:
+      html->print(MqttServer);
+      html->print(':');
+      html->print(MqttPort);
+      break;
+    case 24:
+      if (mqtt_client.connected()) {
+        html->print("Connected ");
+        html->print(timeSince(lastDisconnectedTime));
+      } else {
+        html->print("Disconnected ");
+        html->print(timeSince(lastConnectedTime));
+      }
+      break;
+    case 25: html->printNumber(mqttDisconnectCounter - 1); break;
+    case 26: html->printNumber(mqtt_client.getBufferSize()); break;
+    case 27: html->print(MqttClientId); break;
+    case 28: html->print(listOfCommandTopics()); break;
+    case 29: html->print(MqttAck); break;
 #if IR_RX
-    "IR Received topic: " + MqttRecv + "<br>"
+    case 30: html->print(MqttRecv); break;
 #endif  // IR_RX
-    "Log topic: " + MqttLog + "<br>"
-    "LWT topic: " + MqttLwt + "<br>"
-    "QoS: " + String(QOS) + "<br>"
+    case 31: html->print(MqttLog); break;
+    case 32: html->print(MqttLwt); break;
+    case 33: html->printNumber(QOS); break;
     // lastMqttCmd* is unescaped untrusted input.
     // Avoid any possible HTML/XSS when displaying it.
-    "Last MQTT command seen: (topic) '" +
-        irutils::htmlEscape(lastMqttCmdTopic) +
-         "' (payload) '" + irutils::htmlEscape(lastMqttCmd) + "' <i>(" +
-         timeSince(lastMqttCmdTime) + ")</i><br>"
-    "Total published: " + String(mqttSentCounter) + "<br>"
-    "Total received: " + String(mqttRecvCounter) + "<br>"
-    "</p>"
+    case 34: html->printEscaped(lastMqttCmdTopic); break;
+    case 35: html->printEscaped(lastMqttCmd); break;
+    case 36: html->print(timeSince(lastMqttCmdTime)); break;
+    case 37: html->printNumber(mqttSentCounter); break;
+    case 38: html->printNumber(mqttRecvCounter); break;
 #endif  // MQTT_ENABLE
-    "<h4>Climate Information</h4>"
-    "<p>"
-    "IR Send GPIO: " + String(txGpioTable[0]) + "<br>"
-    "Last update source: " + lastClimateSource + "<br>"
-    "Total sent: " + String(irClimateCounter) + "<br>"
-    "Last send: " + String(hasClimateBeenSent ?
-        (String(lastClimateSucceeded ? "Ok" : "FAILED") +
-         " <i>(" + timeElapsed(lastClimateIr.elapsed()) + ")</i>") :
-        "<i>Never</i>") + "<br>"
+    case 39: html->printNumber(txGpioTable[0]); break;
+    case 40: html->print(lastClimateSource); break;
+    case 41: html->printNumber(irClimateCounter); break;
+    case 42:
+      if (hasClimateBeenSent) {
+        html->print(lastClimateSucceeded ? "Ok" : "FAILED");
+        html->print(" <i>(");
+        html->print(timeElapsed(lastClimateIr.elapsed()));
+        html->print(")</i>");
+      } else {
+        html->print("<i>Never</i>");
+      }
+      break;
 #if MQTT_ENABLE
-    "State listen period: " + msToString(kStatListenPeriodMs) + "<br>"
-    "State broadcast period: " + msToString(kBroadcastPeriodMs) + "<br>"
-    "Last state broadcast: " + (hasBroadcastBeenSent ?
-        timeElapsed(lastBroadcast.elapsed()) :
-        String("<i>Never</i>")) + "<br>"
+    case 43: html->print(msToString(kStatListenPeriodMs)); break;
+    case 44: html->print(msToString(kBroadcastPeriodMs)); break;
+    case 45:
+      if (hasBroadcastBeenSent)
+        html->print(timeElapsed(lastBroadcast.elapsed()));
+      else
+        html->print("<i>Never</i>");
+      break;
 #if MQTT_DISCOVERY_ENABLE
-    "Last discovery sent: " + (lockMqttBroadcast ?
-        String("<b>Locked</b>") :
-        (hasDiscoveryBeenSent ?
-            timeElapsed(lastDiscovery.elapsed()) :
-            String("<i>Never</i>"))) +
-        "<br>"
-    "Discovery topic: " + MqttDiscovery + "<br>" +
+    case 46:
+      if (lockMqttBroadcast)
+        html->print("<b>Locked</b>");
+      else if (hasDiscoveryBeenSent)
+        html->print(timeElapsed(lastDiscovery.elapsed()));
+      else
+        html->print("<i>Never</i>");
+      break;
+    case 47: html->print(MqttDiscovery); break;
 #endif  // MQTT_DISCOVERY_ENABLE
-    "Command topics: " + MqttClimate + channel_re + '/' + MQTT_CLIMATE_CMND +
-        '/' + kClimateTopics +
-    "State topics: " + MqttClimate + channel_re + '/' + MQTT_CLIMATE_STAT +
-        '/' + kClimateTopics +
+    case 48:
+    case 49:
+      html->print(MqttClimate);
+      html->print(channel_re);
+      html->print('/');
+      html->print(field == 48 ? MQTT_CLIMATE_CMND : MQTT_CLIMATE_STAT);
+      html->print('/');
+      html->print(kClimateTopics);
+      break;
 #endif  // MQTT_ENABLE
-    "</p>"
-    // Page footer
-    "<hr><p><small><center>"
-      "<i>(Note: Page will refresh every 60 " D_STR_SECONDS ".)</i>"
-    "<centre></small></p>";
-  html += addJsReloadUrl(kUrlInfo, 60, false);
-  html += htmlEnd();
-  server.send(200, "text/html", html);
+  }
+}
+
+// Info web page
+void handleInfo(void) {
+  IRhtmlRenderer html(htmlWrite);
+  htmlStart();
+  html.print(htmlHeader(F("IR MQTT server info")));
+  html.print(htmlMenu());
+  html.render(kHtmlInfo, htmlInfoFields);
+  html.print(addJsReloadUrl(kUrlInfo, 60, false));
+  htmlFinish(&html);
 }
 
 void doRestart(const char* str, const bool serial_only) {
@@ -1473,13 +1558,13 @@ void handleReboot() {
 
 // Parse an Air Conditioner A/C Hex String/code and send it.
 // Args:
-//   irsend: A Ptr to the IRsend object to transmit via.
+//   channel: The IR transmitter to send it via.
 //   irType: Nr. of the protocol we need to send.
 //   str: A hexadecimal string containing the state to be sent.
 // Returns:
-//   bool: Successfully sent or not.
-bool parseStringAndSendAirCon(IRsend *irsend, const decode_type_t irType,
-                              const String str) {
+//   bool: Successfully queued to be sent or not.
+bool parseStringAndSendAirCon(const uint8_t channel,
+                              const decode_type_t irType, const String str) {
   uint8_t strOffset = 0;
   uint8_t state[kStateSizeMax] = {0};  // All array elements are set to 0.
   uint16_t stateSize = 0;
@@ -1608,50 +1693,17 @@ bool parseStringAndSendAirCon(IRsend *irsend, const decode_type_t irType,
       *statePtr = c;
     }
   }
-  if (!irsend->send(irType, state, stateSize)) {
-    debug("Unexpected AirCon type in send request. Not sent.");
+  if (!sendQueue->addState(channel, irType, state, stateSize)) {
+    debug("AirCon state couldn't be queued. Not sent.");
     return false;
   }
   return true;  // We were successful as far as we can tell.
 }
 
-// Count how many values are in the String.
-// Args:
-//   str:  String containing the values.
-//   sep:  Character that separates the values.
-// Returns:
-//   The number of values found in the String.
-uint16_t countValuesInStr(const String str, char sep) {
-  int16_t index = -1;
-  uint16_t count = 1;
-  do {
-    index = str.indexOf(sep, index + 1);
-    count++;
-  } while (index != -1);
-  return count;
-}
-
-// Dynamically allocate an array of uint16_t's.
-// Args:
-//   size:  Nr. of uint16_t's need to be in the new array.
-// Returns:
-//   A Ptr to the new array. Restarts the ESP if it fails.
-uint16_t * newCodeArray(const uint16_t size) {
-  uint16_t *result;
-
-  result = reinterpret_cast<uint16_t*>(malloc(size * sizeof(uint16_t)));
-  // Check we malloc'ed successfully.
-  if (result == NULL)  // malloc failed, so give up.
-    doRestart(
-        "FATAL: Can't allocate memory for an array for a new message! "
-        "Forcing a reboot!", true);  // Send to serial only as we are in low mem
-  return result;
-}
-
 #if SEND_GLOBALCACHE
-// Parse a GlobalCache String/code and send it.
+// Parse a GlobalCache String/code and queue it to be sent.
 // Args:
-//   irsend: A ptr to the IRsend object to transmit via.
+//   channel: The IR transmitter to send it via.
 //   str: A GlobalCache formatted String of comma separated numbers.
 //        e.g. "38000,1,1,170,170,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,
 //              20,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,20,20,20,20,63,
@@ -1659,46 +1711,23 @@ uint16_t * newCodeArray(const uint16_t size) {
 //              63,20,63,20,63,20,63,20,1798"
 //        Note: The leading "1:1,1," of normal GC codes should be removed.
 // Returns:
-//   bool: Successfully sent or not.
-bool parseStringAndSendGC(IRsend *irsend, const String str) {
-  uint16_t count;
-  uint16_t *code_array;
-  String tmp_str;
-
-  // Remove the leading "1:1,1," if present.
-  if (str.startsWith("1:1,1,"))
-    tmp_str = str.substring(6);
-  else
-    tmp_str = str;
-
-  // Find out how many items there are in the string.
-  count = countValuesInStr(tmp_str, ',');
-
-  // Now we know how many there are, allocate the memory to store them all.
-  code_array = newCodeArray(count);
-
-  // Now convert the strings to integers and place them in code_array.
-  count = 0;
-  uint16_t start_from = 0;
-  int16_t index = -1;
-  do {
-    index = tmp_str.indexOf(',', start_from);
-    code_array[count] = tmp_str.substring(start_from, index).toInt();
-    start_from = index + 1;
-    count++;
-  } while (index != -1);
-  irsend->sendGC(code_array, count);  // All done. Send it.
-  free(code_array);  // Free up the memory allocated.
-  if (count > 0)
-    return true;  // We sent something.
-  return false;  // We probably didn't.
+//   bool: Successfully queued to be sent or not.
+bool parseStringAndSendGC(const uint8_t channel, const String str) {
+  const char *values = str.c_str();
+  // Skip the leading "1:1,1," if present.
+  if (str.startsWith("1:1,1,")) values += 6;
+
+  // Check it is well formed before queuing it.
+  if (irutils::countValues(values) == 0) return false;
+  // The values are converted as they are sent.
+  return sendQueue->addText(channel, decode_type_t::GLOBALCACHE, values);
 }
 #endif  // SEND_GLOBALCACHE
 
 #if SEND_PRONTO
-// Parse a Pronto Hex String/code and send it.
+// Parse a Pronto Hex String/code and queue it to be sent.
 // Args:
-//   irsend: A ptr to the IRsend object to transmit via.
+//   channel: The IR transmitter to send it via.
 //   str: A comma-separated String of nr. of repeats, then hexadecimal numbers.
 //        e.g. "R1,0000,0067,0000,0015,0060,0018,0018,0018,0030,0018,0030,0018,
 //              0030,0018,0018,0018,0030,0018,0018,0018,0018,0018,0030,0018,
@@ -1711,97 +1740,44 @@ bool parseStringAndSendGC(IRsend *irsend, const String str) {
 //   repeats:  Nr. of times the message is to be repeated.
 //             This value is ignored if an embeddd repeat is found in str.
 // Returns:
-//   bool: Successfully sent or not.
-bool parseStringAndSendPronto(IRsend *irsend, const String str,
+//   bool: Successfully queued to be sent or not.
+bool parseStringAndSendPronto(const uint8_t channel, const String str,
                               uint16_t repeats) {
-  uint16_t count;
-  uint16_t *code_array;
-  int16_t index = -1;
-  uint16_t start_from = 0;
-
-  // Find out how many items there are in the string.
-  count = countValuesInStr(str, ',');
+  const char *values = str.c_str();
 
   // Check if we have the optional embedded repeats value in the code string.
   if (str.startsWith("R") || str.startsWith("r")) {
     // Grab the first value from the string, as it is the nr. of repeats.
-    index = str.indexOf(',', start_from);
-    repeats = str.substring(start_from + 1, index).toInt();  // Skip the 'R'.
-    start_from = index + 1;
-    count--;  // We don't count the repeats value as part of the code array.
-  }
-
-  // We need at least kProntoMinLength values for the code part.
-  if (count < kProntoMinLength) return false;
-
-  // Now we know how many there are, allocate the memory to store them all.
-  code_array = newCodeArray(count);
-
-  // Rest of the string are values for the code array.
-  // Now convert the hex strings to integers and place them in code_array.
-  count = 0;
-  do {
-    index = str.indexOf(',', start_from);
-    // Convert the hexadecimal value string to an unsigned integer.
-    code_array[count] = strtoul(str.substring(start_from, index).c_str(),
-                                NULL, 16);
-    start_from = index + 1;
-    count++;
-  } while (index != -1);
-
-  irsend->sendPronto(code_array, count, repeats);  // All done. Send it.
-  free(code_array);  // Free up the memory allocated.
-  if (count > 0)
-    return true;  // We sent something.
-  return false;  // We probably didn't.
+    irutils::ValueReader reader(values + 1);  // Skip the 'R'.
+    const char *comma = strchr(values, ',');
+    if (comma == NULL || !reader.next(&repeats)) return false;
+    values = comma + 1;
+  }
+
+  // We need at least kProntoMinLength well formed values for the code part.
+  if (irutils::countValues(values, 16) < kProntoMinLength) return false;
+
+  // The hexadecimal values are converted as they are sent.
+  return sendQueue->addText(channel, decode_type_t::PRONTO, values, repeats);
 }
 #endif  // SEND_PRONTO
 
 #if SEND_RAW
-// Parse an IRremote Raw String/code and send it.
+// Parse an IRremote Raw String/code and queue it to be sent.
+// The values are converted as they are sent, so no array is allocated.
 // Args:
-//   irsend: A ptr to the IRsend object to transmit via.
+//   channel: The IR transmitter to send it via.
 //   str: A comma-separated String containing the freq and raw IR data.
 //        e.g. "38000,9000,4500,600,1450,600,900,650,1500,..."
 //        Requires at least two comma-separated values.
 //        First value is the transmission frequency in Hz or kHz.
 // Returns:
-//   bool: Successfully sent or not.
-bool parseStringAndSendRaw(IRsend *irsend, const String str) {
-  uint16_t count;
-  uint16_t freq = 38000;  // Default to 38kHz.
-  uint16_t *raw_array;
-
-  // Find out how many items there are in the string.
-  count = countValuesInStr(str, ',');
-
-  // We expect the frequency as the first comma separated value, so we need at
-  // least two values. If not, bail out.
-  if (count < 2)  return false;
-  count--;  // We don't count the frequency value as part of the raw array.
-
-  // Now we know how many there are, allocate the memory to store them all.
-  raw_array = newCodeArray(count);
-
-  // Grab the first value from the string, as it is the frequency.
-  int16_t index = str.indexOf(',', 0);
-  freq = str.substring(0, index).toInt();
-  uint16_t start_from = index + 1;
-  // Rest of the string are values for the raw array.
-  // Now convert the strings to integers and place them in raw_array.
-  count = 0;
-  do {
-    index = str.indexOf(',', start_from);
-    raw_array[count] = str.substring(start_from, index).toInt();
-    start_from = index + 1;
-    count++;
-  } while (index != -1);
-
-  irsend->sendRaw(raw_array, count, freq);  // All done. Send it.
-  free(raw_array);  // Free up the memory allocated.
-  if (count > 0)
-    return true;  // We sent something.
-  return false;  // We probably didn't.
+//   bool: Successfully queued to be sent or not.
+bool parseStringAndSendRaw(const uint8_t channel, const String str) {
+  // Check it is well formed & has at least two values before queuing it.
+  if (irutils::countValues(str.c_str()) < 2) return false;
+  // The first value is the frequency, the rest are the raw data.
+  return sendQueue->addText(channel, decode_type_t::RAW, str);
 }
 #endif  // SEND_RAW
 
@@ -1846,11 +1822,10 @@ void handleIr(void) {
     }
   }
   debug("New code received via HTTP");
-  IRsend *tx_ptr = getDefaultIrSendPtr();
-  if (channel >= 0 && channel < kNrOfIrTxGpios && IrSendTable[channel] != NULL)
-    tx_ptr = IrSendTable[channel];
-  lastSendSucceeded = sendIRCode(tx_ptr, ir_type, data, data_str.c_str(), nbits,
-                                 repeat);
+  if (channel < 0 || channel >= kNrOfIrTxGpios ||
+      IrSendTable[channel] == NULL)
+    channel = getDefaultIrSendIdx();
+  sendIRCode(channel, ir_type, data, data_str.c_str(), nbits, repeat);
   String html = htmlHeader(F("IR command sent!"));
   html += addJsReloadUrl(kUrlRoot, kQuickDisplayTime, true);
   html += htmlEnd();
@@ -2042,6 +2017,17 @@ void setup_wifi(void) {
 }
 
 void init_vars(void) {
+  // The menus for the web pages. They don't change, so only make them once.
+  htmlSimpleProtocolOptions = IRhtmlRenderer::protocolOptions(true);
+  htmlAcStateProtocolOptions = IRhtmlRenderer::protocolOptions(false);
+  htmlClimateProtocolOptions = IRhtmlRenderer::climateProtocolOptions();
+  htmlChannelOptions = IRhtmlRenderer::uintOptions(kNrOfIrTxGpios);
+  htmlModelOptions = IRhtmlRenderer::modelOptions();
+  htmlBoolOptions = IRhtmlRenderer::boolOptions();
+  htmlModeOptions = IRhtmlRenderer::modeOptions();
+  htmlFanspeedOptions = IRhtmlRenderer::fanspeedOptions();
+  htmlSwingvOptions = IRhtmlRenderer::swingvOptions();
+  htmlSwinghOptions = IRhtmlRenderer::swinghOptions();
 #if MQTT_ENABLE
   // If we have a prefix already, use it. Otherwise use the hostname.
   if (!strlen(MqttPrefix)) strncpy(MqttPrefix, Hostname, kHostnameLength);
@@ -2059,6 +2045,11 @@ void init_vars(void) {
   MqttClimate = String(MqttPrefix) + '/' + MQTT_CLIMATE;
   // Sub-topic for the climate command topics.
   MqttClimateCmnd = MqttClimate + '/' + MQTT_CLIMATE_CMND + '/';
+  // The climate state publishers, which build all their topics now.
+  for (uint16_t i = 0; i < kNrOfIrTxGpios; i++)
+    climatePublisher[i] = (climate[i] == NULL) ? NULL :
+        new IRacPublisher(publishClimate, NULL, genStatTopic(i),
+                          MQTT_CLIMATE_JSON_BATCH, MQTT_CLIMATE_HA_MODE);
   // Sub-topic for the climate stat topics.
 #if MQTT_DISCOVERY_ENABLE
   MqttDiscovery = "homeassistant/climate/" + String(Hostname) + "/config";
@@ -2108,11 +2099,16 @@ void setup(void) {
       if (IrSendTable[i] != NULL) {
         IrSendTable[i]->begin();
         offset = IrSendTable[i]->calibrate();
+#if IR_RX && IGNORE_OWN_TRANSMISSIONS
+        IrSendTable[i]->setEchoLog(echoLog[i], kEchoLogSize);
+#endif  // IR_RX && IGNORE_OWN_TRANSMISSIONS
       }
       climate[i] = new IRac(txGpioTable[i], kInvertTxOutput);
       if (climate[i] != NULL && i > 0) channel_re += '_' + String(i) + '|';
     }
   }
+  sendQueue = new IRsendQueue(IrSendTable, kNrOfIrTxGpios, kIrSendQueueSize,
+                              kIrSendGapMs * 1000);
   lastClimateSource = F("None");
   if (channel_re.length() == 1) {
     channel_re = "";
@@ -2331,6 +2327,8 @@ bool reconnect(void) {
         if (climate[i] != NULL)
           subscribing(MqttClimate + '_' + String(i) + '/' + MQTT_CLIMATE_CMND +
                       '/' + '+');
+        // The broker may have lost what we published, so send it all again.
+        if (climatePublisher[i] != NULL) climatePublisher[i]->forget();
       }
     } else {
       debug(("failed, rc=" + String(mqtt_client.state()) +
@@ -2376,6 +2374,20 @@ void handleSendMqttDiscovery(void) {
 }
 #endif  // MQTT_DISCOVERY_ENABLE
 
+// Publish a climate setting via MQTT. Used by `IRacPublisher`.
+// Args:
+//   context: Not used.
+//   topic: The topic to publish to.
+//   payload: What to publish.
+//   retain: Ask for the message to be retained or not.
+// Returns:
+//   bool: Successfully published or not.
+bool publishClimate(void *context, const String &topic,
+                    const String &payload, const bool retain) {
+  (void)context;
+  return sendString(topic, payload, retain);
+}
+
 void doBroadcast(TimerMs *timer, const uint32_t interval,
                  IRac *climate[], const bool retain,
                  const bool force) {
@@ -2383,13 +2395,13 @@ void doBroadcast(TimerMs *timer, const uint32_t interval,
     debug("Sending MQTT stat update broadcast.");
     for (uint16_t i = 0; i < kNrOfIrTxGpios; i++) {
       String stat_topic = genStatTopic(i);
-      sendClimate(stat_topic, retain, true, false, true, climate[i]);
+      sendClimate(climatePublisher[i], retain, true, false, true, climate[i]);
 #if REPORT_VCC
       sendString(stat_topic + KEY_VCC, vccToString(), false);
 #endif  // REPORT_VCC
-#if MQTT_CLIMATE_JSON
+#if MQTT_CLIMATE_JSON && !MQTT_CLIMATE_JSON_BATCH
       sendJsonState(climate[i]->next, stat_topic + KEY_JSON);
-#endif  // MQTT_CLIMATE_JSON
+#endif  // MQTT_CLIMATE_JSON && !MQTT_CLIMATE_JSON_BATCH
     }
     timer->reset();  // It's been sent, so reset the timer.
     hasBroadcastBeenSent = true;
@@ -2442,8 +2454,8 @@ void receivingMQTT(String const topic_name, String const callback_str) {
         force_resend = true;
         mqttLog("Climate resend requested.");
       }
-      if (sendClimate(stat_topic, true, false, force_resend, true,
-                      climate[channel]) && !force_resend)
+      if (sendClimate(climatePublisher[channel], true, false, force_resend,
+                      true, climate[channel]) && !force_resend)
         lastClimateSource = F("MQTT");
     } else if (topic_name.startsWith(stat_topic)) {
       debug("It's a climate state topic. Update internal state and DON'T send");
@@ -2477,7 +2489,7 @@ void receivingMQTT(String const topic_name, String const callback_str) {
         {  // It's a pause. Everything after the 'P' should be a number.
           int32_t msecs = std::min((int32_t) strtoul(ircommand + 1, NULL, 10),
                                    kMaxPauseMs);
-          delay(msecs);
+          sendQueue->addPause(channel, msecs);
           mqtt_client.publish(MqttAck.c_str(),
                               String(kPauseChar + String(msecs)).c_str());
           mqttSentCounter++;
@@ -2506,10 +2518,10 @@ void receivingMQTT(String const topic_name, String const callback_str) {
           // If there is still string left, assume it is the repeat count.
           if (next != NULL)
             repeat = atoi(next);
-          // send received MQTT value by IR signal
-          lastSendSucceeded = sendIRCode(
-              IrSendTable[channel], ir_type, code,
-              strchr(sequence_item, kCommandDelimiter[0]) + 1, nbits, repeat);
+          // Queue the received MQTT value to be sent as an IR signal.
+          sendIRCode(channel, ir_type, code,
+                     strchr(sequence_item, kCommandDelimiter[0]) + 1, nbits,
+                     repeat);
         }
     }
     free(ircommand);
@@ -2645,7 +2657,7 @@ void loop(void) {
         unsubscribing(stat_topic + '+');
         // Did something change?
         if (climate[i] != NULL && climate[i]->hasStateChanged()) {
-          sendClimate(stat_topic, true, false, false,
+          sendClimate(climatePublisher[i], true, false, false,
                       MQTT_CLIMATE_IR_SEND_ON_RESTART, climate[i]);
           lastClimateSource = F("MQTT (via retain)");
           mqttLog("The state was recovered from MQTT broker.");
@@ -2700,7 +2712,10 @@ void loop(void) {
 #endif  // USE_DECODED_AC_SETTINGS
   }
 #endif  // IR_RX
-  delay(100);
+  // Send the next IR message waiting in the queue, if any.
+  sendQueued();
+  // Don't hold up the rest of the queue.
+  if (sendQueue == NULL || sendQueue->size() == 0) delay(100);
 }
 
 // Arduino framework doesn't support strtoull(), so make our own one.
@@ -2722,72 +2737,57 @@ uint64_t getUInt64fromHex(char const *str) {
   return result;
 }
 
-// Transmit the given IR message.
+// Queue the given IR message to be transmitted.
 //
 // Args:
-//   irsend:   A pointer to a IRsend object to transmit via.
+//   channel:  The IR transmitter to send it via.
 //   ir_type:  enum of the protocol to be sent.
 //   code:     Numeric payload of the IR message. Most protocols use this.
 //   code_str: The unparsed code to be sent. Used by complex protocol encodings.
 //   bits:     Nr. of bits in the protocol. 0 means use the protocol's default.
 //   repeat:   Nr. of times the message is to be repeated. (Not all protocols.)
 // Returns:
-//   bool: Successfully sent or not.
-bool sendIRCode(IRsend *irsend, decode_type_t const ir_type,
+//   bool: Successfully queued to be sent or not.
+// Note:
+//   The message is sent later, by `sendQueued()`.
+bool sendIRCode(const uint8_t channel, decode_type_t const ir_type,
                 uint64_t const code, char const * code_str, uint16_t bits,
                 uint16_t repeat) {
-  if (irsend == NULL) return false;
+  if (sendQueue == NULL) return false;
   bool success = true;  // Assume success.
   // Ensure we have enough repeats.
   repeat = std::max(IRsend::minRepeats(ir_type), repeat);
   if (bits == 0) bits = IRsend::defaultBits(ir_type);
-  // Create a pseudo-lock so we don't try to send two codes at the same time.
-  while (lockIr)
-    delay(20);
-  lockIr = true;
-
-
-  // Turn off IR capture if we need to.
-#if IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-  if (irrecv != NULL) irrecv->disableIRIn();  // Stop the IR receiver
-#endif  // IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-  // send the IR message.
+  // Queue the IR message.
   switch (ir_type) {
 #if SEND_PRONTO
     case decode_type_t::PRONTO:  // 25
-      success = parseStringAndSendPronto(irsend, code_str, repeat);
+      success = parseStringAndSendPronto(channel, code_str, repeat);
       break;
 #endif  // SEND_PRONTO
     case decode_type_t::RAW:  // 30
 #if SEND_RAW
-      success = parseStringAndSendRaw(irsend, code_str);
+      success = parseStringAndSendRaw(channel, code_str);
       break;
 #endif
 #if SEND_GLOBALCACHE
     case decode_type_t::GLOBALCACHE:  // 31
-      success = parseStringAndSendGC(irsend, code_str);
+      success = parseStringAndSendGC(channel, code_str);
       break;
 #endif
     default:  // Everything else.
       if (hasACState(ir_type))  // protocols with > 64 bits
-        success = parseStringAndSendAirCon(irsend, ir_type, code_str);
+        success = parseStringAndSendAirCon(channel, ir_type, code_str);
       else  // protocols with <= 64 bits
-        success = irsend->send(ir_type, code, bits, repeat);
+        success = sendQueue->addCode(channel, ir_type, code, bits, repeat);
   }
-#if IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-  // Turn IR capture back on if we need to.
-  if (irrecv != NULL) irrecv->enableIRIn();  // Restart the receiver
-#endif  // IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-  lastSendTime = millis();
-  // Release the lock.
-  lockIr = false;
 
-  // Indicate that we sent the message or not.
+  // Indicate that we queued the message or not.
   if (success) {
-    sendReqCounter++;
-    debug("Sent the IR message:");
+    debug("Queued the IR message:");
   } else {
-    debug("Failed to send IR Message:");
+    lastSendSucceeded = false;
+    debug("Failed to queue IR Message:");
   }
   debug(D_STR_PROTOCOL ": ");
   debug(String(ir_type).c_str());
@@ -2796,7 +2796,7 @@ bool sendIRCode(IRsend *irsend, decode_type_t const ir_type,
       ir_type == GLOBALCACHE) {
     debug(D_STR_CODE ": ");
     debug(code_str);
-    // Confirm what we were asked to send was sent.
+    // Confirm what we were asked to send was queued.
 #if MQTT_ENABLE
     if (success) {
       if (ir_type == PRONTO && repeat > 0)
@@ -2832,6 +2832,54 @@ bool sendIRCode(IRsend *irsend, decode_type_t const ir_type,
   return success;
 }
 
+// Send the next queued IR message, if there is one that can be sent now.
+// Called from `loop()`, so only one message is sent at a time.
+void sendQueued(void) {
+  if (sendQueue == NULL) return;
+  uint8_t channel = 0;
+  const uint8_t next = sendQueue->peek(&channel);
+  if (next == kSendQueueNone) return;  // Nothing to send yet.
+#if IR_RX && (DISABLE_CAPTURE_WHILE_TRANSMITTING || IGNORE_OWN_TRANSMISSIONS)
+  // Turn off IR capture if we need to.
+  // Climate messages are sent by IRac, so we can't recognise their echo.
+  const bool pauseCapture = !IGNORE_OWN_TRANSMISSIONS ||
+      next == kSendQueueClimate;
+  if (irrecv != NULL) {
+    if (pauseCapture)
+      irrecv->disableIRIn();  // Stop the IR receiver
+    else
+      irrecv->setEchoSource(IrSendTable[channel]);  // Ignore what we send.
+  }
+#endif  // IR_RX && (DISABLE_CAPTURE_WHILE_TRANSMITTING || ...)
+  bool success = false;
+  const uint8_t kind = sendQueue->poll(&success);
+#if IR_RX && (DISABLE_CAPTURE_WHILE_TRANSMITTING || IGNORE_OWN_TRANSMISSIONS)
+  // Turn IR capture back on if we need to.
+  if (irrecv != NULL && pauseCapture)
+    irrecv->enableIRIn();  // Restart the receiver
+#endif  // IR_RX && (DISABLE_CAPTURE_WHILE_TRANSMITTING || ...)
+  switch (kind) {
+    case kSendQueueNone:
+    case kSendQueuePause:
+      return;  // Nothing was sent.
+    case kSendQueueClimate:
+      lastClimateSucceeded = success;
+      if (success) hasClimateBeenSent = true;
+      lastClimateIr.reset();
+      irClimateCounter++;
+      break;
+    default:
+      lastSendSucceeded = success;
+      lastSendTime = millis();
+  }
+  if (success) {
+    sendReqCounter++;
+    debug("Sent a queued IR message.");
+  } else {
+    debug("Failed to send a queued IR message.");
+  }
+}
+
 bool sendInt(const String topic, const int32_t num, const bool retain) {
 #if MQTT_ENABLE
   mqttSentCounter++;
@@ -3008,126 +3056,54 @@ void updateClimate(stdAc::state_t *state, const String str,
   }
 }
 
-bool sendClimate(const String topic_prefix, const bool retain,
+// Publish (via MQTT) & send (via IR) a climate state, if it has changed.
+// Args:
+//   publisher: What to publish the state with. NULL, if not publishing.
+//   retain: Ask for the published state to be retained or not.
+//   forceMQTT: Publish every setting, even if it hasn't changed.
+//   forceIR: Send the state via IR, even if it hasn't changed.
+//   enableIR: Allow the state to be sent via IR or not.
+//   ac: The climate object holding the state.
+// Returns:
+//   bool: Successful or not.
+bool sendClimate(IRacPublisher *publisher, const bool retain,
                  const bool forceMQTT, const bool forceIR,
                  const bool enableIR, IRac *ac) {
-  bool diff = false;
   bool success = true;
   const stdAc::state_t next = ac->getState();
-  const stdAc::state_t prev = ac->getStatePrev();
-  if (prev.protocol != next.protocol || forceMQTT) {
-    diff = true;
-    success &= sendString(topic_prefix + KEY_PROTOCOL,
-                          typeToString(next.protocol), retain);
-  }
-  if (prev.model != next.model || forceMQTT) {
-    diff = true;
-    success &= sendInt(topic_prefix + KEY_MODEL, next.model, retain);
-  }
-  String mode_str = IRac::opmodeToString(next.mode);
-  // I don't know why, but the modes need to be lower case to work with
-  // Home Assistant & Google Home.
-  mode_str.toLowerCase();
-#if MQTT_CLIMATE_HA_MODE
-  // Home Assistant want's these two bound together.
-  if (prev.power != next.power || prev.mode != next.mode || forceMQTT) {
-    success &= sendBool(topic_prefix + KEY_POWER, next.power, retain);
-    if (!next.power) mode_str = F("off");
-#else  // MQTT_CLIMATE_HA_MODE
-  // In non-Home Assistant mode, power and mode are not bound together.
-  if (prev.power != next.power || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_POWER, next.power, retain);
-  }
-  if (prev.mode != next.mode || forceMQTT) {
-#endif  // MQTT_CLIMATE_HA_MODE
-    success &= sendString(topic_prefix + KEY_MODE, mode_str, retain);
-    diff = true;
-  }
-  if (prev.degrees != next.degrees || forceMQTT) {
-    diff = true;
-    success &= sendFloat(topic_prefix + KEY_TEMP, next.degrees, retain);
-  }
-  if (prev.celsius != next.celsius || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_CELSIUS, next.celsius, retain);
-  }
-  if (prev.fanspeed != next.fanspeed || forceMQTT) {
-    diff = true;
-    success &= sendString(topic_prefix + KEY_FANSPEED,
-                          IRac::fanspeedToString(next.fanspeed), retain);
-  }
-  if (prev.swingv != next.swingv || forceMQTT) {
-    diff = true;
-    success &= sendString(topic_prefix + KEY_SWINGV,
-                          IRac::swingvToString(next.swingv), retain);
-  }
-  if (prev.swingh != next.swingh || forceMQTT) {
-    diff = true;
-    success &= sendString(topic_prefix + KEY_SWINGH,
-                          IRac::swinghToString(next.swingh), retain);
-  }
-  if (prev.quiet != next.quiet || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_QUIET, next.quiet, retain);
-  }
-  if (prev.turbo != next.turbo || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_TURBO, next.turbo, retain);
-  }
-  if (prev.econo != next.econo || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_ECONO, next.econo, retain);
-  }
-  if (prev.light != next.light || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_LIGHT, next.light, retain);
-  }
-  if (prev.filter != next.filter || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_FILTER, next.filter, retain);
-  }
-  if (prev.clean != next.clean || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_CLEAN, next.clean, retain);
-  }
-  if (prev.beep != next.beep || forceMQTT) {
-    diff = true;
-    success &= sendBool(topic_prefix + KEY_BEEP, next.beep, retain);
-  }
-  if (prev.sleep != next.sleep || forceMQTT) {
-    diff = true;
-    success &= sendInt(topic_prefix + KEY_SLEEP, next.sleep, retain);
-  }
+  // Has any of the settings we care about changed since it was last sent?
+  const bool diff = IRac::diffStates(ac->getStatePrev(), next) &
+      kAcPublisherFields;
+  // Only the settings that changed since they were last published are sent.
+  if (publisher != NULL) success &= publisher->publish(next, retain, forceMQTT);
   if (diff && !forceMQTT) {
     debug("Difference in common A/C state detected.");
-#if MQTT_CLIMATE_JSON
-    sendJsonState(next, topic_prefix + KEY_JSON);
-#endif  // MQTT_CLIMATE_JSON
+#if MQTT_CLIMATE_JSON && !MQTT_CLIMATE_JSON_BATCH
+    if (publisher != NULL)
+      sendJsonState(next, publisher->getPrefix() + KEY_JSON);
+#endif  // MQTT_CLIMATE_JSON && !MQTT_CLIMATE_JSON_BATCH
   } else {
     debug("NO difference in common A/C state detected.");
   }
   // Only send an IR message if we need to.
   if (enableIR && ((diff && !forceMQTT) || forceIR)) {
-    sendReqCounter++;
     if (ac == NULL) {  // No climate object is available.
       debug("Can't send climate state as common A/C object doesn't exist!");
       return false;
     }
-    debug("Sending common A/C state via IR.");
-#if IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-    // Turn IR capture off if we need to.
-    if (irrecv != NULL) irrecv->disableIRIn();  // Stop the IR receiver
-#endif  // IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-    lastClimateSucceeded = ac->sendAc();
-#if IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-    // Turn IR capture back on if we need to.
-    if (irrecv != NULL) irrecv->enableIRIn();  // Restart the receiver
-#endif  // IR_RX && DISABLE_CAPTURE_WHILE_TRANSMITTING
-    if (lastClimateSucceeded) hasClimateBeenSent = true;
-    success &= lastClimateSucceeded;
-    lastClimateIr.reset();
-    irClimateCounter++;
+    // Which channel (IR transmitter) does it belong to?
+    uint8_t channel = 0;
+    while (channel < kNrOfIrTxGpios && climate[channel] != ac) channel++;
+    debug("Queuing common A/C state to be sent via IR.");
+    // It replaces any state for this A/C still waiting to be sent.
+    const stdAc::state_t prev = ac->getStatePrev();
+    const bool queued = sendQueue != NULL &&
+        sendQueue->addClimate(channel, ac, next, &prev);
+    if (!queued) {
+      debug("Failed to queue the common A/C state.");
+      lastClimateSucceeded = false;
+    }
+    success &= queued;
   }
   // Mark the "next" value as old/previous.
   if (ac != NULL) {
@@ -3175,10 +3151,10 @@ bool decodeCommonAc(const decode_results *decode) {
   }
   climate[0]->next = state;  // Copy over the new climate state.
 #if MQTT_ENABLE
-  sendClimate(genStatTopic(0), true, false, REPLAY_DECODED_AC_MESSAGE,
+  sendClimate(climatePublisher[0], true, false, REPLAY_DECODED_AC_MESSAGE,
               REPLAY_DECODED_AC_MESSAGE, climate[0]);
 #else  // MQTT_ENABLE
-  sendClimate("", false, false, REPLAY_DECODED_AC_MESSAGE,
+  sendClimate(NULL, false, false, REPLAY_DECODED_AC_MESSAGE,
               REPLAY_DECODED_AC_MESSAGE, climate[0]);
 #endif  // MQTT_ENABLE
   return true;
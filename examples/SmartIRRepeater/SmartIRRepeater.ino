@@ -48,6 +48,8 @@
  * Changes:
  *   Version 1.0: June, 2019
  *     - Initial version.
+ *   Version 1.1: 2021
+ *     - Ignore hearing our own transmissions. (Echo suppression)
  */
 
 #include <Arduino.h>
@@ -84,6 +86,8 @@ const uint16_t kFrequency = 38000;  // in Hz. e.g. 38kHz.
 
 // The IR transmitter.
 IRsend irsend(kIrLedPin);
+// What we sent recently, so we don't repeat it if we hear it ourselves.
+uint16_t echoLog[kCaptureBufferSize];
 // The IR receiver.
 IRrecv irrecv(kRecvPin, kCaptureBufferSize, kTimeout, false);
 // Somewhere to store the captured message.
@@ -93,6 +97,9 @@ decode_results results;
 void setup() {
   irrecv.enableIRIn();  // Start up the IR receiver.
   irsend.begin();       // Start up the IR sender.
+  // Ignore the echo of what we send, rather than repeating it forever.
+  irsend.setEchoLog(echoLog, kCaptureBufferSize);
+  irrecv.setEchoSource(&irsend);
 
   Serial.begin(kBaudRate, SERIAL_8N1);
   while (!Serial)  // Wait for the serial connection to be establised.
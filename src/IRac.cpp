@@ -58,10 +58,21 @@ IRac::IRac(const uint16_t pin, const bool inverted, const bool use_modulation) {
   _pin = pin;
   _inverted = inverted;
   _modulation = use_modulation;
+  _incremental = false;
+#if SEND_DAIKIN
+  _daikin = NULL;
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+  _daikin2 = NULL;
+#endif  // SEND_DAIKIN2
   initState(&next);
+  initState(&_live);
   this->markAsSent();
 }
 
+/// Class destructor
+IRac::~IRac(void) { freeIncremental(); }
+
 /// Initialise the given state with the supplied settings.
 /// @param[out] state A Ptr to where the settings will be stored.
 /// @param[in] vendor The vendor/protocol type.
@@ -139,161 +150,7 @@ stdAc::state_t IRac::getStatePrev(void) { return _prev; }
 /// @param[in] protocol The vendor/protocol type.
 /// @return true if the protocol is supported by this class, otherwise false.
 bool IRac::isProtocolSupported(const decode_type_t protocol) {
-  switch (protocol) {
-#if SEND_AIRWELL
-    case decode_type_t::AIRWELL:
-#endif
-#if SEND_AMCOR
-    case decode_type_t::AMCOR:
-#endif
-#if SEND_ARGO
-    case decode_type_t::ARGO:
-#endif
-#if SEND_CARRIER_AC64
-    case decode_type_t::CARRIER_AC64:
-#endif  // SEND_CARRIER_AC64
-#if SEND_COOLIX
-    case decode_type_t::COOLIX:
-#endif
-#if SEND_CORONA_AC
-    case decode_type_t::CORONA_AC:
-#endif
-#if SEND_DAIKIN
-    case decode_type_t::DAIKIN:
-#endif
-#if SEND_DAIKIN128
-    case decode_type_t::DAIKIN128:
-#endif
-#if SEND_DAIKIN152
-    case decode_type_t::DAIKIN152:
-#endif
-#if SEND_DAIKIN160
-    case decode_type_t::DAIKIN160:
-#endif
-#if SEND_DAIKIN176
-    case decode_type_t::DAIKIN176:
-#endif
-#if SEND_DAIKIN2
-    case decode_type_t::DAIKIN2:
-#endif
-#if SEND_DAIKIN216
-    case decode_type_t::DAIKIN216:
-#endif
-#if SEND_DAIKIN64
-    case decode_type_t::DAIKIN64:
-#endif
-#if SEND_DELONGHI_AC
-    case decode_type_t::DELONGHI_AC:
-#endif
-#if SEND_ECOCLIM
-    case decode_type_t::ECOCLIM:
-#endif
-#if SEND_ELECTRA_AC
-    case decode_type_t::ELECTRA_AC:
-#endif
-#if SEND_FUJITSU_AC
-    case decode_type_t::FUJITSU_AC:
-#endif
-#if SEND_GOODWEATHER
-    case decode_type_t::GOODWEATHER:
-#endif
-#if SEND_GREE
-    case decode_type_t::GREE:
-#endif
-#if SEND_HAIER_AC
-    case decode_type_t::HAIER_AC:
-#endif
-#if SEND_HAIER_AC_YRW02
-    case decode_type_t::HAIER_AC_YRW02:
-#endif
-#if SEND_HITACHI_AC
-    case decode_type_t::HITACHI_AC:
-#endif
-#if SEND_HITACHI_AC1
-    case decode_type_t::HITACHI_AC1:
-#endif
-#if SEND_HITACHI_AC344
-    case decode_type_t::HITACHI_AC344:
-#endif
-#if SEND_HITACHI_AC424
-    case decode_type_t::HITACHI_AC424:
-#endif
-#if SEND_KELON
-    case decode_type_t::KELON:
-#endif
-#if SEND_KELVINATOR
-    case decode_type_t::KELVINATOR:
-#endif
-#if SEND_LG
-    case decode_type_t::LG:
-    case decode_type_t::LG2:
-#endif
-#if SEND_MIDEA
-    case decode_type_t::MIDEA:
-#endif
-#if SEND_MITSUBISHI_AC
-    case decode_type_t::MITSUBISHI_AC:
-#endif
-#if SEND_MITSUBISHI112
-    case decode_type_t::MITSUBISHI112:
-#endif
-#if SEND_MITSUBISHI136
-    case decode_type_t::MITSUBISHI136:
-#endif
-#if SEND_MITSUBISHIHEAVY
-    case decode_type_t::MITSUBISHI_HEAVY_88:
-    case decode_type_t::MITSUBISHI_HEAVY_152:
-#endif
-#if SEND_NEOCLIMA
-    case decode_type_t::NEOCLIMA:
-#endif
-#if SEND_PANASONIC_AC
-    case decode_type_t::PANASONIC_AC:
-#endif
-#if SEND_PANASONIC_AC32
-    case decode_type_t::PANASONIC_AC32:
-#endif
-#if SEND_SAMSUNG_AC
-    case decode_type_t::SAMSUNG_AC:
-#endif
-#if SEND_SANYO_AC
-    case decode_type_t::SANYO_AC:
-#endif
-#if SEND_SHARP_AC
-    case decode_type_t::SHARP_AC:
-#endif
-#if SEND_TCL112AC
-    case decode_type_t::TCL112AC:
-#endif
-#if SEND_TECHNIBEL_AC
-    case decode_type_t::TECHNIBEL_AC:
-#endif
-#if SEND_TECO
-    case decode_type_t::TECO:
-#endif
-#if SEND_TOSHIBA_AC
-    case decode_type_t::TOSHIBA_AC:
-#endif
-#if SEND_TRANSCOLD
-    case decode_type_t::TRANSCOLD:
-#endif
-#if SEND_TROTEC
-    case decode_type_t::TROTEC:
-#endif
-#if SEND_TRUMA
-    case decode_type_t::TRUMA:
-#endif  // SEND_TRUMA
-#if SEND_VESTEL_AC
-    case decode_type_t::VESTEL_AC:
-#endif
-#if SEND_VOLTAS
-    case decode_type_t::VOLTAS:
-#endif
-    case decode_type_t::WHIRLPOOL_AC:
-      return true;
-    default:
-      return false;
-  }
+  return IRsend::protocolInfo(protocol)->ac;
 }
 
 #if SEND_AIRWELL
@@ -534,25 +391,29 @@ void IRac::corona(IRCoronaAc *ac,
 /// @param[in] turbo Run the device in turbo/powerful mode.
 /// @param[in] econo Run the device in economical mode.
 /// @param[in] clean Turn on the self-cleaning mode. e.g. Mould, dry filters etc
+/// @param[in] changed Flags (kAcField*) of the settings to apply. The rest are
+///   assumed to already be set in `ac`. The default is all of them.
 void IRac::daikin(IRDaikinESP *ac,
                   const bool on, const stdAc::opmode_t mode,
                   const float degrees, const stdAc::fanspeed_t fan,
                   const stdAc::swingv_t swingv, const stdAc::swingh_t swingh,
                   const bool quiet, const bool turbo, const bool econo,
-                  const bool clean) {
-  ac->begin();
-  ac->setPower(on);
-  ac->setMode(ac->convertMode(mode));
-  ac->setTemp(degrees);
-  ac->setFan(ac->convertFan(fan));
-  ac->setSwingVertical((int8_t)swingv >= 0);
-  ac->setSwingHorizontal((int8_t)swingh >= 0);
-  ac->setQuiet(quiet);
+                  const bool clean, const uint32_t changed) {
+  // Quiet, Powerful, & Econo affect each other, so set them all if any change.
+  const bool qte = changed & (kAcFieldQuiet | kAcFieldTurbo | kAcFieldEcono);
+  if (changed & kAcFieldProtocol) ac->begin();
+  if (changed & kAcFieldPower) ac->setPower(on);
+  if (changed & kAcFieldMode) ac->setMode(ac->convertMode(mode));
+  if (changed & kAcFieldDegrees) ac->setTemp(degrees);
+  if (changed & kAcFieldFanspeed) ac->setFan(ac->convertFan(fan));
+  if (changed & kAcFieldSwingv) ac->setSwingVertical((int8_t)swingv >= 0);
+  if (changed & kAcFieldSwingh) ac->setSwingHorizontal((int8_t)swingh >= 0);
+  if (qte) ac->setQuiet(quiet);
   // No Light setting available.
   // No Filter setting available.
-  ac->setPowerful(turbo);
-  ac->setEcono(econo);
-  ac->setMold(clean);
+  if (qte) ac->setPowerful(turbo);
+  if (qte) ac->setEcono(econo);
+  if (changed & kAcFieldClean) ac->setMold(clean);
   // No Beep setting available.
   // No Sleep setting available.
   // No Clock setting available.
@@ -698,30 +559,41 @@ void IRac::daikin176(IRDaikin176 *ac,
 /// @param[in] beep Enable/Disable beeps when receiving IR messages.
 /// @param[in] sleep Nr. of minutes for sleep mode. -1 is Off, >= 0 is on.
 /// @param[in] clock The time in Nr. of mins since midnight. < 0 is ignore.
+/// @param[in] changed Flags (kAcField*) of the settings to apply. The rest are
+///   assumed to already be set in `ac`. The default is all of them.
 void IRac::daikin2(IRDaikin2 *ac,
                    const bool on, const stdAc::opmode_t mode,
                    const float degrees, const stdAc::fanspeed_t fan,
                    const stdAc::swingv_t swingv, const stdAc::swingh_t swingh,
                    const bool quiet, const bool turbo, const bool light,
                    const bool econo, const bool filter, const bool clean,
-                   const bool beep, const int16_t sleep, const int16_t clock) {
-  ac->begin();
-  ac->setPower(on);
-  ac->setMode(ac->convertMode(mode));
-  ac->setTemp(degrees);
-  ac->setFan(ac->convertFan(fan));
-  ac->setSwingVertical(ac->convertSwingV(swingv));
-  ac->setSwingHorizontal(ac->convertSwingH(swingh));
-  ac->setQuiet(quiet);
-  ac->setLight(light ? 1 : 3);  // On/High is 1, Off is 3.
-  ac->setPowerful(turbo);
-  ac->setEcono(econo);
-  ac->setPurify(filter);
-  ac->setMold(clean);
-  ac->setClean(true);  // Hardwire auto clean to be on per request (@sheppy99)
-  ac->setBeep(beep ? 2 : 3);  // On/Loud is 2, Off is 3.
-  if (sleep > 0) ac->enableSleepTimer(sleep);
-  if (clock >= 0) ac->setCurrentTime(clock);
+                   const bool beep, const int16_t sleep, const int16_t clock,
+                   const uint32_t changed) {
+  // Quiet & Powerful affect each other, so set them both if either changes.
+  const bool qt = changed & (kAcFieldQuiet | kAcFieldTurbo);
+  if (changed & kAcFieldProtocol) ac->begin();
+  if (changed & kAcFieldPower) ac->setPower(on);
+  if (changed & kAcFieldMode) ac->setMode(ac->convertMode(mode));
+  // The temp range depends on the mode.
+  if (changed & (kAcFieldDegrees | kAcFieldMode)) ac->setTemp(degrees);
+  if (changed & kAcFieldFanspeed) ac->setFan(ac->convertFan(fan));
+  if (changed & kAcFieldSwingv)
+    ac->setSwingVertical(ac->convertSwingV(swingv));
+  if (changed & kAcFieldSwingh)
+    ac->setSwingHorizontal(ac->convertSwingH(swingh));
+  if (qt) ac->setQuiet(quiet);
+  if (changed & kAcFieldLight)
+    ac->setLight(light ? 1 : 3);  // On/High is 1, Off is 3.
+  if (qt) ac->setPowerful(turbo);
+  if (changed & kAcFieldEcono) ac->setEcono(econo);
+  if (changed & kAcFieldFilter) ac->setPurify(filter);
+  if (changed & kAcFieldClean) ac->setMold(clean);
+  // Hardwire auto clean to be on per request (@sheppy99)
+  if (changed & kAcFieldProtocol) ac->setClean(true);
+  if (changed & kAcFieldBeep)
+    ac->setBeep(beep ? 2 : 3);  // On/Loud is 2, Off is 3.
+  if ((changed & kAcFieldSleep) && sleep > 0) ac->enableSleepTimer(sleep);
+  if ((changed & kAcFieldClock) && clock >= 0) ac->setCurrentTime(clock);
   ac->send();
 }
 #endif  // SEND_DAIKIN2
@@ -2236,85 +2108,66 @@ stdAc::state_t IRac::cleanState(const stdAc::state_t state) {
   return result;
 }
 
+/// Which settings does a protocol toggle, rather than set?
+/// @param[in] protocol The vendor/protocol type.
+/// @param[in] model The A/C model if applicable.
+/// @return A mask of `stdAc::kToggle*` bits. e.g. `kCoolixToggles`
+uint8_t IRac::toggleMask(const decode_type_t protocol, const int16_t model) {
+  switch (protocol) {
+    case decode_type_t::AIRWELL:        return kAirwellToggles;
+    case decode_type_t::COOLIX:         return kCoolixToggles;
+    case decode_type_t::CORONA_AC:      return kCoronaAcToggles;
+    case decode_type_t::DAIKIN128:      return kDaikin128Toggles;
+    case decode_type_t::DAIKIN64:       return kDaikin64Toggles;
+    case decode_type_t::ELECTRA_AC:     return kElectraAcToggles;
+    case decode_type_t::FUJITSU_AC:     return kFujitsuAcToggles;
+    case decode_type_t::HITACHI_AC344:  return kHitachiAc344Toggles;
+    case decode_type_t::HITACHI_AC424:  return kHitachiAc424Toggles;
+    case decode_type_t::KELON:          return kKelonToggles;
+    case decode_type_t::MIDEA:          return kMideaToggles;
+    case decode_type_t::PANASONIC_AC:
+      // Only CKP models use a power mode toggle.
+      return (model == panasonic_ac_remote_model_t::kPanasonicCkp)
+          ? kPanasonicAcCkpToggles : 0;
+    case decode_type_t::PANASONIC_AC32: return kPanasonicAc32Toggles;
+    case decode_type_t::SHARP_AC:       return kSharpAcToggles;
+    case decode_type_t::TRANSCOLD:      return kTranscoldToggles;
+    case decode_type_t::WHIRLPOOL_AC:   return kWhirlpoolAcToggles;
+    default:                            return 0;
+  }
+}
+
 /// Create a new state base on desired & previous states but handle
 /// any state changes for options that need to be toggled.
 /// @param[in] desired The state_t structure describing the desired a/c state.
 /// @param[in] prev A Ptr to the previous state_t structure.
 /// @return A stdAc::state_t with the needed settings.
+/// @note A toggled setting is "on" in the result only if it has changed.
+///   Which settings are toggled comes from `toggleMask()`.
 stdAc::state_t IRac::handleToggles(const stdAc::state_t desired,
                                    const stdAc::state_t *prev) {
   stdAc::state_t result = desired;
   // If we've been given a previous state AND the it's the same A/C basically.
   if (prev != NULL && desired.protocol == prev->protocol &&
       desired.model == prev->model) {
-    // Check if we have to handle toggle settings for specific A/C protocols.
-    switch (desired.protocol) {
-      case decode_type_t::COOLIX:
-      case decode_type_t::TRANSCOLD:
-        if ((desired.swingv == stdAc::swingv_t::kOff) ^
-            (prev->swingv == stdAc::swingv_t::kOff))  // It changed, so toggle.
-          result.swingv = stdAc::swingv_t::kAuto;
-        else
-          result.swingv = stdAc::swingv_t::kOff;  // No change, so no toggle.
-        result.turbo = desired.turbo ^ prev->turbo;
-        result.light = desired.light ^ prev->light;
-        result.clean = desired.clean ^ prev->clean;
-        result.sleep = ((desired.sleep >= 0) ^ (prev->sleep >= 0)) ? 0 : -1;
-        break;
-      case decode_type_t::DAIKIN128:
-        result.power = desired.power ^ prev->power;
-        result.light = desired.light ^ prev->light;
-        break;
-      case decode_type_t::ELECTRA_AC:
-        result.light = desired.light ^ prev->light;
-        break;
-      case decode_type_t::FUJITSU_AC:
-        result.turbo = desired.turbo ^ prev->turbo;
-        result.econo = desired.econo ^ prev->econo;
-        break;
-      case decode_type_t::MIDEA:
-        result.turbo = desired.turbo ^ prev->turbo;
-        result.econo = desired.econo ^ prev->econo;
-        result.light = desired.light ^ prev->light;
-        // FALL THRU
-      case decode_type_t::CORONA_AC:
-      case decode_type_t::HITACHI_AC344:
-      case decode_type_t::HITACHI_AC424:
-        if ((desired.swingv == stdAc::swingv_t::kOff) ^
-            (prev->swingv == stdAc::swingv_t::kOff))  // It changed, so toggle.
-          result.swingv = stdAc::swingv_t::kAuto;
-        else
-          result.swingv = stdAc::swingv_t::kOff;  // No change, so no toggle.
-        break;
-      case decode_type_t::SHARP_AC:
-        result.light = desired.light ^ prev->light;
-        if ((desired.swingv == stdAc::swingv_t::kOff) ^
-            (prev->swingv == stdAc::swingv_t::kOff))  // It changed, so toggle.
-          result.swingv = stdAc::swingv_t::kAuto;
-        else
-          result.swingv = stdAc::swingv_t::kOff;  // No change, so no toggle.
-        break;
-      case decode_type_t::KELON:
-        if ((desired.swingv == stdAc::swingv_t::kOff) ^
-            (prev->swingv == stdAc::swingv_t::kOff))  // It changed, so toggle.
-          result.swingv = stdAc::swingv_t::kAuto;
-        else
-          result.swingv = stdAc::swingv_t::kOff;  // No change, so no toggle.
-        // FALL-THRU
-      case decode_type_t::AIRWELL:
-      case decode_type_t::DAIKIN64:
-      case decode_type_t::PANASONIC_AC32:
-      case decode_type_t::WHIRLPOOL_AC:
-        result.power = desired.power ^ prev->power;
-        break;
-      case decode_type_t::PANASONIC_AC:
-        // CKP models use a power mode toggle.
-        if (desired.model == panasonic_ac_remote_model_t::kPanasonicCkp)
-          result.power = desired.power ^ prev->power;
-        break;
-      default:
-        {};
-    }
+    const uint8_t toggles = toggleMask(desired.protocol, desired.model);
+    result.power = desired.power ^ (prev->power &&
+                                    (toggles & stdAc::kTogglePower));
+    result.turbo = desired.turbo ^ (prev->turbo &&
+                                    (toggles & stdAc::kToggleTurbo));
+    result.econo = desired.econo ^ (prev->econo &&
+                                    (toggles & stdAc::kToggleEcono));
+    result.light = desired.light ^ (prev->light &&
+                                    (toggles & stdAc::kToggleLight));
+    result.clean = desired.clean ^ (prev->clean &&
+                                    (toggles & stdAc::kToggleClean));
+    if (toggles & stdAc::kToggleSwingV)
+      result.swingv = ((desired.swingv == stdAc::swingv_t::kOff) ^
+                       (prev->swingv == stdAc::swingv_t::kOff))
+          ? stdAc::swingv_t::kAuto  // It changed, so toggle.
+          : stdAc::swingv_t::kOff;  // No change, so no toggle.
+    if (toggles & stdAc::kToggleSleep)
+      result.sleep = ((desired.sleep >= 0) ^ (prev->sleep >= 0)) ? 0 : -1;
   }
   return result;
 }
@@ -2381,6 +2234,8 @@ bool IRac::sendAc(const stdAc::state_t desired, const stdAc::state_t *prev) {
   const stdAc::swingv_t prev_swingv = (prev != NULL) ? prev->swingv
                                                      : stdAc::swingv_t::kOff;
 #endif  // SEND_LG
+  // Only update what has changed, if we can & have been asked to.
+  if (_incremental && sendAcIncremental(send, degC)) return true;
   // Per vendor settings & setup.
   switch (send.protocol) {
 #if SEND_AIRWELL
@@ -2877,6 +2732,121 @@ bool IRac::sendAc(void) {
   return success;
 }
 
+// Layout of `stdAc::packed_state_t`.
+// raw[0]: protocol (16 bits) | model (16 bits)
+// raw[1]: sleep (16 bits) | clock (16 bits)
+// raw[2]: The bit offsets below.
+const uint8_t kPackedDegreesOffset = 0;  // Tenths of a degree. 2's complement.
+const uint8_t kPackedDegreesSize = 11;  // i.e. -102.4 to +102.3
+const int16_t kPackedDegreesMax = (1 << (kPackedDegreesSize - 1)) - 1;
+const uint8_t kPackedCelsiusOffset = 11;
+const uint8_t kPackedPowerOffset = 12;
+const uint8_t kPackedModeOffset = 13;  // opmode_t + 1
+const uint8_t kPackedFanspeedOffset = 16;
+const uint8_t kPackedSwingvOffset = 19;  // swingv_t + 1
+const uint8_t kPackedSwinghOffset = 22;  // swingh_t + 1
+const uint8_t kPackedEnumSize = 3;
+const uint8_t kPackedQuietOffset = 25;
+const uint8_t kPackedTurboOffset = 26;
+const uint8_t kPackedEconoOffset = 27;
+const uint8_t kPackedLightOffset = 28;
+const uint8_t kPackedFilterOffset = 29;
+const uint8_t kPackedCleanOffset = 30;
+const uint8_t kPackedBeepOffset = 31;
+// Every value of the enums must fit in their fields. Widen them if not.
+static_assert((int8_t)stdAc::opmode_t::kLastOpmodeEnum + 1 <
+              (1 << kPackedEnumSize), "opmode_t doesn't fit when packed.");
+static_assert((int8_t)stdAc::fanspeed_t::kLastFanspeedEnum <
+              (1 << kPackedEnumSize), "fanspeed_t doesn't fit when packed.");
+static_assert((int8_t)stdAc::swingv_t::kLastSwingvEnum + 1 <
+              (1 << kPackedEnumSize), "swingv_t doesn't fit when packed.");
+static_assert((int8_t)stdAc::swingh_t::kLastSwinghEnum + 1 <
+              (1 << kPackedEnumSize), "swingh_t doesn't fit when packed.");
+
+/// Convert an AirCon state into its compact form.
+/// @param[in] state The state_t to convert.
+/// @return The packed equivalent.
+/// @note Degrees are kept to the nearest tenth of a degree, & are limited to
+///   -102.4 to +102.3 degrees. Everything else is kept exactly. So two states
+///   whose degrees differ by less than 0.05, or are both above 102.3, pack the
+///   same. Use `cmpStates()` to compare states exactly.
+stdAc::packed_state_t IRac::packState(const stdAc::state_t state) {
+  stdAc::packed_state_t packed;
+  packed.raw[0] = (uint16_t)state.protocol |
+      (uint32_t)(uint16_t)state.model << 16;
+  packed.raw[1] = (uint16_t)state.sleep |
+      (uint32_t)(uint16_t)state.clock << 16;
+  int32_t tenths = state.degrees * 10 + ((state.degrees < 0) ? -0.5 : 0.5);
+  tenths = std::min(std::max(tenths, (int32_t)-kPackedDegreesMax - 1),
+                    (int32_t)kPackedDegreesMax);
+  uint32_t *other = &packed.raw[2];
+  *other = 0;
+  irutils::setBits(other, kPackedDegreesOffset, kPackedDegreesSize, tenths);
+  irutils::setBit(other, kPackedCelsiusOffset, state.celsius);
+  irutils::setBit(other, kPackedPowerOffset, state.power);
+  irutils::setBits(other, kPackedModeOffset, kPackedEnumSize,
+                   (int8_t)state.mode + 1);
+  irutils::setBits(other, kPackedFanspeedOffset, kPackedEnumSize,
+                   (int8_t)state.fanspeed);
+  irutils::setBits(other, kPackedSwingvOffset, kPackedEnumSize,
+                   (int8_t)state.swingv + 1);
+  irutils::setBits(other, kPackedSwinghOffset, kPackedEnumSize,
+                   (int8_t)state.swingh + 1);
+  irutils::setBit(other, kPackedQuietOffset, state.quiet);
+  irutils::setBit(other, kPackedTurboOffset, state.turbo);
+  irutils::setBit(other, kPackedEconoOffset, state.econo);
+  irutils::setBit(other, kPackedLightOffset, state.light);
+  irutils::setBit(other, kPackedFilterOffset, state.filter);
+  irutils::setBit(other, kPackedCleanOffset, state.clean);
+  irutils::setBit(other, kPackedBeepOffset, state.beep);
+  return packed;
+}
+
+/// Convert a compact AirCon state back into a normal one.
+/// @param[in] packed The packed_state_t to convert.
+/// @return The equivalent state_t.
+stdAc::state_t IRac::unpackState(const stdAc::packed_state_t packed) {
+  stdAc::state_t state;
+  state.protocol = (decode_type_t)(int16_t)GETBITS32(packed.raw[0], 0, 16);
+  state.model = (int16_t)GETBITS32(packed.raw[0], 16, 16);
+  state.sleep = (int16_t)GETBITS32(packed.raw[1], 0, 16);
+  state.clock = (int16_t)GETBITS32(packed.raw[1], 16, 16);
+  const uint32_t other = packed.raw[2];
+  int16_t tenths = GETBITS32(other, kPackedDegreesOffset, kPackedDegreesSize);
+  if (tenths > kPackedDegreesMax) tenths -= 1 << kPackedDegreesSize;
+  state.degrees = tenths / 10.0;
+  state.celsius = GETBIT32(other, kPackedCelsiusOffset);
+  state.power = GETBIT32(other, kPackedPowerOffset);
+  state.mode = (stdAc::opmode_t)(
+      GETBITS32(other, kPackedModeOffset, kPackedEnumSize) - 1);
+  state.fanspeed = (stdAc::fanspeed_t)GETBITS32(other, kPackedFanspeedOffset,
+                                                kPackedEnumSize);
+  state.swingv = (stdAc::swingv_t)(
+      GETBITS32(other, kPackedSwingvOffset, kPackedEnumSize) - 1);
+  state.swingh = (stdAc::swingh_t)(
+      GETBITS32(other, kPackedSwinghOffset, kPackedEnumSize) - 1);
+  state.quiet = GETBIT32(other, kPackedQuietOffset);
+  state.turbo = GETBIT32(other, kPackedTurboOffset);
+  state.econo = GETBIT32(other, kPackedEconoOffset);
+  state.light = GETBIT32(other, kPackedLightOffset);
+  state.filter = GETBIT32(other, kPackedFilterOffset);
+  state.clean = GETBIT32(other, kPackedCleanOffset);
+  state.beep = GETBIT32(other, kPackedBeepOffset);
+  return state;
+}
+
+/// Calculate a hash of a compact AirCon state. (FNV-1a)
+/// It is the same on every platform, so it can be stored or sent elsewhere.
+/// @param[in] packed The packed_state_t to hash.
+/// @return A 32-bit hash of it.
+uint32_t IRac::hashState(const stdAc::packed_state_t packed) {
+  uint32_t hash = kFnvBasis32;
+  for (uint8_t i = 0; i < 3; i++)
+    for (uint8_t shift = 0; shift < 32; shift += 8)
+      hash = (hash ^ ((packed.raw[i] >> shift) & 0xFF)) * kFnvPrime32;
+  return hash;
+}
+
 /// Compare two AirCon states.
 /// @note The comparison excludes the clock.
 /// @param a A state_t to be compared.
@@ -2896,6 +2866,135 @@ bool IRac::cmpStates(const stdAc::state_t a, const stdAc::state_t b) {
 /// @return True if it has changed, False if not.
 bool IRac::hasStateChanged(void) { return cmpStates(next, _prev); }
 
+/// Calculate which fields of two AirCon states differ.
+/// @param a A state_t to be compared.
+/// @param b A state_t to be compared.
+/// @return The kAcField* flags of the fields that differ. 0 if identical.
+uint32_t IRac::diffStates(const stdAc::state_t a, const stdAc::state_t b) {
+  uint32_t result = 0;
+  if (a.protocol != b.protocol) result |= kAcFieldProtocol;
+  if (a.model != b.model) result |= kAcFieldModel;
+  if (a.power != b.power) result |= kAcFieldPower;
+  if (a.mode != b.mode) result |= kAcFieldMode;
+  if (a.degrees != b.degrees) result |= kAcFieldDegrees;
+  if (a.celsius != b.celsius) result |= kAcFieldCelsius;
+  if (a.fanspeed != b.fanspeed) result |= kAcFieldFanspeed;
+  if (a.swingv != b.swingv) result |= kAcFieldSwingv;
+  if (a.swingh != b.swingh) result |= kAcFieldSwingh;
+  if (a.quiet != b.quiet) result |= kAcFieldQuiet;
+  if (a.turbo != b.turbo) result |= kAcFieldTurbo;
+  if (a.econo != b.econo) result |= kAcFieldEcono;
+  if (a.light != b.light) result |= kAcFieldLight;
+  if (a.filter != b.filter) result |= kAcFieldFilter;
+  if (a.clean != b.clean) result |= kAcFieldClean;
+  if (a.beep != b.beep) result |= kAcFieldBeep;
+  if (a.sleep != b.sleep) result |= kAcFieldSleep;
+  if (a.clock != b.clock) result |= kAcFieldClock;
+  return result;
+}
+
+/// Enable or disable incremental updates when sending A/C messages.
+/// When enabled, a persistent object is kept for each (supported) protocol,
+/// and only the settings that changed since the last send are applied to it,
+/// rather than building every setting into a fresh object each time.
+/// @note The resulting messages are identical either way. Protocols without
+///   incremental support are always sent the normal way.
+/// @note Uses some heap memory for each protocol used while enabled.
+/// @param[in] enable true, use incremental updates. false, don't.
+void IRac::setIncremental(const bool enable) {
+  _incremental = enable;
+  if (!enable) freeIncremental();
+}
+
+/// Are incremental updates being used when sending A/C messages?
+/// @return true, they are. false, they aren't.
+bool IRac::getIncremental(void) const { return _incremental; }
+
+/// Release any persistent objects used for incremental updates.
+void IRac::freeIncremental(void) {
+#if SEND_DAIKIN
+  delete _daikin;
+  _daikin = NULL;
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+  delete _daikin2;
+  _daikin2 = NULL;
+#endif  // SEND_DAIKIN2
+  initState(&_live);
+}
+
+/// Which settings of a protocol can be updated without a fresh start.
+/// @param[in] protocol The vendor/protocol type.
+/// @return The kAcField* flags of the settings that can be updated in place.
+///   0 if the protocol doesn't support incremental updates.
+uint32_t IRac::incrementalFields(const decode_type_t protocol) {
+  switch (protocol) {
+#if SEND_DAIKIN
+    case DAIKIN:
+      return kAcFieldPower | kAcFieldMode | kAcFieldDegrees | kAcFieldCelsius |
+          kAcFieldFanspeed | kAcFieldSwingv | kAcFieldSwingh | kAcFieldQuiet |
+          kAcFieldTurbo | kAcFieldEcono | kAcFieldClean |
+          // Not used by this protocol.
+          kAcFieldLight | kAcFieldFilter | kAcFieldBeep | kAcFieldSleep |
+          kAcFieldClock;
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+    case DAIKIN2:  // Sleep can't be turned off again, so it isn't included.
+      return kAcFieldPower | kAcFieldMode | kAcFieldDegrees | kAcFieldCelsius |
+          kAcFieldFanspeed | kAcFieldSwingv | kAcFieldSwingh | kAcFieldQuiet |
+          kAcFieldTurbo | kAcFieldEcono | kAcFieldLight | kAcFieldFilter |
+          kAcFieldClean | kAcFieldBeep | kAcFieldClock;
+#endif  // SEND_DAIKIN2
+    default:
+      return 0;
+  }
+}
+
+/// Send an A/C message by applying only the settings that have changed since
+/// the last one to a persistent object for the protocol.
+/// @param[in] send The (cleaned & toggle handled) state to be sent.
+/// @param[in] degC The desired temperature in Celsius.
+/// @return True, if it was sent. False, if the protocol isn't supported.
+bool IRac::sendAcIncremental(const stdAc::state_t send, const float degC) {
+  uint32_t changed = diffStates(send, _live);
+  if (changed & kAcFieldCelsius) changed |= kAcFieldDegrees;
+  // Start afresh if there is anything we can't apply to the existing state.
+  // e.g. A different protocol or model, or a setting that can't be undone.
+  // A change of protocol also catches there being no existing object yet.
+  const bool rebuild = (changed & ~incrementalFields(send.protocol)) ||
+      ((changed & kAcFieldClock) && send.clock < 0);
+  if (rebuild) changed = kAcFieldAll;
+  switch (send.protocol) {
+#if SEND_DAIKIN
+    case DAIKIN:
+      if (rebuild) {
+        delete _daikin;
+        _daikin = new IRDaikinESP(_pin, _inverted, _modulation);
+      }
+      daikin(_daikin, send.power, send.mode, degC, send.fanspeed, send.swingv,
+             send.swingh, send.quiet, send.turbo, send.econo, send.clean,
+             changed);
+      break;
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+    case DAIKIN2:
+      if (rebuild) {
+        delete _daikin2;
+        _daikin2 = new IRDaikin2(_pin, _inverted, _modulation);
+      }
+      daikin2(_daikin2, send.power, send.mode, degC, send.fanspeed,
+              send.swingv, send.swingh, send.quiet, send.turbo, send.light,
+              send.econo, send.filter, send.clean, send.beep, send.sleep,
+              send.clock, changed);
+      break;
+#endif  // SEND_DAIKIN2
+    default:
+      return false;  // Not supported. Use the normal method.
+  }
+  _live = send;
+  return true;
+}
+
 /// Convert the supplied str into the appropriate enum.
 /// @param[in] str A Ptr to a C-style string to be converted.
 /// @param[in] def The enum to return if no conversion was possible.
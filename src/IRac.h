@@ -47,13 +47,41 @@
 // Constants
 const int8_t kGpioUnused = -1;  ///< A placeholder for not using an actual GPIO.
 
+// Flags for each of the fields of a `stdAc::state_t`.
+// See: `IRac::diffStates()`
+const uint32_t kAcFieldProtocol = 1UL << 0;
+const uint32_t kAcFieldModel =    1UL << 1;
+const uint32_t kAcFieldPower =    1UL << 2;
+const uint32_t kAcFieldMode =     1UL << 3;
+const uint32_t kAcFieldDegrees =  1UL << 4;
+const uint32_t kAcFieldCelsius =  1UL << 5;
+const uint32_t kAcFieldFanspeed = 1UL << 6;
+const uint32_t kAcFieldSwingv =   1UL << 7;
+const uint32_t kAcFieldSwingh =   1UL << 8;
+const uint32_t kAcFieldQuiet =    1UL << 9;
+const uint32_t kAcFieldTurbo =    1UL << 10;
+const uint32_t kAcFieldEcono =    1UL << 11;
+const uint32_t kAcFieldLight =    1UL << 12;
+const uint32_t kAcFieldFilter =   1UL << 13;
+const uint32_t kAcFieldClean =    1UL << 14;
+const uint32_t kAcFieldBeep =     1UL << 15;
+const uint32_t kAcFieldSleep =    1UL << 16;
+const uint32_t kAcFieldClock =    1UL << 17;
+const uint32_t kAcFieldAll =      (1UL << 18) - 1;  ///< Every field.
+
 // Class
 /// A universal/common/generic interface for controling supported A/Cs.
 class IRac {
  public:
   explicit IRac(const uint16_t pin, const bool inverted = false,
                 const bool use_modulation = true);
+  ~IRac(void);
+  // It owns the persistent objects, so it can't be copied.
+  IRac(const IRac &) = delete;
+  IRac &operator=(const IRac &) = delete;
   static bool isProtocolSupported(const decode_type_t protocol);
+  static uint8_t toggleMask(const decode_type_t protocol,
+                            const int16_t model = -1);
   static void initState(stdAc::state_t *state,
                         const decode_type_t vendor, const int16_t model,
                         const bool power, const stdAc::opmode_t mode,
@@ -78,6 +106,12 @@ class IRac {
               const bool beep, const int16_t sleep = -1,
               const int16_t clock = -1);
   static bool cmpStates(const stdAc::state_t a, const stdAc::state_t b);
+  static stdAc::packed_state_t packState(const stdAc::state_t state);
+  static stdAc::state_t unpackState(const stdAc::packed_state_t packed);
+  static uint32_t hashState(const stdAc::packed_state_t packed);
+  static uint32_t diffStates(const stdAc::state_t a, const stdAc::state_t b);
+  void setIncremental(const bool enable);
+  bool getIncremental(void) const;
   static bool strToBool(const char *str, const bool def = false);
   static int16_t strToModel(const char *str, const int16_t def = -1);
   static stdAc::opmode_t strToOpmode(
@@ -106,6 +140,17 @@ class IRac {
   bool _inverted;  ///< IR LED is lit when GPIO is LOW (true) or HIGH (false)?
   bool _modulation;  ///< Is frequency modulation to be used?
   stdAc::state_t _prev;  ///< The state we expect the device to currently be in.
+  bool _incremental;  ///< Are persistent objects updated with only changes?
+  stdAc::state_t _live;  ///< The state last applied to a persistent object.
+#if SEND_DAIKIN
+  IRDaikinESP *_daikin;  ///< Persistent object for incremental updates.
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+  IRDaikin2 *_daikin2;  ///< Persistent object for incremental updates.
+#endif  // SEND_DAIKIN2
+  static uint32_t incrementalFields(const decode_type_t protocol);
+  bool sendAcIncremental(const stdAc::state_t send, const float degC);
+  void freeIncremental(void);
 #if SEND_AIRWELL
   void airwell(IRAirwellAc *ac,
                const bool on, const stdAc::opmode_t mode, const float degrees,
@@ -148,7 +193,7 @@ void carrier64(IRCarrierAc64 *ac,
               const stdAc::fanspeed_t fan,
               const stdAc::swingv_t swingv, const stdAc::swingh_t swingh,
               const bool quiet, const bool turbo, const bool econo,
-              const bool clean);
+              const bool clean, const uint32_t changed = kAcFieldAll);
 #endif  // SEND_DAIKIN
 #if SEND_DAIKIN128
   void daikin128(IRDaikin128 *ac,
@@ -186,7 +231,7 @@ void carrier64(IRCarrierAc64 *ac,
                const bool quiet, const bool turbo, const bool light,
                const bool econo, const bool filter, const bool clean,
                const bool beep, const int16_t sleep = -1,
-               const int16_t clock = -1);
+               const int16_t clock = -1, const uint32_t changed = kAcFieldAll);
 #endif  // SEND_DAIKIN2
 #if SEND_DAIKIN216
 void daikin216(IRDaikin216 *ac,
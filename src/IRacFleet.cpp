@@ -0,0 +1,252 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+/// @file
+/// @brief Control many A/C devices over a few IR emitters.
+
+#include "IRacFleet.h"
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include "IRutils.h"
+
+/// Class constructor.
+/// @param[in] emitters An array of the IRac object for each emitter.
+///   An entry may be NULL, if the emitter isn't in use.
+/// @param[in] nr_emitters The nr. of entries in `emitters`.
+/// @param[in] size The nr. of devices there is room for.
+/// @param[in] gap The minimum time between messages on an emitter. (uSeconds)
+IRacFleet::IRacFleet(IRac *emitters[], const uint8_t nr_emitters,
+                     const uint16_t size, const uint32_t gap)
+    : _nr_emitters(nr_emitters), _size(size) {
+  _emitters = new IRac*[nr_emitters];
+  _gap = new uint32_t[nr_emitters];
+  _wait = new uint32_t[nr_emitters];
+  _timer = new IRtimer[nr_emitters];
+  for (uint8_t i = 0; i < nr_emitters; i++) {
+    _emitters[i] = emitters[i];
+    _gap[i] = gap;
+    _wait[i] = 0;
+  }
+  _devices = new acfleet_device_t[size];
+  clear();
+}
+
+/// Class destructor.
+IRacFleet::~IRacFleet(void) {
+  delete[] _devices;
+  delete[] _timer;
+  delete[] _wait;
+  delete[] _gap;
+  delete[] _emitters;
+}
+
+/// Remove all the devices.
+void IRacFleet::clear(void) {
+  _count = 0;
+  _next = 0;
+}
+
+/// Get the nr. of devices in the fleet.
+/// @return The nr. of devices added.
+uint16_t IRacFleet::count(void) const { return _count; }
+
+/// Get the nr. of devices the fleet has room for.
+/// @return The size of the fleet.
+uint16_t IRacFleet::capacity(void) const { return _size; }
+
+/// Set the minimum time between messages on an emitter.
+/// @param[in] emitter The emitter.
+/// @param[in] gap The new gap. (uSeconds)
+void IRacFleet::setGap(const uint8_t emitter, const uint32_t gap) {
+  if (emitter < _nr_emitters) _gap[emitter] = gap;
+}
+
+/// Get the minimum time between messages on an emitter.
+/// @param[in] emitter The emitter.
+/// @return The gap (uSeconds), or 0 if the emitter doesn't exist.
+uint32_t IRacFleet::getGap(const uint8_t emitter) const {
+  return (emitter < _nr_emitters) ? _gap[emitter] : 0;
+}
+
+/// Add a device to the fleet.
+/// Its initial state is the default `stdAc::state_t`, and it isn't sent until
+/// a state is set for it.
+/// @param[in] emitter The emitter it is sent with.
+/// @param[in] protocol The A/C protocol it uses.
+/// @param[in] model The model of the protocol it uses.
+/// @return The id of the device, or kAcFleetNone if it couldn't be added.
+int16_t IRacFleet::add(const uint8_t emitter, const decode_type_t protocol,
+                       const int16_t model) {
+  if (_count >= _size || emitter >= _nr_emitters ||
+      _emitters[emitter] == NULL || !IRac::isProtocolSupported(protocol))
+    return kAcFleetNone;
+  stdAc::state_t state;
+  IRac::initState(&state);
+  state.protocol = protocol;
+  state.model = model;
+  acfleet_device_t *device = &_devices[_count];
+  device->desired = IRac::packState(state);
+  device->sent = device->desired;  // Not valid until kAcFleetSentFlag is set.
+  device->emitter = emitter;
+  device->flags = 0;
+  return _count++;
+}
+
+/// Work out if a device needs its desired state sent.
+/// @param[in,out] device The device to update.
+/// @note Like `IRac::cmpStates()`, the clock alone isn't a reason to send.
+void IRacFleet::update(acfleet_device_t *device) {
+  const bool changed = !(device->flags & kAcFleetSentFlag) ||
+      device->desired.raw[0] != device->sent.raw[0] ||
+      device->desired.raw[2] != device->sent.raw[2] ||
+      (uint16_t)device->desired.raw[1] != (uint16_t)device->sent.raw[1];
+  if (changed)
+    device->flags |= kAcFleetPendingFlag;
+  else
+    device->flags &= ~kAcFleetPendingFlag;
+}
+
+/// Set the state we want a device to be in.
+/// @param[in] id The device.
+/// @param[in] desired The state. Its protocol & model are ignored, the
+///   device's own are used instead.
+/// @return true, if the device exists. false, if not.
+bool IRacFleet::setState(const uint16_t id, const stdAc::state_t desired) {
+  if (id >= _count) return false;
+  acfleet_device_t *device = &_devices[id];
+  const uint32_t protocol_model = device->desired.raw[0];
+  device->desired = IRac::packState(desired);
+  device->desired.raw[0] = protocol_model;
+  update(device);
+  return true;
+}
+
+/// Set the state we want a batch of devices to be in.
+/// @param[in] ids An array of the devices.
+/// @param[in] nr_ids The nr. of entries in `ids`.
+/// @param[in] desired The state. Its protocol & model are ignored, each
+///   device's own are used instead.
+/// @return The nr. of devices that were set.
+uint16_t IRacFleet::setStates(const uint16_t ids[], const uint16_t nr_ids,
+                              const stdAc::state_t desired) {
+  uint16_t result = 0;
+  for (uint16_t i = 0; i < nr_ids; i++)
+    if (setState(ids[i], desired)) result++;
+  return result;
+}
+
+/// Set the state we want all the devices, or all those on an emitter, to be in.
+/// @param[in] desired The state. Its protocol & model are ignored, each
+///   device's own are used instead.
+/// @param[in] emitter Only set the devices on this emitter.
+///   kAcFleetAllEmitters means every device.
+/// @return The nr. of devices that were set.
+uint16_t IRacFleet::setAll(const stdAc::state_t desired,
+                           const uint8_t emitter) {
+  uint16_t result = 0;
+  for (uint16_t id = 0; id < _count; id++)
+    if (emitter == kAcFleetAllEmitters || _devices[id].emitter == emitter)
+      if (setState(id, desired)) result++;
+  return result;
+}
+
+/// Get the state we want a device to be in.
+/// @param[in] id The device.
+/// @param[out] state Where to put the state.
+/// @return true, if the device exists. false, if not.
+/// @note The degrees are only kept to a tenth of a degree.
+bool IRacFleet::getState(const uint16_t id, stdAc::state_t *state) const {
+  if (id >= _count || state == NULL) return false;
+  *state = IRac::unpackState(_devices[id].desired);
+  return true;
+}
+
+/// Get the state we last sent to a device.
+/// @param[in] id The device.
+/// @param[out] state Where to put the state.
+/// @return true, if something has been sent to it. false, if not.
+bool IRacFleet::getSent(const uint16_t id, stdAc::state_t *state) const {
+  if (id >= _count || state == NULL ||
+      !(_devices[id].flags & kAcFleetSentFlag)) return false;
+  *state = IRac::unpackState(_devices[id].sent);
+  return true;
+}
+
+/// Send a device's desired state again, even if it hasn't changed.
+/// e.g. In case the device missed the last message.
+/// @param[in] id The device.
+/// @return true, if the device exists. false, if not.
+bool IRacFleet::resend(const uint16_t id) {
+  if (id >= _count) return false;
+  _devices[id].flags |= kAcFleetPendingFlag;
+  return true;
+}
+
+/// Get the nr. of devices waiting to be sent.
+/// @return The nr. of devices that have changed since they were last sent.
+uint16_t IRacFleet::pending(void) const {
+  uint16_t result = 0;
+  for (uint16_t id = 0; id < _count; id++)
+    if (_devices[id].flags & kAcFleetPendingFlag) result++;
+  return result;
+}
+
+/// Get the nr. of devices waiting to be sent on an emitter.
+/// @param[in] emitter The emitter.
+/// @return The nr. of its devices that have changed since they were last sent.
+uint16_t IRacFleet::pending(const uint8_t emitter) const {
+  uint16_t result = 0;
+  for (uint16_t id = 0; id < _count; id++)
+    if (_devices[id].emitter == emitter &&
+        (_devices[id].flags & kAcFleetPendingFlag)) result++;
+  return result;
+}
+
+/// Has an emitter been idle for long enough to send something else?
+/// @param[in] emitter The emitter.
+/// @return true, if it has. false, if not.
+bool IRacFleet::idle(const uint8_t emitter) {
+  if (_wait[emitter] && _timer[emitter].elapsed() >= _wait[emitter])
+    _wait[emitter] = 0;  // Stop checking, so the timer can't wrap around.
+  return !_wait[emitter];
+}
+
+/// Send the next device that needs it, if its emitter is free.
+/// At most one message is sent per call, so it can be called from `loop()`
+/// without holding everything else up for long. The devices take turns, so
+/// one that changes often can't starve the others.
+/// @param[out] success Was the message sent? Optional.
+/// @return The id of the device it was sent to, or kAcFleetNone if nothing
+///   could be sent yet.
+/// @note A device whose message failed to send is left waiting, but it goes
+///   to the back of the line.
+int16_t IRacFleet::poll(bool *success) {
+  for (uint16_t i = 0; i < _count; i++) {
+    const uint16_t id = (_next + i) % _count;
+    acfleet_device_t *device = &_devices[id];
+    if (!(device->flags & kAcFleetPendingFlag) || !idle(device->emitter))
+      continue;
+    IRac *ac = _emitters[device->emitter];
+    // The IRac object is shared, so give it this device's view of the world.
+    ac->next = IRac::unpackState(device->desired);
+    bool sent;
+    if (device->flags & kAcFleetSentFlag) {
+      const stdAc::state_t prev = IRac::unpackState(device->sent);
+      sent = ac->sendAc(ac->next, &prev);
+    } else {
+      sent = ac->sendAc(ac->next, NULL);
+    }
+    if (sent) {
+      ac->markAsSent();
+      device->sent = device->desired;
+      device->flags = (device->flags | kAcFleetSentFlag) & ~kAcFleetPendingFlag;
+    }
+    if (success != NULL) *success = sent;
+    // Keep the emitter quiet for a while after it.
+    _wait[device->emitter] = _gap[device->emitter];
+    _timer[device->emitter].reset();
+    _next = (id + 1) % _count;
+    return id;
+  }
+  return kAcFleetNone;
+}
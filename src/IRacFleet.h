@@ -0,0 +1,86 @@
+#ifndef IRACFLEET_H_
+#define IRACFLEET_H_
+
+// Copyright 2021 IRremoteESP8266 authors
+
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include "IRremoteESP8266.h"
+#include "IRac.h"
+#include "IRsend.h"
+#include "IRtimer.h"
+
+// Constants
+const int16_t kAcFleetNone = -1;  ///< Not a device. e.g. Nothing was sent.
+/// Apply a batch operation to the devices on every emitter.
+const uint8_t kAcFleetAllEmitters = 0xFF;
+/// Default nr. of devices a fleet can hold.
+const uint16_t kAcFleetDefaultSize = 16;
+/// Default minimum time between messages on each emitter. (uSeconds)
+const uint32_t kAcFleetDefaultGap = 100000;  // 100ms
+
+// Device flags.
+const uint8_t kAcFleetSentFlag = 1 << 0;  ///< `sent` is valid.
+const uint8_t kAcFleetPendingFlag = 1 << 1;  ///< `desired` needs to be sent.
+
+/// An A/C device controlled by the fleet.
+/// @note The protocol & model are kept in the packed states.
+typedef struct {
+  stdAc::packed_state_t desired;  ///< The state we want it to be in.
+  stdAc::packed_state_t sent;  ///< The state we last sent it, if flagged.
+  uint8_t emitter;  ///< Which emitter (IRac object) it is sent with.
+  uint8_t flags;  ///< kAcFleet*Flag
+} acfleet_device_t;
+
+/// Controls many A/C devices, spread over one or more emitters (IR LEDs).
+/// Each emitter is an `IRac` object that is shared by all of its devices, and
+/// each device only costs a compact fixed size entry.
+/// States can be set per device, or for batches of them. Only devices whose
+/// state has changed are sent, one message per `poll()`, taking turns across
+/// the devices. A minimum gap is kept between messages on each emitter, so
+/// their messages never overlap, but other emitters aren't held up by it.
+class IRacFleet {
+ public:
+  IRacFleet(IRac *emitters[], const uint8_t nr_emitters,
+            const uint16_t size = kAcFleetDefaultSize,
+            const uint32_t gap = kAcFleetDefaultGap);
+  ~IRacFleet(void);
+  // It owns the per-emitter arrays & the devices, so it can't be copied.
+  IRacFleet(const IRacFleet &) = delete;
+  IRacFleet &operator=(const IRacFleet &) = delete;
+  int16_t add(const uint8_t emitter, const decode_type_t protocol,
+              const int16_t model = -1);
+  uint16_t count(void) const;
+  uint16_t capacity(void) const;
+  void clear(void);
+  bool setState(const uint16_t id, const stdAc::state_t desired);
+  uint16_t setStates(const uint16_t ids[], const uint16_t nr_ids,
+                     const stdAc::state_t desired);
+  uint16_t setAll(const stdAc::state_t desired,
+                  const uint8_t emitter = kAcFleetAllEmitters);
+  bool getState(const uint16_t id, stdAc::state_t *state) const;
+  bool getSent(const uint16_t id, stdAc::state_t *state) const;
+  bool resend(const uint16_t id);
+  uint16_t pending(void) const;
+  uint16_t pending(const uint8_t emitter) const;
+  int16_t poll(bool *success = NULL);
+  void setGap(const uint8_t emitter, const uint32_t gap);
+  uint32_t getGap(const uint8_t emitter) const;
+#ifndef UNIT_TEST
+
+ private:
+#endif
+  IRac **_emitters;  ///< The IRac object for each emitter.
+  uint8_t _nr_emitters;  ///< Nr. of emitters.
+  acfleet_device_t *_devices;  ///< The devices.
+  uint16_t _size;  ///< Nr. of devices there is room for.
+  uint16_t _count;  ///< Nr. of devices added.
+  uint16_t _next;  ///< The device to start looking for work from.
+  uint32_t *_gap;  ///< The minimum gap after a message, per emitter.
+  uint32_t *_wait;  ///< How long each emitter must still be idle for.
+  IRtimer *_timer;  ///< When each emitter was last used.
+  bool idle(const uint8_t emitter);
+  void update(acfleet_device_t *device);
+};
+#endif  // IRACFLEET_H_
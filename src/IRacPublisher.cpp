@@ -0,0 +1,222 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+/// @file
+/// @brief Report the settings of a common A/C state, only sending changes.
+
+#include "IRacPublisher.h"
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include "IRac.h"
+#include "IRutils.h"
+
+/// The name of each field, in bit order of the `kAcField*` flags.
+/// @note These are part of the external (e.g. MQTT) interface, so they are
+///   never translated.
+const char * const kAcPublisherFieldNames[] = {
+    "protocol", "model", "power", "mode", "temp", "use_celsius", "fanspeed",
+    "swingv", "swingh", "quiet", "turbo", "econo", "light", "filter", "clean",
+    "beep", "sleep"};
+static_assert(sizeof(kAcPublisherFieldNames) /
+              sizeof(kAcPublisherFieldNames[0]) == kAcPublisherNrFields,
+              "kAcPublisherFieldNames needs a name for every field.");
+/// The name of the topic for the whole state as a JSON document.
+const char * const kAcPublisherJsonName = "json";
+/// The name of the topic for just the changed settings as a JSON document.
+const char * const kAcPublisherJsonDeltaName = "json_delta";
+
+/// Class constructor.
+/// @param[in] publish The function to call to publish each topic & payload.
+/// @param[in] context Passed to `publish` each time it is called.
+/// @param[in] prefix The start of each topic. e.g. "ir_server/ac/stat/"
+/// @param[in] json Publish the settings as JSON documents instead of a topic
+///   per setting, or not.
+/// @param[in] ha_mode Bind power & mode together, Home Assistant style, or not.
+IRacPublisher::IRacPublisher(PublishFn publish, void *context,
+                             const String prefix, const bool json,
+                             const bool ha_mode)
+    : _publish(publish), _context(context), _json(json), _ha_mode(ha_mode) {
+  setPrefix(prefix);
+  forget();
+}
+
+/// Set the start of each topic, and build all the topics from it.
+/// @param[in] prefix The new prefix. e.g. "ir_server/ac/stat/"
+void IRacPublisher::setPrefix(const String prefix) {
+  _prefix = prefix;
+  for (uint8_t i = 0; i < kAcPublisherNrFields; i++)
+    _topics[i] = _prefix + kAcPublisherFieldNames[i];
+  _json_topic = _prefix + kAcPublisherJsonName;
+  _json_delta_topic = _prefix + kAcPublisherJsonDeltaName;
+}
+
+/// Get the start of each topic.
+/// @return The prefix.
+String IRacPublisher::getPrefix(void) const { return _prefix; }
+
+/// Set if the settings are to be published as JSON documents.
+/// @param[in] on true, when anything changes, publish the whole state to the
+///   "json" topic, and just the changed settings to the "json_delta" topic
+///   (never retained), instead of a topic per setting. false, only a topic
+///   per setting.
+void IRacPublisher::setJson(const bool on) { _json = on; }
+
+/// Get if the settings are published as JSON documents.
+/// @return true, they are. false, they aren't.
+bool IRacPublisher::getJson(void) const { return _json; }
+
+/// Set if power & mode are bound together, as Home Assistant expects.
+/// i.e. The mode is reported as off when the power is, and a change in either
+/// reports both.
+/// @param[in] on true, bind them. false, don't.
+void IRacPublisher::setHaMode(const bool on) { _ha_mode = on; }
+
+/// Get if power & mode are bound together, as Home Assistant expects.
+/// @return true, they are. false, they aren't.
+bool IRacPublisher::getHaMode(void) const { return _ha_mode; }
+
+/// Forget what was last published, so the next `publish()` reports it all.
+/// e.g. After reconnecting to the MQTT broker.
+void IRacPublisher::forget(void) {
+  _valid = false;
+  _unsent = 0;
+}
+
+/// Which settings would `publish()` report for a given state?
+/// @param[in] state The state to compare with what was last published.
+/// @return The flags (kAcField*) of the settings that would be reported.
+uint32_t IRacPublisher::pending(const stdAc::state_t &state) const {
+  if (!_valid) return kAcPublisherFields;
+  uint32_t result = (IRac::diffStates(_last, state) | _unsent) &
+      kAcPublisherFields;
+  if (_ha_mode && (result & (kAcFieldPower | kAcFieldMode)))
+    result |= kAcFieldPower | kAcFieldMode;
+  return result;
+}
+
+/// Report the settings that have changed since the last time.
+/// Each changed setting is published to its own topic. If JSON is on, the
+/// whole state is published to the "json" topic instead, so a retained copy
+/// is always complete, and the changed settings to the "json_delta" topic.
+/// @param[in] state The state to report.
+/// @param[in] retain Ask for the published values to be retained or not.
+///   The "json_delta" document is never retained.
+/// @param[in] force Report every setting, changed or not.
+/// @return true, if everything was published. false, if not.
+/// @note Settings that fail to publish are retried next time.
+bool IRacPublisher::publish(const stdAc::state_t &state, const bool retain,
+                            const bool force) {
+  const uint32_t fields = force ? kAcPublisherFields : pending(state);
+  _last = state;
+  _valid = true;
+  _unsent = 0;
+  if (!fields) return true;  // Nothing to do.
+  if (_json) {
+    if (!_publish(_context, _json_topic,
+                  toJson(state, kAcPublisherFields, _ha_mode), retain) ||
+        !_publish(_context, _json_delta_topic,
+                  toJson(state, fields, _ha_mode), false))
+      _unsent = fields;
+    return !_unsent;
+  }
+  for (uint8_t i = 0; i < kAcPublisherNrFields; i++) {
+    const uint32_t field = 1UL << i;
+    if ((fields & field) &&
+        !_publish(_context, _topics[i], fieldValue(state, field, _ha_mode),
+                  retain))
+      _unsent |= field;
+  }
+  return !_unsent;
+}
+
+/// Convert some of the settings of a state to a JSON document.
+/// @param[in] state The state to get the values from.
+/// @param[in] fields The flags (kAcField*) of the settings to include.
+/// @param[in] ha_mode Report the mode as off if the power is, or not.
+/// @return The document. e.g. {"power":"on","temp":21.5}
+String IRacPublisher::toJson(const stdAc::state_t &state,
+                             const uint32_t fields, const bool ha_mode) {
+  String result = "{";
+  for (uint8_t i = 0; i < kAcPublisherNrFields; i++) {
+    const uint32_t field = 1UL << i;
+    if (!(fields & field)) continue;
+    if (result.length() > 1) result += ',';
+    result += '"';
+    result += kAcPublisherFieldNames[i];
+    result += "\":";
+    if (isNumeric(field)) {
+      result += fieldValue(state, field, ha_mode);
+    } else {
+      result += '"';
+      result += fieldValue(state, field, ha_mode);
+      result += '"';
+    }
+  }
+  result += '}';
+  return result;
+}
+
+/// Get the name of a setting, as used in topics & JSON documents.
+/// @param[in] field The flag (kAcField*) of the setting.
+/// @return The name, or NULL if it isn't one that is reported.
+const char *IRacPublisher::fieldName(const uint32_t field) {
+  for (uint8_t i = 0; i < kAcPublisherNrFields; i++)
+    if (field == (1UL << i)) return kAcPublisherFieldNames[i];
+  return NULL;
+}
+
+/// Is a setting reported as a number?
+/// @param[in] field The flag (kAcField*) of the setting.
+/// @return true, it is a number. false, it is text.
+bool IRacPublisher::isNumeric(const uint32_t field) {
+  return field & (kAcFieldModel | kAcFieldDegrees | kAcFieldSleep);
+}
+
+/// Get the value of a setting, as text.
+/// @param[in] state The state to get the value from.
+/// @param[in] field The flag (kAcField*) of the setting.
+/// @param[in] ha_mode Report the mode as off if the power is, or not.
+/// @return The value. e.g. "on", "cool", "21.5". Empty if the field is unknown.
+String IRacPublisher::fieldValue(const stdAc::state_t &state,
+                                 const uint32_t field, const bool ha_mode) {
+  bool flag;
+  switch (field) {
+    case kAcFieldProtocol: return typeToString(state.protocol);
+    case kAcFieldModel: return int64ToString(state.model);
+    case kAcFieldMode: {
+      String mode = IRac::opmodeToString(
+          (ha_mode && !state.power) ? stdAc::opmode_t::kOff : state.mode);
+      // The modes need to be lower case to work with Home Assistant & Google
+      // Home.
+      for (uint16_t i = 0; i < mode.length(); i++)
+        if (mode[i] >= 'A' && mode[i] <= 'Z') mode[i] += 'a' - 'A';
+      return mode;
+    }
+    case kAcFieldDegrees: {
+      // One decimal place.
+      const int32_t tenths = state.degrees * 10 +
+          (state.degrees < 0 ? -0.5 : 0.5);
+      const uint32_t magnitude = tenths < 0 ? -tenths : tenths;
+      String result = tenths < 0 ? "-" : "";
+      result += uint64ToString(magnitude / 10);
+      result += '.';
+      result += uint64ToString(magnitude % 10);
+      return result;
+    }
+    case kAcFieldFanspeed: return IRac::fanspeedToString(state.fanspeed);
+    case kAcFieldSwingv: return IRac::swingvToString(state.swingv);
+    case kAcFieldSwingh: return IRac::swinghToString(state.swingh);
+    case kAcFieldSleep: return int64ToString(state.sleep);
+    case kAcFieldPower: flag = state.power; break;
+    case kAcFieldCelsius: flag = state.celsius; break;
+    case kAcFieldQuiet: flag = state.quiet; break;
+    case kAcFieldTurbo: flag = state.turbo; break;
+    case kAcFieldEcono: flag = state.econo; break;
+    case kAcFieldLight: flag = state.light; break;
+    case kAcFieldFilter: flag = state.filter; break;
+    case kAcFieldClean: flag = state.clean; break;
+    case kAcFieldBeep: flag = state.beep; break;
+    default: return "";
+  }
+  return flag ? "on" : "off";
+}
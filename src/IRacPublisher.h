@@ -0,0 +1,69 @@
+#ifndef IRACPUBLISHER_H_
+#define IRACPUBLISHER_H_
+
+// Copyright 2021 IRremoteESP8266 authors
+
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include "IRremoteESP8266.h"
+#include "IRac.h"
+
+// Constants
+/// The settings of a `stdAc::state_t` that `IRacPublisher` reports on.
+/// i.e. All but the clock.
+const uint32_t kAcPublisherFields = kAcFieldAll & ~kAcFieldClock;
+const uint8_t kAcPublisherNrFields = 17;  ///< Nr. of bits set in the above.
+static_assert(kAcPublisherFields == (1UL << kAcPublisherNrFields) - 1,
+              "kAcPublisherNrFields must match kAcPublisherFields.");
+
+/// Reports the settings of a common A/C state as topic/payload pairs.
+/// e.g. For publishing via MQTT.
+/// It remembers what it last published, and only reports the settings that
+/// have changed since, one topic per setting. Optionally, the whole state is
+/// published as a JSON document, and the changes as another, instead.
+/// The topics are built once, not each time a setting is published.
+/// @note What is done with each topic/payload pair is up to the caller, via
+///   a callback. That keeps this free of any network code, so it can be
+///   tested on the host.
+class IRacPublisher {
+ public:
+  /// A function that publishes a payload to a topic.
+  /// @return true, if it was published. false, if not.
+  typedef bool (*PublishFn)(void *context, const String &topic,
+                            const String &payload, const bool retain);
+  IRacPublisher(PublishFn publish, void *context, const String prefix = "",
+                const bool json = false, const bool ha_mode = false);
+  void setPrefix(const String prefix);
+  String getPrefix(void) const;
+  void setJson(const bool on);
+  bool getJson(void) const;
+  void setHaMode(const bool on);
+  bool getHaMode(void) const;
+  uint32_t pending(const stdAc::state_t &state) const;
+  bool publish(const stdAc::state_t &state, const bool retain = true,
+               const bool force = false);
+  void forget(void);
+  static const char *fieldName(const uint32_t field);
+  static String fieldValue(const stdAc::state_t &state, const uint32_t field,
+                           const bool ha_mode = false);
+  static String toJson(const stdAc::state_t &state, const uint32_t fields,
+                       const bool ha_mode = false);
+#ifndef UNIT_TEST
+
+ private:
+#endif
+  PublishFn _publish;  ///< Where to send each topic & payload.
+  void *_context;  ///< What to pass to `_publish`.
+  String _prefix;  ///< The start of every topic.
+  String _topics[kAcPublisherNrFields];  ///< The topic for each setting.
+  String _json_topic;  ///< The topic for the whole state as JSON.
+  String _json_delta_topic;  ///< The topic for the changes as JSON.
+  bool _json;  ///< Publish JSON documents rather than a topic per setting?
+  bool _ha_mode;  ///< Bind power & mode together, Home Assistant style?
+  bool _valid;  ///< Has `_last` been published?
+  stdAc::state_t _last;  ///< The state that was last published.
+  uint32_t _unsent;  ///< Fields that failed to publish last time.
+  static bool isNumeric(const uint32_t field);
+};
+#endif  // IRACPUBLISHER_H_
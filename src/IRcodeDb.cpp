@@ -0,0 +1,385 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+/// @file
+/// @brief A database of known IR codes, & the actions they map to.
+
+#include "IRcodeDb.h"
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include <string.h>
+#include "IRutils.h"
+
+/// Class constructor.
+/// @param[in] capacity The nr. of bytes the store can hold.
+IRcodeDbRamStore::IRcodeDbRamStore(const uint32_t capacity)
+    : _capacity(capacity), _size(0) {
+  _buf = new uint8_t[capacity];
+}
+
+/// Class destructor.
+IRcodeDbRamStore::~IRcodeDbRamStore(void) { delete[] _buf; }
+
+/// Get the size of the store.
+/// @return The nr. of bytes in it.
+uint32_t IRcodeDbRamStore::size(void) { return _size; }
+
+/// Read bytes from the store.
+/// @param[in] offset Where to read from.
+/// @param[out] buf Where to put them.
+/// @param[in] len How many bytes to read.
+/// @return true, if they were all read. false, if not.
+bool IRcodeDbRamStore::read(const uint32_t offset, uint8_t *buf,
+                            const uint16_t len) {
+  if (offset > _size || len > _size - offset) return false;
+  memcpy(buf, _buf + offset, len);
+  return true;
+}
+
+/// Add bytes to the end of the store.
+/// @param[in] buf The bytes.
+/// @param[in] len How many bytes to add.
+/// @return true, if they were all added. false, if it is full.
+bool IRcodeDbRamStore::append(const uint8_t *buf, const uint16_t len) {
+  if (len > _capacity - _size) return false;
+  memcpy(_buf + _size, buf, len);
+  _size += len;
+  return true;
+}
+
+#ifndef ESP8266
+/// Class constructor.
+/// @param[in] path The file to use. It is created if it doesn't exist.
+IRcodeDbFileStore::IRcodeDbFileStore(const char *path) {
+  _file = fopen(path, "a+b");
+}
+
+/// Class destructor.
+IRcodeDbFileStore::~IRcodeDbFileStore(void) {
+  if (_file != NULL) fclose(_file);
+}
+
+/// Was the file opened?
+/// @return true, if it was. false, if not.
+bool IRcodeDbFileStore::isOpen(void) { return _file != NULL; }
+
+/// Get the size of the store.
+/// @return The nr. of bytes in the file.
+uint32_t IRcodeDbFileStore::size(void) {
+  if (_file == NULL || fseek(_file, 0, SEEK_END)) return 0;
+  const long result = ftell(_file);  // NOLINT(runtime/int)
+  return (result > 0) ? result : 0;
+}
+
+/// Read bytes from the store.
+/// @param[in] offset Where to read from.
+/// @param[out] buf Where to put them.
+/// @param[in] len How many bytes to read.
+/// @return true, if they were all read. false, if not.
+bool IRcodeDbFileStore::read(const uint32_t offset, uint8_t *buf,
+                             const uint16_t len) {
+  return _file != NULL && !fseek(_file, offset, SEEK_SET) &&
+      fread(buf, 1, len, _file) == len;
+}
+
+/// Add bytes to the end of the store.
+/// @param[in] buf The bytes.
+/// @param[in] len How many bytes to add.
+/// @return true, if they were all written out. false, if not.
+bool IRcodeDbFileStore::append(const uint8_t *buf, const uint16_t len) {
+  // The file is opened for appending, so writes always go to the end. But
+  // switching from reading to writing still needs a positioning call.
+  return _file != NULL && !fseek(_file, 0, SEEK_END) &&
+      fwrite(buf, 1, len, _file) == len && !fflush(_file);
+}
+#endif  // ESP8266
+
+/// Class constructor.
+/// @param[in] store Where the records are kept.
+/// @param[in] tail_size The nr. of records added since the last `compact()`
+///   it can hold. Each costs 16 bytes of RAM.
+/// @note Call `begin()` before using it.
+IRcodeDb::IRcodeDb(IRcodeDbStore *store, const uint16_t tail_size)
+    : _store(store), _ready(false), _records(0), _sorted(0),
+      _tail_size(tail_size), _tail_count(0) {
+  _tail = new codedb_entry_t[tail_size];
+}
+
+/// Class destructor.
+IRcodeDb::~IRcodeDb(void) { delete[] _tail; }
+
+/// Read the store, & work out where its sorted run ends.
+/// Records that were damaged while being written are ignored.
+/// @return true, if it is ready to use. false, if the store is unusable, or
+///   has more records after its sorted run than we can hold.
+/// @note Reading the whole store is only done here. If it fails because of
+///   the latter, use an `IRcodeDb` with a larger tail size to `compact()` it.
+bool IRcodeDb::begin(void) {
+  _ready = false;
+  _sorted = 0;
+  _tail_count = 0;
+  if (_store == NULL) return false;
+  const uint32_t size = _store->size();
+  _records = size / kCodeDbRecordSize;
+  // A partly written record at the end would misalign everything after it.
+  if (size % kCodeDbRecordSize) return false;
+  bool in_order = true;
+  uint64_t last = 0;
+  for (uint32_t i = 0; i < _records; i++) {
+    codedb_entry_t entry;
+    if (!readRecord(i, &entry)) {
+      in_order = false;
+      continue;
+    }
+    if (in_order && (i == 0 || entry.key > last)) {
+      _sorted++;
+      last = entry.key;
+    } else {
+      in_order = false;
+      if (!insertTail(entry)) return false;
+    }
+  }
+  _ready = true;
+  return true;
+}
+
+// Layout of a key.
+// protocol (9 bits) | size (7 bits) | data (48 bits)
+// `size` is the nr. of bits of a value kept exactly in `data`, or
+// kCodeDbKeyHashed if `data` is a hash of the size & the value (or state).
+const uint8_t kCodeDbKeyDataSize = 48;
+const uint8_t kCodeDbKeySizeSize = 7;
+const uint8_t kCodeDbKeyProtocolSize = 9;
+const uint8_t kCodeDbKeyHashed = (1 << kCodeDbKeySizeSize) - 1;
+const uint64_t kCodeDbKeyDataMask = (1ULL << kCodeDbKeyDataSize) - 1;
+static_assert(kLastDecodeType < (1 << kCodeDbKeyProtocolSize) - 1,
+              "decode_type_t doesn't fit in a key.");  // UNKNOWN is all 1s.
+
+/// Put the parts of a key together.
+/// @param[in] protocol The protocol of the code.
+/// @param[in] size The nr. of bits in `data`, or kCodeDbKeyHashed.
+/// @param[in] data The value, or a hash.
+/// @return The key.
+static uint64_t makeKey(const decode_type_t protocol, const uint8_t size,
+                        const uint64_t data) {
+  const uint64_t id = (uint16_t)protocol & ((1 << kCodeDbKeyProtocolSize) - 1);
+  return (id << (kCodeDbKeyDataSize + kCodeDbKeySizeSize)) |
+      ((uint64_t)size << kCodeDbKeyDataSize) | (data & kCodeDbKeyDataMask);
+}
+
+/// Hash some bytes, & how many bits they hold. (FNV-1a, folded to 48 bits)
+/// @param[in] bits The nr. of bits in the code.
+/// @param[in] bytes The bytes of it.
+/// @param[in] len The nr. of bytes.
+/// @return The hash.
+static uint64_t hashKeyData(const uint16_t bits, const uint8_t *bytes,
+                            const uint16_t len) {
+  uint64_t hash = kFnvBasis64;
+  hash = (hash ^ (bits & 0xFF)) * kFnvPrime64;
+  hash = (hash ^ (bits >> 8)) * kFnvPrime64;
+  for (uint16_t i = 0; i < len; i++)
+    hash = (hash ^ bytes[i]) * kFnvPrime64;
+  return (hash ^ (hash >> kCodeDbKeyDataSize)) & kCodeDbKeyDataMask;
+}
+
+/// Make the key of a simple (value based) code.
+/// @param[in] protocol The protocol of the code.
+/// @param[in] bits The nr. of bits in it.
+/// @param[in] value The value of it.
+/// @return The key. Values of up to 48 bits are kept as they are. Larger ones
+///   are hashed.
+uint64_t IRcodeDb::key(const decode_type_t protocol, const uint16_t bits,
+                       const uint64_t value) {
+  if (bits <= kCodeDbKeyDataSize) return makeKey(protocol, bits, value);
+  uint8_t bytes[sizeof(value)];
+  for (uint8_t i = 0; i < sizeof(value); i++) bytes[i] = value >> (i * 8);
+  return makeKey(protocol, kCodeDbKeyHashed,
+                 hashKeyData(bits, bytes, sizeof(bytes)));
+}
+
+/// Make the key of a state (array) based code. e.g. An A/C message.
+/// @param[in] protocol The protocol of the code.
+/// @param[in] bits The nr. of bits in it.
+/// @param[in] state The state of it.
+/// @return The key. The state is hashed.
+uint64_t IRcodeDb::key(const decode_type_t protocol, const uint16_t bits,
+                       const uint8_t state[]) {
+  return makeKey(protocol, kCodeDbKeyHashed,
+                 hashKeyData(bits, state, (bits + 7) / 8));
+}
+
+/// Make the key of a decoded message.
+/// @param[in] results The result of a successful `IRrecv::decode()`.
+/// @return The key.
+uint64_t IRcodeDb::key(const decode_results *results) {
+  if (hasACState(results->decode_type))
+    return key(results->decode_type, results->bits, results->state);
+  return key(results->decode_type, results->bits, results->value);
+}
+
+/// Add a code, or change the action of one already in the database.
+/// @param[in] key The key of the code.
+/// @param[in] action What it maps to. Any value but kCodeDbNone.
+/// @return true, if it was added. false, if it couldn't be. e.g. The store is
+///   full, or too many records have been added since the last `compact()`.
+/// @note Nothing is written if it already maps to `action`.
+bool IRcodeDb::add(const uint64_t key, const uint32_t action) {
+  if (!_ready) return false;
+  if (lookup(key) == action) return true;
+  // A key already in the tail takes the same space when it is replaced.
+  if (_tail_count >= _tail_size && findTail(key) < 0) return false;
+  const codedb_entry_t entry = {key, action};
+  uint8_t record[kCodeDbRecordSize];
+  encodeRecord(entry, record);
+  if (!_store->append(record, kCodeDbRecordSize)) return false;
+  _records++;
+  return insertTail(entry);
+}
+
+/// Remove a code from the database.
+/// @param[in] key The key of the code.
+/// @return true, if it isn't in the database now. false, if not.
+bool IRcodeDb::remove(const uint64_t key) { return add(key, kCodeDbNone); }
+
+/// Find the action a code maps to.
+/// @param[in] key The key of the code.
+/// @return The action, or kCodeDbNone if it isn't in the database.
+uint32_t IRcodeDb::lookup(const uint64_t key) {
+  if (!_ready) return kCodeDbNone;
+  // What was added since the last compact() overrides the sorted run.
+  const int32_t found = findTail(key);
+  if (found >= 0) return _tail[found].action;
+  uint32_t low = 0;
+  uint32_t high = _sorted;
+  while (low < high) {
+    const uint32_t mid = low + (high - low) / 2;
+    codedb_entry_t entry;
+    if (!readRecord(mid, &entry)) return kCodeDbNone;
+    if (entry.key == key) return entry.action;
+    if (entry.key < key)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return kCodeDbNone;
+}
+
+/// Find the action a decoded message maps to.
+/// @param[in] results The result of a successful `IRrecv::decode()`.
+/// @return The action, or kCodeDbNone if it isn't in the database.
+uint32_t IRcodeDb::lookup(const decode_results *results) {
+  return lookup(key(results));
+}
+
+/// Get the nr. of records in the store.
+/// @return The nr. of records, including those that have been overridden.
+uint32_t IRcodeDb::records(void) const { return _records; }
+
+/// Get the nr. of records added since the last `compact()`.
+/// @return The nr. of entries in the RAM index.
+uint16_t IRcodeDb::pending(void) const { return _tail_count; }
+
+/// Write just the current records, sorted by key, to a new store, & use it
+/// from now on. Overridden & removed codes are dropped.
+/// Only one record is held in RAM at a time.
+/// @param[in] dst The new store. It must be empty.
+/// @return true, if it was successful. false, if not. If the new store
+///   couldn't be written, the old one is still used.
+/// @note The old store is no longer needed afterwards. e.g. Delete its file.
+bool IRcodeDb::compact(IRcodeDbStore *dst) {
+  if (!_ready || dst == NULL || dst == _store || dst->size()) return false;
+  uint32_t i = 0;
+  uint16_t j = 0;
+  while (i < _sorted || j < _tail_count) {
+    codedb_entry_t entry;
+    if (i < _sorted && !readRecord(i, &entry)) return false;
+    // Merge the two sorted lists. The tail wins for the same key.
+    if (j < _tail_count && (i >= _sorted || _tail[j].key <= entry.key)) {
+      if (i < _sorted && _tail[j].key == entry.key) i++;
+      entry = _tail[j++];
+    } else {
+      i++;
+    }
+    if (entry.action == kCodeDbNone) continue;  // It was removed.
+    uint8_t record[kCodeDbRecordSize];
+    encodeRecord(entry, record);
+    if (!dst->append(record, kCodeDbRecordSize)) return false;
+  }
+  _store = dst;
+  return begin();
+}
+
+/// Convert an entry to a record in a store.
+/// i.e. The key (8 bytes), the action (4), & a check of them (4), all
+/// little-endian.
+/// @param[in] entry The entry.
+/// @param[out] record Where to put the record.
+void IRcodeDb::encodeRecord(const codedb_entry_t entry, uint8_t *record) {
+  for (uint8_t i = 0; i < 8; i++) record[i] = entry.key >> (i * 8);
+  for (uint8_t i = 0; i < 4; i++) record[8 + i] = entry.action >> (i * 8);
+  uint32_t check = kFnvBasis32;
+  for (uint8_t i = 0; i < 12; i++) check = (check ^ record[i]) * kFnvPrime32;
+  for (uint8_t i = 0; i < 4; i++) record[12 + i] = check >> (i * 8);
+}
+
+/// Convert a record in a store to an entry.
+/// @param[in] record The record.
+/// @param[out] entry Where to put the entry.
+/// @return true, if the record is intact. false, if not.
+bool IRcodeDb::decodeRecord(const uint8_t *record, codedb_entry_t *entry) {
+  uint32_t check = kFnvBasis32;
+  for (uint8_t i = 0; i < 12; i++) check = (check ^ record[i]) * kFnvPrime32;
+  uint32_t stored = 0;
+  for (uint8_t i = 0; i < 4; i++) stored |= (uint32_t)record[12 + i] << (i * 8);
+  if (check != stored) return false;
+  entry->key = 0;
+  for (uint8_t i = 0; i < 8; i++) entry->key |= (uint64_t)record[i] << (i * 8);
+  entry->action = 0;
+  for (uint8_t i = 0; i < 4; i++)
+    entry->action |= (uint32_t)record[8 + i] << (i * 8);
+  return true;
+}
+
+/// Read a record from the store.
+/// @param[in] index The nr. of the record.
+/// @param[out] entry Where to put it.
+/// @return true, if it was read & is intact. false, if not.
+bool IRcodeDb::readRecord(const uint32_t index, codedb_entry_t *entry) {
+  uint8_t record[kCodeDbRecordSize];
+  return _store->read(index * kCodeDbRecordSize, record, kCodeDbRecordSize) &&
+      decodeRecord(record, entry);
+}
+
+/// Add an entry to the RAM index, or replace the one with the same key.
+/// @param[in] entry The entry.
+/// @return true, if it was. false, if there is no room for it.
+bool IRcodeDb::insertTail(const codedb_entry_t entry) {
+  const int32_t found = findTail(entry.key);
+  if (found >= 0) {
+    _tail[found] = entry;
+    return true;
+  }
+  if (_tail_count >= _tail_size) return false;
+  const uint16_t pos = -(found + 1);
+  for (uint16_t i = _tail_count; i > pos; i--) _tail[i] = _tail[i - 1];
+  _tail[pos] = entry;
+  _tail_count++;
+  return true;
+}
+
+/// Binary search the RAM index for a key.
+/// @param[in] key The key.
+/// @return Where it is, if found. If not, -(where it should go) - 1.
+int32_t IRcodeDb::findTail(const uint64_t key) const {
+  uint16_t low = 0;
+  uint16_t high = _tail_count;
+  while (low < high) {
+    const uint16_t mid = low + (high - low) / 2;
+    if (_tail[mid].key == key) return mid;
+    if (_tail[mid].key < key)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return -(int32_t)low - 1;
+}
@@ -0,0 +1,142 @@
+#ifndef IRCODEDB_H_
+#define IRCODEDB_H_
+
+// Copyright 2021 IRremoteESP8266 authors
+
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#ifndef ESP8266
+#include <stdio.h>
+#endif  // ESP8266
+#include "IRremoteESP8266.h"
+#include "IRrecv.h"
+
+// Constants
+const uint32_t kCodeDbNone = 0xFFFFFFFF;  ///< No action. i.e. Not found.
+const uint8_t kCodeDbRecordSize = 16;  ///< Bytes per record in a store.
+/// Default nr. of records added since the last `compact()` that it can hold.
+const uint16_t kCodeDbDefaultTail = 64;
+
+/// A code & the action it maps to.
+typedef struct {
+  uint64_t key;  ///< See `IRcodeDb::key()`.
+  uint32_t action;  ///< kCodeDbNone means it has been removed.
+} codedb_entry_t;
+
+/// Where an `IRcodeDb` keeps its records. e.g. A file in flash, or RAM.
+/// It only ever needs to be appended to, & read from anywhere.
+/// Subclass it for other storage. e.g. A LittleFS `File` on an ESP8266.
+class IRcodeDbStore {
+ public:
+  virtual ~IRcodeDbStore(void) {}
+  /// Get the size of the store.
+  /// @return The nr. of bytes in it.
+  virtual uint32_t size(void) = 0;
+  /// Read bytes from the store.
+  /// @param[in] offset Where to read from.
+  /// @param[out] buf Where to put them.
+  /// @param[in] len How many bytes to read.
+  /// @return true, if they were all read. false, if not.
+  virtual bool read(const uint32_t offset, uint8_t *buf,
+                    const uint16_t len) = 0;
+  /// Add bytes to the end of the store.
+  /// @param[in] buf The bytes.
+  /// @param[in] len How many bytes to add.
+  /// @return true, if they were all added. false, if not.
+  virtual bool append(const uint8_t *buf, const uint16_t len) = 0;
+};
+
+/// A store kept in a fixed size RAM buffer.
+class IRcodeDbRamStore : public IRcodeDbStore {
+ public:
+  explicit IRcodeDbRamStore(const uint32_t capacity);
+  ~IRcodeDbRamStore(void);
+  // It owns its buffer, so it can't be copied.
+  IRcodeDbRamStore(const IRcodeDbRamStore &) = delete;
+  IRcodeDbRamStore &operator=(const IRcodeDbRamStore &) = delete;
+  uint32_t size(void);
+  bool read(const uint32_t offset, uint8_t *buf, const uint16_t len);
+  bool append(const uint8_t *buf, const uint16_t len);
+#ifndef UNIT_TEST
+
+ private:
+#endif
+  uint8_t *_buf;  ///< The contents.
+  uint32_t _capacity;  ///< Nr. of bytes `_buf` can hold.
+  uint32_t _size;  ///< Nr. of bytes used.
+};
+
+#ifndef ESP8266
+/// A store kept in a file, via stdio. e.g. On the host, or an ESP32's VFS.
+class IRcodeDbFileStore : public IRcodeDbStore {
+ public:
+  explicit IRcodeDbFileStore(const char *path);
+  ~IRcodeDbFileStore(void);
+  // It owns the open file, so it can't be copied.
+  IRcodeDbFileStore(const IRcodeDbFileStore &) = delete;
+  IRcodeDbFileStore &operator=(const IRcodeDbFileStore &) = delete;
+  bool isOpen(void);
+  uint32_t size(void);
+  bool read(const uint32_t offset, uint8_t *buf, const uint16_t len);
+  bool append(const uint8_t *buf, const uint16_t len);
+#ifndef UNIT_TEST
+
+ private:
+#endif
+  FILE *_file;  ///< The open file, or NULL.
+};
+#endif  // ESP8266
+
+/// A database of known codes, & the action each one maps to.
+/// e.g. What to do when a decoded message is received.
+/// Codes are keyed by their protocol, size, & value, so a `decode()` result
+/// can be looked up directly. Values of up to 48 bits are kept exactly. Larger
+/// ones, & states, are hashed, so two of those could share a key.
+///
+/// The store is append-only. Records are kept in it in two parts:
+///   - A run sorted by key, written by `compact()`. Looked up by a binary
+///     search of the store, O(log n) reads, without loading it into RAM.
+///   - Those added since, which are also held in a small sorted RAM index.
+///     When it is full, `compact()` the database into a new store.
+/// Later records override earlier ones for the same key, & removing a code
+/// adds a record with no action.
+class IRcodeDb {
+ public:
+  explicit IRcodeDb(IRcodeDbStore *store,
+                    const uint16_t tail_size = kCodeDbDefaultTail);
+  ~IRcodeDb(void);
+  // It owns the RAM index, so it can't be copied.
+  IRcodeDb(const IRcodeDb &) = delete;
+  IRcodeDb &operator=(const IRcodeDb &) = delete;
+  bool begin(void);
+  static uint64_t key(const decode_type_t protocol, const uint16_t bits,
+                      const uint64_t value);
+  static uint64_t key(const decode_type_t protocol, const uint16_t bits,
+                      const uint8_t state[]);
+  static uint64_t key(const decode_results *results);
+  bool add(const uint64_t key, const uint32_t action);
+  bool remove(const uint64_t key);
+  uint32_t lookup(const uint64_t key);
+  uint32_t lookup(const decode_results *results);
+  uint32_t records(void) const;
+  uint16_t pending(void) const;
+  bool compact(IRcodeDbStore *dst);
+#ifndef UNIT_TEST
+
+ private:
+#endif
+  IRcodeDbStore *_store;  ///< Where the records are kept.
+  bool _ready;  ///< Has the store been read successfully?
+  uint32_t _records;  ///< Nr. of records in the store.
+  uint32_t _sorted;  ///< Nr. of records at the start of it in key order.
+  codedb_entry_t *_tail;  ///< The records after those, by key.
+  uint16_t _tail_size;  ///< Nr. of entries `_tail` can hold.
+  uint16_t _tail_count;  ///< Nr. of entries in `_tail`.
+  static void encodeRecord(const codedb_entry_t entry, uint8_t *record);
+  static bool decodeRecord(const uint8_t *record, codedb_entry_t *entry);
+  bool readRecord(const uint32_t index, codedb_entry_t *entry);
+  bool insertTail(const codedb_entry_t entry);
+  int32_t findTail(const uint64_t key) const;
+};
+#endif  // IRCODEDB_H_
@@ -0,0 +1,326 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+/// @file
+/// @brief Stream web pages from templates kept in flash, in bounded memory.
+
+#include "IRhtmlRenderer.h"
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include <string.h>
+#include <algorithm>
+#include "IRac.h"
+#include "IRutils.h"
+
+#ifndef PGM_P
+#define PGM_P const char *  // Pretend we have PGM_P even if we really don't.
+#endif  // PGM_P
+#ifndef pgm_read_byte
+/// Pretend we have pgm_read_byte() even if we really don't.
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#endif  // pgm_read_byte
+
+/// The text that marks the selected item in an `<option>` list.
+const char * const kHtmlSelectedStr = " selected='selected'";
+/// The text that precedes the value of each item in an `<option>` list.
+const char * const kHtmlOptionValueStr = "value='";
+
+/// Class constructor.
+/// @param[in] write The function to call with each chunk of output.
+IRhtmlRenderer::IRhtmlRenderer(WriteFn write)
+    : _write(write), _used(0), _total(0) {}
+
+/// Add some bytes to the output, writing out the buffer each time it fills.
+/// @param[in] data The bytes to add.
+/// @param[in] length The nr. of bytes to add.
+void IRhtmlRenderer::write(const char *data, uint16_t length) {
+  _total += length;
+  while (length) {
+    if (_used == kHtmlRendererBufferSize) flush();
+    uint16_t size = std::min((uint16_t)(kHtmlRendererBufferSize - _used),
+                             length);
+    memcpy(_buffer + _used, data, size);
+    _used += size;
+    data += size;
+    length -= size;
+  }
+}
+
+/// Write out whatever is in the buffer.
+/// @note Call this when the page is done, or nothing may be written at all.
+void IRhtmlRenderer::flush(void) {
+  if (_used && _write != NULL) _write(_buffer, _used);
+  _used = 0;
+}
+
+/// Get the nr. of bytes output so far, including any not yet written.
+/// @return The length of the page so far.
+uint32_t IRhtmlRenderer::length(void) const { return _total; }
+
+/// Output a template, with each of its fields filled in by a callback.
+/// e.g. "<b>{0}</b> is {1}" calls `field` with 0, then 1, at those points.
+/// @param[in] tmpl The template, in flash (PROGMEM) if the platform has it.
+/// @param[in] field The function that writes the value of each field.
+///   If NULL, the fields are left empty.
+/// @param[in] arg Passed to `field` each time it is called.
+void IRhtmlRenderer::render(const char *tmpl, FieldFn field, void *arg) {
+  PGM_P ptr = tmpl;
+  for (char c = pgm_read_byte(ptr); c; c = pgm_read_byte(++ptr)) {
+    if (c == '{') {
+      PGM_P end = ptr + 1;
+      uint16_t index = 0;
+      char digit = pgm_read_byte(end);
+      bool found = false;
+      while (digit >= '0' && digit <= '9' && index < 1000) {
+        index = index * 10 + digit - '0';
+        found = true;
+        digit = pgm_read_byte(++end);
+      }
+      if (found && digit == '}') {
+        if (field != NULL) field(this, arg, index);
+        ptr = end;
+        continue;
+      }
+    }
+    if (_used == kHtmlRendererBufferSize) flush();
+    _buffer[_used++] = c;
+    _total++;
+  }
+}
+
+/// Output some text.
+/// @param[in] str The text.
+void IRhtmlRenderer::print(const char *str) { write(str, strlen(str)); }
+
+/// Output some text.
+/// @param[in] str The text.
+void IRhtmlRenderer::print(const String &str) {
+  write(str.c_str(), str.length());
+}
+
+/// Output some text that is in flash (PROGMEM) if the platform has it.
+/// @param[in] str The text. Unlike `render()`, it has no fields.
+void IRhtmlRenderer::printP(const char *str) {
+  for (char c = pgm_read_byte(str); c; c = pgm_read_byte(++str)) {
+    if (_used == kHtmlRendererBufferSize) flush();
+    _buffer[_used++] = c;
+    _total++;
+  }
+}
+
+/// Output a single character.
+/// @param[in] c The character.
+void IRhtmlRenderer::print(const char c) { write(&c, 1); }
+
+/// Output a number, in decimal.
+/// @param[in] value The number.
+void IRhtmlRenderer::printNumber(const int32_t value) {
+  char digits[12];  // Enough for "-2147483648".
+  uint8_t start = sizeof(digits);
+  uint32_t magnitude = value < 0 ? -(int64_t)value : value;
+  do {
+    digits[--start] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude);
+  if (value < 0) digits[--start] = '-';
+  write(digits + start, sizeof(digits) - start);
+}
+
+/// Output some text, made safe to display. i.e. Untrusted input.
+/// @param[in] str The text to escape.
+/// @note Escapes the same characters as `irutils::htmlEscape()`, but doesn't
+///   make a copy of the text to do it.
+void IRhtmlRenderer::printEscaped(const String &str) {
+  for (uint16_t i = 0; i < str.length(); i++) {
+    switch (str[i]) {
+      // ';!-"<>=&#{}() are all unsafe.
+      case '\'': print("&apos;"); break;
+      case ';':  print("&semi;"); break;
+      case '!':  print("&excl;"); break;
+      case '-':  print("&dash;"); break;
+      case '\"': print("&quot;"); break;
+      case '<':  print("&lt;"); break;
+      case '>':  print("&gt;"); break;
+      case '=':  print("&#equals;"); break;
+      case '&':  print("&amp;"); break;
+      case '#':  print("&num;"); break;
+      case '{':  print("&lcub;"); break;
+      case '}':  print("&rcub;"); break;
+      case '(':  print("&lpar;"); break;
+      case ')':  print("&rpar;"); break;
+      default:   print(str[i]);
+    }
+  }
+}
+
+/// Find where the selected item's marker goes in an `<option>` list.
+/// @param[in] options The list, as made by `addOption()`.
+/// @param[in] selected The value of the selected item.
+/// @return Where the marker goes, or NULL if the value isn't in the list.
+const char *IRhtmlRenderer::findSelected(const char *options,
+                                         const char *selected) {
+  const uint16_t length = strlen(selected);
+  const uint8_t prefix = strlen(kHtmlOptionValueStr);
+  for (const char *ptr = strstr(options, kHtmlOptionValueStr); ptr != NULL;
+       ptr = strstr(ptr + 1, kHtmlOptionValueStr)) {
+    ptr += prefix;
+    if (strncmp(ptr, selected, length) == 0 && ptr[length] == '\'')
+      return ptr + length + 1;
+  }
+  return NULL;
+}
+
+/// Output an `<option>` list, marking the selected item as it goes.
+/// @param[in] options The list, as made by `addOption()`.
+/// @param[in] selected The value of the item to mark as selected.
+void IRhtmlRenderer::printOptions(const String &options,
+                                  const String &selected) {
+  const char *start = options.c_str();
+  const char *mark = findSelected(start, selected.c_str());
+  if (mark == NULL) {
+    print(options);
+  } else {
+    write(start, mark - start);
+    print(kHtmlSelectedStr);
+    print(mark);
+  }
+}
+
+/// Output a `<select>` menu.
+/// @param[in] name The name of the form field.
+/// @param[in] options The `<option>` list, as made by `addOption()`.
+/// @param[in] selected The value of the item to mark as selected.
+void IRhtmlRenderer::printSelect(const char *name, const String &options,
+                                 const String &selected) {
+  print("<select name='");
+  print(name);
+  print("'>");
+  printOptions(options, selected);
+  print("</select>");
+}
+
+/// Add an item to an `<option>` list.
+/// @param[in,out] list The list to add it to.
+/// @param[in] value The value of the item.
+/// @param[in] text What is displayed for the item.
+void IRhtmlRenderer::addOption(String *list, const String &value,
+                               const String &text) {
+  *list += "<option ";
+  *list += kHtmlOptionValueStr;
+  *list += value;
+  *list += "'>";
+  *list += text;
+  *list += "</option>";
+}
+
+/// Make the `<option>` list for a boolean setting. i.e. "off" & "on".
+/// @return The list.
+String IRhtmlRenderer::boolOptions(void) {
+  String result = "";
+  for (uint16_t i = 0; i < 2; i++)
+    addOption(&result, IRac::boolToString(i), IRac::boolToString(i));
+  return result;
+}
+
+/// Make the `<option>` list for a range of numbers.
+/// @param[in] max One more than the largest number. i.e. "0" to "max - 1".
+/// @return The list.
+String IRhtmlRenderer::uintOptions(const uint16_t max) {
+  String result = "";
+  for (uint16_t i = 0; i < max; i++) {
+    const String num = uint64ToString(i);
+    addOption(&result, num, num);
+  }
+  return result;
+}
+
+/// Make the `<option>` list of protocols the library can send.
+/// The raw protocols (RAW, PRONTO, & GLOBALCACHE) aren't included.
+/// @param[in] simple true, list the simple protocols. false, list those that
+///   need a state array. i.e. A/Cs.
+/// @return The list. The values are the protocol numbers.
+String IRhtmlRenderer::protocolOptions(const bool simple) {
+  String result = "";
+  for (uint16_t i = 1; i <= decode_type_t::kLastDecodeType; i++) {
+    if (simple ^ hasACState((decode_type_t)i)) {
+      switch (i) {
+        case decode_type_t::RAW:
+        case decode_type_t::PRONTO:
+        case decode_type_t::GLOBALCACHE:
+          break;
+        default:
+          addOption(&result, uint64ToString(i), typeToString((decode_type_t)i));
+      }
+    }
+  }
+  return result;
+}
+
+/// Make the `<option>` list of protocols `IRac` supports.
+/// @return The list. The values are the protocol numbers.
+String IRhtmlRenderer::climateProtocolOptions(void) {
+  String result = "";
+  for (uint16_t i = 1; i <= decode_type_t::kLastDecodeType; i++)
+    if (IRac::isProtocolSupported((decode_type_t)i))
+      addOption(&result, uint64ToString(i), typeToString((decode_type_t)i));
+  return result;
+}
+
+/// Make the `<option>` list for an A/C model. i.e. "-1" (Default) to "6".
+/// @return The list.
+String IRhtmlRenderer::modelOptions(void) {
+  String result = "";
+  for (int16_t i = -1; i <= 6; i++) {
+    const String num = int64ToString(i);
+    switch (i) {
+      case -1: addOption(&result, num, "Default"); break;
+      case 0: addOption(&result, num, "Unknown"); break;
+      default: addOption(&result, num, num);
+    }
+  }
+  return result;
+}
+
+/// Make the `<option>` list of the common A/C operating modes.
+/// @return The list.
+String IRhtmlRenderer::modeOptions(void) {
+  String result = "";
+  for (int8_t i = -1; i <= (int8_t)stdAc::opmode_t::kLastOpmodeEnum; i++) {
+    const String mode = IRac::opmodeToString((stdAc::opmode_t)i);
+    addOption(&result, mode, mode);
+  }
+  return result;
+}
+
+/// Make the `<option>` list of the common A/C fan speeds.
+/// @return The list.
+String IRhtmlRenderer::fanspeedOptions(void) {
+  String result = "";
+  for (int8_t i = 0; i <= (int8_t)stdAc::fanspeed_t::kLastFanspeedEnum; i++) {
+    const String speed = IRac::fanspeedToString((stdAc::fanspeed_t)i);
+    addOption(&result, speed, speed);
+  }
+  return result;
+}
+
+/// Make the `<option>` list of the common A/C vertical swing settings.
+/// @return The list.
+String IRhtmlRenderer::swingvOptions(void) {
+  String result = "";
+  for (int8_t i = -1; i <= (int8_t)stdAc::swingv_t::kLastSwingvEnum; i++) {
+    const String swing = IRac::swingvToString((stdAc::swingv_t)i);
+    addOption(&result, swing, swing);
+  }
+  return result;
+}
+
+/// Make the `<option>` list of the common A/C horizontal swing settings.
+/// @return The list.
+String IRhtmlRenderer::swinghOptions(void) {
+  String result = "";
+  for (int8_t i = -1; i <= (int8_t)stdAc::swingh_t::kLastSwinghEnum; i++) {
+    const String swing = IRac::swinghToString((stdAc::swingh_t)i);
+    addOption(&result, swing, swing);
+  }
+  return result;
+}
@@ -0,0 +1,67 @@
+#ifndef IRHTMLRENDERER_H_
+#define IRHTMLRENDERER_H_
+
+// Copyright 2021 IRremoteESP8266 authors
+
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include "IRremoteESP8266.h"
+
+// Constants
+/// Size of the output buffer. Also the largest chunk `IRhtmlRenderer` writes.
+const uint16_t kHtmlRendererBufferSize = 512;
+
+/// Streams web pages from templates, without building them in memory.
+/// A template is a (flash) string with numbered fields, e.g. "{0}", in it.
+/// The static text is copied straight to the output, and a callback is asked
+/// to write the dynamic value of each field as it is reached.
+/// The output is collected in a fixed size buffer, and passed on in chunks.
+/// e.g. To a web server using chunked transfer encoding.
+/// It also makes the `<option>` lists for the common `<select>` menus, so
+/// they can be made once & reused, with the selected item marked as they are
+/// written.
+/// @note A '{' that isn't followed by digits & a '}' is just text. e.g. In
+///   JavaScript or CSS.
+class IRhtmlRenderer {
+ public:
+  /// A function that writes a chunk of the output somewhere.
+  typedef void (*WriteFn)(const char *data, const uint16_t length);
+  /// A function that writes the value of a field in a template.
+  typedef void (*FieldFn)(IRhtmlRenderer *html, void *arg,
+                          const uint16_t field);
+  explicit IRhtmlRenderer(WriteFn write);
+  void render(const char *tmpl, FieldFn field = NULL, void *arg = NULL);
+  void print(const char *str);
+  void print(const String &str);
+  void printP(const char *str);
+  void print(const char c);
+  void printNumber(const int32_t value);
+  void printEscaped(const String &str);
+  void printOptions(const String &options, const String &selected);
+  void printSelect(const char *name, const String &options,
+                   const String &selected);
+  void flush(void);
+  uint32_t length(void) const;
+  static void addOption(String *list, const String &value, const String &text);
+  static String boolOptions(void);
+  static String uintOptions(const uint16_t max);
+  static String protocolOptions(const bool simple);
+  static String climateProtocolOptions(void);
+  static String modelOptions(void);
+  static String modeOptions(void);
+  static String fanspeedOptions(void);
+  static String swingvOptions(void);
+  static String swinghOptions(void);
+#ifndef UNIT_TEST
+
+ private:
+#endif
+  WriteFn _write;  ///< Where to send each chunk of output.
+  char _buffer[kHtmlRendererBufferSize];  ///< Output not yet written.
+  uint16_t _used;  ///< Nr. of bytes of `_buffer` in use.
+  uint32_t _total;  ///< Nr. of bytes output so far.
+  void write(const char *data, uint16_t length);
+  static const char *findSelected(const char *options, const char *selected);
+};
+#endif  // IRHTMLRENDERER_H_
@@ -5,6 +5,7 @@
 
 #include "IRrecv.h"
 #include <stddef.h>
+#include <string.h>
 #ifndef UNIT_TEST
 #if defined(ESP8266)
 extern "C" {
@@ -19,6 +20,7 @@ extern "C" {
 #include <cassert>
 #endif  // UNIT_TEST
 #include "IRremoteESP8266.h"
+#include "IRsend.h"
 #include "IRutils.h"
 
 #ifdef UNIT_TEST
@@ -194,7 +196,10 @@ static void USE_IRAM_ATTR gpio_intr() {
 
   if (params.rcvstate == kIdleState) {
     params.rcvstate = kMarkState;
-    params.rawbuf[rawlen] = 1;
+    // Note how long it was quiet for before it, in case it is the next
+    // section of a message. See `IRrecv::setAssembly()`.
+    const uint32_t quiet = (now - start) / kRawTick;
+    params.rawbuf[rawlen] = (quiet > UINT16_MAX) ? UINT16_MAX : quiet;
   } else {
     if (now < start)
       params.rawbuf[rawlen] = (UINT32_MAX - start + now) / kRawTick;
@@ -297,8 +302,20 @@ IRrecv::IRrecv(const uint16_t recvpin, const uint16_t bufsize,
   }
 #if DECODE_HASH
   _unknown_threshold = kUnknownThreshold;
+  _hash_mode = kHashLegacy;
 #endif  // DECODE_HASH
   _tolerance = kTolerance;
+  _echo_source = NULL;
+  _dup_window = 0;
+  _dup_drop = true;
+  _adaptive = false;
+  _asm_buf = NULL;
+  _asm_size = 0;
+  _asm_len = 0;
+  _asm_sections = 0;
+  _asm_gap = kTimeoutMsAuto;
+  setCalibration(NULL, 0);
+  _cal_pending_count = 0;
 }
 
 /// Class destructor
@@ -315,6 +332,7 @@ IRrecv::~IRrecv(void) {
     delete[] params_save->rawbuf;
     delete params_save;
   }
+  delete[] _asm_buf;
 }
 
 /// Set up and (re)start the IR capture mechanism.
@@ -415,12 +433,366 @@ void IRrecv::copyIrParams(volatile irparams_t *src, irparams_t *dst) {
 /// @return The size of the buffer that is in use by the object.
 uint16_t IRrecv::getBufSize(void) { return params.bufsize; }
 
+/// Ignore the IR messages sent by an IRsend object, while still capturing.
+/// i.e. Keep receiving while transmitting, & discard the echo of what we sent,
+/// rather than disabling capture (and losing real messages) while sending.
+/// @param[in] irsend The sender to ignore, or NULL to ignore nothing.
+///   It must keep a record of what it sends. See `IRsend::setEchoLog()`.
+/// @note Only a capture that is entirely made of what was sent is ignored.
+///   One that overlaps a real message is decoded as normal, if it can be.
+void IRrecv::setEchoSource(IRsend *irsend) { _echo_source = irsend; }
+
+/// Is a capture just the echo of something we sent recently?
+/// If it is, that part of what was sent is marked as heard, so it can't hide a
+/// real message later. e.g. The same button being pressed again.
+/// @param[in] results The capture to check.
+/// @return true, if it is an echo. false, if not.
+bool IRrecv::matchEcho(const decode_results *results) {
+  IRsend *irsend = _echo_source;
+  if (irsend == NULL || irsend->_echo_log == NULL || results->overflow ||
+      results->rawlen <= kStartOffset || !irsend->echoRecent())
+    return false;
+  const uint16_t *log = irsend->_echo_log;
+  const uint16_t len = irsend->_echo_len;
+  const uint16_t count = results->rawlen - kStartOffset;
+  // Try each mark we sent, that hasn't been heard yet, as the start.
+  for (uint16_t start = irsend->_echo_used; start + count <= len; start += 2) {
+    uint16_t i = 0;
+    for (; i < count; i++) {
+      const uint32_t measured = results->rawbuf[kStartOffset + i];
+      if (!((i & 1) ? matchSpace(measured, log[start + i])
+                    : matchMark(measured, log[start + i])))
+        break;
+    }
+    if (i < count) continue;  // Not a match.
+    const uint16_t end = start + count;
+    // If the capture ended with a mark, what we sent next must have been a
+    // gap long enough to end the capture.
+    if ((end & 1) && end < len &&
+        !matchAtLeast(log[end] / kRawTick, MS_TO_USEC(params.timeout)))
+      continue;
+    irsend->_echo_used = (end + 1) & ~1;  // Round up to the next mark.
+    return true;
+  }
+  return false;
+}
+
+/// Recognise messages we have decoded very recently. e.g. A remote sending the
+/// same frame 2-3 times, as Sony & some A/C remotes do.
+/// @param[in] msecs How long (in mSeconds) after a message is first decoded,
+///   that the same message is considered a duplicate. 0 disables this.
+///   e.g. 250ms covers most protocols' repeats, but not a button being held.
+/// @param[in] drop Should `decode()` discard duplicates? If not, they are only
+///   flagged, via `decode_results.repeat`.
+void IRrecv::setDuplicateWindow(const uint16_t msecs, const bool drop) {
+  _dup_window = msecs;
+  _dup_drop = drop;
+  // Forget what we have seen already.
+  for (uint8_t i = 0; i < kDuplicateCacheSize; i++) _dup_hash[i] = 0;
+}
+
+/// Is a decoded message the same as one that was first decoded less than
+/// `_dup_window` mSeconds ago?
+/// If it is new, it is remembered, in place of the oldest message remembered.
+/// @param[in] results The decoded message.
+/// @return true, if it is a duplicate. false, if not.
+/// @note Expired messages must already have been forgotten.
+///   See `expireDuplicates()`.
+bool IRrecv::isDuplicate(const decode_results *results) {
+  // Hash the protocol, size, & data of the message.
+  uint32_t hash = kFnvBasis32;
+  hash = (hash * kFnvPrime32) ^ (uint32_t)results->decode_type;
+  hash = (hash * kFnvPrime32) ^ results->bits;
+  if (hasACState(results->decode_type)) {
+    for (uint16_t i = 0; i < results->bits / 8 && i < kStateSizeMax; i++)
+      hash = (hash * kFnvPrime32) ^ results->state[i];
+  } else {
+    hash = (hash * kFnvPrime32) ^ (uint32_t)results->value;
+    hash = (hash * kFnvPrime32) ^ (uint32_t)(results->value >> 32);
+  }
+  uint8_t oldest = 0;
+  uint32_t oldest_age = 0;
+  for (uint8_t i = 0; i < kDuplicateCacheSize; i++) {
+    if (_dup_hash[i] == 0) {  // Unused.
+      oldest = i;
+      oldest_age = UINT32_MAX;
+      continue;
+    }
+    if (_dup_hash[i] == hash) return true;
+    const uint32_t age = _dup_time[i].elapsed();
+    if (age > oldest_age) {
+      oldest = i;
+      oldest_age = age;
+    }
+  }
+  _dup_hash[oldest] = hash;
+  _dup_time[oldest].reset();
+  return false;
+}
+
+/// Forget the messages that were first decoded `_dup_window` mSeconds or more
+/// ago. `decode()` calls it each time it is polled, so a remembered message is
+/// forgotten long before its timer can wrap around & make it look new again.
+void IRrecv::expireDuplicates(void) {
+  const uint32_t window = MS_TO_USEC((uint32_t)_dup_window);
+  for (uint8_t i = 0; i < kDuplicateCacheSize; i++)
+    if (_dup_hash[i] && _dup_time[i].elapsed() >= window) _dup_hash[i] = 0;
+}
+
+/// Join messages that arrive as several captures back together, so they can
+/// be decoded. e.g. Daikin, Fujitsu, & other A/C protocols send a message in
+/// sections separated by gaps. A capture `timeout` shorter than those gaps
+/// splits the message, but the decoders need to see every section at once.
+/// When on, each capture is held as a section, & the next one is joined onto
+/// it if the silence between them is no longer than `max_gap`. The joined
+/// message is what is decoded & reported, once it decodes as a known protocol.
+/// That lets a short `timeout` report simple messages quickly, without
+/// breaking the protocols with long gaps.
+/// @param[in] bufsize Nr. of entries to hold the sections in. 0 turns it off.
+///   It needs to fit every section of the largest message. e.g. kRawBufAuto
+/// @param[in] max_gap The longest silence (mSeconds) between the sections of a
+///   message. The default covers every protocol enabled in this build.
+/// @return true, if it is set up. false, if the memory couldn't be allocated.
+/// @note A section that doesn't decode by itself is still reported as UNKNOWN
+///   when it arrives, as we can't know more will follow. See
+///   `setUnknownThreshold()` to hide them.
+/// @note While sections are held, a capture may be decoded up to
+///   `kAssembleMaxSections` times, which costs more CPU time.
+/// @note It only works if the next section is captured from its start. i.e.
+///   Capturing has to resume as soon as `decode()` is called, not after the
+///   section has been handled. So use the `save_buffer` constructor option,
+///   or give every `decode()` call a `save` buffer. Otherwise the next
+///   section has usually started before capturing resumes.
+bool IRrecv::setAssembly(const uint16_t bufsize, const uint8_t max_gap) {
+  delete[] _asm_buf;
+  _asm_buf = NULL;
+  _asm_size = 0;
+  _asm_sections = 0;
+  _asm_gap = std::min(max_gap, (uint8_t)kMaxTimeoutMs);
+  if (bufsize) {
+    _asm_buf = new uint16_t[bufsize];
+    if (_asm_buf == NULL) return false;
+    _asm_size = bufsize;
+  }
+  return true;
+}
+
+/// Hold a capture as the latest section of a message, & try to decode it
+/// joined onto the sections held before it.
+/// @param[in,out] results A ptr to the capture. `rawbuf[0]` must be the
+///   silence before it. If a joined message is decoded, it points to it.
+/// @param[in] max_skip Passed on to the decoders.
+/// @return true, if a joined message was decoded. false, if not.
+bool IRrecv::assemble(decode_results *results, uint8_t max_skip) {
+  const uint16_t len = results->rawlen;
+  if (results->overflow || len <= kStartOffset || len > _asm_size) {
+    _asm_sections = 0;
+    return false;
+  }
+  // Too long after the last section to be part of the same message?
+  if (results->rawbuf[0] > MS_TO_USEC(_asm_gap) / kRawTick) _asm_sections = 0;
+  // Make room for it by forgetting the oldest sections, if we need to.
+  while (_asm_sections &&
+         (_asm_sections >= kAssembleMaxSections ||
+          _asm_len + len > _asm_size)) {
+    const uint16_t used = (_asm_sections > 1) ? _asm_start[1] : _asm_len;
+    for (uint16_t i = used; i < _asm_len; i++)
+      _asm_buf[i - used] = _asm_buf[i];
+    _asm_len -= used;
+    _asm_sections--;
+    for (uint8_t i = 0; i < _asm_sections; i++)
+      _asm_start[i] = _asm_start[i + 1] - used;
+  }
+  if (!_asm_sections) _asm_len = 0;
+  // Its `rawbuf[0]` becomes the gap between it & the section before it.
+  _asm_start[_asm_sections++] = _asm_len;
+  for (uint16_t i = 0; i < len; i++) _asm_buf[_asm_len++] = results->rawbuf[i];
+  // Try it with all the sections before it first, then fewer & fewer.
+  // On its own is left to the caller.
+  volatile uint16_t *rawbuf = results->rawbuf;
+  for (uint8_t i = 0; i + 1 < _asm_sections; i++) {
+    results->rawbuf = _asm_buf + _asm_start[i];
+    results->rawlen = _asm_len - _asm_start[i];
+    if (decodeProtocols(results, max_skip) &&
+        results->decode_type != decode_type_t::UNKNOWN) {
+      _asm_sections = 0;  // They've been used up.
+      return true;
+    }
+  }
+  // No luck. Put it back how it was.
+  results->rawbuf = rawbuf;
+  results->rawlen = len;
+  return false;
+}
+
+/// Learn a simple message from a capture, so it can be sent again without
+/// keeping all of its raw timings. e.g. A button of an unsupported remote.
+/// The marks & spaces of the capture are grouped by their duration, to find
+/// the header, bit, & footer timings. Every frame of the capture must be the
+/// same, i.e. The frame may be repeated, but the message can't have several
+/// different sections.
+/// @param[in] results The capture to learn from. Usually an UNKNOWN message.
+/// @param[out] code Where to store what was learned.
+/// @return true, if it could be learned. false, if not. e.g. It uses Manchester
+///   coding, has more than `kLearnedMaxBytes` of data per frame, or a mark
+///   longer than `UINT16_MAX` uSeconds.
+/// @note This is a port of the analysis `tools/auto_analyse_raw_data.py` does.
+/// @see `IRsend::sendLearned()`
+bool IRrecv::analyseRaw(const decode_results *results, learned_code_t *code) {
+  if (results->overflow || results->rawlen < kStartOffset + 3) return false;
+  // Group the durations of the marks & spaces that could be data bits.
+  // i.e. Everything but the header (if any) & the gap of each frame.
+  uint32_t total[2][kLearnTimingClasses];  // In ticks.
+  uint16_t count[2][kLearnTimingClasses];
+  uint8_t classes[2] = {0, 0};
+  bool frame_start = true;
+  for (uint16_t i = kStartOffset; i < results->rawlen; i++) {
+    const uint8_t kind = (i - kStartOffset) & 1;  // 0 = mark, 1 = space.
+    const uint32_t ticks = results->rawbuf[i];
+    if (kind && ticks * kRawTick >= kLearnMinGap) {  // Between frames.
+      frame_start = true;
+      continue;
+    }
+    if (frame_start) {  // Possibly a header.
+      if (kind) frame_start = false;
+      continue;
+    }
+    uint8_t c = 0;
+    while (c < classes[kind] &&
+           !match(ticks, total[kind][c] * kRawTick / count[kind][c]))
+      c++;
+    if (c == classes[kind]) {  // Not like anything seen so far.
+      if (c >= kLearnTimingClasses) return false;  // Too varied.
+      classes[kind]++;
+      total[kind][c] = 0;
+      count[kind][c] = 0;
+    }
+    total[kind][c] += ticks;
+    count[kind][c]++;
+  }
+  if (!classes[0] || !classes[1]) return false;  // No data bits.
+  // The two most common durations of each kind, in uSecs.
+  uint32_t usecs[2][2];
+  uint16_t seconds[2] = {0, 0};  // How often the 2nd most common was seen.
+  for (uint8_t kind = 0; kind < 2; kind++) {
+    uint8_t first = 0;
+    uint8_t second = 0;
+    for (uint8_t c = 1; c < classes[kind]; c++)
+      if (count[kind][c] > count[kind][first]) first = c;
+    for (uint8_t c = 0; c < classes[kind]; c++)
+      if (c != first && count[kind][c] > seconds[kind]) {
+        second = c;
+        seconds[kind] = count[kind][c];
+      }
+    usecs[kind][0] = total[kind][first] * kRawTick / count[kind][first];
+    usecs[kind][1] = seconds[kind] ?
+        total[kind][second] * kRawTick / count[kind][second] : usecs[kind][0];
+  }
+  // The data is coded by whichever kind varies the most. The other kind should
+  // be the same for both a `0` & a `1`.
+  const uint8_t coded = (seconds[1] >= seconds[0]) ? 1 : 0;
+  const uint32_t zero = std::min(usecs[coded][0], usecs[coded][1]);
+  const uint32_t one = std::max(usecs[coded][0], usecs[coded][1]);
+  // Marks are sent with `IRsend::mark()`, so must fit in 16 bits.
+  if ((coded ? usecs[0][0] : one) > UINT16_MAX) return false;
+  code->zeromark = coded ? usecs[0][0] : zero;
+  code->onemark = coded ? usecs[0][0] : one;
+  code->zerospace = coded ? zero : usecs[1][0];
+  code->onespace = coded ? one : usecs[1][0];
+  // Now work out the rest, frame by frame.
+  uint16_t offset = learnFrame(results, kStartOffset, code);
+  if (!offset || !code->nbits) return false;
+  learned_code_t frame = *code;
+  code->repeat = 0;
+  while (offset < results->rawlen) {  // The rest must be repeats of it.
+    offset = learnFrame(results, offset, &frame);
+    if (!offset || frame.nbits != code->nbits ||
+        memcmp(frame.data, code->data, (code->nbits + 7) / 8))
+      return false;
+    if (!frame.hdrmark != !code->hdrmark ||
+        !frame.footermark != !code->footermark)
+      return false;
+    if (code->hdrmark && !(match(frame.hdrmark / kRawTick, code->hdrmark) &&
+                           match(frame.hdrspace / kRawTick, code->hdrspace)))
+      return false;
+    if (code->footermark &&
+        !match(frame.footermark / kRawTick, code->footermark))
+      return false;
+    code->repeat++;
+  }
+  if (!code->gap) code->gap = kDefaultMessageGap;  // We don't know it.
+  return true;
+}
+
+/// Learn the header, data, footer, & gap of a frame of a capture, given the
+/// timings of the data bits.
+/// @param[in] results The capture to learn from.
+/// @param[in] offset The index in the capture where the frame starts.
+/// @param[in,out] code The bit timings to use, & where to store the rest.
+/// @return The index of the next frame, or 0 if it couldn't be learned.
+///   e.g. A mark is too long to send.
+uint16_t IRrecv::learnFrame(const decode_results *results, uint16_t offset,
+                            learned_code_t *code) {
+  const uint16_t end = results->rawlen;
+  code->hdrmark = 0;
+  code->hdrspace = 0;
+  code->footermark = 0;
+  code->gap = 0;
+  code->nbits = 0;
+  memset(code->data, 0, kLearnedMaxBytes);
+  // Header
+  if (offset + 1 < end &&
+      !((match(results->rawbuf[offset], code->onemark) &&
+         match(results->rawbuf[offset + 1], code->onespace)) ||
+        (match(results->rawbuf[offset], code->zeromark) &&
+         match(results->rawbuf[offset + 1], code->zerospace)))) {
+    if (results->rawbuf[offset] * kRawTick > UINT16_MAX) return 0;
+    code->hdrmark = results->rawbuf[offset++] * kRawTick;
+    code->hdrspace = results->rawbuf[offset++] * kRawTick;
+  }
+  // Data
+  for (; offset + 1 < end; offset += 2) {
+    bool one;
+    if (match(results->rawbuf[offset], code->onemark) &&
+        match(results->rawbuf[offset + 1], code->onespace))
+      one = true;
+    else if (match(results->rawbuf[offset], code->zeromark) &&
+             match(results->rawbuf[offset + 1], code->zerospace))
+      one = false;
+    else
+      break;  // Not a data bit, so it must be the footer.
+    if (code->nbits >= kLearnedMaxBytes * 8) return 0;  // Too big.
+    if (one) code->data[code->nbits / 8] |= 0x80 >> (code->nbits % 8);
+    code->nbits++;
+  }
+  // Footer
+  if (offset < end) {
+    if (results->rawbuf[offset] * kRawTick > UINT16_MAX) return 0;
+    code->footermark = results->rawbuf[offset++] * kRawTick;
+  }
+  if (offset < end) code->gap = results->rawbuf[offset++] * kRawTick;
+  return offset;
+}
+
 #if DECODE_HASH
 /// Set the minimum length we will consider for reporting UNKNOWN message types.
 /// @param[in] length Min nr. of mark/space pulses required to be considered.
 void IRrecv::setUnknownThreshold(const uint16_t length) {
   _unknown_threshold = length;
 }
+
+/// Set how UNKNOWN messages are hashed by `decodeHash()`.
+/// @param[in] mode `kHashLegacy` (the default), or `kHashLogBuckets`.
+///   `kHashLegacy` makes the same 32-bit values as previous versions.
+///   `kHashLogBuckets` makes 64-bit values, that are far less likely to
+///   collide, but differ from the values `kHashLegacy` makes.
+void IRrecv::setHashMode(const uint8_t mode) {
+  _hash_mode = (mode == kHashLogBuckets) ? kHashLogBuckets : kHashLegacy;
+}
+
+/// Get how UNKNOWN messages are hashed by `decodeHash()`.
+/// @return `kHashLegacy` or `kHashLogBuckets`.
+uint8_t IRrecv::getHashMode(void) { return _hash_mode; }
 #endif  // DECODE_HASH
 
 
@@ -434,6 +806,185 @@ void IRrecv::setTolerance(const uint8_t percent) {
 /// @return A integer percentage.
 uint8_t IRrecv::getTolerance(void) { return _tolerance; }
 
+/// Set if we learn & use how each protocol's timings are distorted.
+/// Cheap receivers (and remotes) often stretch marks & shrink spaces by
+/// 50-150us, or run at a slightly wrong speed. When on, every frame matched by
+/// `matchGeneric()` etc., in a message that `decode()` then accepts, updates a
+/// running estimate of the scale & excess of its timings. Once a few have been
+/// seen, later frames with the same timings are matched against the corrected
+/// timings instead of the usual ones.
+/// This lets a lower tolerance (`setTolerance()`) be used, which means fewer
+/// false matches & protocol decoders can reject a message sooner.
+/// e.g. Learn with the usual tolerance, then lower it.
+/// @param[in] on true to learn & use corrections. false (the default) to only
+///   use the protocols' usual timings.
+/// @note Protocols that don't use `matchGeneric()` aren't affected.
+/// @note If the receiver or remote changes, forget what was learnt with
+///   `setCalibration(NULL, 0)`, as the usual timings are no longer matched.
+/// @see getCalibration() & setCalibration() to save & restore what is learnt.
+void IRrecv::setAdaptiveTiming(const bool on) { _adaptive = on; }
+
+/// Get if we learn & use how each protocol's timings are distorted.
+/// @return true, if we do. false, if not.
+bool IRrecv::getAdaptiveTiming(void) { return _adaptive; }
+
+/// Get what adaptive timing calibration has learnt. e.g. To save it.
+/// @param[out] table Where to copy it to. It needs `kCalibrationSlots` entries.
+/// @return The nr. of entries in use. i.e. That were learnt from something.
+uint8_t IRrecv::getCalibration(timing_calibration_t *table) {
+  uint8_t used = 0;
+  for (uint8_t i = 0; i < kCalibrationSlots; i++) {
+    table[i] = _calibration[i];
+    if (_calibration[i].samples) used++;
+  }
+  return used;
+}
+
+/// Set what adaptive timing calibration knows. e.g. Restore a saved copy.
+/// @param[in] table The entries to use. (from `getCalibration()`)
+///   NULL forgets everything learnt so far.
+/// @param[in] count The nr. of entries in `table`.
+/// @note Out of range scales & excesses are limited to what `calibrate()`
+///   could have learnt.
+void IRrecv::setCalibration(const timing_calibration_t *table,
+                            const uint8_t count) {
+  for (uint8_t i = 0; i < kCalibrationSlots; i++) {
+    if (table != NULL && i < count) {
+      _calibration[i] = table[i];
+      _calibration[i].scale = std::min(
+          std::max(table[i].scale,
+                   (uint16_t)(kCalibrationUnity - kCalibrationMaxSkew)),
+          (uint16_t)(kCalibrationUnity + kCalibrationMaxSkew));
+      _calibration[i].excess = std::min(
+          std::max(table[i].excess, (int16_t)-kCalibrationMaxExcess),
+          kCalibrationMaxExcess);
+    } else {
+      _calibration[i].id = 0;
+      _calibration[i].scale = kCalibrationUnity;
+      _calibration[i].excess = 0;
+      _calibration[i].samples = 0;
+    }
+  }
+}
+
+/// Find what we have learnt about a set of timings.
+/// @param[in] id The hash of the timings.
+/// @return A ptr to the entry, or NULL if there isn't one.
+timing_calibration_t *IRrecv::findCalibration(const uint16_t id) {
+  for (uint8_t i = 0; i < kCalibrationSlots; i++)
+    if (_calibration[i].samples && _calibration[i].id == id)
+      return &_calibration[i];
+  return NULL;
+}
+
+/// Work out the calibration of a set of timings from a frame that matched them.
+/// It is held until the decoder has finished with the message. See `accept()`.
+/// Durations are assumed to be `scale` times their expected value, with marks
+/// `excess` uSecs longer, and spaces `excess` uSecs shorter, than that.
+/// @param[in] data_ptr A pointer to the start of the frame in the capture.
+/// @param[in] id The hash of the timings.
+/// @param[in] nbits Nr. of data bits in the frame.
+/// @param[in] hdrmark Nr. of uSeconds for the expected header mark signal.
+/// @param[in] hdrspace Nr. of uSeconds for the expected header space signal.
+/// @param[in] onemark Nr. of uSeconds in an expected mark signal for a '1' bit.
+/// @param[in] onespace Nr. of uSecs in an expected space signal for a '1' bit.
+/// @param[in] zeromark Nr. of uSecs in an expected mark signal for a '0' bit.
+/// @param[in] zerospace Nr. of uSecs in an expected space signal for a '0' bit.
+/// @param[in] footermark Nr. of uSeconds for the expected footer mark signal.
+/// @note The footer space isn't used, as it is often an open ended gap.
+void IRrecv::calibrate(volatile uint16_t *data_ptr, const uint16_t id,
+                       const uint16_t nbits,
+                       const uint16_t hdrmark, const uint32_t hdrspace,
+                       const uint16_t onemark, const uint32_t onespace,
+                       const uint16_t zeromark, const uint32_t zerospace,
+                       const uint16_t footermark) {
+  // Totals of what was measured & expected. [0] is marks, [1] is spaces.
+  uint32_t measured[2] = {0, 0};
+  uint32_t expected[2] = {0, 0};
+  uint16_t count[2] = {0, 0};
+  uint16_t i = 0;
+  if (hdrmark) {
+    measured[0] += *(data_ptr + i++) * kRawTick;
+    expected[0] += hdrmark;
+    count[0]++;
+  }
+  if (hdrspace) {
+    measured[1] += *(data_ptr + i++) * kRawTick;
+    expected[1] += hdrspace;
+    count[1]++;
+  }
+  // Same as _matchTimings(). i.e. Is the data section followed by a space?
+  const bool kexpectspace = footermark || (onespace != zerospace);
+  const uint16_t data_end = i + nbits * 2 - (kexpectspace ? 0 : 1);
+  for (uint8_t space = 0; i < data_end; i++, space ^= 1) {
+    const uint32_t usecs = *(data_ptr + i) * kRawTick;
+    const uint32_t one = space ? onespace : onemark;
+    const uint32_t zero = space ? zerospace : zeromark;
+    // It matched one of them, so assume it was the closest.
+    const uint32_t diff_one = (usecs > one) ? usecs - one : one - usecs;
+    const uint32_t diff_zero = (usecs > zero) ? usecs - zero : zero - usecs;
+    measured[space] += usecs;
+    expected[space] += (diff_one <= diff_zero) ? one : zero;
+    count[space]++;
+  }
+  if (footermark) {
+    measured[0] += *(data_ptr + i) * kRawTick;
+    expected[0] += footermark;
+    count[0]++;
+  }
+  if (!count[0] || !count[1]) return;  // Can't tell scale & excess apart.
+  // Compare the average mark & space, so the excess of each cancels out.
+  const uint32_t avg_mark = measured[0] / count[0];
+  const uint32_t avg_space = measured[1] / count[1];
+  const uint32_t exp_mark = expected[0] / count[0];
+  const uint32_t exp_space = expected[1] / count[1];
+  int32_t scale = ((avg_mark + avg_space) * kCalibrationUnity) /
+      (exp_mark + exp_space);
+  scale = std::min(std::max(scale, (int32_t)(kCalibrationUnity -
+                                             kCalibrationMaxSkew)),
+                   (int32_t)(kCalibrationUnity + kCalibrationMaxSkew));
+  int32_t excess = (int32_t)avg_mark -
+      (int32_t)(exp_mark * scale / kCalibrationUnity);
+  excess = std::min(std::max(excess, (int32_t)-kCalibrationMaxExcess),
+                    (int32_t)kCalibrationMaxExcess);
+
+  if (_cal_pending_count >= kCalibrationPending) return;  // No room.
+  timing_calibration_t *pending = &_cal_pending[_cal_pending_count++];
+  pending->id = id;
+  pending->scale = scale;
+  pending->excess = excess;
+  pending->samples = 1;
+}
+
+/// Finish a decoder's attempt at a message. Only if it was decoded, is what
+/// was learnt from its frames (by `calibrate()`) added to the calibration.
+/// @param[in] decoded Did the decoder accept the message?
+/// @return The same as `decoded`.
+bool IRrecv::accept(const bool decoded) {
+  for (uint8_t i = 0; decoded && i < _cal_pending_count; i++) {
+    const timing_calibration_t *pending = &_cal_pending[i];
+    int32_t scale = pending->scale;
+    int32_t excess = pending->excess;
+    timing_calibration_t *cal = findCalibration(pending->id);
+    if (cal == NULL) {  // New timings, so replace the least used entry.
+      cal = &_calibration[0];
+      for (uint8_t j = 1; j < kCalibrationSlots; j++)
+        if (_calibration[j].samples < cal->samples) cal = &_calibration[j];
+      cal->id = pending->id;
+      cal->samples = 0;
+    }
+    if (cal->samples) {  // A running average, so one odd frame matters less.
+      scale = cal->scale + (scale - cal->scale) / 4;
+      excess = cal->excess + (excess - cal->excess) / 4;
+    }
+    cal->scale = scale;
+    cal->excess = excess;
+    if (cal->samples < UINT8_MAX) cal->samples++;
+  }
+  _cal_pending_count = 0;
+  return decoded;
+}
+
 #if ENABLE_NOISE_FILTER_OPTION
 /// Remove or merge pulses in the capture buffer that are too short.
 /// @param[in,out] results Ptr to the decode_results we are going to filter.
@@ -503,8 +1054,30 @@ void IRrecv::crudeNoiseFilter(decode_results *results, const uint16_t floor) {
 ///     150 - 200 usecs expect broken protocols.
 ///     At 200+ usecs, you **have** protocols you can't decode!!
 /// @return A boolean indicating if an IR message is ready or not.
+/// @note Messages decoded very recently may be flagged as a repeat, or
+///   ignored. See `setDuplicateWindow()`.
 bool IRrecv::decode(decode_results *results, irparams_t *save,
                     uint8_t max_skip, uint16_t noise_floor) {
+  if (_dup_window) expireDuplicates();
+  if (!_decode(results, save, max_skip, noise_floor)) return false;
+  // A whole message by itself means what we held wasn't the start of one.
+  if (results->decode_type != decode_type_t::UNKNOWN) _asm_sections = 0;
+  // Handle duplicates of what we decoded recently, if asked to.
+  if (_dup_window && isDuplicate(results)) {
+    results->repeat = true;
+    if (_dup_drop) {
+      // Only resume if `_decode()` didn't, so we can capture the next one.
+      if (save == NULL && params_save == NULL) resume();
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Decodes the received IR message, regardless of whether we've seen it before.
+/// @see decode() for the parameters & return value.
+bool IRrecv::_decode(decode_results *results, irparams_t *save,
+                     uint8_t max_skip, uint16_t noise_floor) {
   // Proceed only if an IR message been received.
 #ifndef UNIT_TEST
   if (params.rcvstate != kStopState) return false;
@@ -544,6 +1117,30 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
     results->overflow = save->overflow;
   }
 
+#if ENABLE_NOISE_FILTER_OPTION
+  crudeNoiseFilter(results, noise_floor);
+#endif  // ENABLE_NOISE_FILTER_OPTION
+  // Ignore the echo of our own transmissions, if asked to.
+  if (matchEcho(results)) {
+    _asm_sections = 0;  // It came between us & anything we were holding.
+    if (!resumed) resume();
+    return false;
+  }
+  // Try it as the next section of a message we've been holding, if asked to.
+  if (_asm_size && assemble(results, max_skip)) return true;
+  if (decodeProtocols(results, max_skip)) return true;
+  // Throw away and start over
+  if (!resumed)  // Check if we have already resumed.
+    resume();
+  return false;
+}
+
+/// Try all the enabled protocol decoders on a capture.
+/// @param[in,out] results A ptr to where the capture is & the decode goes.
+/// @param[in] max_skip Maximum Nr. of pulses at the begining of a capture we
+///   can skip when attempting to find a protocol we can successfully decode.
+/// @return true, if it was decoded. false, if not.
+bool IRrecv::decodeProtocols(decode_results *results, uint8_t max_skip) {
   // Reset any previously partially processed results.
   results->decode_type = UNKNOWN;
   results->bits = 0;
@@ -551,21 +1148,21 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
   results->address = 0;
   results->command = 0;
   results->repeat = false;
+  _cal_pending_count = 0;  // e.g. From a decoder called directly.
 
-#if ENABLE_NOISE_FILTER_OPTION
-  crudeNoiseFilter(results, noise_floor);
-#endif  // ENABLE_NOISE_FILTER_OPTION
   // Keep looking for protocols until we've run out of entries to skip or we
   // find a valid protocol message.
+  // Never skip past the end of the capture, otherwise the decoders' unsigned
+  // `rawlen - offset` calculations wrap around & read beyond the buffer.
   for (uint16_t offset = kStartOffset;
-       offset <= (max_skip * 2) + kStartOffset;
+       offset <= (max_skip * 2) + kStartOffset && offset < results->rawlen;
        offset += 2) {
 #if DECODE_AIWA_RC_T501
     DPRINTLN("Attempting Aiwa RC T501 decode");
     // Try decodeAiwaRCT501() before decodeSanyoLC7461() & decodeNEC()
     // because the protocols are similar. This protocol is more specific than
     // those ones, so should go before them.
-    if (decodeAiwaRCT501(results, offset)) return true;
+    if (accept(decodeAiwaRCT501(results, offset))) return true;
 #endif
 #if DECODE_SANYO
     DPRINTLN("Attempting Sanyo LC7461 decode");
@@ -573,7 +1170,7 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
     // similar in timings & structure, but the Sanyo one is much longer than the
     // NEC protocol (42 vs 32 bits) so this one should be tried first to try to
     // reduce false detection as a NEC packet.
-    if (decodeSanyoLC7461(results, offset)) return true;
+    if (accept(decodeSanyoLC7461(results, offset))) return true;
 #endif
 #if DECODE_CARRIER_AC
     DPRINTLN("Attempting Carrier AC decode");
@@ -581,7 +1178,7 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
     // similar in timings & structure, but the Carrier one is much longer than
     // the NEC protocol (3x32 bits vs 1x32 bits) so this one should be tried
     // first to try to reduce false detection as a NEC packet.
-    if (decodeCarrierAC(results, offset)) return true;
+    if (accept(decodeCarrierAC(results, offset))) return true;
 #endif
 #if DECODE_PIONEER
     DPRINTLN("Attempting Pioneer decode");
@@ -589,7 +1186,7 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
     // similar in timings & structure, but the Pioneer one is much longer than
     // the NEC protocol (2x32 bits vs 1x32 bits) so this one should be tried
     // first to try to reduce false detection as a NEC packet.
-    if (decodePioneer(results, offset)) return true;
+    if (accept(decodePioneer(results, offset))) return true;
 #endif
 #if DECODE_EPSON
   DPRINTLN("Attempting Epson decode");
@@ -597,144 +1194,147 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
   // similar in timings & structure, but the Epson one is much longer than the
   // NEC protocol (3x32 identical bits vs 1x32 bits) so this one should be tried
   // first to try to reduce false detection as a NEC packet.
-  if (decodeEpson(results, offset)) return true;
+  if (accept(decodeEpson(results, offset))) return true;
 #endif
 #if DECODE_NEC
     DPRINTLN("Attempting NEC decode");
-    if (decodeNEC(results, offset)) return true;
+    if (accept(decodeNEC(results, offset))) return true;
 #endif
 #if DECODE_MILESTAG2
     DPRINTLN("Attempting MilesTag2 decode");
   // Try decodeMilestag2() before decodeSony() because the protocols are
   // similar in timings & structure, but the Miles one differs in nbits
   // so this one should be tried first to try to reduce false detection
-    if (decodeMilestag2(results, offset, kMilesTag2MsgBits) ||
-        decodeMilestag2(results, offset, kMilesTag2ShotBits)) return true;
+    if (accept(decodeMilestag2(results, offset, kMilesTag2MsgBits)) ||
+        accept(decodeMilestag2(results, offset, kMilesTag2ShotBits)))
+      return true;
 #endif
 #if DECODE_SONY
     DPRINTLN("Attempting Sony decode");
-    if (decodeSony(results, offset)) return true;
+    if (accept(decodeSony(results, offset))) return true;
 #endif
 #if DECODE_MITSUBISHI
     DPRINTLN("Attempting Mitsubishi decode");
-    if (decodeMitsubishi(results, offset)) return true;
+    if (accept(decodeMitsubishi(results, offset))) return true;
 #endif
 #if DECODE_MITSUBISHI_AC
     DPRINTLN("Attempting Mitsubishi AC decode");
-    if (decodeMitsubishiAC(results, offset)) return true;
+    if (accept(decodeMitsubishiAC(results, offset))) return true;
 #endif
 #if DECODE_MITSUBISHI2
     DPRINTLN("Attempting Mitsubishi2 decode");
-    if (decodeMitsubishi2(results, offset)) return true;
+    if (accept(decodeMitsubishi2(results, offset))) return true;
 #endif
 #if DECODE_RC5
     DPRINTLN("Attempting RC5 decode");
-    if (decodeRC5(results, offset)) return true;
+    if (accept(decodeRC5(results, offset))) return true;
 #endif
 #if DECODE_RC6
     DPRINTLN("Attempting RC6 decode");
-    if (decodeRC6(results, offset)) return true;
+    if (accept(decodeRC6(results, offset))) return true;
 #endif
 #if DECODE_RCMM
     DPRINTLN("Attempting RC-MM decode");
-    if (decodeRCMM(results, offset)) return true;
+    if (accept(decodeRCMM(results, offset))) return true;
 #endif
 #if DECODE_FUJITSU_AC
     // Fujitsu A/C needs to precede Panasonic and Denon as it has a short
     // message which looks exactly the same as a Panasonic/Denon message.
     DPRINTLN("Attempting Fujitsu A/C decode");
-    if (decodeFujitsuAC(results, offset)) return true;
+    if (accept(decodeFujitsuAC(results, offset))) return true;
 #endif
 #if DECODE_DENON
     // Denon needs to precede Panasonic as it is a special case of Panasonic.
     DPRINTLN("Attempting Denon decode");
-    if (decodeDenon(results, offset, kDenon48Bits) ||
-        decodeDenon(results, offset, kDenonBits) ||
-        decodeDenon(results, offset, kDenonLegacyBits))
+    if (accept(decodeDenon(results, offset, kDenon48Bits)) ||
+        accept(decodeDenon(results, offset, kDenonBits)) ||
+        accept(decodeDenon(results, offset, kDenonLegacyBits)))
       return true;
 #endif
 #if DECODE_PANASONIC
     DPRINTLN("Attempting Panasonic decode");
-    if (decodePanasonic(results, offset)) return true;
+    if (accept(decodePanasonic(results, offset))) return true;
 #endif
 #if DECODE_LG
     DPRINTLN("Attempting LG (28-bit) decode");
-    if (decodeLG(results, offset, kLgBits, true)) return true;
+    if (accept(decodeLG(results, offset, kLgBits, true))) return true;
     DPRINTLN("Attempting LG (32-bit) decode");
     // LG32 should be tried before Samsung
-    if (decodeLG(results, offset, kLg32Bits, true)) return true;
+    if (accept(decodeLG(results, offset, kLg32Bits, true))) return true;
 #endif
 #if DECODE_GICABLE
     // Note: Needs to happen before JVC decode, because it looks similar except
     //       with a required NEC-like repeat code.
     DPRINTLN("Attempting GICable decode");
-    if (decodeGICable(results, offset)) return true;
+    if (accept(decodeGICable(results, offset))) return true;
 #endif
 #if DECODE_JVC
     DPRINTLN("Attempting JVC decode");
-    if (decodeJVC(results, offset)) return true;
+    if (accept(decodeJVC(results, offset))) return true;
 #endif
 #if DECODE_SAMSUNG
     DPRINTLN("Attempting SAMSUNG decode");
-    if (decodeSAMSUNG(results, offset)) return true;
+    if (accept(decodeSAMSUNG(results, offset))) return true;
 #endif
 #if DECODE_SAMSUNG36
     DPRINTLN("Attempting Samsung36 decode");
-    if (decodeSamsung36(results, offset)) return true;
+    if (accept(decodeSamsung36(results, offset))) return true;
 #endif
 #if DECODE_WHYNTER
     DPRINTLN("Attempting Whynter decode");
-    if (decodeWhynter(results, offset)) return true;
+    if (accept(decodeWhynter(results, offset))) return true;
 #endif
 #if DECODE_DISH
     DPRINTLN("Attempting DISH decode");
-    if (decodeDISH(results, offset)) return true;
+    if (accept(decodeDISH(results, offset))) return true;
 #endif
 #if DECODE_SHARP
     DPRINTLN("Attempting Sharp decode");
-    if (decodeSharp(results, offset)) return true;
+    if (accept(decodeSharp(results, offset))) return true;
 #endif
 #if DECODE_COOLIX
     DPRINTLN("Attempting Coolix decode");
-    if (decodeCOOLIX(results, offset)) return true;
+    if (accept(decodeCOOLIX(results, offset))) return true;
 #endif
 #if DECODE_NIKAI
     DPRINTLN("Attempting Nikai decode");
-    if (decodeNikai(results, offset)) return true;
+    if (accept(decodeNikai(results, offset))) return true;
 #endif
 #if DECODE_KELVINATOR
     // Kelvinator based-devices use a similar code to Gree ones, to avoid false
     // matches this needs to happen before decodeGree().
     DPRINTLN("Attempting Kelvinator decode");
-    if (decodeKelvinator(results, offset)) return true;
+    if (accept(decodeKelvinator(results, offset))) return true;
 #endif
 #if DECODE_DAIKIN
     DPRINTLN("Attempting Daikin decode");
-    if (decodeDaikin(results, offset)) return true;
+    if (accept(decodeDaikin(results, offset))) return true;
 #endif
 #if DECODE_DAIKIN2
     DPRINTLN("Attempting Daikin2 decode");
-    if (decodeDaikin2(results, offset)) return true;
+    if (accept(decodeDaikin2(results, offset))) return true;
 #endif
 #if DECODE_DAIKIN216
     DPRINTLN("Attempting Daikin216 decode");
-    if (decodeDaikin216(results, offset)) return true;
+    if (accept(decodeDaikin216(results, offset))) return true;
 #endif
 #if DECODE_TOSHIBA_AC
     DPRINTLN("Attempting Toshiba AC 72bit decode");
-    if (decodeToshibaAC(results, offset)) return true;
+    if (accept(decodeToshibaAC(results, offset))) return true;
     DPRINTLN("Attempting Toshiba AC 80bit decode");
-    if (decodeToshibaAC(results, offset, kToshibaACBitsLong)) return true;
+    if (accept(decodeToshibaAC(results, offset, kToshibaACBitsLong)))
+      return true;
     DPRINTLN("Attempting Toshiba AC 56bit decode");
-    if (decodeToshibaAC(results, offset, kToshibaACBitsShort)) return true;
+    if (accept(decodeToshibaAC(results, offset, kToshibaACBitsShort)))
+      return true;
 #endif
 #if DECODE_MIDEA
     DPRINTLN("Attempting Midea decode");
-    if (decodeMidea(results, offset)) return true;
+    if (accept(decodeMidea(results, offset))) return true;
 #endif
 #if DECODE_MAGIQUEST
     DPRINTLN("Attempting Magiquest decode");
-    if (decodeMagiQuest(results, offset)) return true;
+    if (accept(decodeMagiQuest(results, offset))) return true;
 #endif
   /* NOTE: Disabled due to poor quality.
 #if DECODE_SANYO
@@ -742,7 +1342,7 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
     // *IF* you are going to enable it, do it near last to avoid false positive
     // matches.
     DPRINTLN("Attempting Sanyo SA8650B decode");
-    if (decodeSanyo(results, offset))
+    if (accept(decodeSanyo(results, offset)))
       return true;
 #endif
   */
@@ -753,276 +1353,279 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
     // other protocols that are NEC-like as well, as turning off strict may
     // cause this to match other valid protocols.
     DPRINTLN("Attempting NEC (non-strict) decode");
-    if (decodeNEC(results, offset, kNECBits, false)) {
+    if (accept(decodeNEC(results, offset, kNECBits, false))) {
       results->decode_type = NEC_LIKE;
       return true;
     }
 #endif
 #if DECODE_LASERTAG
     DPRINTLN("Attempting Lasertag decode");
-    if (decodeLasertag(results, offset)) return true;
+    if (accept(decodeLasertag(results, offset))) return true;
 #endif
 #if DECODE_GREE
     // Gree based-devices use a similar code to Kelvinator ones, to avoid false
     // matches this needs to happen after decodeKelvinator().
     DPRINTLN("Attempting Gree decode");
-    if (decodeGree(results, offset)) return true;
+    if (accept(decodeGree(results, offset))) return true;
 #endif
 #if DECODE_HAIER_AC
     DPRINTLN("Attempting Haier AC decode");
-    if (decodeHaierAC(results, offset)) return true;
+    if (accept(decodeHaierAC(results, offset))) return true;
 #endif
 #if DECODE_HAIER_AC_YRW02
     DPRINTLN("Attempting Haier AC YR-W02 decode");
-    if (decodeHaierACYRW02(results, offset)) return true;
+    if (accept(decodeHaierACYRW02(results, offset))) return true;
 #endif
 #if DECODE_HAIER_AC176
     DPRINTLN("Attempting Haier AC 176 bit decode");
-    if (decodeHaierAC176(results, offset)) return true;
+    if (accept(decodeHaierAC176(results, offset))) return true;
 #endif  // DECODE_HAIER_AC176
 #if DECODE_HITACHI_AC424
     // HitachiAc424 should be checked before HitachiAC, HitachiAC2,
     // & HitachiAC184
     DPRINTLN("Attempting Hitachi AC 424 decode");
-    if (decodeHitachiAc424(results, offset, kHitachiAc424Bits)) return true;
+    if (accept(decodeHitachiAc424(results, offset, kHitachiAc424Bits)))
+      return true;
 #endif  // DECODE_HITACHI_AC424
 #if DECODE_MITSUBISHI136
     // Needs to happen before HitachiAc3 decode.
     DPRINTLN("Attempting Mitsubishi136 decode");
-    if (decodeMitsubishi136(results, offset)) return true;
+    if (accept(decodeMitsubishi136(results, offset))) return true;
 #endif  // DECODE_MITSUBISHI136
 #if DECODE_HITACHI_AC3
     // HitachiAc3 should be checked before HitachiAC & HitachiAC2
     // Attempt normal before the short version.
     DPRINTLN("Attempting Hitachi AC3 decode");
     // Order these in decreasing bit size, as it is more optimal.
-    if (decodeHitachiAc3(results, offset, kHitachiAc3Bits) ||
-        decodeHitachiAc3(results, offset, kHitachiAc3Bits - 4 * 8) ||
-        decodeHitachiAc3(results, offset, kHitachiAc3Bits - 6 * 8) ||
-        decodeHitachiAc3(results, offset, kHitachiAc3MinBits + 2 * 8) ||
-        decodeHitachiAc3(results, offset, kHitachiAc3MinBits))
+    if (accept(decodeHitachiAc3(results, offset, kHitachiAc3Bits)) ||
+        accept(decodeHitachiAc3(results, offset, kHitachiAc3Bits - 4 * 8)) ||
+        accept(decodeHitachiAc3(results, offset, kHitachiAc3Bits - 6 * 8)) ||
+        accept(decodeHitachiAc3(results, offset, kHitachiAc3MinBits + 2 * 8)) ||
+        accept(decodeHitachiAc3(results, offset, kHitachiAc3MinBits)))
       return true;
 #endif  // DECODE_HITACHI_AC3
 #if DECODE_HITACHI_AC344
     // HitachiAC344 should be checked before HitachiAC
     DPRINTLN("Attempting Hitachi AC344 decode");
-    if (decodeHitachiAC(results, offset, kHitachiAc344Bits, true, false))
+    if (accept(decodeHitachiAC(results, offset, kHitachiAc344Bits)))
       return true;
 #endif  // DECODE_HITACHI_AC344
 #if DECODE_HITACHI_AC2
     // HitachiAC2 should be checked before HitachiAC
     DPRINTLN("Attempting Hitachi AC2 decode");
-    if (decodeHitachiAC(results, offset, kHitachiAc2Bits)) return true;
+    if (accept(decodeHitachiAC(results, offset, kHitachiAc2Bits))) return true;
 #endif  // DECODE_HITACHI_AC2
 #if DECODE_HITACHI_AC
     DPRINTLN("Attempting Hitachi AC decode");
-    if (decodeHitachiAC(results, offset, kHitachiAcBits)) return true;
+    if (accept(decodeHitachiAC(results, offset, kHitachiAcBits))) return true;
 #endif
 #if DECODE_HITACHI_AC1
     DPRINTLN("Attempting Hitachi AC1 decode");
-    if (decodeHitachiAC(results, offset, kHitachiAc1Bits)) return true;
+    if (accept(decodeHitachiAC(results, offset, kHitachiAc1Bits))) return true;
 #endif
 #if DECODE_WHIRLPOOL_AC
     DPRINTLN("Attempting Whirlpool AC decode");
-    if (decodeWhirlpoolAC(results, offset)) return true;
+    if (accept(decodeWhirlpoolAC(results, offset))) return true;
 #endif
 #if DECODE_SAMSUNG_AC
     DPRINTLN("Attempting Samsung AC (extended) decode");
     // Check the extended size first, as it should fail fast due to longer
     // length.
-    if (decodeSamsungAC(results, offset, kSamsungAcExtendedBits, false))
+    if (accept(decodeSamsungAC(results, offset, kSamsungAcExtendedBits, false)))
       return true;
     // Now check for the more common length.
     DPRINTLN("Attempting Samsung AC decode");
-    if (decodeSamsungAC(results, offset, kSamsungAcBits)) return true;
+    if (accept(decodeSamsungAC(results, offset, kSamsungAcBits))) return true;
 #endif
 #if DECODE_ELECTRA_AC
     DPRINTLN("Attempting Electra AC decode");
-    if (decodeElectraAC(results, offset)) return true;
+    if (accept(decodeElectraAC(results, offset))) return true;
 #endif
 #if DECODE_PANASONIC_AC
     DPRINTLN("Attempting Panasonic AC decode");
-    if (decodePanasonicAC(results, offset)) return true;
+    if (accept(decodePanasonicAC(results, offset))) return true;
     DPRINTLN("Attempting Panasonic AC short decode");
-    if (decodePanasonicAC(results, offset, kPanasonicAcShortBits)) return true;
+    if (accept(decodePanasonicAC(results, offset, kPanasonicAcShortBits)))
+      return true;
 #endif
 #if DECODE_LUTRON
     DPRINTLN("Attempting Lutron decode");
-    if (decodeLutron(results, offset)) return true;
+    if (accept(decodeLutron(results, offset))) return true;
 #endif
 #if DECODE_MWM
     DPRINTLN("Attempting MWM decode");
-    if (decodeMWM(results, offset)) return true;
+    if (accept(decodeMWM(results, offset))) return true;
 #endif
 #if DECODE_VESTEL_AC
     DPRINTLN("Attempting Vestel AC decode");
-    if (decodeVestelAc(results, offset)) return true;
+    if (accept(decodeVestelAc(results, offset))) return true;
 #endif
 #if DECODE_MITSUBISHI112 || DECODE_TCL112AC
     // Mitsubish112 and Tcl112 share the same decoder.
     DPRINTLN("Attempting Mitsubishi112/TCL112AC decode");
-    if (decodeMitsubishi112(results, offset)) return true;
+    if (accept(decodeMitsubishi112(results, offset))) return true;
 #endif  // DECODE_MITSUBISHI112 || DECODE_TCL112AC
 #if DECODE_TECO
     DPRINTLN("Attempting Teco decode");
-    if (decodeTeco(results, offset)) return true;
+    if (accept(decodeTeco(results, offset))) return true;
 #endif
 #if DECODE_LEGOPF
     DPRINTLN("Attempting LEGOPF decode");
-    if (decodeLegoPf(results, offset)) return true;
+    if (accept(decodeLegoPf(results, offset))) return true;
 #endif
 #if DECODE_MITSUBISHIHEAVY
     DPRINTLN("Attempting MITSUBISHIHEAVY (152 bit) decode");
-    if (decodeMitsubishiHeavy(results, offset, kMitsubishiHeavy152Bits))
+    if (accept(decodeMitsubishiHeavy(results, offset, kMitsubishiHeavy152Bits)))
       return true;
     DPRINTLN("Attempting MITSUBISHIHEAVY (88 bit) decode");
-    if (decodeMitsubishiHeavy(results, offset, kMitsubishiHeavy88Bits))
+    if (accept(decodeMitsubishiHeavy(results, offset, kMitsubishiHeavy88Bits)))
       return true;
 #endif
 #if DECODE_ARGO
     DPRINTLN("Attempting Argo decode");
-    if (decodeArgo(results, offset)) return true;
+    if (accept(decodeArgo(results, offset))) return true;
 #endif  // DECODE_ARGO
 #if DECODE_SHARP_AC
     DPRINTLN("Attempting SHARP_AC decode");
-    if (decodeSharpAc(results, offset)) return true;
+    if (accept(decodeSharpAc(results, offset))) return true;
 #endif
 #if DECODE_GOODWEATHER
     DPRINTLN("Attempting GOODWEATHER decode");
-    if (decodeGoodweather(results, offset)) return true;
+    if (accept(decodeGoodweather(results, offset))) return true;
 #endif  // DECODE_GOODWEATHER
 #if DECODE_INAX
     DPRINTLN("Attempting Inax decode");
-    if (decodeInax(results, offset)) return true;
+    if (accept(decodeInax(results, offset))) return true;
 #endif  // DECODE_INAX
 #if DECODE_TROTEC
     DPRINTLN("Attempting Trotec decode");
-    if (decodeTrotec(results, offset)) return true;
+    if (accept(decodeTrotec(results, offset))) return true;
 #endif  // DECODE_TROTEC
 #if DECODE_DAIKIN160
     DPRINTLN("Attempting Daikin160 decode");
-    if (decodeDaikin160(results, offset)) return true;
+    if (accept(decodeDaikin160(results, offset))) return true;
 #endif  // DECODE_DAIKIN160
 #if DECODE_NEOCLIMA
     DPRINTLN("Attempting Neoclima decode");
-    if (decodeNeoclima(results, offset)) return true;
+    if (accept(decodeNeoclima(results, offset))) return true;
 #endif  // DECODE_NEOCLIMA
 #if DECODE_DAIKIN176
     DPRINTLN("Attempting Daikin176 decode");
-    if (decodeDaikin176(results, offset)) return true;
+    if (accept(decodeDaikin176(results, offset))) return true;
 #endif  // DECODE_DAIKIN176
 #if DECODE_DAIKIN128
     DPRINTLN("Attempting Daikin128 decode");
-    if (decodeDaikin128(results, offset)) return true;
+    if (accept(decodeDaikin128(results, offset))) return true;
 #endif  // DECODE_DAIKIN128
 #if DECODE_AMCOR
     DPRINTLN("Attempting Amcor decode");
-    if (decodeAmcor(results, offset)) return true;
+    if (accept(decodeAmcor(results, offset))) return true;
 #endif  // DECODE_AMCOR
 #if DECODE_DAIKIN152
     DPRINTLN("Attempting Daikin152 decode");
-    if (decodeDaikin152(results, offset)) return true;
+    if (accept(decodeDaikin152(results, offset))) return true;
 #endif  // DECODE_DAIKIN152
 #if DECODE_SYMPHONY
     DPRINTLN("Attempting Symphony decode");
-    if (decodeSymphony(results, offset)) return true;
+    if (accept(decodeSymphony(results, offset))) return true;
 #endif  // DECODE_SYMPHONY
 #if DECODE_DAIKIN64
     DPRINTLN("Attempting Daikin64 decode");
-    if (decodeDaikin64(results, offset)) return true;
+    if (accept(decodeDaikin64(results, offset))) return true;
 #endif  // DECODE_DAIKIN64
 #if DECODE_AIRWELL
     DPRINTLN("Attempting Airwell decode");
-    if (decodeAirwell(results, offset)) return true;
+    if (accept(decodeAirwell(results, offset))) return true;
 #endif  // DECODE_AIRWELL
 #if DECODE_DELONGHI_AC
     DPRINTLN("Attempting Delonghi AC decode");
-    if (decodeDelonghiAc(results, offset)) return true;
+    if (accept(decodeDelonghiAc(results, offset))) return true;
 #endif  // DECODE_DELONGHI_AC
 #if DECODE_DOSHISHA
     DPRINTLN("Attempting Doshisha decode");
-    if (decodeDoshisha(results, offset)) return true;
+    if (accept(decodeDoshisha(results, offset))) return true;
 #endif  // DECODE_DOSHISHA
 #if DECODE_TRUMA
     // Needs to happen before decodeMultibrackets() as they can appear similar.
     DPRINTLN("Attempting Truma decode");
-    if (decodeTruma(results, offset)) return true;
+    if (accept(decodeTruma(results, offset))) return true;
 #endif  // DECODE_TRUMA
 #if DECODE_MULTIBRACKETS
     DPRINTLN("Attempting Multibrackets decode");
-    if (decodeMultibrackets(results, offset)) return true;
+    if (accept(decodeMultibrackets(results, offset))) return true;
 #endif  // DECODE_MULTIBRACKETS
 #if DECODE_CARRIER_AC40
     DPRINTLN("Attempting Carrier 40bit decode");
-    if (decodeCarrierAC40(results, offset)) return true;
+    if (accept(decodeCarrierAC40(results, offset))) return true;
 #endif  // DECODE_CARRIER_AC40
 #if DECODE_CARRIER_AC64
     DPRINTLN("Attempting Carrier 64bit decode");
-    if (decodeCarrierAC64(results, offset)) return true;
+    if (accept(decodeCarrierAC64(results, offset))) return true;
 #endif  // DECODE_CARRIER_AC64
 #if DECODE_TECHNIBEL_AC
     DPRINTLN("Attempting Technibel AC decode");
-    if (decodeTechnibelAc(results, offset)) return true;
+    if (accept(decodeTechnibelAc(results, offset))) return true;
 #endif  // DECODE_TECHNIBEL_AC
 #if DECODE_CORONA_AC
     DPRINTLN("Attempting CoronaAc decode");
-    if (decodeCoronaAc(results, offset)) return true;
+    if (accept(decodeCoronaAc(results, offset))) return true;
 #endif  // DECODE_CORONA_AC
 #if DECODE_MIDEA24
     DPRINTLN("Attempting Midea-Nec decode");
-    if (decodeMidea24(results, offset)) return true;
+    if (accept(decodeMidea24(results, offset))) return true;
 #endif  // DECODE_MIDEA24
 #if DECODE_ZEPEAL
     DPRINTLN("Attempting Zepeal decode");
-    if (decodeZepeal(results, offset)) return true;
+    if (accept(decodeZepeal(results, offset))) return true;
 #endif  // DECODE_ZEPEAL
 #if DECODE_SANYO_AC
     DPRINTLN("Attempting Sanyo AC decode");
-    if (decodeSanyoAc(results, offset)) return true;
+    if (accept(decodeSanyoAc(results, offset))) return true;
 #endif  // DECODE_SANYO_AC
 #if DECODE_VOLTAS
   DPRINTLN("Attempting Voltas decode");
-  if (decodeVoltas(results)) return true;
+  if (accept(decodeVoltas(results))) return true;
 #endif  // DECODE_VOLTAS
 #if DECODE_METZ
     DPRINTLN("Attempting Metz decode");
-    if (decodeMetz(results, offset)) return true;
+    if (accept(decodeMetz(results, offset))) return true;
 #endif  // DECODE_METZ
 #if DECODE_TRANSCOLD
     DPRINTLN("Attempting Transcold decode");
-    if (decodeTranscold(results, offset)) return true;
+    if (accept(decodeTranscold(results, offset))) return true;
 #endif  // DECODE_TRANSCOLD
 #if DECODE_MIRAGE
     DPRINTLN("Attempting Mirage decode");
-    if (decodeMirage(results, offset)) return true;
+    if (accept(decodeMirage(results, offset))) return true;
 #endif  // DECODE_MIRAGE
 #if DECODE_ELITESCREENS
     DPRINTLN("Attempting EliteScreens decode");
-    if (decodeElitescreens(results, offset)) return true;
+    if (accept(decodeElitescreens(results, offset))) return true;
 #endif  // DECODE_ELITESCREENS
 #if DECODE_PANASONIC_AC32
     DPRINTLN("Attempting Panasonic AC (32bit) long decode");
-    if (decodePanasonicAC32(results, offset, kPanasonicAc32Bits)) return true;
+    if (accept(decodePanasonicAC32(results, offset, kPanasonicAc32Bits)))
+      return true;
     DPRINTLN("Attempting Panasonic AC (32bit) short decode");
-    if (decodePanasonicAC32(results, offset, kPanasonicAc32Bits / 2))
+    if (accept(decodePanasonicAC32(results, offset, kPanasonicAc32Bits / 2)))
       return true;
 #endif  // DECODE_PANASONIC_AC32
 #if DECODE_ECOCLIM
     DPRINTLN("Attempting Ecoclim decode");
-    if (decodeEcoclim(results, offset, kEcoclimBits) ||
-        decodeEcoclim(results, offset, kEcoclimShortBits)) return true;
+    if (accept(decodeEcoclim(results, offset, kEcoclimBits)) ||
+        accept(decodeEcoclim(results, offset, kEcoclimShortBits))) return true;
 #endif  // DECODE_ECOCLIM
 #if DECODE_XMP
     DPRINTLN("Attempting XMP decode");
-    if (decodeXmp(results, offset, kXmpBits)) return true;
+    if (accept(decodeXmp(results, offset, kXmpBits))) return true;
 #endif  // DECODE_XMP
 #if DECODE_TEKNOPOINT
     DPRINTLN("Attempting Teknopoint decode");
-    if (decodeTeknopoint(results, offset)) return true;
+    if (accept(decodeTeknopoint(results, offset))) return true;
 #endif  // DECODE_TEKNOPOINT
 #if DECODE_KELON
     DPRINTLN("Attempting Kelon decode");
-    if (decodeKelon(results, offset)) return true;
+    if (accept(decodeKelon(results, offset))) return true;
 #endif  // DECODE_KELON
   // Typically new protocols are added above this line.
   }
@@ -1034,12 +1637,552 @@ bool IRrecv::decode(decode_results *results, irparams_t *save,
     return true;
   }
 #endif  // DECODE_HASH
-  // Throw away and start over
-  if (!resumed)  // Check if we have already resumed.
-    resume();
   return false;
 }
 
+/// Check the entries of a `protocol_decoder_t` table are in `decode_type_t`
+/// order. (Compile-time)
+/// @param[in] table The table to check.
+/// @param[in] size The nr. of entries in it.
+/// @param[in] i The entry to start checking from.
+/// @return True if entry `i` and all those after it are okay.
+static constexpr bool decodersAreValid(const protocol_decoder_t *table,
+                                       const uint16_t size,
+                                       const uint16_t i = 0) {
+  return i >= size ||
+      (table[i].protocol == i && decodersAreValid(table, size, i + 1));
+}
+
+/// Decode a capture as a given protocol, using only that protocol's decoder.
+/// i.e. No other protocols are tried, and no leading entries are skipped.
+/// @param[in,out] results Ptr to the data to decode & where to store the result
+/// @param[in] protocol The protocol to decode it as.
+/// @param[in] nbits The number of data bits to expect.
+/// @param[in] strict Flag indicating if we should perform strict matching.
+///   e.g. Checksums. Turn it off to accept any data the protocol can carry.
+/// @return True if it can decode it, false if it can't, or if the protocol
+///   has no decoder in this build.
+/// @note Some protocols share a decoder, & can't be told apart by it.
+///   e.g. NEC_LIKE & SHERWOOD decode as NEC. Check `results->decode_type`.
+bool IRrecv::decodeAs(decode_results *results, const decode_type_t protocol,
+                      const uint16_t nbits, const bool strict) {
+  // The decoder of each protocol, indexed by `decode_type_t`.
+  // Only `decodeAs()` uses it, as it pulls in the decoder of every protocol.
+  // i.e. {protocol, decoding method}
+  static constexpr protocol_decoder_t kDecoders[] = {
+    {UNUSED, NULL},
+#if DECODE_RC5
+    {RC5, &IRrecv::decodeRC5},
+#else  // DECODE_RC5
+    {RC5, NULL},
+#endif  // DECODE_RC5
+#if DECODE_RC6
+    {RC6, &IRrecv::decodeRC6},
+#else  // DECODE_RC6
+    {RC6, NULL},
+#endif  // DECODE_RC6
+#if DECODE_NEC
+    {NEC, &IRrecv::decodeNEC},
+#else  // DECODE_NEC
+    {NEC, NULL},
+#endif  // DECODE_NEC
+#if DECODE_SONY
+    {SONY, &IRrecv::decodeSony},
+#else  // DECODE_SONY
+    {SONY, NULL},
+#endif  // DECODE_SONY
+#if DECODE_PANASONIC
+    {PANASONIC, &IRrecv::decodePanasonic64},
+#else  // DECODE_PANASONIC
+    {PANASONIC, NULL},
+#endif  // DECODE_PANASONIC
+#if DECODE_JVC
+    {JVC, &IRrecv::decodeJVC},
+#else  // DECODE_JVC
+    {JVC, NULL},
+#endif  // DECODE_JVC
+#if DECODE_SAMSUNG
+    {SAMSUNG, &IRrecv::decodeSAMSUNG},
+#else  // DECODE_SAMSUNG
+    {SAMSUNG, NULL},
+#endif  // DECODE_SAMSUNG
+#if DECODE_WHYNTER
+    {WHYNTER, &IRrecv::decodeWhynter},
+#else  // DECODE_WHYNTER
+    {WHYNTER, NULL},
+#endif  // DECODE_WHYNTER
+#if DECODE_AIWA_RC_T501
+    {AIWA_RC_T501, &IRrecv::decodeAiwaRCT501},
+#else  // DECODE_AIWA_RC_T501
+    {AIWA_RC_T501, NULL},
+#endif  // DECODE_AIWA_RC_T501
+#if DECODE_LG
+    {LG, &IRrecv::decodeLG},
+#else  // DECODE_LG
+    {LG, NULL},
+#endif  // DECODE_LG
+    {SANYO, NULL},
+#if DECODE_MITSUBISHI
+    {MITSUBISHI, &IRrecv::decodeMitsubishi},
+#else  // DECODE_MITSUBISHI
+    {MITSUBISHI, NULL},
+#endif  // DECODE_MITSUBISHI
+#if DECODE_DISH
+    {DISH, &IRrecv::decodeDISH},
+#else  // DECODE_DISH
+    {DISH, NULL},
+#endif  // DECODE_DISH
+#if DECODE_SHARP
+    {SHARP, &IRrecv::decodeSharpRaw},
+#else  // DECODE_SHARP
+    {SHARP, NULL},
+#endif  // DECODE_SHARP
+#if DECODE_COOLIX
+    {COOLIX, &IRrecv::decodeCOOLIX},
+#else  // DECODE_COOLIX
+    {COOLIX, NULL},
+#endif  // DECODE_COOLIX
+#if DECODE_DAIKIN
+    {DAIKIN, &IRrecv::decodeDaikin},
+#else  // DECODE_DAIKIN
+    {DAIKIN, NULL},
+#endif  // DECODE_DAIKIN
+#if DECODE_DENON
+    {DENON, &IRrecv::decodeDenon},
+#else  // DECODE_DENON
+    {DENON, NULL},
+#endif  // DECODE_DENON
+#if DECODE_KELVINATOR
+    {KELVINATOR, &IRrecv::decodeKelvinator},
+#else  // DECODE_KELVINATOR
+    {KELVINATOR, NULL},
+#endif  // DECODE_KELVINATOR
+#if DECODE_NEC  // DECODE_SHERWOOD is DECODE_NEC.
+    {SHERWOOD, &IRrecv::decodeNEC},
+#else  // DECODE_NEC
+    {SHERWOOD, NULL},
+#endif  // DECODE_NEC
+#if DECODE_MITSUBISHI_AC
+    {MITSUBISHI_AC, &IRrecv::decodeMitsubishiAC},
+#else  // DECODE_MITSUBISHI_AC
+    {MITSUBISHI_AC, NULL},
+#endif  // DECODE_MITSUBISHI_AC
+#if DECODE_RCMM
+    {RCMM, &IRrecv::decodeRCMM},
+#else  // DECODE_RCMM
+    {RCMM, NULL},
+#endif  // DECODE_RCMM
+#if DECODE_SANYO
+    {SANYO_LC7461, &IRrecv::decodeSanyoLC7461},
+#else  // DECODE_SANYO
+    {SANYO_LC7461, NULL},
+#endif  // DECODE_SANYO
+#if DECODE_RC5
+    {RC5X, &IRrecv::decodeRC5},
+#else  // DECODE_RC5
+    {RC5X, NULL},
+#endif  // DECODE_RC5
+#if DECODE_GREE
+    {GREE, &IRrecv::decodeGree},
+#else  // DECODE_GREE
+    {GREE, NULL},
+#endif  // DECODE_GREE
+    {PRONTO, NULL},
+#if DECODE_NEC
+    {NEC_LIKE, &IRrecv::decodeNEC},
+#else  // DECODE_NEC
+    {NEC_LIKE, NULL},
+#endif  // DECODE_NEC
+#if DECODE_ARGO
+    {ARGO, &IRrecv::decodeArgo},
+#else  // DECODE_ARGO
+    {ARGO, NULL},
+#endif  // DECODE_ARGO
+#if DECODE_TROTEC
+    {TROTEC, &IRrecv::decodeTrotec},
+#else  // DECODE_TROTEC
+    {TROTEC, NULL},
+#endif  // DECODE_TROTEC
+#if DECODE_NIKAI
+    {NIKAI, &IRrecv::decodeNikai},
+#else  // DECODE_NIKAI
+    {NIKAI, NULL},
+#endif  // DECODE_NIKAI
+    {RAW, NULL},
+    {GLOBALCACHE, NULL},
+#if DECODE_TOSHIBA_AC
+    {TOSHIBA_AC, &IRrecv::decodeToshibaAC},
+#else  // DECODE_TOSHIBA_AC
+    {TOSHIBA_AC, NULL},
+#endif  // DECODE_TOSHIBA_AC
+#if DECODE_FUJITSU_AC
+    {FUJITSU_AC, &IRrecv::decodeFujitsuAC},
+#else  // DECODE_FUJITSU_AC
+    {FUJITSU_AC, NULL},
+#endif  // DECODE_FUJITSU_AC
+#if DECODE_MIDEA
+    {MIDEA, &IRrecv::decodeMidea},
+#else  // DECODE_MIDEA
+    {MIDEA, NULL},
+#endif  // DECODE_MIDEA
+#if DECODE_MAGIQUEST
+    {MAGIQUEST, &IRrecv::decodeMagiQuest},
+#else  // DECODE_MAGIQUEST
+    {MAGIQUEST, NULL},
+#endif  // DECODE_MAGIQUEST
+#if DECODE_LASERTAG
+    {LASERTAG, &IRrecv::decodeLasertag},
+#else  // DECODE_LASERTAG
+    {LASERTAG, NULL},
+#endif  // DECODE_LASERTAG
+#if DECODE_CARRIER_AC
+    {CARRIER_AC, &IRrecv::decodeCarrierAC},
+#else  // DECODE_CARRIER_AC
+    {CARRIER_AC, NULL},
+#endif  // DECODE_CARRIER_AC
+#if DECODE_HAIER_AC
+    {HAIER_AC, &IRrecv::decodeHaierAC},
+#else  // DECODE_HAIER_AC
+    {HAIER_AC, NULL},
+#endif  // DECODE_HAIER_AC
+#if DECODE_MITSUBISHI2
+    {MITSUBISHI2, &IRrecv::decodeMitsubishi2},
+#else  // DECODE_MITSUBISHI2
+    {MITSUBISHI2, NULL},
+#endif  // DECODE_MITSUBISHI2
+#if DECODE_HITACHI_AC
+    {HITACHI_AC, &IRrecv::decodeHitachiAC},
+#else  // DECODE_HITACHI_AC
+    {HITACHI_AC, NULL},
+#endif  // DECODE_HITACHI_AC
+#if DECODE_HITACHI_AC1
+    {HITACHI_AC1, &IRrecv::decodeHitachiAC},
+#else  // DECODE_HITACHI_AC1
+    {HITACHI_AC1, NULL},
+#endif  // DECODE_HITACHI_AC1
+#if DECODE_HITACHI_AC2
+    {HITACHI_AC2, &IRrecv::decodeHitachiAC},
+#else  // DECODE_HITACHI_AC2
+    {HITACHI_AC2, NULL},
+#endif  // DECODE_HITACHI_AC2
+#if DECODE_GICABLE
+    {GICABLE, &IRrecv::decodeGICable},
+#else  // DECODE_GICABLE
+    {GICABLE, NULL},
+#endif  // DECODE_GICABLE
+#if DECODE_HAIER_AC_YRW02
+    {HAIER_AC_YRW02, &IRrecv::decodeHaierACYRW02},
+#else  // DECODE_HAIER_AC_YRW02
+    {HAIER_AC_YRW02, NULL},
+#endif  // DECODE_HAIER_AC_YRW02
+#if DECODE_WHIRLPOOL_AC
+    {WHIRLPOOL_AC, &IRrecv::decodeWhirlpoolAC},
+#else  // DECODE_WHIRLPOOL_AC
+    {WHIRLPOOL_AC, NULL},
+#endif  // DECODE_WHIRLPOOL_AC
+#if DECODE_SAMSUNG_AC
+    {SAMSUNG_AC, &IRrecv::decodeSamsungAC},
+#else  // DECODE_SAMSUNG_AC
+    {SAMSUNG_AC, NULL},
+#endif  // DECODE_SAMSUNG_AC
+#if DECODE_LUTRON
+    {LUTRON, &IRrecv::decodeLutron},
+#else  // DECODE_LUTRON
+    {LUTRON, NULL},
+#endif  // DECODE_LUTRON
+#if DECODE_ELECTRA_AC
+    {ELECTRA_AC, &IRrecv::decodeElectraAC},
+#else  // DECODE_ELECTRA_AC
+    {ELECTRA_AC, NULL},
+#endif  // DECODE_ELECTRA_AC
+#if DECODE_PANASONIC_AC
+    {PANASONIC_AC, &IRrecv::decodePanasonicAC},
+#else  // DECODE_PANASONIC_AC
+    {PANASONIC_AC, NULL},
+#endif  // DECODE_PANASONIC_AC
+#if DECODE_PIONEER
+    {PIONEER, &IRrecv::decodePioneer},
+#else  // DECODE_PIONEER
+    {PIONEER, NULL},
+#endif  // DECODE_PIONEER
+#if DECODE_LG
+    {LG2, &IRrecv::decodeLG},
+#else  // DECODE_LG
+    {LG2, NULL},
+#endif  // DECODE_LG
+#if DECODE_MWM
+    {MWM, &IRrecv::decodeMWM},
+#else  // DECODE_MWM
+    {MWM, NULL},
+#endif  // DECODE_MWM
+#if DECODE_DAIKIN2
+    {DAIKIN2, &IRrecv::decodeDaikin2},
+#else  // DECODE_DAIKIN2
+    {DAIKIN2, NULL},
+#endif  // DECODE_DAIKIN2
+#if DECODE_VESTEL_AC
+    {VESTEL_AC, &IRrecv::decodeVestelAc},
+#else  // DECODE_VESTEL_AC
+    {VESTEL_AC, NULL},
+#endif  // DECODE_VESTEL_AC
+#if DECODE_TECO
+    {TECO, &IRrecv::decodeTeco},
+#else  // DECODE_TECO
+    {TECO, NULL},
+#endif  // DECODE_TECO
+#if DECODE_SAMSUNG36
+    {SAMSUNG36, &IRrecv::decodeSamsung36},
+#else  // DECODE_SAMSUNG36
+    {SAMSUNG36, NULL},
+#endif  // DECODE_SAMSUNG36
+#if DECODE_TCL112AC
+    {TCL112AC, &IRrecv::decodeMitsubishi112},
+#else  // DECODE_TCL112AC
+    {TCL112AC, NULL},
+#endif  // DECODE_TCL112AC
+#if DECODE_LEGOPF
+    {LEGOPF, &IRrecv::decodeLegoPf},
+#else  // DECODE_LEGOPF
+    {LEGOPF, NULL},
+#endif  // DECODE_LEGOPF
+#if DECODE_MITSUBISHIHEAVY
+    {MITSUBISHI_HEAVY_88, &IRrecv::decodeMitsubishiHeavy},
+#else  // DECODE_MITSUBISHIHEAVY
+    {MITSUBISHI_HEAVY_88, NULL},
+#endif  // DECODE_MITSUBISHIHEAVY
+#if DECODE_MITSUBISHIHEAVY
+    {MITSUBISHI_HEAVY_152, &IRrecv::decodeMitsubishiHeavy},
+#else  // DECODE_MITSUBISHIHEAVY
+    {MITSUBISHI_HEAVY_152, NULL},
+#endif  // DECODE_MITSUBISHIHEAVY
+#if DECODE_DAIKIN216
+    {DAIKIN216, &IRrecv::decodeDaikin216},
+#else  // DECODE_DAIKIN216
+    {DAIKIN216, NULL},
+#endif  // DECODE_DAIKIN216
+#if DECODE_SHARP_AC
+    {SHARP_AC, &IRrecv::decodeSharpAc},
+#else  // DECODE_SHARP_AC
+    {SHARP_AC, NULL},
+#endif  // DECODE_SHARP_AC
+#if DECODE_GOODWEATHER
+    {GOODWEATHER, &IRrecv::decodeGoodweather},
+#else  // DECODE_GOODWEATHER
+    {GOODWEATHER, NULL},
+#endif  // DECODE_GOODWEATHER
+#if DECODE_INAX
+    {INAX, &IRrecv::decodeInax},
+#else  // DECODE_INAX
+    {INAX, NULL},
+#endif  // DECODE_INAX
+#if DECODE_DAIKIN160
+    {DAIKIN160, &IRrecv::decodeDaikin160},
+#else  // DECODE_DAIKIN160
+    {DAIKIN160, NULL},
+#endif  // DECODE_DAIKIN160
+#if DECODE_NEOCLIMA
+    {NEOCLIMA, &IRrecv::decodeNeoclima},
+#else  // DECODE_NEOCLIMA
+    {NEOCLIMA, NULL},
+#endif  // DECODE_NEOCLIMA
+#if DECODE_DAIKIN176
+    {DAIKIN176, &IRrecv::decodeDaikin176},
+#else  // DECODE_DAIKIN176
+    {DAIKIN176, NULL},
+#endif  // DECODE_DAIKIN176
+#if DECODE_DAIKIN128
+    {DAIKIN128, &IRrecv::decodeDaikin128},
+#else  // DECODE_DAIKIN128
+    {DAIKIN128, NULL},
+#endif  // DECODE_DAIKIN128
+#if DECODE_AMCOR
+    {AMCOR, &IRrecv::decodeAmcor},
+#else  // DECODE_AMCOR
+    {AMCOR, NULL},
+#endif  // DECODE_AMCOR
+#if DECODE_DAIKIN152
+    {DAIKIN152, &IRrecv::decodeDaikin152},
+#else  // DECODE_DAIKIN152
+    {DAIKIN152, NULL},
+#endif  // DECODE_DAIKIN152
+#if DECODE_MITSUBISHI136
+    {MITSUBISHI136, &IRrecv::decodeMitsubishi136},
+#else  // DECODE_MITSUBISHI136
+    {MITSUBISHI136, NULL},
+#endif  // DECODE_MITSUBISHI136
+#if DECODE_MITSUBISHI112
+    {MITSUBISHI112, &IRrecv::decodeMitsubishi112},
+#else  // DECODE_MITSUBISHI112
+    {MITSUBISHI112, NULL},
+#endif  // DECODE_MITSUBISHI112
+#if DECODE_HITACHI_AC424
+    {HITACHI_AC424, &IRrecv::decodeHitachiAc424},
+#else  // DECODE_HITACHI_AC424
+    {HITACHI_AC424, NULL},
+#endif  // DECODE_HITACHI_AC424
+#if DECODE_SONY
+    {SONY_38K, &IRrecv::decodeSony},
+#else  // DECODE_SONY
+    {SONY_38K, NULL},
+#endif  // DECODE_SONY
+#if DECODE_EPSON
+    {EPSON, &IRrecv::decodeEpson},
+#else  // DECODE_EPSON
+    {EPSON, NULL},
+#endif  // DECODE_EPSON
+#if DECODE_SYMPHONY
+    {SYMPHONY, &IRrecv::decodeSymphony},
+#else  // DECODE_SYMPHONY
+    {SYMPHONY, NULL},
+#endif  // DECODE_SYMPHONY
+#if DECODE_HITACHI_AC3
+    {HITACHI_AC3, &IRrecv::decodeHitachiAc3},
+#else  // DECODE_HITACHI_AC3
+    {HITACHI_AC3, NULL},
+#endif  // DECODE_HITACHI_AC3
+#if DECODE_DAIKIN64
+    {DAIKIN64, &IRrecv::decodeDaikin64},
+#else  // DECODE_DAIKIN64
+    {DAIKIN64, NULL},
+#endif  // DECODE_DAIKIN64
+#if DECODE_AIRWELL
+    {AIRWELL, &IRrecv::decodeAirwell},
+#else  // DECODE_AIRWELL
+    {AIRWELL, NULL},
+#endif  // DECODE_AIRWELL
+#if DECODE_DELONGHI_AC
+    {DELONGHI_AC, &IRrecv::decodeDelonghiAc},
+#else  // DECODE_DELONGHI_AC
+    {DELONGHI_AC, NULL},
+#endif  // DECODE_DELONGHI_AC
+#if DECODE_DOSHISHA
+    {DOSHISHA, &IRrecv::decodeDoshisha},
+#else  // DECODE_DOSHISHA
+    {DOSHISHA, NULL},
+#endif  // DECODE_DOSHISHA
+#if DECODE_MULTIBRACKETS
+    {MULTIBRACKETS, &IRrecv::decodeMultibrackets},
+#else  // DECODE_MULTIBRACKETS
+    {MULTIBRACKETS, NULL},
+#endif  // DECODE_MULTIBRACKETS
+#if DECODE_CARRIER_AC40
+    {CARRIER_AC40, &IRrecv::decodeCarrierAC40},
+#else  // DECODE_CARRIER_AC40
+    {CARRIER_AC40, NULL},
+#endif  // DECODE_CARRIER_AC40
+#if DECODE_CARRIER_AC64
+    {CARRIER_AC64, &IRrecv::decodeCarrierAC64},
+#else  // DECODE_CARRIER_AC64
+    {CARRIER_AC64, NULL},
+#endif  // DECODE_CARRIER_AC64
+#if DECODE_HITACHI_AC344
+    {HITACHI_AC344, &IRrecv::decodeHitachiAC},
+#else  // DECODE_HITACHI_AC344
+    {HITACHI_AC344, NULL},
+#endif  // DECODE_HITACHI_AC344
+#if DECODE_CORONA_AC
+    {CORONA_AC, &IRrecv::decodeCoronaAc},
+#else  // DECODE_CORONA_AC
+    {CORONA_AC, NULL},
+#endif  // DECODE_CORONA_AC
+#if DECODE_MIDEA24
+    {MIDEA24, &IRrecv::decodeMidea24},
+#else  // DECODE_MIDEA24
+    {MIDEA24, NULL},
+#endif  // DECODE_MIDEA24
+#if DECODE_ZEPEAL
+    {ZEPEAL, &IRrecv::decodeZepeal},
+#else  // DECODE_ZEPEAL
+    {ZEPEAL, NULL},
+#endif  // DECODE_ZEPEAL
+#if DECODE_SANYO_AC
+    {SANYO_AC, &IRrecv::decodeSanyoAc},
+#else  // DECODE_SANYO_AC
+    {SANYO_AC, NULL},
+#endif  // DECODE_SANYO_AC
+#if DECODE_VOLTAS
+    {VOLTAS, &IRrecv::decodeVoltas},
+#else  // DECODE_VOLTAS
+    {VOLTAS, NULL},
+#endif  // DECODE_VOLTAS
+#if DECODE_METZ
+    {METZ, &IRrecv::decodeMetz},
+#else  // DECODE_METZ
+    {METZ, NULL},
+#endif  // DECODE_METZ
+#if DECODE_TRANSCOLD
+    {TRANSCOLD, &IRrecv::decodeTranscold},
+#else  // DECODE_TRANSCOLD
+    {TRANSCOLD, NULL},
+#endif  // DECODE_TRANSCOLD
+#if DECODE_TECHNIBEL_AC
+    {TECHNIBEL_AC, &IRrecv::decodeTechnibelAc},
+#else  // DECODE_TECHNIBEL_AC
+    {TECHNIBEL_AC, NULL},
+#endif  // DECODE_TECHNIBEL_AC
+#if DECODE_MIRAGE
+    {MIRAGE, &IRrecv::decodeMirage},
+#else  // DECODE_MIRAGE
+    {MIRAGE, NULL},
+#endif  // DECODE_MIRAGE
+#if DECODE_ELITESCREENS
+    {ELITESCREENS, &IRrecv::decodeElitescreens},
+#else  // DECODE_ELITESCREENS
+    {ELITESCREENS, NULL},
+#endif  // DECODE_ELITESCREENS
+#if DECODE_PANASONIC_AC32
+    {PANASONIC_AC32, &IRrecv::decodePanasonicAC32},
+#else  // DECODE_PANASONIC_AC32
+    {PANASONIC_AC32, NULL},
+#endif  // DECODE_PANASONIC_AC32
+#if DECODE_MILESTAG2
+    {MILESTAG2, &IRrecv::decodeMilestag2},
+#else  // DECODE_MILESTAG2
+    {MILESTAG2, NULL},
+#endif  // DECODE_MILESTAG2
+#if DECODE_ECOCLIM
+    {ECOCLIM, &IRrecv::decodeEcoclim},
+#else  // DECODE_ECOCLIM
+    {ECOCLIM, NULL},
+#endif  // DECODE_ECOCLIM
+#if DECODE_XMP
+    {XMP, &IRrecv::decodeXmp},
+#else  // DECODE_XMP
+    {XMP, NULL},
+#endif  // DECODE_XMP
+#if DECODE_TRUMA
+    {TRUMA, &IRrecv::decodeTruma},
+#else  // DECODE_TRUMA
+    {TRUMA, NULL},
+#endif  // DECODE_TRUMA
+#if DECODE_HAIER_AC176
+    {HAIER_AC176, &IRrecv::decodeHaierAC176},
+#else  // DECODE_HAIER_AC176
+    {HAIER_AC176, NULL},
+#endif  // DECODE_HAIER_AC176
+#if DECODE_TEKNOPOINT
+    {TEKNOPOINT, &IRrecv::decodeTeknopoint},
+#else  // DECODE_TEKNOPOINT
+    {TEKNOPOINT, NULL},
+#endif  // DECODE_TEKNOPOINT
+#if DECODE_KELON
+    {KELON, &IRrecv::decodeKelon},
+#else  // DECODE_KELON
+    {KELON, NULL},
+#endif  // DECODE_KELON
+  };
+  const uint16_t kDecodersSize = sizeof(kDecoders) / sizeof(kDecoders[0]);
+  static_assert(kDecodersSize == kLastDecodeType + 1,
+                "kDecoders needs an entry for every decode_type_t.");
+  static_assert(decodersAreValid(kDecoders, kDecodersSize),
+                "kDecoders is not in decode_type_t order.");
+
+  if (protocol < 0 || protocol > kLastDecodeType) return false;
+  if (kDecoders[protocol].decoder == NULL) return false;
+  return (this->*kDecoders[protocol].decoder)(results, kStartOffset, nbits,
+                                              strict);
+}
+
 /// Convert the tolerance percentage into something valid.
 /// @param[in] percentage An integer percentage.
 uint8_t IRrecv::_validTolerance(const uint8_t percentage) {
@@ -1251,6 +2394,14 @@ uint16_t IRrecv::compare(const uint16_t oldval, const uint16_t newval) {
 bool IRrecv::decodeHash(decode_results *results) {
   // Require at least some samples to prevent triggering on noise
   if (results->rawlen < _unknown_threshold) return false;
+  if (_hash_mode == kHashLogBuckets) {
+    results->value = hashLogBuckets(results);
+    results->bits = results->rawlen / 2;
+    results->address = 0;
+    results->command = 0;
+    results->decode_type = UNKNOWN;
+    return true;
+  }
   int32_t hash = kFnvBasis32;
   // 'rawlen - 2' to avoid the look ahead from going out of bounds.
   // Should probably be -3 to avoid comparing the trailing space entry,
@@ -1268,6 +2419,43 @@ bool IRrecv::decodeHash(decode_results *results) {
   results->decode_type = UNKNOWN;
   return true;
 }
+
+/// Hash a capture into a 64-bit value, using log-scale duration buckets.
+///
+/// The algorithm: Like the legacy one, compare each mark (or space) to the
+/// previous mark (or space). Sort the ratio of the two into a log-scale
+/// bucket. i.e. The same (< x1.19), longer (< x4.76), or much longer, or the
+/// same for shorter. The buckets are two octaves wide, with their edges
+/// between the ratios typical of IR protocols, so timing errors rarely move a
+/// ratio to another bucket. e.g. A `1` vs. a `0` bit is usually x2-x3, and a
+/// header vs. a bit is usually x8 or more. Hash the sequence of buckets, and
+/// whether each is for a mark or a space, into a 64-bit FNV-1a value.
+/// @param[in] results The capture to hash.
+/// @return The hash.
+/// @note Only uses integer maths. Unlike the legacy hash, every entry of the
+///   capture is used, & a mark can't hash the same as a space.
+///   `tools/bench_hash.cpp` compares the two.
+uint64_t IRrecv::hashLogBuckets(const decode_results *results) {
+  // The capture has finished, so it is safe to not treat it as volatile.
+  const uint16_t *raw = const_cast<const uint16_t *>(results->rawbuf);
+  uint64_t hash = kFnvBasis64;
+  for (uint16_t i = kStartOffset + 2; i < results->rawlen; i++) {
+    const uint32_t prev = raw[i - 2];
+    const uint32_t now = raw[i];
+    const bool shorter = now < prev;
+    // The ratio of the two is compared in 8 bit fixed point.
+    const uint32_t hi = (shorter ? prev : now) << 8;
+    const uint32_t lo = shorter ? now : prev;
+    uint8_t bucket = 0;  // The same.
+    if (hi >= lo * 304) bucket++;  // x1.19 i.e. 2^(1/4)
+    if (hi >= lo * 1218) bucket++;  // x4.76 i.e. 2^(9/4)
+    // Odd entries are marks, even ones are spaces. When they are the same, it
+    // doesn't matter which is shorter.
+    const uint8_t value = (i & 1) << 3 | (bucket && shorter) << 2 | bucket;
+    hash = (hash ^ value) * kFnvPrime64;
+  }
+  return hash;
+}
 #endif  // DECODE_HASH
 
 /// Match & decode the typical data section of an IR message.
@@ -1353,6 +2541,11 @@ uint16_t IRrecv::matchBytes(volatile uint16_t *data_ptr, uint8_t *result_ptr,
                             const uint16_t zeromark, const uint32_t zerospace,
                             const uint8_t tolerance, const int16_t excess,
                             const bool MSBfirst, const bool expectlastspace) {
+#if ENABLE_SLICED_MATCH
+  return matchBytesSliced(data_ptr, result_ptr, remaining, nbytes,
+                          onemark, onespace, zeromark, zerospace,
+                          tolerance, excess, MSBfirst, expectlastspace);
+#else  // ENABLE_SLICED_MATCH
   // Check if there is enough capture buffer to possibly have the desired bytes.
   if (remaining + expectlastspace < (nbytes * 8 * 2) + 1)
     return 0;  // Nope, so abort.
@@ -1367,6 +2560,163 @@ uint16_t IRrecv::matchBytes(volatile uint16_t *data_ptr, uint8_t *result_ptr,
     offset += result.used;
   }
   return offset;
+#endif  // ENABLE_SLICED_MATCH
+}
+
+/// Calculate the range of tick values `match()` would accept.
+/// @param[in] usecs Nr. of uSeconds expected.
+/// @param[in] tolerance Percent as an integer. e.g. 10 is 10%
+/// @param[out] low The smallest nr. of ticks that matches.
+/// @param[out] high The largest nr. of ticks that matches.
+/// @note If nothing can match, `low` is greater than `high`.
+void IRrecv::tickRange(const uint32_t usecs, const uint8_t tolerance,
+                       uint16_t *low, uint16_t *high) {
+#ifdef UNIT_TEST
+  // The same sanity checks as `match()`.
+  assert(ticksLow(usecs, tolerance) <= usecs);
+  assert(ticksHigh(usecs, tolerance) < UINT32_MAX >> 3);
+  assert(ticksHigh(usecs, tolerance) >= usecs);
+#endif  // UNIT_TEST
+  // measured * kRawTick >= ticksLow() & measured * kRawTick <= ticksHigh()
+  const uint32_t lowest = (ticksLow(usecs, tolerance) + kRawTick - 1) /
+      kRawTick;
+  const uint32_t highest = ticksHigh(usecs, tolerance) / kRawTick;
+  *low = std::min(lowest, (uint32_t)UINT16_MAX);
+  *high = std::min(highest, (uint32_t)UINT16_MAX);
+  if (lowest > UINT16_MAX) *high = 0;  // Nothing can match.
+}
+
+#if ENABLE_SLICED_MATCH || defined(UNIT_TEST)
+/// Nr. of bits `matchBytesSliced()` works on at a time.
+const uint16_t kSliceBits = 64;
+
+/// Classify a block of data bits. Written so the compiler can vectorise it.
+/// i.e. No branches or early exits. Every bit is compared to every range.
+/// @param[in] marks The mark of each bit. (ticks)
+/// @param[in] spaces The space of each bit. (ticks)
+/// @param[in] nbits Nr. of bits in the block.
+/// @param[in] range The ticks ranges for a '1' mark, a '1' space, a '0' mark,
+///   & a '0' space, as low & high pairs.
+/// @param[out] ones Set to 1 for each bit that is a '1', else 0.
+/// @param[out] valid Set to 1 for each bit that is a '1' or a '0', else 0.
+static void sliceBits(const uint16_t *marks, const uint16_t *spaces,
+                      const uint16_t nbits, const uint16_t range[8],
+                      uint8_t *ones, uint8_t *valid) {
+  for (uint16_t i = 0; i < nbits; i++) {
+    const uint8_t one = (marks[i] >= range[0]) & (marks[i] <= range[1]) &
+        (spaces[i] >= range[2]) & (spaces[i] <= range[3]);
+    const uint8_t zero = (marks[i] >= range[4]) & (marks[i] <= range[5]) &
+        (spaces[i] >= range[6]) & (spaces[i] <= range[7]);
+    ones[i] = one;
+    valid[i] = one | zero;
+  }
+}
+
+/// Match & decode the typical data section of an IR message, many bits at a
+/// time. It gives exactly the same results as doing it with `matchData()`,
+/// byte by byte.
+/// @param[in] data_ptr A pointer to where we are at in the capture buffer.
+/// @param[out] result_ptr A ptr to where to start storing the bytes we decoded.
+/// @param[in] remaining The size of the capture buffer remaining.
+/// @param[in] nbytes Nr. of data bytes we expect.
+/// @param[in] onemark Nr. of uSeconds in an expected mark signal for a '1' bit.
+/// @param[in] onespace Nr. of uSecs in an expected space signal for a '1' bit.
+/// @param[in] zeromark Nr. of uSecs in an expected mark signal for a '0' bit.
+/// @param[in] zerospace Nr. of uSecs in an expected space signal for a '0' bit.
+/// @param[in] tolerance Percentage error margin to allow.
+/// @param[in] excess Nr. of uSeconds.
+/// @param[in] MSBfirst Bit order to save the data in.
+///   true is Most Significant Bit First Order, false is Least Significant First
+/// @param[in] expectlastspace Do we expect a space at the end of the message?
+/// @return If successful, how many buffer entries were used. Otherwise 0.
+/// @note The data written to `result_ptr` before a failure may differ from
+///   `matchData()`'s, but both return 0 then.
+uint16_t IRrecv::matchBytesSliced(volatile uint16_t *data_ptr,
+                                  uint8_t *result_ptr,
+                                  const uint16_t remaining,
+                                  const uint16_t nbytes,
+                                  const uint16_t onemark,
+                                  const uint32_t onespace,
+                                  const uint16_t zeromark,
+                                  const uint32_t zerospace,
+                                  const uint8_t tolerance,
+                                  const int16_t excess,
+                                  const bool MSBfirst,
+                                  const bool expectlastspace) {
+  // Check if there is enough capture buffer to possibly have the desired bytes.
+  if (remaining + expectlastspace < (nbytes * 8 * 2) + 1)
+    return 0;  // Nope, so abort.
+  if (!nbytes) return 0;
+  // Work out the ranges once, rather than for every bit.
+  // i.e. The same values as `matchMark()` & `matchSpace()` would use.
+  uint16_t range[8];
+  tickRange(onemark + excess, tolerance, &range[0], &range[1]);
+  tickRange(onespace - excess, tolerance, &range[2], &range[3]);
+  tickRange(zeromark + excess, tolerance, &range[4], &range[5]);
+  tickRange(zerospace - excess, tolerance, &range[6], &range[7]);
+  // Without a last space, the last bit is only its mark, so do it on its own.
+  const uint16_t nbits = nbytes * 8 - !expectlastspace;
+  uint16_t marks[kSliceBits];
+  uint16_t spaces[kSliceBits];
+  uint8_t ones[kSliceBits];
+  uint8_t valid[kSliceBits];
+  uint8_t byte = 0;
+  for (uint16_t start = 0; start < nbits; start += kSliceBits) {
+    const uint16_t count = std::min((uint16_t)(nbits - start), kSliceBits);
+    // Copy them out of the volatile buffer, so the compiler is free to
+    // vectorise the comparisons.
+    for (uint16_t i = 0; i < count; i++) {
+      marks[i] = data_ptr[(start + i) * 2];
+      spaces[i] = data_ptr[(start + i) * 2 + 1];
+    }
+    sliceBits(marks, spaces, count, range, ones, valid);
+    uint8_t all_valid = 1;
+    for (uint16_t i = 0; i < count; i++) all_valid &= valid[i];
+    if (!all_valid) return 0;  // A bit is neither a '1' nor a '0', so fail.
+    // Pack the bits into bytes.
+    for (uint16_t i = 0; i < count; i++) {
+      const uint16_t bit = start + i;
+      if (MSBfirst)
+        byte = (byte << 1) | ones[i];
+      else
+        byte |= ones[i] << (bit % 8);
+      if (bit % 8 == 7) {
+        result_ptr[bit / 8] = byte;
+        byte = 0;
+      }
+    }
+  }
+  if (!expectlastspace) {  // The last bit is just a mark.
+    const uint16_t mark = data_ptr[nbits * 2];
+    uint8_t one;
+    if (mark >= range[0] && mark <= range[1])
+      one = 1;
+    else if (mark >= range[4] && mark <= range[5])
+      one = 0;
+    else
+      return 0;
+    result_ptr[nbytes - 1] = MSBfirst ? (byte << 1) | one : byte | one << 7;
+  }
+  return nbytes * 16 - !expectlastspace;
+}
+#endif  // ENABLE_SLICED_MATCH || defined(UNIT_TEST)
+
+/// Scale a mark's duration by a calibration, without it wrapping around.
+/// @param[in] usecs The usual duration of the mark.
+/// @param[in] scale The calibration's scale. (kCalibrationUnity = 1.0)
+/// @return The scaled duration, limited to what a mark can be.
+static uint16_t scaleMark(const uint16_t usecs, const uint16_t scale) {
+  return std::min((uint32_t)usecs * scale / kCalibrationUnity,
+                  (uint32_t)UINT16_MAX);
+}
+
+/// Scale a space's duration by a calibration, without it wrapping around.
+/// @param[in] usecs The usual duration of the space.
+/// @param[in] scale The calibration's scale. (kCalibrationUnity = 1.0)
+/// @return The scaled duration, limited to what a space can be.
+static uint32_t scaleSpace(const uint32_t usecs, const uint16_t scale) {
+  return std::min((uint64_t)usecs * scale / kCalibrationUnity,
+                  (uint64_t)UINT32_MAX);
 }
 
 /// Match & decode a generic/typical IR message.
@@ -1399,6 +2749,9 @@ uint16_t IRrecv::matchBytes(volatile uint16_t *data_ptr, uint8_t *result_ptr,
 /// @param[in] MSBfirst Bit order to save the data in. (Def: true)
 ///   true is Most Significant Bit First Order, false is Least Significant First
 /// @return If successful, how many buffer entries were used. Otherwise 0.
+/// @note Uses & updates any adaptive timing calibration. See
+///   `setAdaptiveTiming()`. Once a set of timings has been calibrated, only
+///   the calibrated timings are matched, not the usual ones.
 uint16_t IRrecv::_matchGeneric(volatile uint16_t *data_ptr,
                               uint64_t *result_bits_ptr,
                               uint8_t *result_bytes_ptr,
@@ -1417,6 +2770,67 @@ uint16_t IRrecv::_matchGeneric(volatile uint16_t *data_ptr,
                               const uint8_t tolerance,
                               const int16_t excess,
                               const bool MSBfirst) {
+  uint16_t id = 0;
+  if (_adaptive) {
+    // Identify the protocol by its timings.
+    uint32_t hash = kFnvBasis32;
+    hash = (hash * kFnvPrime32) ^ hdrmark;
+    hash = (hash * kFnvPrime32) ^ hdrspace;
+    hash = (hash * kFnvPrime32) ^ onemark;
+    hash = (hash * kFnvPrime32) ^ onespace;
+    hash = (hash * kFnvPrime32) ^ zeromark;
+    hash = (hash * kFnvPrime32) ^ zerospace;
+    hash = (hash * kFnvPrime32) ^ footermark;
+    id = (hash >> 16) ^ (hash & 0xFFFF);
+    const timing_calibration_t *cal = findCalibration(id);
+    if (cal != NULL && cal->samples >= kCalibrationMinSamples) {
+      // Use the timings we've learnt to expect, instead of the usual ones.
+      const uint16_t scale = cal->scale;
+      const uint16_t used = _matchTimings(
+          data_ptr, result_bits_ptr, result_bytes_ptr, use_bits, remaining,
+          nbits,
+          scaleMark(hdrmark, scale), scaleSpace(hdrspace, scale),
+          scaleMark(onemark, scale), scaleSpace(onespace, scale),
+          scaleMark(zeromark, scale), scaleSpace(zerospace, scale),
+          scaleMark(footermark, scale), scaleSpace(footerspace, scale),
+          atleast, tolerance, cal->excess, MSBfirst);
+      if (used)
+        calibrate(data_ptr, id, nbits, hdrmark, hdrspace, onemark, onespace,
+                  zeromark, zerospace, footermark);
+      return used;
+    }
+  }
+  const uint16_t used = _matchTimings(
+      data_ptr, result_bits_ptr, result_bytes_ptr, use_bits, remaining, nbits,
+      hdrmark, hdrspace, onemark, onespace, zeromark, zerospace,
+      footermark, footerspace, atleast, tolerance, excess, MSBfirst);
+  if (used && _adaptive)
+    calibrate(data_ptr, id, nbits, hdrmark, hdrspace, onemark, onespace,
+              zeromark, zerospace, footermark);
+  return used;
+}
+
+/// Match & decode a generic/typical IR message, using exactly the timings
+/// given. i.e. No adaptive timing calibration.
+/// @see _matchGeneric() for the parameters & return value.
+uint16_t IRrecv::_matchTimings(volatile uint16_t *data_ptr,
+                               uint64_t *result_bits_ptr,
+                               uint8_t *result_bytes_ptr,
+                               const bool use_bits,
+                               const uint16_t remaining,
+                               const uint16_t nbits,
+                               const uint16_t hdrmark,
+                               const uint32_t hdrspace,
+                               const uint16_t onemark,
+                               const uint32_t onespace,
+                               const uint16_t zeromark,
+                               const uint32_t zerospace,
+                               const uint16_t footermark,
+                               const uint32_t footerspace,
+                               const bool atleast,
+                               const uint8_t tolerance,
+                               const int16_t excess,
+                               const bool MSBfirst) {
   // If we are expecting byte sizes, check it's a factor of 8 or fail.
   if (!use_bits && nbits % 8 != 0)  return 0;
   // Calculate if we expect a trailing space in the data section.
@@ -13,6 +13,8 @@
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
 #include "IRremoteESP8266.h"
+#include "IRsend.h"
+#include "IRtimer.h"
 
 // Constants
 const uint16_t kHeader = 2;        // Usual nr. of header entries.
@@ -48,9 +50,30 @@ const uint8_t kTimeoutMs = 15;  // In MilliSeconds.
 #define TIMEOUT_MS kTimeoutMs   // For legacy documentation.
 const uint16_t kMaxTimeoutMs = kRawTick * (UINT16_MAX / MS_TO_USEC(1));
 
-// Use FNV hash algorithm: http://isthe.com/chongo/tech/comp/fnv/#FNV-param
-const uint32_t kFnvPrime32 = 16777619UL;
-const uint32_t kFnvBasis32 = 2166136261UL;
+// How `decodeHash()` hashes an UNKNOWN message. See `IRrecv::setHashMode()`.
+const uint8_t kHashLegacy = 0;  // 32 bits. Each duration vs. the one before.
+const uint8_t kHashLogBuckets = 1;  // 64 bits. Log-scale duration buckets.
+
+// Nr. of recently decoded messages remembered, to recognise duplicates.
+// See `IRrecv::setDuplicateWindow()`.
+const uint8_t kDuplicateCacheSize = 4;
+
+// Spaces at least this long (uSeconds) separate the frames of a message.
+// See `IRrecv::analyseRaw()`.
+const uint32_t kLearnMinGap = 10000;
+// Max nr. of sections of a message `IRrecv::setAssembly()` will join.
+// e.g. Daikin is sent as four.
+const uint8_t kAssembleMaxSections = 4;
+// Max nr. of different data mark, or space, durations `analyseRaw()` can use.
+const uint8_t kLearnTimingClasses = 8;
+
+// Adaptive timing calibration. See `IRrecv::setAdaptiveTiming()`.
+const uint8_t kCalibrationSlots = 8;  // Nr. of different timings to learn.
+const uint8_t kCalibrationMinSamples = 2;  // Frames needed before it's used.
+const uint16_t kCalibrationUnity = 1024;  // A `scale` of exactly 1.0
+const uint16_t kCalibrationMaxSkew = 128;  // Max. `scale` change. (12.5%)
+const int16_t kCalibrationMaxExcess = 300;  // Max. `excess` in uSeconds.
+const uint8_t kCalibrationPending = 4;  // Max. frames learnt per message.
 
 // Which of the ESP32 timers to use by default. (0-3)
 const uint8_t kDefaultESP32Timer = 3;
@@ -86,6 +109,168 @@ typedef struct {
   uint16_t used;  // How many buffer positions were used.
 } match_result_t;
 
+/// What adaptive timing calibration has learnt about one set of timings.
+/// i.e. How a particular sender/receiver pair distorts a protocol's timings.
+typedef struct {
+  uint16_t id;      // Which protocol timings this is for. (A hash of them)
+  uint16_t scale;   // Measured vs. expected durations. (kCalibrationUnity=1.0)
+  int16_t excess;   // uSecs marks are longer, and spaces shorter, than usual.
+  uint8_t samples;  // Nr. of frames it was learnt from. 0 means unused.
+} timing_calibration_t;
+
+/// What it takes to capture a whole message of a protocol in one go.
+/// @see kCaptureNeeds, kRawBufAuto, kTimeoutMsAuto
+typedef struct {
+  bool enabled;            // Is the protocol's decoder compiled in?
+  decode_type_t protocol;  // Which protocol it is for.
+  uint16_t bufsize;        // Min. `bufsize` that holds a whole message.
+  uint8_t timeout;         // Min. `timeout` (ms) that won't split a message.
+} capture_needs_t;
+
+// The capture needs of each decodable protocol. Measured from what `IRsend`
+// produces for its default sized (or largest) message, using the worst of a
+// few payloads. The timeout is 25% more than the longest space the decoder
+// needs to see in the same capture. `TestIRrecvAutoSize` keeps them honest.
+// Protocols that are decoded as another one are covered by it.
+// e.g. SHERWOOD by NEC. MWM can't be sent via `IRsend::send()`, so it is an
+// estimate for 16 bytes of data.
+constexpr capture_needs_t kCaptureNeeds[] = {
+  {DECODE_RC5, RC5, 29, 3},
+  {DECODE_RC6, RC6, 45, 2},
+  {DECODE_NEC, NEC, 69, 6},
+  {DECODE_SONY, SONY, 43, 1},
+  {DECODE_PANASONIC, PANASONIC, 101, 3},
+  {DECODE_JVC, JVC, 37, 6},
+  {DECODE_SAMSUNG, SAMSUNG, 69, 6},
+  {DECODE_WHYNTER, WHYNTER, 72, 66},
+  {DECODE_AIWA_RC_T501, AIWA_RC_T501, 89, 6},
+  {DECODE_LG, LG, 61, 6},
+  {DECODE_MITSUBISHI, MITSUBISHI, 35, 3},
+  {DECODE_DISH, DISH, 140, 8},
+  {DECODE_SHARP, SHARP, 66, 55},
+  {DECODE_COOLIX, COOLIX, 201, 6},
+  {DECODE_DAIKIN, DAIKIN, 586, 37},
+  {DECODE_DENON, DENON, 66, 55},
+  {DECODE_KELVINATOR, KELVINATOR, 282, 50},
+  {DECODE_MITSUBISHI_AC, MITSUBISHI_AC, 586, 22},
+  {DECODE_RCMM, RCMM, 29, 1},
+  {DECODE_SANYO, SANYO_LC7461, 89, 6},
+  {DECODE_GREE, GREE, 142, 25},
+  {DECODE_ARGO, ARGO, 196, 5},
+  {DECODE_TROTEC, TROTEC, 152, 10},
+  {DECODE_NIKAI, NIKAI, 53, 6},
+  {DECODE_TOSHIBA_AC, TOSHIBA_AC, 298, 10},
+  {DECODE_FUJITSU_AC, FUJITSU_AC, 261, 2},
+  {DECODE_MIDEA, MIDEA, 201, 8},
+  {DECODE_MAGIQUEST, MAGIQUEST, 113, 2},
+  {DECODE_LASERTAG, LASERTAG, 29, 1},
+  {DECODE_CARRIER_AC, CARRIER_AC, 206, 26},
+  {DECODE_HAIER_AC, HAIER_AC, 151, 6},
+  {DECODE_MITSUBISHI2, MITSUBISHI2, 78, 36},
+  {DECODE_HITACHI_AC, HITACHI_AC, 453, 3},
+  {DECODE_HITACHI_AC1, HITACHI_AC1, 213, 5},
+  {DECODE_HITACHI_AC2, HITACHI_AC2, 853, 3},
+  {DECODE_GICABLE, GICABLE, 41, 53},
+  {DECODE_HAIER_AC_YRW02, HAIER_AC_YRW02, 231, 6},
+  {DECODE_WHIRLPOOL_AC, WHIRLPOOL_AC, 345, 10},
+  {DECODE_SAMSUNG_AC, SAMSUNG_AC, 351, 23},
+  {DECODE_LUTRON, LUTRON, 37, 101},
+  {DECODE_ELECTRA_AC, ELECTRA_AC, 213, 6},
+  {DECODE_PANASONIC_AC, PANASONIC_AC, 441, 13},
+  {DECODE_PIONEER, PIONEER, 138, 48},
+  {DECODE_LG, LG2, 61, 13},
+  {DECODE_MWM, MWM, 162, 5},
+  {DECODE_DAIKIN2, DAIKIN2, 636, 45},
+  {DECODE_VESTEL_AC, VESTEL_AC, 117, 12},
+  {DECODE_TECO, TECO, 75, 6},
+  {DECODE_SAMSUNG36, SAMSUNG36, 79, 6},
+  {DECODE_TCL112AC, TCL112AC, 229, 3},
+  {DECODE_LEGOPF, LEGOPF, 37, 2},
+  {DECODE_MITSUBISHIHEAVY, MITSUBISHI_HEAVY_88, 181, 3},
+  {DECODE_MITSUBISHIHEAVY, MITSUBISHI_HEAVY_152, 309, 3},
+  {DECODE_DAIKIN216, DAIKIN216, 442, 38},
+  {DECODE_SHARP_AC, SHARP_AC, 213, 3},
+  {DECODE_GOODWEATHER, GOODWEATHER, 199, 9},
+  {DECODE_INAX, INAX, 53, 6},
+  {DECODE_DAIKIN160, DAIKIN160, 330, 38},
+  {DECODE_NEOCLIMA, NEOCLIMA, 199, 10},
+  {DECODE_DAIKIN176, DAIKIN176, 362, 37},
+  {DECODE_DAIKIN128, DAIKIN128, 268, 26},
+  {DECODE_AMCOR, AMCOR, 266, 43},
+  {DECODE_DAIKIN152, DAIKIN152, 322, 32},
+  {DECODE_MITSUBISHI136, MITSUBISHI136, 277, 2},
+  {DECODE_MITSUBISHI112, MITSUBISHI112, 229, 3},
+  {DECODE_HITACHI_AC424, HITACHI_AC424, 855, 62},
+  {DECODE_EPSON, EPSON, 206, 73},
+  {DECODE_SYMPHONY, SYMPHONY, 25, 2},
+  {DECODE_HITACHI_AC3, HITACHI_AC3, 437, 3},
+  {DECODE_DAIKIN64, DAIKIN64, 139, 26},
+  {DECODE_AIRWELL, AIRWELL, 213, 5},
+  {DECODE_DELONGHI_AC, DELONGHI_AC, 133, 6},
+  {DECODE_DOSHISHA, DOSHISHA, 85, 3},
+  {DECODE_MULTIBRACKETS, MULTIBRACKETS, 22, 88},
+  {DECODE_CARRIER_AC40, CARRIER_AC40, 85, 6},
+  {DECODE_CARRIER_AC64, CARRIER_AC64, 133, 6},
+  {DECODE_HITACHI_AC344, HITACHI_AC344, 693, 3},
+  {DECODE_CORONA_AC, CORONA_AC, 350, 14},
+  {DECODE_MIDEA24, MIDEA24, 101, 6},
+  {DECODE_ZEPEAL, ZEPEAL, 182, 9},
+  {DECODE_SANYO_AC, SANYO_AC, 149, 6},
+  {DECODE_VOLTAS, VOLTAS, 163, 4},
+  {DECODE_METZ, METZ, 43, 3},
+  {DECODE_TRANSCOLD, TRANSCOLD, 103, 10},
+  {DECODE_TECHNIBEL_AC, TECHNIBEL_AC, 117, 6},
+  {DECODE_MIRAGE, MIRAGE, 245, 6},
+  {DECODE_ELITESCREENS, ELITESCREENS, 65, 2},
+  {DECODE_PANASONIC_AC32, PANASONIC_AC32, 274, 18},
+  {DECODE_MILESTAG2, MILESTAG2, 31, 1},
+  {DECODE_ECOCLIM, ECOCLIM, 345, 3},
+  {DECODE_XMP, XMP, 37, 17},
+  {DECODE_TRUMA, TRUMA, 119, 2},
+  {DECODE_HAIER_AC176, HAIER_AC176, 359, 6},
+  {DECODE_TEKNOPOINT, TEKNOPOINT, 229, 3},
+  {DECODE_KELON, KELON, 101, 6},
+};
+const uint16_t kCaptureNeedsSize = sizeof(kCaptureNeeds) /
+                                   sizeof(kCaptureNeeds[0]);
+
+/// Find the largest capture buffer the enabled protocols need.
+/// @param[in] i The entry of `kCaptureNeeds` to start at.
+/// @param[in] most The largest found so far.
+/// @return The size needed, or 0 if no protocols are enabled.
+constexpr uint16_t captureBufNeeded(const uint16_t i = 0,
+                                    const uint16_t most = 0) {
+  return (i >= kCaptureNeedsSize) ? most
+      : captureBufNeeded(i + 1, (kCaptureNeeds[i].enabled &&
+                                 kCaptureNeeds[i].bufsize > most)
+                                    ? kCaptureNeeds[i].bufsize : most);
+}
+
+/// Find the shortest timeout that won't split a message of any of the
+/// enabled protocols.
+/// @param[in] i The entry of `kCaptureNeeds` to start at.
+/// @param[in] most The longest found so far.
+/// @return The timeout needed in milli-Seconds, or 0 if no protocols are
+///   enabled.
+constexpr uint8_t captureTimeoutNeeded(const uint16_t i = 0,
+                                       const uint8_t most = 0) {
+  return (i >= kCaptureNeedsSize) ? most
+      : captureTimeoutNeeded(i + 1, (kCaptureNeeds[i].enabled &&
+                                     kCaptureNeeds[i].timeout > most)
+                                        ? kCaptureNeeds[i].timeout : most);
+}
+
+// A capture buffer size & timeout tuned to just the protocols enabled in this
+// build. e.g. `IRrecv irrecv(kRecvPin, kRawBufAuto, kTimeoutMsAuto);`
+// A build that only decodes NEC needs a lot less RAM, and will report
+// messages sooner, than one that can decode large A/C messages.
+// Note: UNKNOWN messages are not accounted for. If no protocols are enabled,
+//       it is the same as `kRawBuf` & `kTimeoutMs`.
+const uint16_t kRawBufAuto = captureBufNeeded() ? captureBufNeeded()
+                                                : kRawBuf;
+const uint8_t kTimeoutMsAuto = captureTimeoutNeeded() ? captureTimeoutNeeded()
+                                                      : kTimeoutMs;
+
 // Classes
 
 /// Results returned from the decoder
@@ -104,12 +289,26 @@ class decode_results {
     uint8_t state[kStateSizeMax];  // Multi-byte results.
   };
   uint16_t bits;              // Number of bits in decoded value
-  volatile uint16_t *rawbuf;  // Raw intervals in .5 us ticks
+  // Raw intervals in .5 us ticks. rawbuf[0] is how long it was quiet before
+  // the capture started (capped at 0xFFFF), rather than always 1.
+  volatile uint16_t *rawbuf;
   uint16_t rawlen;            // Number of records in rawbuf.
   bool overflow;
   bool repeat;  // Is the result a repeat code?
 };
 
+class IRrecv;
+
+/// A method of `IRrecv` that decodes a protocol. e.g. `decodeNEC()`
+typedef bool (IRrecv::*decode_fn_t)(decode_results *results, uint16_t offset,
+                                    const uint16_t nbits, const bool strict);
+
+/// How `IRrecv::decodeAs()` decodes a protocol.
+typedef struct {
+  decode_type_t protocol;  ///< Which protocol it is.
+  decode_fn_t decoder;  ///< How to decode it. NULL if we can't.
+} protocol_decoder_t;
+
 /// Class for receiving IR messages.
 class IRrecv {
  public:
@@ -128,12 +327,25 @@ class IRrecv {
   uint8_t getTolerance(void);
   bool decode(decode_results *results, irparams_t *save = NULL,
               uint8_t max_skip = 0, uint16_t noise_floor = 0);
+  bool decodeAs(decode_results *results, const decode_type_t protocol,
+                const uint16_t nbits, const bool strict = true);
   void enableIRIn(const bool pullup = false);
   void disableIRIn(void);
   void resume(void);
   uint16_t getBufSize(void);
+  void setEchoSource(IRsend *irsend);
+  void setDuplicateWindow(const uint16_t msecs, const bool drop = true);
+  bool setAssembly(const uint16_t bufsize,
+                   const uint8_t max_gap = kTimeoutMsAuto);
+  bool analyseRaw(const decode_results *results, learned_code_t *code);
+  void setAdaptiveTiming(const bool on);
+  bool getAdaptiveTiming(void);
+  uint8_t getCalibration(timing_calibration_t *table);
+  void setCalibration(const timing_calibration_t *table, const uint8_t count);
 #if DECODE_HASH
   void setUnknownThreshold(const uint16_t length);
+  void setHashMode(const uint8_t mode);
+  uint8_t getHashMode(void);
 #endif
   bool match(const uint32_t measured, const uint32_t desired,
              const uint8_t tolerance = kUseDefTol,
@@ -156,19 +368,72 @@ class IRrecv {
 #endif
   irparams_t *irparams_save;
   uint8_t _tolerance;
+  IRsend *_echo_source;  // Whose transmissions to ignore, if any.
+  uint16_t _dup_window;  // How long (mSeconds) to look for duplicates. 0 = Off
+  bool _dup_drop;  // Drop duplicates? (or just flag them)
+  uint32_t _dup_hash[kDuplicateCacheSize];  // Recent messages. (hashed)
+  IRtimer _dup_time[kDuplicateCacheSize];  // When each was first seen.
+  bool _adaptive;  // Learn & use per-protocol timing corrections?
+  uint16_t *_asm_buf;  // The sections being held, back to back. See assemble()
+  uint16_t _asm_size;  // Nr. of entries `_asm_buf` can hold. 0 = Off
+  uint16_t _asm_len;  // Nr. of entries held.
+  uint16_t _asm_start[kAssembleMaxSections];  // Where each section starts.
+  uint8_t _asm_sections;  // Nr. of sections held.
+  uint8_t _asm_gap;  // Longest gap (mSeconds) between sections.
+  timing_calibration_t _calibration[kCalibrationSlots];
+  // Learnt from the message being decoded. Kept only if it is accepted.
+  timing_calibration_t _cal_pending[kCalibrationPending];
+  uint8_t _cal_pending_count;  // Nr. of `_cal_pending` entries in use.
 #if defined(ESP32)
   uint8_t _timer_num;
 #endif  // defined(ESP32)
 #if DECODE_HASH
   uint16_t _unknown_threshold;
+  uint8_t _hash_mode;
 #endif
 #ifdef UNIT_TEST
   volatile irparams_t *_getParamsPtr(void);
 #endif  // UNIT_TEST
   // These are called by decode
   uint8_t _validTolerance(const uint8_t percentage);
+  bool matchEcho(const decode_results *results);
+  bool _decode(decode_results *results, irparams_t *save,
+               uint8_t max_skip, uint16_t noise_floor);
+  bool isDuplicate(const decode_results *results);
+  void expireDuplicates(void);
+  bool assemble(decode_results *results, uint8_t max_skip);
+  bool decodeProtocols(decode_results *results, uint8_t max_skip);
+  uint16_t learnFrame(const decode_results *results, uint16_t offset,
+                      learned_code_t *code);
   void copyIrParams(volatile irparams_t *src, irparams_t *dst);
   uint16_t compare(const uint16_t oldval, const uint16_t newval);
+  uint64_t hashLogBuckets(const decode_results *results);
+  timing_calibration_t *findCalibration(const uint16_t id);
+  bool accept(const bool decoded);
+  void calibrate(volatile uint16_t *data_ptr, const uint16_t id,
+                 const uint16_t nbits,
+                 const uint16_t hdrmark, const uint32_t hdrspace,
+                 const uint16_t onemark, const uint32_t onespace,
+                 const uint16_t zeromark, const uint32_t zerospace,
+                 const uint16_t footermark);
+  uint16_t _matchTimings(volatile uint16_t *data_ptr,
+                         uint64_t *result_bits_ptr,
+                         uint8_t *result_ptr,
+                         const bool use_bits,
+                         const uint16_t remaining,
+                         const uint16_t required,
+                         const uint16_t hdrmark,
+                         const uint32_t hdrspace,
+                         const uint16_t onemark,
+                         const uint32_t onespace,
+                         const uint16_t zeromark,
+                         const uint32_t zerospace,
+                         const uint16_t footermark,
+                         const uint32_t footerspace,
+                         const bool atleast,
+                         const uint8_t tolerance,
+                         const int16_t excess,
+                         const bool MSBfirst);
   uint32_t ticksLow(const uint32_t usecs,
                     const uint8_t tolerance = kUseDefTol,
                     const uint16_t delta = 0);
@@ -178,6 +443,16 @@ class IRrecv {
   bool matchAtLeast(const uint32_t measured, const uint32_t desired,
                     const uint8_t tolerance = kUseDefTol,
                     const uint16_t delta = 0);
+  void tickRange(const uint32_t usecs, const uint8_t tolerance,
+                 uint16_t *low, uint16_t *high);
+#if ENABLE_SLICED_MATCH || defined(UNIT_TEST)
+  uint16_t matchBytesSliced(volatile uint16_t *data_ptr, uint8_t *result_ptr,
+                            const uint16_t remaining, const uint16_t nbytes,
+                            const uint16_t onemark, const uint32_t onespace,
+                            const uint16_t zeromark, const uint32_t zerospace,
+                            const uint8_t tolerance, const int16_t excess,
+                            const bool MSBfirst, const bool expectlastspace);
+#endif  // ENABLE_SLICED_MATCH || defined(UNIT_TEST)
   uint16_t _matchGeneric(volatile uint16_t *data_ptr,
                          uint64_t *result_bits_ptr,
                          uint8_t *result_ptr,
@@ -331,7 +606,7 @@ class IRrecv {
                            const uint16_t nbits = kMitsubishi136Bits,
                            const bool strict = true);
 #endif
-#if DECODE_MITSUBISHI112
+#if DECODE_MITSUBISHI112 || DECODE_TCL112AC
   bool decodeMitsubishi112(decode_results *results,
                            uint16_t offset = kStartOffset,
                            const uint16_t nbits = kMitsubishi112Bits,
@@ -370,6 +645,12 @@ class IRrecv {
                        const bool strict = false,
                        const uint32_t manufacturer = kPanasonicManufacturer);
 #endif
+#if DECODE_PANASONIC
+  bool decodePanasonic64(decode_results *results,
+                         uint16_t offset = kStartOffset,
+                         const uint16_t nbits = kPanasonicBits,
+                         const bool strict = false);
+#endif  // DECODE_PANASONIC
 #if DECODE_LG
   bool decodeLG(decode_results *results, uint16_t offset = kStartOffset,
                 const uint16_t nbits = kLgBits,
@@ -390,7 +671,7 @@ class IRrecv {
                      const uint16_t nbits = kSamsungBits,
                      const bool strict = true);
 #endif
-#if DECODE_SAMSUNG
+#if DECODE_SAMSUNG36
   bool decodeSamsung36(decode_results *results, uint16_t offset = kStartOffset,
                        const uint16_t nbits = kSamsung36Bits,
                        const bool strict = true);
@@ -425,6 +706,11 @@ class IRrecv {
                    const uint16_t nbits = kSharpBits,
                    const bool strict = true, const bool expansion = true);
 #endif
+#if DECODE_SHARP
+  bool decodeSharpRaw(decode_results *results, uint16_t offset = kStartOffset,
+                      const uint16_t nbits = kSharpBits,
+                      const bool strict = true);
+#endif  // DECODE_SHARP
 #if DECODE_SHARP_AC
   bool decodeSharpAc(decode_results *results, uint16_t offset = kStartOffset,
                      const uint16_t nbits = kSharpAcBits,
@@ -570,10 +856,11 @@ class IRrecv {
                         const uint16_t nbits = kHaierAC176Bits,
                         const bool strict = true);
 #endif  // DECODE_HAIER_AC176
-#if (DECODE_HITACHI_AC || DECODE_HITACHI_AC2 || DECODE_HITACHI_AC344)
+#if (DECODE_HITACHI_AC || DECODE_HITACHI_AC1 || DECODE_HITACHI_AC2 || \
+     DECODE_HITACHI_AC344)
   bool decodeHitachiAC(decode_results *results, uint16_t offset = kStartOffset,
                        const uint16_t nbits = kHitachiAcBits,
-                       const bool strict = true, const bool MSBfirst = true);
+                       const bool strict = true);
 #endif
 #if DECODE_HITACHI_AC1
   bool decodeHitachiAC1(decode_results *results, uint16_t offset = kStartOffset,
@@ -816,6 +816,16 @@
 #define ENABLE_NOISE_FILTER_OPTION true
 #endif  // ENABLE_NOISE_FILTER_OPTION
 
+// Match the data section of long (byte based) messages, e.g. A/C ones, many
+// timings at a time, in a way the compiler can vectorise (SSE2, NEON, etc),
+// rather than bit by bit. The results are identical either way.
+// It is only worth it on a PC, e.g. when decoding large archives of captures
+// with the tools, which turn it on. It is off by default, so the unit tests
+// use the same bit by bit matching as the ESP8266 & ESP32 do.
+#ifndef ENABLE_SLICED_MATCH
+#define ENABLE_SLICED_MATCH false
+#endif  // ENABLE_SLICED_MATCH
+
 /// Enumerator for defining and numbering of supported IR protocol.
 /// @note Always add to the end of the list and should never remove entries
 ///  or change order. Projects may save the type number for later usage
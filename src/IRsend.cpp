@@ -14,6 +14,7 @@
 #include <cmath>
 #endif
 #include "IRtimer.h"
+#include "IRutils.h"
 
 /// Constructor for an IRsend object.
 /// @param[in] IRsendPin Which GPIO pin to use when sending an IR command.
@@ -26,7 +27,8 @@
 ///  i.e. If not, assume a 100% duty cycle. Ignore attempts to change the
 ///  duty cycle etc.
 IRsend::IRsend(uint16_t IRsendPin, bool inverted, bool use_modulation)
-    : IRpin(IRsendPin), periodOffset(kPeriodOffset) {
+    : IRpin(IRsendPin), periodOffset(kPeriodOffset), _echo_log(NULL),
+      _echo_size(0), _echo_len(0), _echo_used(0), _echo_last(0) {
   if (inverted) {
     outputOn = LOW;
     outputOff = HIGH;
@@ -155,6 +157,7 @@ void IRsend::_delayMicroseconds(uint32_t usec) {
 /// Ref:
 ///   https://www.analysir.com/blog/2017/01/29/updated-esp8266-nodemcu-backdoor-upwm-hack-for-ir-signals/
 uint16_t IRsend::mark(uint16_t usec) {
+  logEcho(usec, true);
   // Handle the simple case of no required frequency modulation.
   if (!modulation || _dutycycle >= 100) {
     ledOn();
@@ -192,11 +195,54 @@ uint16_t IRsend::mark(uint16_t usec) {
 /// A space is no output, so the PWM output is disabled.
 /// @param[in] time Time in microseconds (us).
 void IRsend::space(uint32_t time) {
+  logEcho(time, false);
   ledOff();
   if (time == 0) return;
   _delayMicroseconds(time);
 }
 
+/// Keep a record of the marks & spaces we send, so a receiver that is still
+/// capturing while we transmit can recognise & ignore them.
+/// i.e. Echo suppression, rather than disabling capture while sending.
+/// @param[in] log Somewhere to keep the record, or NULL to stop recording.
+///   It must be at least as large as the messages it is to cover.
+/// @param[in] size The nr. of entries `log` can hold.
+/// @see IRrecv::setEchoSource()
+void IRsend::setEchoLog(uint16_t *log, const uint16_t size) {
+  _echo_log = log;
+  _echo_size = (log == NULL) ? 0 : size;
+  _echo_len = 0;
+  _echo_used = 0;
+}
+
+/// Record a mark or space as it is sent, if we've been asked to.
+/// @param[in] usecs The duration of it, in microseconds.
+/// @param[in] is_mark Is it a mark? (or a space)
+void IRsend::logEcho(const uint32_t usecs, const bool is_mark) {
+  if (_echo_log == NULL || usecs == 0) return;
+  // It's a new transmission if nothing has been sent for a while.
+  if (!echoRecent()) {
+    _echo_len = 0;
+    _echo_used = 0;
+  }
+  _echo_timer.reset();
+  _echo_last = usecs;
+  if (_echo_len >= _echo_size) return;  // Full. Only the start is kept.
+  // Marks are at even entries, spaces at odd ones.
+  if (_echo_len && ((_echo_len & 1) == is_mark)) {  // Same as the last one.
+    _echo_log[_echo_len - 1] = std::min(
+        (uint32_t)_echo_log[_echo_len - 1] + usecs, (uint32_t)UINT16_MAX);
+  } else if (_echo_len || is_mark) {  // Never start with a space.
+    _echo_log[_echo_len++] = std::min(usecs, (uint32_t)UINT16_MAX);
+  }
+}
+
+/// Could what we last sent still be heard? i.e. Is the record still useful?
+/// @return true, if it could be. false, if not.
+bool IRsend::echoRecent(void) {
+  return _echo_len && _echo_timer.elapsed() <= _echo_last + kEchoTimeout;
+}
+
 /// Calculate & set any offsets to account for execution times during sending.
 ///
 /// @param[in] hz The frequency to calibrate at >= 1000Hz. Default is 38000Hz.
@@ -432,6 +478,32 @@ void IRsend::sendGeneric(const uint16_t headermark, const uint32_t headerspace,
   }
 }
 
+/// Send a message learned from a capture, as often as it was captured.
+/// @param[in] code The message to send. See `IRrecv::analyseRaw()`.
+/// @param[in] frequency The frequency we want to modulate at. (Hz/kHz)
+/// @note The same as `sendGeneric()`, except the data needn't be whole bytes.
+void IRsend::sendLearned(const learned_code_t *code,
+                         const uint16_t frequency) {
+  const uint16_t nbytes = std::min(code->nbits / 8, (int)kLearnedMaxBytes);
+  const uint8_t extra = (nbytes < kLearnedMaxBytes) ? code->nbits % 8 : 0;
+  enableIROut(frequency, kDutyDefault);
+  for (uint16_t r = 0; r <= code->repeat; r++) {
+    // Header
+    if (code->hdrmark) mark(code->hdrmark);
+    if (code->hdrspace) space(code->hdrspace);
+    // Data
+    for (uint16_t i = 0; i < nbytes; i++)
+      sendData(code->onemark, code->onespace, code->zeromark, code->zerospace,
+               code->data[i], 8, true);
+    if (extra)  // The bits left over are at the top of the last byte.
+      sendData(code->onemark, code->onespace, code->zeromark, code->zerospace,
+               code->data[nbytes] >> (8 - extra), extra, true);
+    // Footer
+    if (code->footermark) mark(code->footermark);
+    space(code->gap);
+  }
+}
+
 /// Generic method for sending Manchester code data.
 /// Will send leading or trailing 0's if the nbits is larger than the number
 /// of bits in data.
@@ -549,218 +621,699 @@ void IRsend::sendRaw(const uint16_t buf[], const uint16_t len,
   }
   ledOff();  // We potentially have ended with a mark(), so turn of the LED.
 }
+
+/// Send a raw IRremote message, converting it from text as it is sent.
+/// i.e. The message doesn't need to be stored anywhere first.
+/// @param[in,out] reader Where to read the microsecond values from.
+///   e.g. `irutils::ValueReader reader("9000,4500,600,1450,600,900");`
+/// @param[in] hz Frequency to send the message at. (kHz < 1000; Hz >= 1000)
+/// @return The nr. of values sent. Use `reader->failed()` to check if all of
+///   the input was valid.
+/// @note Even values are Mark times (On), Odd values are Space times (Off).
+/// @note Each value is converted just before it is sent, which adds a few
+///   microseconds to each mark & space. Malformed input stops the message.
+uint16_t IRsend::sendRaw(irutils::ValueReader *reader, const uint16_t hz) {
+  enableIROut(hz);
+  uint16_t usecs;
+  uint16_t i = 0;
+  for (; reader->next(&usecs); i++) {
+    if (i & 1)  // Odd bit.
+      space(usecs);
+    else  // Even bit.
+      mark(usecs);
+  }
+  ledOff();  // We potentially have ended with a mark(), so turn of the LED.
+  return i;
+}
 #endif  // SEND_RAW
 
+/// Everything the library knows about each protocol, indexed by
+/// `decode_type_t`. It is the one place `minRepeats()`, `defaultBits()`,
+/// `hasACState()`, & `IRac::isProtocolSupported()` get it from.
+/// i.e. {protocol, default bits, min. repeats, uses a state[]?, IRac support}
+/// @note It holds no sending methods, so using it doesn't link them all in.
+static constexpr protocol_info_t kProtocols[] = {
+  {UNUSED, 0, kNoRepeat, false, false},
+  {RC5, 12, kNoRepeat, false, false},
+  {RC6, 20, kNoRepeat, false, false},
+  {NEC, 32, kNoRepeat, false, false},
+  {SONY, 20, kSonyMinRepeat, false, false},
+  {PANASONIC, 48, kNoRepeat, false, false},
+  {JVC, 16, kNoRepeat, false, false},
+  {SAMSUNG, 32, kNoRepeat, false, false},
+  {WHYNTER, 32, kNoRepeat, false, false},
+  {AIWA_RC_T501, 15, kSingleRepeat, false, false},
+  {LG, 28, kNoRepeat, false, SEND_LG},
+  {SANYO, 0, kNoRepeat, false, false},
+  {MITSUBISHI, 16, kSingleRepeat, false, false},
+  {DISH, 16, kDishMinRepeat, false, false},
+  {SHARP, 15, kNoRepeat, false, false},
+  {COOLIX, 24, kSingleRepeat, false, SEND_COOLIX},
+  {DAIKIN, kDaikinBits, kNoRepeat, true, SEND_DAIKIN},
+  {DENON, 15, kNoRepeat, false, false},
+  {KELVINATOR, kKelvinatorBits, kNoRepeat, true, SEND_KELVINATOR},
+  {SHERWOOD, 32, kSingleRepeat, false, false},
+  {MITSUBISHI_AC, kMitsubishiACBits, kSingleRepeat, true, SEND_MITSUBISHI_AC},
+  {RCMM, 24, kNoRepeat, false, false},
+  {SANYO_LC7461, kSanyoLC7461Bits, kNoRepeat, false, false},
+  {RC5X, 13, kNoRepeat, false, false},
+  {GREE, kGreeBits, kNoRepeat, true, SEND_GREE},
+  {PRONTO, 0, kNoRepeat, false, false},
+  {NEC_LIKE, 32, kNoRepeat, false, false},
+  {ARGO, kArgoBits, kNoRepeat, true, SEND_ARGO},
+  {TROTEC, kTrotecBits, kNoRepeat, true, SEND_TROTEC},
+  {NIKAI, 24, kNoRepeat, false, false},
+  {RAW, 0, kNoRepeat, false, false},
+  {GLOBALCACHE, 0, kNoRepeat, false, false},
+  {TOSHIBA_AC, kToshibaACBits, kSingleRepeat, true, SEND_TOSHIBA_AC},
+  {FUJITSU_AC, 0, kNoRepeat, true, SEND_FUJITSU_AC},
+  {MIDEA, 48, kNoRepeat, false, SEND_MIDEA},
+  {MAGIQUEST, 56, kNoRepeat, false, false},
+  {LASERTAG, 13, kNoRepeat, false, false},
+  {CARRIER_AC, 32, kNoRepeat, false, false},
+  {HAIER_AC, kHaierACBits, kNoRepeat, true, SEND_HAIER_AC},
+  {MITSUBISHI2, 16, kSingleRepeat, false, false},
+  {HITACHI_AC, kHitachiAcBits, kNoRepeat, true, SEND_HITACHI_AC},
+  {HITACHI_AC1, kHitachiAc1Bits, kNoRepeat, true, SEND_HITACHI_AC1},
+  {HITACHI_AC2, kHitachiAc2Bits, kNoRepeat, true, false},
+  {GICABLE, 16, kSingleRepeat, false, false},
+  {HAIER_AC_YRW02, kHaierACYRW02Bits, kNoRepeat, true, SEND_HAIER_AC_YRW02},
+  {WHIRLPOOL_AC, kWhirlpoolAcBits, kNoRepeat, true, SEND_WHIRLPOOL_AC},
+  {SAMSUNG_AC, kSamsungAcBits, kNoRepeat, true, SEND_SAMSUNG_AC},
+  {LUTRON, 35, kNoRepeat, false, false},
+  {ELECTRA_AC, kElectraAcBits, kNoRepeat, true, SEND_ELECTRA_AC},
+  {PANASONIC_AC, kPanasonicAcBits, kNoRepeat, true, SEND_PANASONIC_AC},
+  {PIONEER, 64, kNoRepeat, false, false},
+  {LG2, 28, kNoRepeat, false, SEND_LG},
+  {MWM, 0, kNoRepeat, true, false},
+  {DAIKIN2, kDaikin2Bits, kNoRepeat, true, SEND_DAIKIN2},
+  {VESTEL_AC, 56, kNoRepeat, false, SEND_VESTEL_AC},
+  {TECO, 35, kNoRepeat, false, SEND_TECO},
+  {SAMSUNG36, 36, kNoRepeat, false, false},
+  {TCL112AC, kTcl112AcBits, kNoRepeat, true, SEND_TCL112AC},
+  {LEGOPF, 16, kNoRepeat, false, false},
+  {MITSUBISHI_HEAVY_88, kMitsubishiHeavy88Bits, kNoRepeat, true,
+   SEND_MITSUBISHIHEAVY},
+  {MITSUBISHI_HEAVY_152, kMitsubishiHeavy152Bits, kNoRepeat, true,
+   SEND_MITSUBISHIHEAVY},
+  {DAIKIN216, kDaikin216Bits, kNoRepeat, true, SEND_DAIKIN216},
+  {SHARP_AC, kSharpAcBits, kNoRepeat, true, SEND_SHARP_AC},
+  {GOODWEATHER, 48, kNoRepeat, false, SEND_GOODWEATHER},
+  {INAX, 24, kSingleRepeat, false, false},
+  {DAIKIN160, kDaikin160Bits, kNoRepeat, true, SEND_DAIKIN160},
+  {NEOCLIMA, kNeoclimaBits, kNoRepeat, true, SEND_NEOCLIMA},
+  {DAIKIN176, kDaikin176Bits, kNoRepeat, true, SEND_DAIKIN176},
+  {DAIKIN128, kDaikin128Bits, kNoRepeat, true, SEND_DAIKIN128},
+  {AMCOR, 64, kSingleRepeat, true, SEND_AMCOR},
+  {DAIKIN152, kDaikin152Bits, kNoRepeat, true, SEND_DAIKIN152},
+  {MITSUBISHI136, kMitsubishi136Bits, kNoRepeat, true, SEND_MITSUBISHI136},
+  {MITSUBISHI112, kMitsubishi112Bits, kNoRepeat, true, SEND_MITSUBISHI112},
+  {HITACHI_AC424, kHitachiAc424Bits, kNoRepeat, true, SEND_HITACHI_AC424},
+  {SONY_38K, 20, kSonyMinRepeat + 1, false, false},
+  {EPSON, 32, kEpsonMinRepeat, false, false},
+  {SYMPHONY, 12, kSymphonyDefaultRepeat, false, false},
+  {HITACHI_AC3, kHitachiAc3Bits, kNoRepeat, true, false},
+  {DAIKIN64, kDaikin64Bits, kNoRepeat, false, SEND_DAIKIN64},
+  {AIRWELL, 34, kAirwellMinRepeats, false, SEND_AIRWELL},
+  {DELONGHI_AC, 64, kNoRepeat, false, SEND_DELONGHI_AC},
+  {DOSHISHA, kDoshishaBits, kNoRepeat, false, false},
+  {MULTIBRACKETS, 8, kSingleRepeat, false, false},
+  {CARRIER_AC40, kCarrierAc40Bits, kCarrierAc40MinRepeat, false, false},
+  {CARRIER_AC64, 64, kNoRepeat, false, SEND_CARRIER_AC64},
+  {HITACHI_AC344, kHitachiAc344Bits, kNoRepeat, true, SEND_HITACHI_AC344},
+  {CORONA_AC, kCoronaAcBits, kNoRepeat, true, SEND_CORONA_AC},
+  {MIDEA24, 24, kSingleRepeat, false, false},
+  {ZEPEAL, 16, kZepealMinRepeat, false, false},
+  {SANYO_AC, kSanyoAcBits, kNoRepeat, true, SEND_SANYO_AC},
+  {VOLTAS, kVoltasBits, kNoRepeat, true, SEND_VOLTAS},
+  {METZ, 19, kNoRepeat, false, false},
+  {TRANSCOLD, 24, kNoRepeat, false, SEND_TRANSCOLD},
+  {TECHNIBEL_AC, 56, kNoRepeat, false, SEND_TECHNIBEL_AC},
+  {MIRAGE, kMirageBits, kNoRepeat, true, false},
+  {ELITESCREENS, 32, kSingleRepeat, false, false},
+  {PANASONIC_AC32, 32, kNoRepeat, false, SEND_PANASONIC_AC32},
+  {MILESTAG2, kMilesTag2ShotBits, kNoRepeat, false, false},
+  {ECOCLIM, 56, kNoRepeat, false, SEND_ECOCLIM},
+  {XMP, kXmpBits, kNoRepeat, false, false},
+  {TRUMA, 56, kNoRepeat, false, SEND_TRUMA},
+  {HAIER_AC176, kHaierAC176Bits, kNoRepeat, true, false},
+  {TEKNOPOINT, kTeknopointBits, kNoRepeat, true, false},
+  {KELON, 48, kNoRepeat, false, SEND_KELON},
+};
+const uint16_t kProtocolsSize = sizeof(kProtocols) / sizeof(kProtocols[0]);
+
+/// How `send()` sends each protocol, indexed by `decode_type_t`.
+/// Only `send()` uses it, as it pulls in the sending method of every protocol.
+/// i.e. {protocol, value sending method, state[] sending method}
+static constexpr protocol_sender_t kSenders[] = {
+  {UNUSED, NULL, NULL},
+#if SEND_RC5
+  {RC5, &IRsend::sendRC5, NULL},
+#else  // SEND_RC5
+  {RC5, NULL, NULL},
+#endif  // SEND_RC5
+#if SEND_RC6
+  {RC6, &IRsend::sendRC6, NULL},
+#else  // SEND_RC6
+  {RC6, NULL, NULL},
+#endif  // SEND_RC6
+#if SEND_NEC
+  {NEC, &IRsend::sendNEC, NULL},
+#else  // SEND_NEC
+  {NEC, NULL, NULL},
+#endif  // SEND_NEC
+#if SEND_SONY
+  {SONY, &IRsend::sendSony, NULL},
+#else  // SEND_SONY
+  {SONY, NULL, NULL},
+#endif  // SEND_SONY
+#if SEND_PANASONIC
+  {PANASONIC, &IRsend::sendPanasonic64, NULL},
+#else  // SEND_PANASONIC
+  {PANASONIC, NULL, NULL},
+#endif  // SEND_PANASONIC
+#if SEND_JVC
+  {JVC, &IRsend::sendJVC, NULL},
+#else  // SEND_JVC
+  {JVC, NULL, NULL},
+#endif  // SEND_JVC
+#if SEND_SAMSUNG
+  {SAMSUNG, &IRsend::sendSAMSUNG, NULL},
+#else  // SEND_SAMSUNG
+  {SAMSUNG, NULL, NULL},
+#endif  // SEND_SAMSUNG
+#if SEND_WHYNTER
+  {WHYNTER, &IRsend::sendWhynter, NULL},
+#else  // SEND_WHYNTER
+  {WHYNTER, NULL, NULL},
+#endif  // SEND_WHYNTER
+#if SEND_AIWA_RC_T501
+  {AIWA_RC_T501, &IRsend::sendAiwaRCT501, NULL},
+#else  // SEND_AIWA_RC_T501
+  {AIWA_RC_T501, NULL, NULL},
+#endif  // SEND_AIWA_RC_T501
+#if SEND_LG
+  {LG, &IRsend::sendLG, NULL},
+#else  // SEND_LG
+  {LG, NULL, NULL},
+#endif  // SEND_LG
+  {SANYO, NULL, NULL},
+#if SEND_MITSUBISHI
+  {MITSUBISHI, &IRsend::sendMitsubishi, NULL},
+#else  // SEND_MITSUBISHI
+  {MITSUBISHI, NULL, NULL},
+#endif  // SEND_MITSUBISHI
+#if SEND_DISH
+  {DISH, &IRsend::sendDISH, NULL},
+#else  // SEND_DISH
+  {DISH, NULL, NULL},
+#endif  // SEND_DISH
+#if SEND_SHARP
+  {SHARP, &IRsend::sendSharpRaw, NULL},
+#else  // SEND_SHARP
+  {SHARP, NULL, NULL},
+#endif  // SEND_SHARP
+#if SEND_COOLIX
+  {COOLIX, &IRsend::sendCOOLIX, NULL},
+#else  // SEND_COOLIX
+  {COOLIX, NULL, NULL},
+#endif  // SEND_COOLIX
+#if SEND_DAIKIN
+  {DAIKIN, NULL, &IRsend::sendDaikin},
+#else  // SEND_DAIKIN
+  {DAIKIN, NULL, NULL},
+#endif  // SEND_DAIKIN
+#if SEND_DENON
+  {DENON, &IRsend::sendDenon, NULL},
+#else  // SEND_DENON
+  {DENON, NULL, NULL},
+#endif  // SEND_DENON
+#if SEND_KELVINATOR
+  {KELVINATOR, NULL, &IRsend::sendKelvinator},
+#else  // SEND_KELVINATOR
+  {KELVINATOR, NULL, NULL},
+#endif  // SEND_KELVINATOR
+#if SEND_SHERWOOD
+  {SHERWOOD, &IRsend::sendSherwood, NULL},
+#else  // SEND_SHERWOOD
+  {SHERWOOD, NULL, NULL},
+#endif  // SEND_SHERWOOD
+#if SEND_MITSUBISHI_AC
+  {MITSUBISHI_AC, NULL, &IRsend::sendMitsubishiAC},
+#else  // SEND_MITSUBISHI_AC
+  {MITSUBISHI_AC, NULL, NULL},
+#endif  // SEND_MITSUBISHI_AC
+#if SEND_RCMM
+  {RCMM, &IRsend::sendRCMM, NULL},
+#else  // SEND_RCMM
+  {RCMM, NULL, NULL},
+#endif  // SEND_RCMM
+#if SEND_SANYO
+  {SANYO_LC7461, &IRsend::sendSanyoLC7461, NULL},
+#else  // SEND_SANYO
+  {SANYO_LC7461, NULL, NULL},
+#endif  // SEND_SANYO
+#if SEND_RC5
+  {RC5X, &IRsend::sendRC5, NULL},
+#else  // SEND_RC5
+  {RC5X, NULL, NULL},
+#endif  // SEND_RC5
+#if SEND_GREE
+  {GREE,
+   static_cast<send_value_fn_t>(&IRsend::sendGree),
+   static_cast<send_state_fn_t>(&IRsend::sendGree)},
+#else  // SEND_GREE
+  {GREE, NULL, NULL},
+#endif  // SEND_GREE
+  {PRONTO, NULL, NULL},
+#if SEND_NEC
+  {NEC_LIKE, &IRsend::sendNEC, NULL},
+#else  // SEND_NEC
+  {NEC_LIKE, NULL, NULL},
+#endif  // SEND_NEC
+#if SEND_ARGO
+  {ARGO, NULL, &IRsend::sendArgo},
+#else  // SEND_ARGO
+  {ARGO, NULL, NULL},
+#endif  // SEND_ARGO
+#if SEND_TROTEC
+  {TROTEC, NULL, &IRsend::sendTrotec},
+#else  // SEND_TROTEC
+  {TROTEC, NULL, NULL},
+#endif  // SEND_TROTEC
+#if SEND_NIKAI
+  {NIKAI, &IRsend::sendNikai, NULL},
+#else  // SEND_NIKAI
+  {NIKAI, NULL, NULL},
+#endif  // SEND_NIKAI
+  {RAW, NULL, NULL},
+  {GLOBALCACHE, NULL, NULL},
+#if SEND_TOSHIBA_AC
+  {TOSHIBA_AC, NULL, &IRsend::sendToshibaAC},
+#else  // SEND_TOSHIBA_AC
+  {TOSHIBA_AC, NULL, NULL},
+#endif  // SEND_TOSHIBA_AC
+#if SEND_FUJITSU_AC
+  {FUJITSU_AC, NULL, &IRsend::sendFujitsuAC},
+#else  // SEND_FUJITSU_AC
+  {FUJITSU_AC, NULL, NULL},
+#endif  // SEND_FUJITSU_AC
+#if SEND_MIDEA
+  {MIDEA, &IRsend::sendMidea, NULL},
+#else  // SEND_MIDEA
+  {MIDEA, NULL, NULL},
+#endif  // SEND_MIDEA
+#if SEND_MAGIQUEST
+  {MAGIQUEST, &IRsend::sendMagiQuest, NULL},
+#else  // SEND_MAGIQUEST
+  {MAGIQUEST, NULL, NULL},
+#endif  // SEND_MAGIQUEST
+#if SEND_LASERTAG
+  {LASERTAG, &IRsend::sendLasertag, NULL},
+#else  // SEND_LASERTAG
+  {LASERTAG, NULL, NULL},
+#endif  // SEND_LASERTAG
+#if SEND_CARRIER_AC
+  {CARRIER_AC, &IRsend::sendCarrierAC, NULL},
+#else  // SEND_CARRIER_AC
+  {CARRIER_AC, NULL, NULL},
+#endif  // SEND_CARRIER_AC
+#if SEND_HAIER_AC
+  {HAIER_AC, NULL, &IRsend::sendHaierAC},
+#else  // SEND_HAIER_AC
+  {HAIER_AC, NULL, NULL},
+#endif  // SEND_HAIER_AC
+#if SEND_MITSUBISHI2
+  {MITSUBISHI2, &IRsend::sendMitsubishi2, NULL},
+#else  // SEND_MITSUBISHI2
+  {MITSUBISHI2, NULL, NULL},
+#endif  // SEND_MITSUBISHI2
+#if SEND_HITACHI_AC
+  {HITACHI_AC, NULL, &IRsend::sendHitachiAC},
+#else  // SEND_HITACHI_AC
+  {HITACHI_AC, NULL, NULL},
+#endif  // SEND_HITACHI_AC
+#if SEND_HITACHI_AC1
+  {HITACHI_AC1, NULL, &IRsend::sendHitachiAC1},
+#else  // SEND_HITACHI_AC1
+  {HITACHI_AC1, NULL, NULL},
+#endif  // SEND_HITACHI_AC1
+#if SEND_HITACHI_AC2
+  {HITACHI_AC2, NULL, &IRsend::sendHitachiAC2},
+#else  // SEND_HITACHI_AC2
+  {HITACHI_AC2, NULL, NULL},
+#endif  // SEND_HITACHI_AC2
+#if SEND_GICABLE
+  {GICABLE, &IRsend::sendGICable, NULL},
+#else  // SEND_GICABLE
+  {GICABLE, NULL, NULL},
+#endif  // SEND_GICABLE
+#if SEND_HAIER_AC_YRW02
+  {HAIER_AC_YRW02, NULL, &IRsend::sendHaierACYRW02},
+#else  // SEND_HAIER_AC_YRW02
+  {HAIER_AC_YRW02, NULL, NULL},
+#endif  // SEND_HAIER_AC_YRW02
+#if SEND_WHIRLPOOL_AC
+  {WHIRLPOOL_AC, NULL, &IRsend::sendWhirlpoolAC},
+#else  // SEND_WHIRLPOOL_AC
+  {WHIRLPOOL_AC, NULL, NULL},
+#endif  // SEND_WHIRLPOOL_AC
+#if SEND_SAMSUNG_AC
+  {SAMSUNG_AC, NULL, &IRsend::sendSamsungAC},
+#else  // SEND_SAMSUNG_AC
+  {SAMSUNG_AC, NULL, NULL},
+#endif  // SEND_SAMSUNG_AC
+#if SEND_LUTRON
+  {LUTRON, &IRsend::sendLutron, NULL},
+#else  // SEND_LUTRON
+  {LUTRON, NULL, NULL},
+#endif  // SEND_LUTRON
+#if SEND_ELECTRA_AC
+  {ELECTRA_AC, NULL, &IRsend::sendElectraAC},
+#else  // SEND_ELECTRA_AC
+  {ELECTRA_AC, NULL, NULL},
+#endif  // SEND_ELECTRA_AC
+#if SEND_PANASONIC_AC
+  {PANASONIC_AC, NULL, &IRsend::sendPanasonicAC},
+#else  // SEND_PANASONIC_AC
+  {PANASONIC_AC, NULL, NULL},
+#endif  // SEND_PANASONIC_AC
+#if SEND_PIONEER
+  {PIONEER, &IRsend::sendPioneer, NULL},
+#else  // SEND_PIONEER
+  {PIONEER, NULL, NULL},
+#endif  // SEND_PIONEER
+#if SEND_LG
+  {LG2, &IRsend::sendLG2, NULL},
+#else  // SEND_LG
+  {LG2, NULL, NULL},
+#endif  // SEND_LG
+#if SEND_MWM
+  {MWM, NULL, &IRsend::sendMWM},
+#else  // SEND_MWM
+  {MWM, NULL, NULL},
+#endif  // SEND_MWM
+#if SEND_DAIKIN2
+  {DAIKIN2, NULL, &IRsend::sendDaikin2},
+#else  // SEND_DAIKIN2
+  {DAIKIN2, NULL, NULL},
+#endif  // SEND_DAIKIN2
+#if SEND_VESTEL_AC
+  {VESTEL_AC, &IRsend::sendVestelAc, NULL},
+#else  // SEND_VESTEL_AC
+  {VESTEL_AC, NULL, NULL},
+#endif  // SEND_VESTEL_AC
+#if SEND_TECO
+  {TECO, &IRsend::sendTeco, NULL},
+#else  // SEND_TECO
+  {TECO, NULL, NULL},
+#endif  // SEND_TECO
+#if SEND_SAMSUNG36
+  {SAMSUNG36, &IRsend::sendSamsung36, NULL},
+#else  // SEND_SAMSUNG36
+  {SAMSUNG36, NULL, NULL},
+#endif  // SEND_SAMSUNG36
+#if SEND_TCL112AC
+  {TCL112AC, NULL, &IRsend::sendTcl112Ac},
+#else  // SEND_TCL112AC
+  {TCL112AC, NULL, NULL},
+#endif  // SEND_TCL112AC
+#if SEND_LEGOPF
+  {LEGOPF, &IRsend::sendLegoPf, NULL},
+#else  // SEND_LEGOPF
+  {LEGOPF, NULL, NULL},
+#endif  // SEND_LEGOPF
+#if SEND_MITSUBISHIHEAVY
+  {MITSUBISHI_HEAVY_88, NULL, &IRsend::sendMitsubishiHeavy88},
+#else  // SEND_MITSUBISHIHEAVY
+  {MITSUBISHI_HEAVY_88, NULL, NULL},
+#endif  // SEND_MITSUBISHIHEAVY
+#if SEND_MITSUBISHIHEAVY
+  {MITSUBISHI_HEAVY_152, NULL, &IRsend::sendMitsubishiHeavy152},
+#else  // SEND_MITSUBISHIHEAVY
+  {MITSUBISHI_HEAVY_152, NULL, NULL},
+#endif  // SEND_MITSUBISHIHEAVY
+#if SEND_DAIKIN216
+  {DAIKIN216, NULL, &IRsend::sendDaikin216},
+#else  // SEND_DAIKIN216
+  {DAIKIN216, NULL, NULL},
+#endif  // SEND_DAIKIN216
+#if SEND_SHARP_AC
+  {SHARP_AC, NULL, &IRsend::sendSharpAc},
+#else  // SEND_SHARP_AC
+  {SHARP_AC, NULL, NULL},
+#endif  // SEND_SHARP_AC
+#if SEND_GOODWEATHER
+  {GOODWEATHER, &IRsend::sendGoodweather, NULL},
+#else  // SEND_GOODWEATHER
+  {GOODWEATHER, NULL, NULL},
+#endif  // SEND_GOODWEATHER
+#if SEND_INAX
+  {INAX, &IRsend::sendInax, NULL},
+#else  // SEND_INAX
+  {INAX, NULL, NULL},
+#endif  // SEND_INAX
+#if SEND_DAIKIN160
+  {DAIKIN160, NULL, &IRsend::sendDaikin160},
+#else  // SEND_DAIKIN160
+  {DAIKIN160, NULL, NULL},
+#endif  // SEND_DAIKIN160
+#if SEND_NEOCLIMA
+  {NEOCLIMA, NULL, &IRsend::sendNeoclima},
+#else  // SEND_NEOCLIMA
+  {NEOCLIMA, NULL, NULL},
+#endif  // SEND_NEOCLIMA
+#if SEND_DAIKIN176
+  {DAIKIN176, NULL, &IRsend::sendDaikin176},
+#else  // SEND_DAIKIN176
+  {DAIKIN176, NULL, NULL},
+#endif  // SEND_DAIKIN176
+#if SEND_DAIKIN128
+  {DAIKIN128, NULL, &IRsend::sendDaikin128},
+#else  // SEND_DAIKIN128
+  {DAIKIN128, NULL, NULL},
+#endif  // SEND_DAIKIN128
+#if SEND_AMCOR
+  {AMCOR, NULL, &IRsend::sendAmcor},
+#else  // SEND_AMCOR
+  {AMCOR, NULL, NULL},
+#endif  // SEND_AMCOR
+#if SEND_DAIKIN152
+  {DAIKIN152, NULL, &IRsend::sendDaikin152},
+#else  // SEND_DAIKIN152
+  {DAIKIN152, NULL, NULL},
+#endif  // SEND_DAIKIN152
+#if SEND_MITSUBISHI136
+  {MITSUBISHI136, NULL, &IRsend::sendMitsubishi136},
+#else  // SEND_MITSUBISHI136
+  {MITSUBISHI136, NULL, NULL},
+#endif  // SEND_MITSUBISHI136
+#if SEND_MITSUBISHI112
+  {MITSUBISHI112, NULL, &IRsend::sendMitsubishi112},
+#else  // SEND_MITSUBISHI112
+  {MITSUBISHI112, NULL, NULL},
+#endif  // SEND_MITSUBISHI112
+#if SEND_HITACHI_AC424
+  {HITACHI_AC424, NULL, &IRsend::sendHitachiAc424},
+#else  // SEND_HITACHI_AC424
+  {HITACHI_AC424, NULL, NULL},
+#endif  // SEND_HITACHI_AC424
+#if SEND_SONY
+  {SONY_38K, &IRsend::sendSony38, NULL},
+#else  // SEND_SONY
+  {SONY_38K, NULL, NULL},
+#endif  // SEND_SONY
+#if SEND_EPSON
+  {EPSON, &IRsend::sendEpson, NULL},
+#else  // SEND_EPSON
+  {EPSON, NULL, NULL},
+#endif  // SEND_EPSON
+#if SEND_SYMPHONY
+  {SYMPHONY, &IRsend::sendSymphony, NULL},
+#else  // SEND_SYMPHONY
+  {SYMPHONY, NULL, NULL},
+#endif  // SEND_SYMPHONY
+#if SEND_HITACHI_AC3
+  {HITACHI_AC3, NULL, &IRsend::sendHitachiAc3},
+#else  // SEND_HITACHI_AC3
+  {HITACHI_AC3, NULL, NULL},
+#endif  // SEND_HITACHI_AC3
+#if SEND_DAIKIN64
+  {DAIKIN64, &IRsend::sendDaikin64, NULL},
+#else  // SEND_DAIKIN64
+  {DAIKIN64, NULL, NULL},
+#endif  // SEND_DAIKIN64
+#if SEND_AIRWELL
+  {AIRWELL, &IRsend::sendAirwell, NULL},
+#else  // SEND_AIRWELL
+  {AIRWELL, NULL, NULL},
+#endif  // SEND_AIRWELL
+#if SEND_DELONGHI_AC
+  {DELONGHI_AC, &IRsend::sendDelonghiAc, NULL},
+#else  // SEND_DELONGHI_AC
+  {DELONGHI_AC, NULL, NULL},
+#endif  // SEND_DELONGHI_AC
+#if SEND_DOSHISHA
+  {DOSHISHA, &IRsend::sendDoshisha, NULL},
+#else  // SEND_DOSHISHA
+  {DOSHISHA, NULL, NULL},
+#endif  // SEND_DOSHISHA
+#if SEND_MULTIBRACKETS
+  {MULTIBRACKETS, &IRsend::sendMultibrackets, NULL},
+#else  // SEND_MULTIBRACKETS
+  {MULTIBRACKETS, NULL, NULL},
+#endif  // SEND_MULTIBRACKETS
+#if SEND_CARRIER_AC40
+  {CARRIER_AC40, &IRsend::sendCarrierAC40, NULL},
+#else  // SEND_CARRIER_AC40
+  {CARRIER_AC40, NULL, NULL},
+#endif  // SEND_CARRIER_AC40
+#if SEND_CARRIER_AC64
+  {CARRIER_AC64, &IRsend::sendCarrierAC64, NULL},
+#else  // SEND_CARRIER_AC64
+  {CARRIER_AC64, NULL, NULL},
+#endif  // SEND_CARRIER_AC64
+#if SEND_HITACHI_AC344
+  {HITACHI_AC344, NULL, &IRsend::sendHitachiAc344},
+#else  // SEND_HITACHI_AC344
+  {HITACHI_AC344, NULL, NULL},
+#endif  // SEND_HITACHI_AC344
+#if SEND_CORONA_AC
+  {CORONA_AC, NULL, &IRsend::sendCoronaAc},
+#else  // SEND_CORONA_AC
+  {CORONA_AC, NULL, NULL},
+#endif  // SEND_CORONA_AC
+#if SEND_MIDEA24
+  {MIDEA24, &IRsend::sendMidea24, NULL},
+#else  // SEND_MIDEA24
+  {MIDEA24, NULL, NULL},
+#endif  // SEND_MIDEA24
+#if SEND_ZEPEAL
+  {ZEPEAL, &IRsend::sendZepeal, NULL},
+#else  // SEND_ZEPEAL
+  {ZEPEAL, NULL, NULL},
+#endif  // SEND_ZEPEAL
+#if SEND_SANYO_AC
+  {SANYO_AC, NULL, &IRsend::sendSanyoAc},
+#else  // SEND_SANYO_AC
+  {SANYO_AC, NULL, NULL},
+#endif  // SEND_SANYO_AC
+#if SEND_VOLTAS
+  {VOLTAS, NULL, &IRsend::sendVoltas},
+#else  // SEND_VOLTAS
+  {VOLTAS, NULL, NULL},
+#endif  // SEND_VOLTAS
+#if SEND_METZ
+  {METZ, &IRsend::sendMetz, NULL},
+#else  // SEND_METZ
+  {METZ, NULL, NULL},
+#endif  // SEND_METZ
+#if SEND_TRANSCOLD
+  {TRANSCOLD, &IRsend::sendTranscold, NULL},
+#else  // SEND_TRANSCOLD
+  {TRANSCOLD, NULL, NULL},
+#endif  // SEND_TRANSCOLD
+#if SEND_TECHNIBEL_AC
+  {TECHNIBEL_AC, &IRsend::sendTechnibelAc, NULL},
+#else  // SEND_TECHNIBEL_AC
+  {TECHNIBEL_AC, NULL, NULL},
+#endif  // SEND_TECHNIBEL_AC
+#if SEND_MIRAGE
+  {MIRAGE, NULL, &IRsend::sendMirage},
+#else  // SEND_MIRAGE
+  {MIRAGE, NULL, NULL},
+#endif  // SEND_MIRAGE
+#if SEND_ELITESCREENS
+  {ELITESCREENS, &IRsend::sendElitescreens, NULL},
+#else  // SEND_ELITESCREENS
+  {ELITESCREENS, NULL, NULL},
+#endif  // SEND_ELITESCREENS
+#if SEND_PANASONIC_AC32
+  {PANASONIC_AC32, &IRsend::sendPanasonicAC32, NULL},
+#else  // SEND_PANASONIC_AC32
+  {PANASONIC_AC32, NULL, NULL},
+#endif  // SEND_PANASONIC_AC32
+#if SEND_MILESTAG2
+  {MILESTAG2, &IRsend::sendMilestag2, NULL},
+#else  // SEND_MILESTAG2
+  {MILESTAG2, NULL, NULL},
+#endif  // SEND_MILESTAG2
+#if SEND_ECOCLIM
+  {ECOCLIM, &IRsend::sendEcoclim, NULL},
+#else  // SEND_ECOCLIM
+  {ECOCLIM, NULL, NULL},
+#endif  // SEND_ECOCLIM
+#if SEND_XMP
+  {XMP, &IRsend::sendXmp, NULL},
+#else  // SEND_XMP
+  {XMP, NULL, NULL},
+#endif  // SEND_XMP
+#if SEND_TRUMA
+  {TRUMA, &IRsend::sendTruma, NULL},
+#else  // SEND_TRUMA
+  {TRUMA, NULL, NULL},
+#endif  // SEND_TRUMA
+#if SEND_HAIER_AC176
+  {HAIER_AC176, NULL, &IRsend::sendHaierAC176},
+#else  // SEND_HAIER_AC176
+  {HAIER_AC176, NULL, NULL},
+#endif  // SEND_HAIER_AC176
+#if SEND_TEKNOPOINT
+  {TEKNOPOINT, NULL, &IRsend::sendTeknopoint},
+#else  // SEND_TEKNOPOINT
+  {TEKNOPOINT, NULL, NULL},
+#endif  // SEND_TEKNOPOINT
+#if SEND_KELON
+  {KELON, &IRsend::sendKelon, NULL},
+#else  // SEND_KELON
+  {KELON, NULL, NULL},
+#endif  // SEND_KELON
+};
+const uint16_t kSendersSize = sizeof(kSenders) / sizeof(kSenders[0]);
+
+/// Check entries of `kProtocols` & `kSenders` are consistent. (Compile-time)
+/// i.e. They are in `decode_type_t` order, the default size of a state[]
+/// protocol is whole bytes, a value protocol fits in a uint64_t & has no
+/// state[] sender, and every `IRac` supported protocol can be sent.
+/// @param[in] i The entry to start checking from.
+/// @return True if entry `i` and all those after it are okay.
+static constexpr bool protocolsAreValid(const uint16_t i = 0) {
+  return i >= kProtocolsSize ||
+      (kProtocols[i].protocol == i && kSenders[i].protocol == i &&
+       (kProtocols[i].state ? kProtocols[i].bits % 8 == 0
+                            : (kProtocols[i].bits <= 64 &&
+                               kSenders[i].sendState == NULL)) &&
+       (!kProtocols[i].ac || kSenders[i].sendValue != NULL ||
+        kSenders[i].sendState != NULL) &&
+       protocolsAreValid(i + 1));
+}
+
+static_assert(kProtocolsSize == kLastDecodeType + 1,
+              "kProtocols needs an entry for every decode_type_t.");
+static_assert(kSendersSize == kProtocolsSize,
+              "kSenders needs an entry for every decode_type_t.");
+static_assert(protocolsAreValid(), "kProtocols has an inconsistent entry.");
+
+/// Get what the library knows about a given protocol.
+/// @param[in] protocol Protocol number/type you want to know about.
+/// @return A ptr to the information. Unknown protocols get that of `UNUSED`.
+const protocol_info_t *IRsend::protocolInfo(const decode_type_t protocol) {
+  if (protocol < 0 || protocol > kLastDecodeType) return &kProtocols[UNUSED];
+  return &kProtocols[protocol];
+}
+
 /// Get the minimum number of repeats for a given protocol.
 /// @param[in] protocol Protocol number/type of the message you want to send.
 /// @return The number of repeats required.
 uint16_t IRsend::minRepeats(const decode_type_t protocol) {
-  switch (protocol) {
-    // Single repeats
-    case AIWA_RC_T501:
-    case AMCOR:
-    case COOLIX:
-    case ELITESCREENS:
-    case GICABLE:
-    case INAX:
-    case MIDEA24:
-    case MITSUBISHI:
-    case MITSUBISHI2:
-    case MITSUBISHI_AC:
-    case MULTIBRACKETS:
-    case SHERWOOD:
-    case TOSHIBA_AC:
-      return kSingleRepeat;
-    // Special
-    case AIRWELL:
-      return kAirwellMinRepeats;
-    case CARRIER_AC40:
-      return kCarrierAc40MinRepeat;
-    case DISH:
-      return kDishMinRepeat;
-    case EPSON:
-      return kEpsonMinRepeat;
-    case SONY:
-      return kSonyMinRepeat;
-    case SONY_38K:
-      return kSonyMinRepeat + 1;
-    case SYMPHONY:
-      return kSymphonyDefaultRepeat;
-    case ZEPEAL:
-      return kZepealMinRepeat;
-    default:
-      return kNoRepeat;
-  }
+  return protocolInfo(protocol)->repeats;
 }
 
 /// Get the default number of bits for a given protocol.
 /// @param[in] protocol Protocol number/type you want the default bit size for.
 /// @return The number of bits.
 uint16_t IRsend::defaultBits(const decode_type_t protocol) {
-  switch (protocol) {
-    case MULTIBRACKETS:
-      return 8;
-    case RC5:
-    case SYMPHONY:
-      return 12;
-    case LASERTAG:
-    case RC5X:
-      return 13;
-    case AIWA_RC_T501:
-    case DENON:
-    case SHARP:
-      return 15;
-    case DISH:
-    case GICABLE:
-    case JVC:
-    case LEGOPF:
-    case MITSUBISHI:
-    case MITSUBISHI2:
-    case ZEPEAL:
-      return 16;
-    case METZ:
-      return 19;
-    case RC6:
-    case SONY:
-    case SONY_38K:
-      return 20;
-    case COOLIX:
-    case INAX:
-    case MIDEA24:
-    case NIKAI:
-    case RCMM:
-    case TRANSCOLD:
-      return 24;
-    case LG:
-    case LG2:
-      return 28;
-    case CARRIER_AC:
-    case ELITESCREENS:
-    case EPSON:
-    case NEC:
-    case NEC_LIKE:
-    case PANASONIC_AC32:
-    case SAMSUNG:
-    case SHERWOOD:
-    case WHYNTER:
-      return 32;
-    case AIRWELL:
-      return 34;
-    case LUTRON:
-    case TECO:
-      return 35;
-    case SAMSUNG36:
-      return 36;
-    case CARRIER_AC40:
-      return kCarrierAc40Bits;  // 40
-    case DOSHISHA:
-      return kDoshishaBits;  // 40
-    case SANYO_LC7461:
-      return kSanyoLC7461Bits;  // 42
-    case GOODWEATHER:
-    case KELON:
-    case MIDEA:
-    case PANASONIC:
-      return 48;
-    case ECOCLIM:
-    case MAGIQUEST:
-    case VESTEL_AC:
-    case TECHNIBEL_AC:
-    case TRUMA:
-      return 56;
-    case AMCOR:
-    case CARRIER_AC64:
-    case DELONGHI_AC:
-    case PIONEER:
-      return 64;
-    case ARGO:
-      return kArgoBits;
-    case CORONA_AC:
-      return kCoronaAcBits;
-    case DAIKIN:
-      return kDaikinBits;
-    case DAIKIN128:
-      return kDaikin128Bits;
-    case DAIKIN152:
-      return kDaikin152Bits;
-    case DAIKIN160:
-      return kDaikin160Bits;
-    case DAIKIN176:
-      return kDaikin176Bits;
-    case DAIKIN2:
-      return kDaikin2Bits;
-    case DAIKIN216:
-      return kDaikin216Bits;
-    case DAIKIN64:
-      return kDaikin64Bits;
-    case ELECTRA_AC:
-      return kElectraAcBits;
-    case GREE:
-      return kGreeBits;
-    case HAIER_AC:
-      return kHaierACBits;
-    case HAIER_AC_YRW02:
-      return kHaierACYRW02Bits;
-    case HAIER_AC176:
-      return kHaierAC176Bits;
-    case HITACHI_AC:
-      return kHitachiAcBits;
-    case HITACHI_AC1:
-      return kHitachiAc1Bits;
-    case HITACHI_AC2:
-      return kHitachiAc2Bits;
-    case HITACHI_AC3:
-      return kHitachiAc3Bits;
-    case HITACHI_AC344:
-      return kHitachiAc344Bits;
-    case HITACHI_AC424:
-      return kHitachiAc424Bits;
-    case KELVINATOR:
-      return kKelvinatorBits;
-    case MILESTAG2:
-      return kMilesTag2ShotBits;
-    case MIRAGE:
-      return kMirageBits;
-    case MITSUBISHI_AC:
-      return kMitsubishiACBits;
-    case MITSUBISHI136:
-      return kMitsubishi136Bits;
-    case MITSUBISHI112:
-      return kMitsubishi112Bits;
-    case MITSUBISHI_HEAVY_152:
-      return kMitsubishiHeavy152Bits;
-    case MITSUBISHI_HEAVY_88:
-      return kMitsubishiHeavy88Bits;
-    case NEOCLIMA:
-      return kNeoclimaBits;
-    case PANASONIC_AC:
-      return kPanasonicAcBits;
-    case SAMSUNG_AC:
-      return kSamsungAcBits;
-    case SANYO_AC:
-      return kSanyoAcBits;
-    case SHARP_AC:
-      return kSharpAcBits;
-    case TCL112AC:
-      return kTcl112AcBits;
-    case TEKNOPOINT:
-      return kTeknopointBits;
-    case TOSHIBA_AC:
-      return kToshibaACBits;
-    case TROTEC:
-      return kTrotecBits;
-    case VOLTAS:
-      return kVoltasBits;
-    case WHIRLPOOL_AC:
-      return kWhirlpoolAcBits;
-    case XMP:
-      return kXmpBits;
-    // No default amount of bits.
-    case FUJITSU_AC:
-    case MWM:
-    default:
-      return 0;
-  }
+  return protocolInfo(protocol)->bits;
 }
 
 /// Send a simple (up to 64 bits) IR message of a given type.
@@ -772,295 +1325,10 @@ uint16_t IRsend::defaultBits(const decode_type_t protocol) {
 /// @return True if it is a type we can attempt to send, false if not.
 bool IRsend::send(const decode_type_t type, const uint64_t data,
                   const uint16_t nbits, const uint16_t repeat) {
-  uint16_t min_repeat __attribute__((unused)) =
-      std::max(IRsend::minRepeats(type), repeat);
-  switch (type) {
-#if SEND_AIRWELL
-    case AIRWELL:
-      sendAirwell(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_AIWA_RC_T501
-    case AIWA_RC_T501:
-      sendAiwaRCT501(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_CARRIER_AC
-    case CARRIER_AC:
-      sendCarrierAC(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_CARRIER_AC40
-    case CARRIER_AC40:
-      sendCarrierAC40(data, nbits, min_repeat);
-      break;
-#endif  // SEND_CARRIER_AC40
-#if SEND_CARRIER_AC64
-    case CARRIER_AC64:
-      sendCarrierAC64(data, nbits, min_repeat);
-      break;
-#endif  // SEND_CARRIER_AC64
-#if SEND_COOLIX
-    case COOLIX:
-      sendCOOLIX(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_DAIKIN64
-    case DAIKIN64:
-      sendDaikin64(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_DELONGHI_AC
-    case DELONGHI_AC:
-      sendDelonghiAc(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_DENON
-    case DENON:
-      sendDenon(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_DISH
-    case DISH:
-      sendDISH(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_DOSHISHA
-    case DOSHISHA:
-      sendDoshisha(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_ECOCLIM
-    case ECOCLIM:
-      sendEcoclim(data, nbits, min_repeat);
-      break;
-#endif  // SEND_ECOCLIM
-#if SEND_ELITESCREENS
-    case ELITESCREENS:
-      sendElitescreens(data, nbits, min_repeat);
-      break;
-#endif  // SEND_ELITESCREENS
-#if SEND_EPSON
-    case EPSON:
-      sendEpson(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_GICABLE
-    case GICABLE:
-      sendGICable(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_GOODWEATHER
-    case GOODWEATHER:
-      sendGoodweather(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_GREE
-    case GREE:
-      sendGree(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_INAX
-    case INAX:
-      sendInax(data, nbits, min_repeat);
-      break;
-#endif  // SEND_INAX
-#if SEND_JVC
-    case JVC:
-      sendJVC(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_KELON
-    case KELON:
-      sendKelon(data, nbits, min_repeat);
-      break;
-#endif  // SEND_KELON
-#if SEND_LASERTAG
-    case LASERTAG:
-      sendLasertag(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_LEGOPF
-    case LEGOPF:
-      sendLegoPf(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_LG
-    case LG:
-      sendLG(data, nbits, min_repeat);
-      break;
-    case LG2:
-      sendLG2(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_LUTRON
-    case LUTRON:
-      sendLutron(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_MAGIQUEST
-    case MAGIQUEST:
-      sendMagiQuest(data, nbits, min_repeat);
-      break;
-#endif  // SEND_MAGIQUEST
-#if SEND_METZ
-    case METZ:
-      sendMetz(data, nbits, min_repeat);
-      break;
-#endif  // SEND_METZ
-#if SEND_MIDEA
-    case MIDEA:
-      sendMidea(data, nbits, min_repeat);
-      break;
-#endif  // SEND_MIDEA
-#if SEND_MIDEA24
-    case MIDEA24:
-      sendMidea24(data, nbits, min_repeat);
-      break;
-#endif  // SEND_MIDEA24
-#if SEND_MILESTAG2
-    case MILESTAG2:
-      sendMilestag2(data, nbits, min_repeat);
-      break;
-#endif  // SEND_MILESTAG2
-#if SEND_MITSUBISHI
-    case MITSUBISHI:
-      sendMitsubishi(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_MITSUBISHI2
-    case MITSUBISHI2:
-      sendMitsubishi2(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_MULTIBRACKETS
-    case MULTIBRACKETS:
-      sendMultibrackets(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_NIKAI
-    case NIKAI:
-      sendNikai(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_NEC
-    case NEC:
-    case NEC_LIKE:
-      sendNEC(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_PANASONIC
-    case PANASONIC:
-      sendPanasonic64(data, nbits, min_repeat);
-      break;
-#endif  // SEND_PANASONIC
-#if SEND_PANASONIC_AC32
-    case PANASONIC_AC32:
-      sendPanasonicAC32(data, nbits, min_repeat);
-      break;
-#endif  // SEND_PANASONIC_AC32
-#if SEND_PIONEER
-    case PIONEER:
-      sendPioneer(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_RC5
-    case RC5:
-    case RC5X:
-      sendRC5(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_RC6
-    case RC6:
-      sendRC6(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_RCMM
-    case RCMM:
-      sendRCMM(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_SAMSUNG
-    case SAMSUNG:
-      sendSAMSUNG(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_SAMSUNG36
-    case SAMSUNG36:
-      sendSamsung36(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_SANYO
-    case SANYO_LC7461:
-      sendSanyoLC7461(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_SHARP
-    case SHARP:
-      sendSharpRaw(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_SHERWOOD
-    case SHERWOOD:
-      sendSherwood(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_SONY
-    case SONY:
-      sendSony(data, nbits, min_repeat);
-      break;
-    case SONY_38K:
-      sendSony38(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_SYMPHONY
-    case SYMPHONY:
-      sendSymphony(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_TECHNIBEL_AC
-    case TECHNIBEL_AC:
-      sendTechnibelAc(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_TECO
-    case TECO:
-      sendTeco(data, nbits, min_repeat);
-      break;
-#endif  // SEND_TECO
-#if SEND_TRANSCOLD
-    case TRANSCOLD:
-      sendTranscold(data, nbits, min_repeat);
-      break;
-#endif  // SEND_TRANSCOLD
-#if SEND_TRUMA
-    case TRUMA:
-      sendTruma(data, nbits, min_repeat);
-      break;
-#endif  // SEND_TRUMA
-#if SEND_VESTEL_AC
-    case VESTEL_AC:
-      sendVestelAc(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_WHYNTER
-    case WHYNTER:
-      sendWhynter(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_XMP
-    case XMP:
-      sendXmp(data, nbits, min_repeat);
-      break;
-#endif
-#if SEND_ZEPEAL
-    case ZEPEAL:
-      sendZepeal(data, nbits, min_repeat);
-      break;
-#endif  // SEND_ZEPEAL
-    default:
-      return false;
-  }
+  if (type < 0 || type > kLastDecodeType) return false;
+  if (kSenders[type].sendValue == NULL) return false;
+  (this->*kSenders[type].sendValue)(data, nbits,
+                                    std::max(minRepeats(type), repeat));
   return true;
 }
 
@@ -1072,212 +1340,8 @@ bool IRsend::send(const decode_type_t type, const uint64_t data,
 /// @return True if it is a type we can attempt to send, false if not.
 bool IRsend::send(const decode_type_t type, const uint8_t *state,
                   const uint16_t nbytes) {
-  switch (type) {
-#if SEND_VOLTAS
-    case VOLTAS:
-      sendVoltas(state, nbytes);
-      break;
-#endif  // SEND_VOLTAS
-#if SEND_AMCOR
-    case AMCOR:
-      sendAmcor(state, nbytes);
-      break;
-#endif
-#if SEND_ARGO
-    case ARGO:
-      sendArgo(state, nbytes);
-      break;
-#endif  // SEND_ARGO
-#if SEND_CORONA_AC
-    case CORONA_AC:
-      sendCoronaAc(state, nbytes);
-      break;
-#endif  // SEND_ARGO
-#if SEND_DAIKIN
-    case DAIKIN:
-      sendDaikin(state, nbytes);
-      break;
-#endif  // SEND_DAIKIN
-#if SEND_DAIKIN128
-    case DAIKIN128:
-        sendDaikin128(state, nbytes);
-        break;
-#endif  // SEND_DAIKIN128
-#if SEND_DAIKIN152
-    case DAIKIN152:
-        sendDaikin152(state, nbytes);
-        break;
-#endif  // SEND_DAIKIN152
-#if SEND_DAIKIN160
-    case DAIKIN160:
-      sendDaikin160(state, nbytes);
-      break;
-#endif  // SEND_DAIKIN160
-#if SEND_DAIKIN176
-    case DAIKIN176:
-      sendDaikin176(state, nbytes);
-      break;
-#endif  // SEND_DAIKIN176
-#if SEND_DAIKIN2
-    case DAIKIN2:
-      sendDaikin2(state, nbytes);
-      break;
-#endif  // SEND_DAIKIN2
-#if SEND_DAIKIN216
-    case DAIKIN216:
-      sendDaikin216(state, nbytes);
-      break;
-#endif  // SEND_DAIKIN216
-#if SEND_ELECTRA_AC
-    case ELECTRA_AC:
-      sendElectraAC(state, nbytes);
-      break;
-#endif  // SEND_ELECTRA_AC
-#if SEND_FUJITSU_AC
-    case FUJITSU_AC:
-      sendFujitsuAC(state, nbytes);
-      break;
-#endif  // SEND_FUJITSU_AC
-#if SEND_GREE
-    case GREE:
-      sendGree(state, nbytes);
-      break;
-#endif  // SEND_GREE
-#if SEND_HAIER_AC
-    case HAIER_AC:
-      sendHaierAC(state, nbytes);
-      break;
-#endif  // SEND_HAIER_AC
-#if SEND_HAIER_AC_YRW02
-    case HAIER_AC_YRW02:
-      sendHaierACYRW02(state, nbytes);
-      break;
-#endif  // SEND_HAIER_AC_YRW02
-#if SEND_HAIER_AC176
-    case HAIER_AC176:
-      sendHaierAC176(state, nbytes);
-      break;
-#endif  // SEND_HAIER_AC176
-#if SEND_HITACHI_AC
-    case HITACHI_AC:
-      sendHitachiAC(state, nbytes);
-      break;
-#endif  // SEND_HITACHI_AC
-#if SEND_HITACHI_AC1
-    case HITACHI_AC1:
-      sendHitachiAC1(state, nbytes);
-      break;
-#endif  // SEND_HITACHI_AC1
-#if SEND_HITACHI_AC2
-    case HITACHI_AC2:
-      sendHitachiAC2(state, nbytes);
-      break;
-#endif  // SEND_HITACHI_AC2
-#if SEND_HITACHI_AC3
-    case HITACHI_AC3:
-      sendHitachiAc3(state, nbytes);
-      break;
-#endif  // SEND_HITACHI_AC3
-#if SEND_HITACHI_AC344
-    case HITACHI_AC344:
-      sendHitachiAc344(state, nbytes);
-      break;
-#endif  // SEND_HITACHI_AC344
-#if SEND_HITACHI_AC424
-    case HITACHI_AC424:
-      sendHitachiAc424(state, nbytes);
-      break;
-#endif  // SEND_HITACHI_AC424
-#if SEND_KELVINATOR
-    case KELVINATOR:
-      sendKelvinator(state, nbytes);
-      break;
-#endif  // SEND_KELVINATOR
-#if SEND_MIRAGE
-    case MIRAGE:
-      sendMirage(state, nbytes);
-      break;
-#endif  // SEND_MIRAGE
-#if SEND_MITSUBISHI_AC
-    case MITSUBISHI_AC:
-      sendMitsubishiAC(state, nbytes);
-      break;
-#endif  // SEND_MITSUBISHI_AC
-#if SEND_MITSUBISHI136
-    case MITSUBISHI136:
-      sendMitsubishi136(state, nbytes);
-      break;
-#endif  // SEND_MITSUBISHI136
-#if SEND_MITSUBISHI112
-    case MITSUBISHI112:
-      sendMitsubishi112(state, nbytes);
-      break;
-#endif  // SEND_MITSUBISHI112
-#if SEND_MITSUBISHIHEAVY
-    case MITSUBISHI_HEAVY_88:
-      sendMitsubishiHeavy88(state, nbytes);
-      break;
-    case MITSUBISHI_HEAVY_152:
-      sendMitsubishiHeavy152(state, nbytes);
-      break;
-#endif  // SEND_MITSUBISHIHEAVY
-#if SEND_MWM
-    case MWM:
-      sendMWM(state, nbytes);
-      break;
-#endif  // SEND_MWM
-#if SEND_NEOCLIMA
-    case NEOCLIMA:
-      sendNeoclima(state, nbytes);
-      break;
-#endif  // SEND_NEOCLIMA
-#if SEND_PANASONIC_AC
-    case PANASONIC_AC:
-      sendPanasonicAC(state, nbytes);
-      break;
-#endif  // SEND_PANASONIC_AC
-#if SEND_SAMSUNG_AC
-    case SAMSUNG_AC:
-      sendSamsungAC(state, nbytes);
-      break;
-#endif  // SEND_SAMSUNG_AC
-#if SEND_SANYO_AC
-    case SANYO_AC:
-      sendSanyoAc(state, nbytes);
-      break;
-#endif  // SEND_SANYO_AC
-#if SEND_SHARP_AC
-    case SHARP_AC:
-      sendSharpAc(state, nbytes);
-      break;
-#endif  // SEND_SHARP_AC
-#if SEND_TCL112AC
-    case TCL112AC:
-      sendTcl112Ac(state, nbytes);
-      break;
-#endif  // SEND_TCL112AC
-#if SEND_TEKNOPOINT
-    case TEKNOPOINT:
-      sendTeknopoint(state, nbytes);
-      break;
-#endif  // SEND_TEKNOPOINT
-#if SEND_TOSHIBA_AC
-    case TOSHIBA_AC:
-      sendToshibaAC(state, nbytes);
-      break;
-#endif  // SEND_TOSHIBA_AC
-#if SEND_TROTEC
-    case TROTEC:
-      sendTrotec(state, nbytes);
-      break;
-#endif  // SEND_TROTEC
-#if SEND_WHIRLPOOL_AC
-    case WHIRLPOOL_AC:
-      sendWhirlpoolAC(state, nbytes);
-      break;
-#endif  // SEND_WHIRLPOOL_AC
-    default:
-      return false;
-  }
+  if (type < 0 || type > kLastDecodeType) return false;
+  if (kSenders[type].sendState == NULL) return false;
+  (this->*kSenders[type].sendState)(state, nbytes, minRepeats(type));
   return true;
 }
@@ -7,6 +7,11 @@
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
 #include "IRremoteESP8266.h"
+#include "IRtimer.h"
+
+// Forward declaration. (IRutils.h depends on this file.)
+namespace irutils { class ValueReader; }
+class IRsend;
 
 // Originally from https://github.com/shirriff/Arduino-IRremote/
 // Updated by markszabo (https://github.com/crankyoldgit/IRremoteESP8266) for
@@ -32,6 +37,9 @@ const int8_t kPeriodOffset = -2;
 // Calculated on ESP8266 Wemos D1 mini using v2.4.1 with v2.4.0 ESP core @ 40MHz
 const int8_t kPeriodOffset = -5;
 #endif  // (defined(ESP8266) && F_CPU == 160000000L)
+/// How long what was sent is remembered, for recognising its echo. (uSeconds)
+/// i.e. After this long, we can't be hearing it any more.
+const uint32_t kEchoTimeout = 500000;  // 500ms
 const uint8_t kDutyDefault = 50;  // Percentage
 const uint8_t kDutyMax = 100;     // Percentage
 // delayMicroseconds() is only accurate to 16383us.
@@ -39,6 +47,8 @@ const uint8_t kDutyMax = 100;     // Percentage
 const uint16_t kMaxAccurateUsecDelay = 16383;
 //  Usecs to wait between messages we don't know the proper gap time.
 const uint32_t kDefaultMessageGap = 100000;
+/// Max nr. of bytes of data a learned message can hold. i.e. 512 bits.
+const uint16_t kLearnedMaxBytes = 64;
 
 /// Enumerators and Structures for the Common A/C API.
 namespace stdAc {
@@ -114,6 +124,24 @@ namespace stdAc {
     int16_t sleep;
     int16_t clock;
   } state_t;
+
+  /// Settings of `state_t` that some protocols can only toggle, rather than
+  /// set. Each protocol declares which of them it toggles as a mask.
+  /// @see `IRac::toggleMask()` & `IRac::handleToggles()`
+  const uint8_t kTogglePower =  1 << 0;
+  const uint8_t kToggleSwingV = 1 << 1;
+  const uint8_t kToggleTurbo =  1 << 2;
+  const uint8_t kToggleEcono =  1 << 3;
+  const uint8_t kToggleLight =  1 << 4;
+  const uint8_t kToggleClean =  1 << 5;
+  const uint8_t kToggleSleep =  1 << 6;
+
+  /// A compact, fixed size, encoding of a `state_t`. i.e. For storing,
+  /// comparing, & hashing them cheaply. It has no padding, so `memcmp()` works.
+  /// @see `IRac::packState()`, `IRac::unpackState()`, & `IRac::hashState()`
+  typedef struct {
+    uint32_t raw[3];  ///< protocol & model | sleep & clock | everything else.
+  } packed_state_t;
 };  // namespace stdAc
 
 /// Fujitsu A/C model numbers
@@ -179,6 +207,49 @@ enum lg_ac_remote_model_t {
   AKB74955603,        // (3) LG2 28-bit Protocol variant
 };
 
+/// A simple message (pulse distance or pulse width coded), learned from a
+/// capture. It is much smaller than the raw timings it was learned from.
+/// @see `IRrecv::analyseRaw()` & `IRsend::sendLearned()`.
+/// @note Marks are 16 bits, as that is all `IRsend::mark()` can send.
+typedef struct {
+  uint16_t hdrmark;  ///< Header mark. (uSeconds) 0 = None.
+  uint32_t hdrspace;  ///< Header space. (uSeconds) 0 = None.
+  uint16_t onemark;  ///< Mark of a `1` bit. (uSeconds)
+  uint32_t onespace;  ///< Space of a `1` bit. (uSeconds)
+  uint16_t zeromark;  ///< Mark of a `0` bit. (uSeconds)
+  uint32_t zerospace;  ///< Space of a `0` bit. (uSeconds)
+  uint16_t footermark;  ///< Footer mark. (uSeconds) 0 = None.
+  uint32_t gap;  ///< Space after each frame. (uSeconds)
+  uint16_t nbits;  ///< Nr. of bits of data.
+  uint16_t repeat;  ///< Nr. of times the frame is repeated.
+  uint8_t data[kLearnedMaxBytes];  ///< The bits of data, MSB first.
+} learned_code_t;
+
+/// A method of `IRsend` that sends a simple message. e.g. `sendNEC()`
+typedef void (IRsend::*send_value_fn_t)(const uint64_t data,
+                                        const uint16_t nbits,
+                                        const uint16_t repeat);
+/// A method of `IRsend` that sends a state[] message. e.g. `sendDaikin()`
+typedef void (IRsend::*send_state_fn_t)(const uint8_t data[],
+                                        const uint16_t nbytes,
+                                        const uint16_t repeat);
+
+/// What the library knows about a protocol.
+/// @see `IRsend::protocolInfo()`
+typedef struct {
+  decode_type_t protocol;  ///< Which protocol it is.
+  uint16_t bits;  ///< Default nr. of bits in a message. 0 means no default.
+  uint16_t repeats;  ///< Min. nr. of repeats to send.
+  bool state;  ///< Does it use a state[] rather than a uint64_t value?
+  bool ac;  ///< Can it be sent by the Common A/C API? i.e. `IRac`
+} protocol_info_t;
+
+/// How `IRsend::send()` sends a protocol.
+typedef struct {
+  decode_type_t protocol;  ///< Which protocol it is.
+  send_value_fn_t sendValue;  ///< How to send a value. NULL if we can't.
+  send_state_fn_t sendState;  ///< How to send a state[]. NULL if we can't.
+} protocol_sender_t;
 
 // Classes
 
@@ -196,7 +267,9 @@ class IRsend {
   VIRTUAL uint16_t mark(uint16_t usec);
   VIRTUAL void space(uint32_t usec);
   int8_t calibrate(uint16_t hz = 38000U);
+  void setEchoLog(uint16_t *log, const uint16_t size);
   void sendRaw(const uint16_t buf[], const uint16_t len, const uint16_t hz);
+  uint16_t sendRaw(irutils::ValueReader *reader, const uint16_t hz);
   void sendData(uint16_t onemark, uint32_t onespace, uint16_t zeromark,
                 uint32_t zerospace, uint64_t data, uint16_t nbits,
                 bool MSBfirst = true);
@@ -233,6 +306,9 @@ class IRsend {
                    const uint8_t *dataptr, const uint16_t nbytes,
                    const uint16_t frequency, const bool MSBfirst,
                    const uint16_t repeat, const uint8_t dutycycle);
+  void sendLearned(const learned_code_t *code,
+                   const uint16_t frequency = 38);
+  static const protocol_info_t *protocolInfo(const decode_type_t protocol);
   static uint16_t minRepeats(const decode_type_t protocol);
   static uint16_t defaultBits(const decode_type_t protocol);
   bool send(const decode_type_t type, const uint64_t data,
@@ -412,6 +488,7 @@ class IRsend {
 #endif  // SEND_INAX
 #if SEND_GLOBALCACHE
   void sendGC(uint16_t buf[], uint16_t len);
+  bool sendGC(irutils::ValueReader *reader);
 #endif
 #if SEND_KELVINATOR
   void sendKelvinator(const unsigned char data[],
@@ -474,6 +551,8 @@ class IRsend {
 #endif  // SEND_GOODWEATHER
 #if SEND_PRONTO
   void sendPronto(uint16_t data[], uint16_t len, uint16_t repeat = kNoRepeat);
+  bool sendPronto(irutils::ValueReader *reader,
+                  uint16_t repeat = kNoRepeat);
 #endif
 #if SEND_ARGO
   void sendArgo(const unsigned char data[],
@@ -748,7 +827,17 @@ class IRsend {
   int8_t periodOffset;
   uint8_t _dutycycle;
   bool modulation;
+  // What was sent recently. See `setEchoLog()`.
+  uint16_t *_echo_log;  ///< The marks & spaces sent. (uSeconds)
+  uint16_t _echo_size;  ///< Nr. of entries `_echo_log` can hold.
+  uint16_t _echo_len;  ///< Nr. of entries in `_echo_log`.
+  uint16_t _echo_used;  ///< Entries before this have been heard already.
+  uint32_t _echo_last;  ///< The duration of the last mark or space sent.
+  IRtimer _echo_timer;  ///< When the last mark or space was started.
   uint32_t calcUSecPeriod(uint32_t hz, bool use_offset = true);
+  void logEcho(const uint32_t usecs, const bool is_mark);
+  bool echoRecent(void);
+  friend class IRrecv;  // So it can recognise & ignore what we sent.
 #if SEND_SONY
   void _sendSony(const uint64_t data, const uint16_t nbits,
                  const uint16_t repeat, const uint16_t freq);
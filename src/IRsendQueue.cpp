@@ -0,0 +1,356 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+/// @file
+/// @brief Queue IR messages per transmitter, and send them when asked to.
+
+#include "IRsendQueue.h"
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include <string.h>
+#include <algorithm>
+#include "IRutils.h"
+
+/// Class constructor.
+/// @param[in] senders An array of the transmitter for each channel.
+///   An entry may be NULL, if the channel isn't in use.
+/// @param[in] channels The nr. of entries in `senders`.
+/// @param[in] size The nr. of messages that can be waiting, over all channels.
+/// @param[in] gap The minimum time between messages on a channel. (uSeconds)
+IRsendQueue::IRsendQueue(IRsend *senders[], const uint8_t channels,
+                         const uint16_t size, const uint32_t gap)
+    : _channels(channels), _size(size), _order(0) {
+  _senders = new IRsend*[channels];
+  _gap = new uint32_t[channels];
+  _wait = new uint32_t[channels];
+  _timer = new IRtimer[channels];
+  _pause = new uint32_t[channels];
+  _pause_timer = new TimerMs[channels];
+  for (uint8_t i = 0; i < channels; i++) {
+    _senders[i] = senders[i];
+    _gap[i] = gap;
+    _wait[i] = 0;
+    _pause[i] = 0;
+  }
+  _entries = new sendqueue_entry_t[size];
+  clear();
+}
+
+/// Class destructor.
+IRsendQueue::~IRsendQueue(void) {
+  delete[] _entries;
+  delete[] _pause_timer;
+  delete[] _pause;
+  delete[] _timer;
+  delete[] _wait;
+  delete[] _gap;
+  delete[] _senders;
+}
+
+/// Drop all the messages that are waiting.
+void IRsendQueue::clear(void) {
+  for (uint16_t i = 0; i < _size; i++) {
+    _entries[i].kind = kSendQueueNone;
+    _entries[i].text = "";
+  }
+}
+
+/// Set the minimum time between messages on a channel.
+/// @param[in] channel The channel.
+/// @param[in] gap The new gap. (uSeconds)
+void IRsendQueue::setGap(const uint8_t channel, const uint32_t gap) {
+  if (channel < _channels) _gap[channel] = gap;
+}
+
+/// Get the minimum time between messages on a channel.
+/// @param[in] channel The channel.
+/// @return The gap (uSeconds), or 0 if the channel doesn't exist.
+uint32_t IRsendQueue::getGap(const uint8_t channel) const {
+  return (channel < _channels) ? _gap[channel] : 0;
+}
+
+/// Get the nr. of messages that can be waiting, over all channels.
+/// @return The size of the pool of entries.
+uint16_t IRsendQueue::capacity(void) const { return _size; }
+
+/// Get the nr. of messages waiting, over all channels.
+/// @return The nr. of entries in use.
+uint16_t IRsendQueue::size(void) const {
+  uint16_t result = 0;
+  for (uint16_t i = 0; i < _size; i++)
+    if (_entries[i].kind != kSendQueueNone) result++;
+  return result;
+}
+
+/// Get the nr. of messages waiting for a channel.
+/// @param[in] channel The channel.
+/// @return The nr. of entries in use for that channel.
+uint16_t IRsendQueue::size(const uint8_t channel) const {
+  uint16_t result = 0;
+  for (uint16_t i = 0; i < _size; i++)
+    if (_entries[i].kind != kSendQueueNone && _entries[i].channel == channel)
+      result++;
+  return result;
+}
+
+/// Claim a free entry for a new message.
+/// @param[in] channel The channel it is for.
+/// @param[in] kind What sort of message it is.
+/// @param[in] priority How urgent it is.
+/// @return The entry, or NULL if the channel isn't usable or the pool is full.
+sendqueue_entry_t *IRsendQueue::add(const uint8_t channel, const uint8_t kind,
+                                    const uint8_t priority) {
+  if (channel >= _channels || _senders[channel] == NULL) return NULL;
+  for (uint16_t i = 0; i < _size; i++) {
+    sendqueue_entry_t *entry = &_entries[i];
+    if (entry->kind == kSendQueueNone) {
+      entry->kind = kind;
+      entry->channel = channel;
+      entry->priority = priority;
+      entry->order = _order++;
+      entry->protocol = decode_type_t::UNKNOWN;
+      entry->value = 0;
+      entry->nbits = 0;
+      entry->repeat = kNoRepeat;
+      entry->ac = NULL;
+      return entry;
+    }
+  }
+  return NULL;  // Full.
+}
+
+/// Queue a simple (<= 64 bit) message.
+/// @param[in] channel The channel to send it on.
+/// @param[in] protocol The protocol to send it as.
+/// @param[in] value The code to send.
+/// @param[in] nbits The nr. of bits in the code. 0 means the default for the
+///   protocol.
+/// @param[in] repeat The nr. of times to repeat it. At least the minimum for
+///   the protocol is always sent.
+/// @param[in] priority How urgent it is. (kSendQueuePriority*)
+/// @return true, if it was queued. false, if not.
+bool IRsendQueue::addCode(const uint8_t channel, const decode_type_t protocol,
+                          const uint64_t value, const uint16_t nbits,
+                          const uint16_t repeat, const uint8_t priority) {
+  if (hasACState(protocol)) return false;  // Wrong sort of protocol.
+  sendqueue_entry_t *entry = add(channel, kSendQueueCode, priority);
+  if (entry == NULL) return false;
+  entry->protocol = protocol;
+  entry->value = value;
+  entry->nbits = nbits ? nbits : IRsend::defaultBits(protocol);
+  entry->repeat = std::max(IRsend::minRepeats(protocol), repeat);
+  return true;
+}
+
+/// Queue a state (byte array) based message.
+/// @param[in] channel The channel to send it on.
+/// @param[in] protocol The protocol to send it as.
+/// @param[in] state The state to send. It is copied.
+/// @param[in] nbytes The nr. of bytes in the state.
+/// @param[in] priority How urgent it is. (kSendQueuePriority*)
+/// @return true, if it was queued. false, if not.
+bool IRsendQueue::addState(const uint8_t channel, const decode_type_t protocol,
+                           const uint8_t *state, const uint16_t nbytes,
+                           const uint8_t priority) {
+  if (!hasACState(protocol) || nbytes > kStateSizeMax) return false;
+  sendqueue_entry_t *entry = add(channel, kSendQueueState, priority);
+  if (entry == NULL) return false;
+  entry->protocol = protocol;
+  entry->nbits = nbytes;
+  memcpy(entry->state, state, nbytes);
+  return true;
+}
+
+/// Queue a message made of a string of values.
+/// @param[in] channel The channel to send it on.
+/// @param[in] protocol One of RAW, GLOBALCACHE, or PRONTO.
+/// @param[in] text The comma separated values. It is copied.
+///   RAW: The frequency, then the mark & space times. e.g. "38000,9000,4500,.."
+///   GLOBALCACHE: Without the leading "1:1,1,". e.g. "38000,1,1,170,170,..."
+///   PRONTO: Hexadecimal values. e.g. "0000,0067,0000,0015,0060,0018,..."
+/// @param[in] repeat The nr. of times to repeat it. (PRONTO only)
+/// @param[in] priority How urgent it is. (kSendQueuePriority*)
+/// @return true, if it was queued. false, if not.
+/// @note The values are only checked when sent, so check them first if you
+///   need to know. e.g. With `irutils::countValues()`.
+bool IRsendQueue::addText(const uint8_t channel, const decode_type_t protocol,
+                          const String text, const uint16_t repeat,
+                          const uint8_t priority) {
+  switch (protocol) {
+    case decode_type_t::RAW:
+    case decode_type_t::GLOBALCACHE:
+    case decode_type_t::PRONTO:
+      break;
+    default:
+      return false;
+  }
+  sendqueue_entry_t *entry = add(channel, kSendQueueText, priority);
+  if (entry == NULL) return false;
+  entry->protocol = protocol;
+  entry->repeat = repeat;
+  entry->text = text;
+  return true;
+}
+
+/// Queue a common A/C (climate) state to be sent.
+/// If a state for the same channel & A/C is still waiting to be sent, it is
+/// replaced instead. i.e. Only the latest state is sent.
+/// @param[in] channel The channel it is for.
+/// @param[in] ac The IRac object to send it with.
+/// @param[in] desired The state to send.
+/// @param[in] prev A Ptr to the state the A/C is in now, if known.
+///   Needed for protocols that use toggles. It is ignored if an earlier state
+///   is replaced, as the A/C is still in the state before that one.
+/// @param[in] priority How urgent it is. (kSendQueuePriority*)
+/// @return true, if it was queued or replaced. false, if not.
+bool IRsendQueue::addClimate(const uint8_t channel, IRac *ac,
+                             const stdAc::state_t desired,
+                             const stdAc::state_t *prev,
+                             const uint8_t priority) {
+  if (ac == NULL) return false;
+  for (uint16_t i = 0; i < _size; i++) {
+    sendqueue_entry_t *entry = &_entries[i];
+    if (entry->kind == kSendQueueClimate && entry->channel == channel &&
+        entry->ac == ac) {  // Supersede it.
+      entry->climate.desired = desired;
+      entry->priority = std::max(entry->priority, priority);
+      return true;
+    }
+  }
+  sendqueue_entry_t *entry = add(channel, kSendQueueClimate, priority);
+  if (entry == NULL) return false;
+  entry->ac = ac;
+  entry->climate.desired = desired;
+  entry->climate.has_prev = (prev != NULL);
+  if (prev != NULL) entry->climate.prev = *prev;
+  return true;
+}
+
+/// Queue a pause. i.e. Don't send anything on the channel for a while.
+/// @param[in] channel The channel to pause.
+/// @param[in] msecs How long to pause for. (mSeconds)
+/// @param[in] priority How urgent it is. (kSendQueuePriority*)
+/// @return true, if it was queued. false, if not.
+/// @note Higher priority messages are not held up by it.
+bool IRsendQueue::addPause(const uint8_t channel, const uint32_t msecs,
+                           const uint8_t priority) {
+  sendqueue_entry_t *entry = add(channel, kSendQueuePause, priority);
+  if (entry == NULL) return false;
+  entry->value = msecs;
+  return true;
+}
+
+/// Has a channel been idle for long enough to send something else?
+/// @param[in] channel The channel.
+/// @return true, if it has. false, if not.
+bool IRsendQueue::idle(const uint8_t channel) {
+  // Stop checking each one once it has passed, so the timers can't wrap.
+  if (_wait[channel] && _timer[channel].elapsed() >= _wait[channel])
+    _wait[channel] = 0;
+  if (_pause[channel] && _pause_timer[channel].elapsed() >= _pause[channel])
+    _pause[channel] = 0;
+  return !_wait[channel] && !_pause[channel];
+}
+
+/// Find the message to send next.
+/// @return The entry, or NULL if nothing can be sent yet.
+sendqueue_entry_t *IRsendQueue::next(void) {
+  sendqueue_entry_t *result = NULL;
+  for (uint16_t i = 0; i < _size; i++) {
+    sendqueue_entry_t *entry = &_entries[i];
+    if (entry->kind == kSendQueueNone || !idle(entry->channel)) continue;
+    if (result == NULL || entry->priority > result->priority ||
+        (entry->priority == result->priority && entry->order < result->order))
+      result = entry;
+  }
+  return result;
+}
+
+/// Is there a message that can be sent now?
+/// @return true, if `poll()` would send something. false, if not.
+bool IRsendQueue::ready(void) { return next() != NULL; }
+
+/// What would `poll()` send now, if anything?
+/// @param[out] channel The channel it would be sent on. Optional.
+/// @return What sort of message it is (kSendQueue*), or kSendQueueNone if
+///   there is nothing to send yet.
+uint8_t IRsendQueue::peek(uint8_t *channel) {
+  sendqueue_entry_t *entry = next();
+  if (entry == NULL) return kSendQueueNone;
+  if (channel != NULL) *channel = entry->channel;
+  return entry->kind;
+}
+
+/// Send the message in an entry.
+/// @param[in] entry The entry.
+/// @return true, if it was sent. false, if not.
+bool IRsendQueue::send(sendqueue_entry_t *entry) {
+  IRsend *irsend = _senders[entry->channel];
+  switch (entry->kind) {
+    case kSendQueueCode:
+      return irsend->send(entry->protocol, entry->value, entry->nbits,
+                          entry->repeat);
+    case kSendQueueState:
+      return irsend->send(entry->protocol, entry->state, entry->nbits);
+    case kSendQueueText: {
+      const uint8_t base = (entry->protocol == decode_type_t::PRONTO) ? 16 : 10;
+      irutils::ValueReader reader(entry->text.c_str(), base);
+      switch (entry->protocol) {
+#if SEND_RAW
+        case decode_type_t::RAW: {
+          uint16_t freq;
+          return reader.next(&freq) && irsend->sendRaw(&reader, freq) > 0;
+        }
+#endif  // SEND_RAW
+#if SEND_GLOBALCACHE
+        case decode_type_t::GLOBALCACHE:
+          return irsend->sendGC(&reader);
+#endif  // SEND_GLOBALCACHE
+#if SEND_PRONTO
+        case decode_type_t::PRONTO:
+          return irsend->sendPronto(&reader, entry->repeat);
+#endif  // SEND_PRONTO
+        default:
+          return false;
+      }
+    }
+    case kSendQueueClimate:
+      return entry->ac->sendAc(entry->climate.desired,
+                               entry->climate.has_prev ? &entry->climate.prev
+                                                       : NULL);
+    case kSendQueuePause:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Send the next message, if there is one that can be sent now.
+/// At most one message is sent per call, so it can be called from `loop()`
+/// without holding everything else up for long.
+/// @param[out] success Was the message sent? Optional.
+/// @return What sort of message it was (kSendQueue*), or kSendQueueNone if
+///   there was nothing to send yet.
+uint8_t IRsendQueue::poll(bool *success) {
+  sendqueue_entry_t *entry = next();
+  if (entry == NULL) return kSendQueueNone;
+  const uint8_t kind = entry->kind;
+  const uint8_t channel = entry->channel;
+  const bool sent = send(entry);
+  if (success != NULL) *success = sent;
+  // Keep the channel quiet for a while after it.
+  // Pauses are timed in mSeconds, as they can be longer than a uSecond timer
+  // can count.
+  if (kind == kSendQueuePause) {
+    _wait[channel] = 0;
+    _pause[channel] = entry->value;
+    _pause_timer[channel].reset();
+  } else {
+    _wait[channel] = _gap[channel];
+    _timer[channel].reset();
+  }
+  // Free the entry.
+  entry->kind = kSendQueueNone;
+  entry->text = "";
+  return kind;
+}
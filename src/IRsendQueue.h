@@ -0,0 +1,118 @@
+#ifndef IRSENDQUEUE_H_
+#define IRSENDQUEUE_H_
+
+// Copyright 2021 IRremoteESP8266 authors
+
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
+#include "IRremoteESP8266.h"
+#include "IRac.h"
+#include "IRrecv.h"
+#include "IRsend.h"
+#include "IRtimer.h"
+
+// Constants
+// The kinds of message in the queue.
+const uint8_t kSendQueueNone = 0;  ///< Nothing. i.e. An unused entry.
+const uint8_t kSendQueueCode = 1;  ///< A simple (<= 64 bit) message.
+const uint8_t kSendQueueState = 2;  ///< A state (byte array) based message.
+const uint8_t kSendQueueText = 3;  ///< A Raw, GlobalCache, or Pronto string.
+const uint8_t kSendQueueClimate = 4;  ///< A common A/C state, sent via IRac.
+const uint8_t kSendQueuePause = 5;  ///< A pause. i.e. Nothing is sent.
+
+// Priorities. Higher priority messages are sent first on each channel.
+const uint8_t kSendQueuePriorityNormal = 0;  ///< e.g. TV/media remotes.
+const uint8_t kSendQueuePriorityHigh = 1;  ///< e.g. Climate (A/C) states.
+
+/// Default nr. of messages that can be waiting, over all the channels.
+const uint16_t kSendQueueDefaultSize = 8;
+/// Default minimum time between messages on each channel. (uSeconds)
+const uint32_t kSendQueueDefaultGap = 40000;  // 40ms
+
+/// An IR message waiting to be sent.
+typedef struct {
+  uint8_t kind;  ///< What sort of message it is. (kSendQueue*)
+  uint8_t channel;  ///< Which transmitter to send it with.
+  uint8_t priority;  ///< How urgent it is. (kSendQueuePriority*)
+  uint32_t order;  ///< When it was queued. Lower is earlier.
+  decode_type_t protocol;  ///< The protocol to send it as.
+  uint64_t value;  ///< The code, or the length of a pause. (mSeconds)
+  uint16_t nbits;  ///< The nr. of bits of the code, or bytes of the state.
+  uint16_t repeat;  ///< The nr. of repeats to send.
+  String text;  ///< The values of a Raw, GlobalCache or Pronto message.
+  IRac *ac;  ///< What to send a climate state with.
+  union {
+    uint8_t state[kStateSizeMax];  ///< A state based message.
+    struct {
+      stdAc::state_t desired;  ///< The climate state to send.
+      stdAc::state_t prev;  ///< The climate state before it.
+      bool has_prev;  ///< Is `prev` valid?
+    } climate;
+  };
+} sendqueue_entry_t;
+
+/// Queues IR messages for a set of transmitters (channels), and sends them
+/// one at a time, when called. e.g. From `loop()`.
+/// Each channel's messages are sent in the order they were queued, except
+/// that higher priority messages go first. A minimum gap is kept between the
+/// messages on each channel.
+/// A climate (A/C) state replaces one for the same channel that is still
+/// waiting, so only the latest state is sent.
+/// @note All the channels share a fixed pool of entries, so it is allocated
+///   only once.
+class IRsendQueue {
+ public:
+  IRsendQueue(IRsend *senders[], const uint8_t channels,
+              const uint16_t size = kSendQueueDefaultSize,
+              const uint32_t gap = kSendQueueDefaultGap);
+  ~IRsendQueue(void);
+  // It owns the per-channel arrays & the pool, so it can't be copied.
+  IRsendQueue(const IRsendQueue &) = delete;
+  IRsendQueue &operator=(const IRsendQueue &) = delete;
+  bool addCode(const uint8_t channel, const decode_type_t protocol,
+               const uint64_t value, const uint16_t nbits = 0,
+               const uint16_t repeat = kNoRepeat,
+               const uint8_t priority = kSendQueuePriorityNormal);
+  bool addState(const uint8_t channel, const decode_type_t protocol,
+                const uint8_t *state, const uint16_t nbytes,
+                const uint8_t priority = kSendQueuePriorityNormal);
+  bool addText(const uint8_t channel, const decode_type_t protocol,
+               const String text, const uint16_t repeat = kNoRepeat,
+               const uint8_t priority = kSendQueuePriorityNormal);
+  bool addClimate(const uint8_t channel, IRac *ac,
+                  const stdAc::state_t desired,
+                  const stdAc::state_t *prev = NULL,
+                  const uint8_t priority = kSendQueuePriorityHigh);
+  bool addPause(const uint8_t channel, const uint32_t msecs,
+                const uint8_t priority = kSendQueuePriorityNormal);
+  bool ready(void);
+  uint8_t peek(uint8_t *channel = NULL);
+  uint8_t poll(bool *success = NULL);
+  uint16_t size(void) const;
+  uint16_t size(const uint8_t channel) const;
+  uint16_t capacity(void) const;
+  void clear(void);
+  void setGap(const uint8_t channel, const uint32_t gap);
+  uint32_t getGap(const uint8_t channel) const;
+#ifndef UNIT_TEST
+
+ private:
+#endif
+  IRsend **_senders;  ///< The transmitter for each channel.
+  uint8_t _channels;  ///< Nr. of channels.
+  sendqueue_entry_t *_entries;  ///< The pool of entries.
+  uint16_t _size;  ///< Nr. of entries in the pool.
+  uint32_t _order;  ///< The order of the next message to be queued.
+  uint32_t *_gap;  ///< The minimum gap after a message, per channel.
+  uint32_t *_wait;  ///< How long each channel must still be idle for.
+  IRtimer *_timer;  ///< When each channel was last used.
+  uint32_t *_pause;  ///< How long each channel is paused for. (mSeconds)
+  TimerMs *_pause_timer;  ///< When each channel's pause started.
+  sendqueue_entry_t *add(const uint8_t channel, const uint8_t kind,
+                         const uint8_t priority);
+  bool idle(const uint8_t channel);
+  sendqueue_entry_t *next(void);
+  bool send(sendqueue_entry_t *entry);
+};
+#endif  // IRSENDQUEUE_H_
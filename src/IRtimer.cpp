@@ -74,5 +74,5 @@ uint32_t TimerMs::elapsed() {
 /// @param[in] msecs Nr. of mSeconds to be added.
 /// @note Only used in unit testing.
 #ifdef UNIT_TEST
-void TimerMs::add(uint32_t msecs) { _IRtimer_unittest_now += msecs; }
+void TimerMs::add(uint32_t msecs) { _TimerMs_unittest_now += msecs; }
 #endif  // UNIT_TEST
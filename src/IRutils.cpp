@@ -26,11 +26,21 @@ uint64_t reverseBits(uint64_t input, uint16_t nbits) {
   // Cap the nr. of bits to rotate to the max nr. of bits in the input.
   nbits = std::min(nbits, (uint16_t)(sizeof(input) * 8));
   uint64_t output = 0;
-  for (uint16_t i = 0; i < nbits; i++) {
+  uint16_t i = 0;
+  // Do whole bytes at a time first. The same as 8 passes of the loop below.
+  for (; i + 8 <= nbits; i += 8) {
+    output <<= 8;
+    output |= irutils::reverseByte(input);
+    input >>= 8;
+  }
+  for (; i < nbits; i++) {
     output <<= 1;
     output |= (input & 1);
     input >>= 1;
   }
+  // All of them were reversed, so there is nothing to merge. (Nor can a
+  // uint64_t be shifted by 64 bits.)
+  if (nbits == sizeof(input) * 8) return output;
   // Merge any remaining unreversed bits back to the top of the reversed bits.
   return (input << nbits) | output;
 }
@@ -140,53 +150,7 @@ String typeToString(const decode_type_t protocol, const bool isRepeat) {
 /// @param[in] protocol The decode_type_t protocol we are enquiring about.
 /// @return True if the protocol uses a state array. False if just an integer.
 bool hasACState(const decode_type_t protocol) {
-  switch (protocol) {
-    // This is kept sorted by name
-    case AMCOR:
-    case ARGO:
-    case CORONA_AC:
-    case DAIKIN:
-    case DAIKIN128:
-    case DAIKIN152:
-    case DAIKIN160:
-    case DAIKIN176:
-    case DAIKIN2:
-    case DAIKIN216:
-    case ELECTRA_AC:
-    case FUJITSU_AC:
-    case GREE:
-    case HAIER_AC:
-    case HAIER_AC_YRW02:
-    case HAIER_AC176:
-    case HITACHI_AC:
-    case HITACHI_AC1:
-    case HITACHI_AC2:
-    case HITACHI_AC3:
-    case HITACHI_AC344:
-    case HITACHI_AC424:
-    case KELVINATOR:
-    case MIRAGE:
-    case MITSUBISHI136:
-    case MITSUBISHI112:
-    case MITSUBISHI_AC:
-    case MITSUBISHI_HEAVY_88:
-    case MITSUBISHI_HEAVY_152:
-    case MWM:
-    case NEOCLIMA:
-    case PANASONIC_AC:
-    case SAMSUNG_AC:
-    case SANYO_AC:
-    case SHARP_AC:
-    case TCL112AC:
-    case TEKNOPOINT:
-    case TOSHIBA_AC:
-    case TROTEC:
-    case VOLTAS:
-    case WHIRLPOOL_AC:
-      return true;
-    default:
-      return false;
-  }
+  return IRsend::protocolInfo(protocol)->state;
 }
 
 /// Return the corrected length of a 'raw' format array structure
@@ -383,6 +347,27 @@ uint16_t* resultToRawArray(const decode_results * const decode) {
   return result;
 }
 
+/// Fetch the next 4 bytes of an array as a 32-bit word, regardless of its
+/// alignment. The byte order doesn't matter to the callers.
+/// @param[in] ptr A ptr to the first of the bytes.
+/// @return The 4 bytes as a word.
+static inline uint32_t loadWord(const uint8_t * const ptr) {
+  uint32_t word;
+  memcpy(&word, ptr, sizeof(word));
+  return word;
+}
+
+/// Add up the bytes of a word as two pairs of 16-bit lanes.
+/// @param[in] word The 4 bytes to sum.
+/// @return The lanes. Each is at most 0x1FE.
+static inline uint32_t pairBytes(const uint32_t word) {
+  return (word & 0x00FF00FF) + ((word >> 8) & 0x00FF00FF);
+}
+
+/// Nr. of words that can be accumulated via `pairBytes()` before a lane could
+/// overflow.
+const uint8_t kMaxPairedWords = 128;  // i.e. 0xFFFF / 0x1FE
+
 /// Sum all the bytes of an array and return the least significant 8-bits of
 /// the result.
 /// @param[in] start A ptr to the start of the byte array to calculate over.
@@ -391,9 +376,33 @@ uint16_t* resultToRawArray(const decode_results * const decode) {
 /// @return The 8-bit calculated result of all the bytes and init value.
 uint8_t sumBytes(const uint8_t * const start, const uint16_t length,
                  const uint8_t init) {
+  uint32_t checksum = init;
+  const uint8_t *ptr = start;
+  uint16_t left = length;
+  // Four bytes at a time while we can.
+  while (left >= 4) {
+    uint32_t lanes = 0;
+    for (uint8_t n = 0; n < kMaxPairedWords && left >= 4;
+         n++, ptr += 4, left -= 4)
+      lanes += pairBytes(loadWord(ptr));
+    checksum += lanes + (lanes >> 16);
+  }
+  while (left--) checksum += *ptr++;
+  return checksum;
+}
+
+/// Sum the specified nr. of bytes of an integer and return the least
+/// significant 8-bits of the result.
+/// @param[in] data The integer to be summed.
+/// @param[in] count The number of bytes to sum. Starts from LSB. Max of 8.
+/// @param[in] init Starting value of the calculation to use. (Default is 0)
+/// @return The 8-bit calculated result of all the bytes and init value.
+uint8_t sumBytes(const uint64_t data, const uint8_t count,
+                 const uint8_t init) {
   uint8_t checksum = init;
-  const uint8_t *ptr;
-  for (ptr = start; ptr - start < length; ptr++) checksum += *ptr;
+  uint64_t copy = data;
+  const uint8_t nrofbytes = (count < 8) ? count : 8;
+  for (uint8_t i = 0; i < nrofbytes; i++, copy >>= 8) checksum += copy;
   return checksum;
 }
 
@@ -404,9 +413,15 @@ uint8_t sumBytes(const uint8_t * const start, const uint16_t length,
 /// @return The 8-bit calculated result of all the bytes and init value.
 uint8_t xorBytes(const uint8_t * const start, const uint16_t length,
                  const uint8_t init) {
-  uint8_t checksum = init;
-  const uint8_t *ptr;
-  for (ptr = start; ptr - start < length; ptr++) checksum ^= *ptr;
+  const uint8_t *ptr = start;
+  uint16_t left = length;
+  uint32_t lanes = 0;
+  // Four bytes at a time while we can, then fold them together.
+  for (; left >= 4; ptr += 4, left -= 4) lanes ^= loadWord(ptr);
+  lanes ^= lanes >> 16;
+  lanes ^= lanes >> 8;
+  uint8_t checksum = init ^ lanes;
+  while (left--) checksum ^= *ptr++;
   return checksum;
 }
 
@@ -419,10 +434,18 @@ uint8_t xorBytes(const uint8_t * const start, const uint16_t length,
 uint16_t countBits(const uint8_t * const start, const uint16_t length,
                    const bool ones, const uint16_t init) {
   uint16_t count = init;
-  for (uint16_t offset = 0; offset < length; offset++)
-    for (uint8_t currentbyte = *(start + offset);
-         currentbyte;
-         currentbyte >>= 1)
+  const uint8_t *ptr = start;
+  uint16_t left = length;
+  // Four bytes at a time while we can. (A "SWAR" population count)
+  for (; left >= 4; ptr += 4, left -= 4) {
+    uint32_t word = loadWord(ptr);
+    word -= (word >> 1) & 0x55555555;
+    word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F;
+    count += (word * 0x01010101) >> 24;
+  }
+  for (; left; left--, ptr++)
+    for (uint8_t currentbyte = *ptr; currentbyte; currentbyte >>= 1)
       if (currentbyte & 1) count++;
   if (ones || length == 0)
     return count;
@@ -469,6 +492,26 @@ float celsiusToFahrenheit(const float deg) { return (deg * 9.0) / 5.0 + 32.0; }
 /// Convert degrees Fahrenheit to degrees Celsius.
 float fahrenheitToCelsius(const float deg) { return (deg - 32.0) * 5.0 / 9.0; }
 
+/// Convert tenths of a degree Celsius to tenths of a degree Fahrenheit.
+/// e.g. 215 (21.5C) is 707 (70.7F).
+/// @param[in] tenths Temperature in tenths of a degree Celsius.
+/// @return Temperature in tenths of a degree Fahrenheit, truncated.
+/// @note Integer maths only. For whole degrees >= 0C, the result truncated to a
+///   whole degree is the same as the truncated `celsiusToFahrenheit()`.
+int16_t celsiusToFahrenheitTenths(const int16_t tenths) {
+  return (int32_t)tenths * 9 / 5 + 320;
+}
+
+/// Convert tenths of a degree Fahrenheit to tenths of a degree Celsius.
+/// e.g. 707 (70.7F) is 215 (21.5C).
+/// @param[in] tenths Temperature in tenths of a degree Fahrenheit.
+/// @return Temperature in tenths of a degree Celsius, truncated.
+/// @note Integer maths only. For whole degrees >= 32F, the result truncated to
+///   a whole degree is the same as the truncated `fahrenheitToCelsius()`.
+int16_t fahrenheitToCelsiusTenths(const int16_t tenths) {
+  return ((int32_t)tenths - 320) * 5 / 9;
+}
+
 namespace irutils {
   /// Create a String with a colon separated "label: value" pair suitable for
   /// Humans.
@@ -923,10 +966,21 @@ namespace irutils {
   /// @return The 8-bit calculated result of all the bytes and init value.
   uint8_t sumNibbles(const uint8_t * const start, const uint16_t length,
                      const uint8_t init) {
-    uint8_t sum = init;
-    const uint8_t *ptr;
-    for (ptr = start; ptr - start < length; ptr++)
-      sum += (*ptr >> 4) + (*ptr & 0xF);
+    uint32_t sum = init;
+    const uint8_t *ptr = start;
+    uint16_t left = length;
+    // Four bytes at a time while we can.
+    while (left >= 4) {
+      uint32_t lanes = 0;
+      for (uint8_t n = 0; n < kMaxPairedWords && left >= 4;
+           n++, ptr += 4, left -= 4) {
+        const uint32_t word = loadWord(ptr);
+        // Each byte becomes the sum of its two nibbles. i.e. At most 0x1E.
+        lanes += pairBytes((word & 0x0F0F0F0F) + ((word >> 4) & 0x0F0F0F0F));
+      }
+      sum += lanes + (lanes >> 16);
+    }
+    for (; left; left--, ptr++) sum += (*ptr >> 4) + (*ptr & 0xF);
     return sum;
   }
 
@@ -945,6 +999,17 @@ namespace irutils {
     return nibbleonly ? sum & 0xF : sum;
   }
 
+  /// Reverse the order of the bits in a byte. e.g. 0b00000001 -> 0b10000000
+  /// @param[in] byte The value to be reversed.
+  /// @return The reversed value.
+  /// @note Much quicker than `reverseBits(byte, 8)`.
+  uint8_t reverseByte(const uint8_t byte) {
+    static const uint8_t kReversedNibble[16] = {
+        0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+        0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+    return (kReversedNibble[byte & 0xF] << 4) | kReversedNibble[byte >> 4];
+  }
+
   /// Convert a byte of Binary Coded Decimal(BCD) into an Integer.
   /// @param[in] bcd The BCD value.
   /// @return A normal Integer value.
@@ -1128,6 +1193,148 @@ namespace irutils {
     return true;
   }
 
+  const int16_t kNoChar = -2;  ///< `ValueReader` hasn't fetched a char yet.
+
+  /// Class constructor for reading values from a C-style string.
+  /// @param[in] str The string to read. It is not copied.
+  /// @param[in] base The base/radix of the values. 10 (Default) or 16.
+  ValueReader::ValueReader(const char *str, const uint8_t base)
+      : _str(str ? str : ""), _source(NULL), _context(NULL), _peeked(kNoChar),
+        _base(base), _failed(false), _expect(false), _count(0) {}
+
+  /// Class constructor for reading values from any source of characters.
+  /// e.g. A network connection.
+  /// @param[in] source A function that returns the next char, or -1 at the end.
+  /// @param[in] context Passed to `source` each time it is called.
+  /// @param[in] base The base/radix of the values. 10 (Default) or 16.
+  ValueReader::ValueReader(CharSource source, void *context,
+                           const uint8_t base)
+      : _str(NULL), _source(source), _context(context), _peeked(kNoChar),
+        _base(base), _failed(false), _expect(false), _count(0) {}
+
+  /// Look at the next character without consuming it.
+  /// @return The character, or -1 if at the end.
+  int16_t ValueReader::peek(void) {
+    if (_str != NULL) return *_str ? (uint8_t)*_str : -1;
+    if (_peeked == kNoChar) _peeked = _source(_context);
+    return _peeked;
+  }
+
+  /// Consume the next character.
+  void ValueReader::advance(void) {
+    if (_str != NULL) {
+      if (*_str) _str++;
+    } else {
+      _peeked = kNoChar;
+    }
+  }
+
+  /// Consume any white space.
+  /// @return true, if any was found. false, if not.
+  bool ValueReader::skipSpaces(void) {
+    bool found = false;
+    for (int16_t c = peek(); c == ' ' || c == '\t' || c == '\r' || c == '\n';
+         c = peek()) {
+      advance();
+      found = true;
+    }
+    return found;
+  }
+
+  /// Read the next value.
+  /// @param[out] value Where to store the value.
+  /// @return true, if a value was read. false, if at the end or an error
+  ///   occurred. Use `failed()` to tell which.
+  /// @note Values must fit in 16 bits. A leading "0x" is allowed in base 16.
+  bool ValueReader::next(uint16_t *value) {
+    if (_failed) return false;
+    skipSpaces();
+    int16_t c = peek();
+    if (c < 0) {  // At the end of the input.
+      _failed = _expect;  // e.g. A trailing comma.
+      return false;
+    }
+    uint32_t result = 0;
+    uint8_t digits = 0;
+    for (;; advance(), c = peek()) {
+      int8_t digit = -1;
+      if (c >= '0' && c <= '9')
+        digit = c - '0';
+      else if (c >= 'a' && c <= 'z')
+        digit = c - 'a' + 10;
+      else if (c >= 'A' && c <= 'Z')
+        digit = c - 'A' + 10;
+      if (digit < 0 || digit >= _base) {
+        // Allow a "0x" prefix for hexadecimal values.
+        if (_base == 16 && digits == 1 && result == 0 &&
+            (c == 'x' || c == 'X')) {
+          digits = 0;
+          continue;
+        }
+        break;
+      }
+      result = result * _base + digit;
+      if (result > UINT16_MAX) break;  // Too big.
+      digits++;
+    }
+    // The value must be followed by a separator, or the end of the input.
+    const bool spaced = skipSpaces();
+    c = peek();
+    _expect = (c == ',');
+    if (_expect)
+      advance();
+    else if (c >= 0 && !spaced)
+      digits = 0;  // Something unexpected.
+    if (!digits || result > UINT16_MAX) {
+      _failed = true;
+      return false;
+    }
+    *value = result;
+    _count++;
+    return true;
+  }
+
+  /// Has malformed input been found? e.g. A non-digit or an empty value.
+  /// @return true, if it has. false, if not.
+  bool ValueReader::failed(void) const { return _failed; }
+
+  /// The nr. of values read so far.
+  /// @return The count.
+  uint16_t ValueReader::count(void) const { return _count; }
+
+  /// Change the base/radix of the values that follow.
+  /// @param[in] base The base/radix to use. e.g. 10 or 16.
+  void ValueReader::setBase(const uint8_t base) { _base = base; }
+
+  /// Count the values in a string of comma and/or space separated values.
+  /// @param[in] str A C-style string of the values.
+  /// @param[in] base The base/radix of the values. 10 (Default) or 16.
+  /// @return The nr. of values, or 0 if any of it is malformed.
+  uint16_t countValues(const char *str, const uint8_t base) {
+    ValueReader reader(str, base);
+    uint16_t value;
+    while (reader.next(&value)) {}
+    return reader.failed() ? 0 : reader.count();
+  }
+
+  /// Convert a string of comma and/or space separated values into an array.
+  /// @param[in] str A C-style string of the values.
+  /// @param[out] values The array to store them in.
+  /// @param[in] max The max nr. of entries `values` can hold.
+  /// @param[in] base The base/radix of the values. 10 (Default) or 16.
+  /// @return The nr. of values stored, or 0 if any of it is malformed or
+  ///   there are more than `max` values.
+  uint16_t parseValues(const char *str, uint16_t *values, const uint16_t max,
+                       const uint8_t base) {
+    ValueReader reader(str, base);
+    uint16_t value;
+    while (reader.next(&value)) {
+      if (reader.count() > max) return 0;
+      values[reader.count() - 1] = value;
+    }
+    return reader.failed() ? 0 : reader.count();
+  }
+
   /// Perform a low level bit manipulation sanity check for the given cpu
   /// architecture and the compiler operation. Calls to this should return
   /// 0 if everything is as expected, anything else means the library won't work
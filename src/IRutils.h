@@ -18,6 +18,11 @@ const uint8_t kNibbleSize = 4;
 const uint8_t kLowNibble = 0;
 const uint8_t kHighNibble = 4;
 const uint8_t kModeBitsSize = 3;
+// Use FNV hash algorithm: http://isthe.com/chongo/tech/comp/fnv/#FNV-param
+const uint32_t kFnvPrime32 = 16777619UL;
+const uint32_t kFnvBasis32 = 2166136261UL;
+const uint64_t kFnvPrime64 = 1099511628211ULL;
+const uint64_t kFnvBasis64 = 14695981039346656037ULL;
 uint64_t reverseBits(uint64_t input, uint16_t nbits);
 String uint64ToString(uint64_t input, uint8_t base = 10);
 String int64ToString(int64_t input, uint8_t base = 10);
@@ -33,6 +38,8 @@ uint16_t getCorrectedRawLength(const decode_results * const results);
 uint16_t *resultToRawArray(const decode_results * const decode);
 uint8_t sumBytes(const uint8_t * const start, const uint16_t length,
                  const uint8_t init = 0);
+uint8_t sumBytes(const uint64_t data, const uint8_t count,
+                 const uint8_t init = 0);
 uint8_t xorBytes(const uint8_t * const start, const uint16_t length,
                  const uint8_t init = 0);
 uint16_t countBits(const uint8_t * const start, const uint16_t length,
@@ -43,6 +50,8 @@ uint64_t invertBits(const uint64_t data, const uint16_t nbits);
 decode_type_t strToDecodeType(const char *str);
 float celsiusToFahrenheit(const float deg);
 float fahrenheitToCelsius(const float deg);
+int16_t celsiusToFahrenheitTenths(const int16_t tenths);
+int16_t fahrenheitToCelsiusTenths(const int16_t tenths);
 /// Namespace for covering common functions & procedures for advancd protocol
 /// handlers
 namespace irutils {
@@ -92,6 +101,7 @@ namespace irutils {
                      const uint8_t init = 0);
   uint8_t sumNibbles(const uint64_t data, const uint8_t count = 16,
                      const uint8_t init = 0, const bool nibbleonly = true);
+  uint8_t reverseByte(const uint8_t byte);
   uint8_t bcdToUint8(const uint8_t bcd);
   uint8_t uint8ToBcd(const uint8_t integer);
   bool getBit(const uint64_t data, const uint8_t position,
@@ -131,5 +141,115 @@ namespace irutils {
   uint8_t * invertBytePairs(uint8_t *ptr, const uint16_t length);
   bool checkInvertedBytePairs(const uint8_t * const ptr, const uint16_t length);
   uint8_t lowLevelSanityCheck(void);
+
+  /// Reads a sequence of unsigned integers from text, one value at a time, in
+  /// a single pass & without using the heap.
+  /// Values are separated by commas and/or white space.
+  /// e.g. "38000,1,1,170,170,20,63" or "0000 0067 0000 0015" (base 16)
+  class ValueReader {
+   public:
+    /// A source of characters. It returns the next one, or -1 at the end.
+    typedef int16_t (*CharSource)(void *context);
+    explicit ValueReader(const char *str, const uint8_t base = 10);
+    ValueReader(CharSource source, void *context, const uint8_t base = 10);
+    bool next(uint16_t *value);
+    bool failed(void) const;
+    uint16_t count(void) const;
+    void setBase(const uint8_t base);
+
+   private:
+    const char *_str;  ///< The string being read, or NULL if using `_source`.
+    CharSource _source;  ///< Where to get characters from if not `_str`.
+    void *_context;  ///< What to pass to `_source`.
+    int16_t _peeked;  ///< The character from `_source` yet to be consumed.
+    uint8_t _base;  ///< The base/radix of the values. e.g. 10 or 16
+    bool _failed;  ///< Has malformed input been found?
+    bool _expect;  ///< Must there be another value? i.e. After a comma.
+    uint16_t _count;  ///< Nr. of values read so far.
+    int16_t peek(void);
+    void advance(void);
+    bool skipSpaces(void);
+  };
+  uint16_t countValues(const char *str, const uint8_t base = 10);
+  uint16_t parseValues(const char *str, uint16_t *values, const uint16_t max,
+                       const uint8_t base = 10);
+
+  /// A field of bits at a fixed location in a byte array. e.g. An A/C setting.
+  /// Intended to be a member of a `union` which overlays the array, in place
+  /// of a compiler dependent bit-field, so the layout is exactly as written &
+  /// accesses compile to a few byte-wide shifts & masks.
+  /// Assigning & reading it behaves like the equivalent unsigned bit-field.
+  /// @tparam kByte The index of the byte holding the lowest bit of the field.
+  /// @tparam kOffset The position of the lowest bit in that byte. (0-7)
+  /// @tparam kSize The nr. of bits in the field. Spans bytes lowest first.
+  template <uint16_t kByte, uint8_t kOffset, uint8_t kSize>
+  struct BitField {
+    static_assert(kOffset < 8, "kOffset must be less than 8.");
+    static_assert(kSize > 0 && kOffset + kSize <= 32,
+                  "The field must be 1 bit or more, and span at most 4 bytes.");
+    static constexpr uint8_t kBytes = (kOffset + kSize + 7) / 8;
+    static constexpr uint32_t kMask = ((uint64_t)1 << kSize) - 1;
+
+    uint8_t raw[kByte + kBytes];  ///< Overlays the bytes of the array.
+
+    /// Get the value of the field.
+    /// @note An `int`, just like the integer promotion of a bit-field.
+    operator int() const {
+      if (kBytes == 1) return (raw[kByte] >> kOffset) & kMask;
+      uint32_t value = 0;
+      for (uint8_t i = 0; i < kBytes; i++)
+        value |= (uint32_t)raw[kByte + i] << (i * 8);
+      return (value >> kOffset) & kMask;
+    }
+
+    /// Set the value of the field. Excess high bits are discarded.
+    /// @param[in] value The new value.
+    BitField &operator=(const uint32_t value) {
+      const uint32_t mask = kMask << kOffset;
+      const uint32_t bits = (value & kMask) << kOffset;
+      for (uint8_t i = 0; i < kBytes; i++)
+        raw[kByte + i] = (raw[kByte + i] & ~(mask >> (i * 8))) |
+            (bits >> (i * 8));
+      return *this;
+    }
+  };
+
+  /// A native A/C setting & the common (stdAc) setting it is equivalent to.
+  /// An array of these describes how a protocol converts a setting (e.g. mode,
+  /// fan speed, swing) both ways, in place of a pair of `switch` statements.
+  /// @tparam T The common (stdAc) type. e.g. `stdAc::opmode_t`
+  /// @note When several entries have the same native value, the first is the
+  ///   one it converts back to. e.g. List `kMedium` before `kLow` if both are
+  ///   the same native speed, and it should be reported as `kMedium`.
+  template <typename T>
+  struct AcMapping {
+    uint8_t native;  ///< The protocol's value.
+    T common;  ///< The equivalent stdAc value.
+  };
+
+  /// Convert a common (stdAc) setting to its native equivalent.
+  /// @param[in] map The mappings of the setting.
+  /// @param[in] common The setting to convert.
+  /// @param[in] def The native value to use if it isn't in the `map`.
+  /// @return The native equivalent.
+  template <typename T, uint16_t N>
+  uint8_t toNative(const AcMapping<T> (&map)[N], const T common,
+                   const uint8_t def) {
+    for (uint16_t i = 0; i < N; i++)
+      if (map[i].common == common) return map[i].native;
+    return def;
+  }
+
+  /// Convert a native setting to its common (stdAc) equivalent.
+  /// @param[in] map The mappings of the setting.
+  /// @param[in] native The setting to convert.
+  /// @param[in] def The common value to use if it isn't in the `map`.
+  /// @return The common equivalent.
+  template <typename T, uint16_t N>
+  T toCommon(const AcMapping<T> (&map)[N], const uint8_t native, const T def) {
+    for (uint16_t i = 0; i < N; i++)
+      if (map[i].native == native) return map[i].common;
+    return def;
+  }
 }  // namespace irutils
 #endif  // IRUTILS_H_
@@ -53,6 +53,8 @@ const uint8_t kAirwellHeat = 2;  // 0b010
 const uint8_t kAirwellAuto = 3;  // 0b011
 const uint8_t kAirwellDry = 4;   // 0b100
 const uint8_t kAirwellFan = 5;   // 0b101
+/// Settings an Airwell message toggles, rather than sets.
+const uint8_t kAirwellToggles = stdAc::kTogglePower;
 
 
 // Classes
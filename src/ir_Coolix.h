@@ -89,6 +89,10 @@ const uint32_t kCoolixClean  = 0b101101011111010110101010;  // 0xB5F5AA
 const uint32_t kCoolixCmdFan = 0b101100101011111111100100;  // 0xB2BFE4
 // On, 25C, Mode: Auto, Fan: Auto, Zone Follow: Off, Sensor Temp: Ignore.
 const uint32_t kCoolixDefaultState = 0b101100100001111111001000;  // 0xB21FC8
+/// Settings a Coolix message toggles, rather than sets.
+const uint8_t kCoolixToggles = stdAc::kToggleSwingV | stdAc::kToggleTurbo |
+                               stdAc::kToggleLight | stdAc::kToggleClean |
+                               stdAc::kToggleSleep;
 
 /// Native representation of a Coolix A/C message.
 union CoolixProtocol {
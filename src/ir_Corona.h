@@ -100,6 +100,8 @@ const uint16_t kCoronaAcTimerMax = 12 * 60;  // 12H in Minutes
 // Min value on remote is 1 hour, actual sent value can be 2 secs
 const uint16_t kCoronaAcTimerOff = 0xffff;
 const uint16_t kCoronaAcTimerUnitsPerMin = 30;  // 30 units = 1 minute
+/// Settings a Corona message toggles, rather than sets.
+const uint8_t kCoronaAcToggles = stdAc::kToggleSwingV;
 
 // Classes
 
@@ -52,6 +52,23 @@ using irutils::setBits;
 using irutils::sumNibbles;
 using irutils::uint8ToBcd;
 
+using irutils::AcMapping;
+
+/// How the native modes map to the common ones.
+const AcMapping<stdAc::opmode_t> kDaikinModeMap[] = {
+    {kDaikinCool, stdAc::opmode_t::kCool},
+    {kDaikinHeat, stdAc::opmode_t::kHeat},
+    {kDaikinDry, stdAc::opmode_t::kDry},
+    {kDaikinFan, stdAc::opmode_t::kFan}};
+/// How the native fan speeds map to the common ones.
+const AcMapping<stdAc::fanspeed_t> kDaikinFanMap[] = {
+    {kDaikinFanQuiet, stdAc::fanspeed_t::kMin},
+    {kDaikinFanMin, stdAc::fanspeed_t::kLow},
+    {kDaikinFanMed, stdAc::fanspeed_t::kMedium},
+    {kDaikinFanMin + 1, stdAc::fanspeed_t::kMedium},
+    {kDaikinFanMax - 1, stdAc::fanspeed_t::kHigh},
+    {kDaikinFanMax, stdAc::fanspeed_t::kMax}};
+
 #if SEND_DAIKIN
 /// Send a Daikin 280-bit A/C formatted message.
 /// Status: STABLE
@@ -474,55 +491,28 @@ bool IRDaikinESP::getWeeklyTimerEnable(void) const {
 /// @param[in] mode The enum to be converted.
 /// @return The native equivalent of the enum.
 uint8_t IRDaikinESP::convertMode(const stdAc::opmode_t mode) {
-  switch (mode) {
-    case stdAc::opmode_t::kCool: return kDaikinCool;
-    case stdAc::opmode_t::kHeat: return kDaikinHeat;
-    case stdAc::opmode_t::kDry: return kDaikinDry;
-    case stdAc::opmode_t::kFan: return kDaikinFan;
-    default: return kDaikinAuto;
-  }
+  return irutils::toNative(kDaikinModeMap, mode, kDaikinAuto);
 }
 
 /// Convert a stdAc::fanspeed_t enum into it's native speed.
 /// @param[in] speed The enum to be converted.
 /// @return The native equivalent of the enum.
 uint8_t IRDaikinESP::convertFan(const stdAc::fanspeed_t speed) {
-  switch (speed) {
-    case stdAc::fanspeed_t::kMin: return kDaikinFanQuiet;
-    case stdAc::fanspeed_t::kLow: return kDaikinFanMin;
-    case stdAc::fanspeed_t::kMedium: return kDaikinFanMed;
-    case stdAc::fanspeed_t::kHigh: return kDaikinFanMax - 1;
-    case stdAc::fanspeed_t::kMax: return kDaikinFanMax;
-    default: return kDaikinFanAuto;
-  }
+  return irutils::toNative(kDaikinFanMap, speed, kDaikinFanAuto);
 }
 
 /// Convert a native mode into its stdAc equivalent.
 /// @param[in] mode The native setting to be converted.
 /// @return The stdAc equivalent of the native setting.
 stdAc::opmode_t IRDaikinESP::toCommonMode(const uint8_t mode) {
-  switch (mode) {
-    case kDaikinCool: return stdAc::opmode_t::kCool;
-    case kDaikinHeat: return stdAc::opmode_t::kHeat;
-    case kDaikinDry: return stdAc::opmode_t::kDry;
-    case kDaikinFan: return stdAc::opmode_t::kFan;
-    default: return stdAc::opmode_t::kAuto;
-  }
+  return irutils::toCommon(kDaikinModeMap, mode, stdAc::opmode_t::kAuto);
 }
 
 /// Convert a native fan speed into its stdAc equivalent.
 /// @param[in] speed The native setting to be converted.
 /// @return The stdAc equivalent of the native setting.
 stdAc::fanspeed_t IRDaikinESP::toCommonFanSpeed(const uint8_t speed) {
-  switch (speed) {
-    case kDaikinFanMax: return stdAc::fanspeed_t::kMax;
-    case kDaikinFanMax - 1: return stdAc::fanspeed_t::kHigh;
-    case kDaikinFanMed:
-    case kDaikinFanMin + 1: return stdAc::fanspeed_t::kMedium;
-    case kDaikinFanMin: return stdAc::fanspeed_t::kLow;
-    case kDaikinFanQuiet: return stdAc::fanspeed_t::kMin;
-    default: return stdAc::fanspeed_t::kAuto;
-  }
+  return irutils::toCommon(kDaikinFanMap, speed, stdAc::fanspeed_t::kAuto);
 }
 
 /// Convert the current internal state into its stdAc::state_t equivalent.
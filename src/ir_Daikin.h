@@ -54,6 +54,7 @@
 #include "IRrecv.h"
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
+#include "IRutils.h"
 #ifdef UNIT_TEST
 #include "IRsend_test.h"
 #endif
@@ -61,70 +62,34 @@
 /// Native representation of a Daikin A/C message.
 union DaikinESPProtocol{
   uint8_t raw[kDaikinStateLength];  ///< The state of the IR remote.
-  struct {
-    // Byte 0~5
-    uint64_t          :48;
-    // Byte 6
-    uint64_t          :4;
-    uint64_t Comfort  :1;
-    uint64_t          :3;
-    // Byte 7
-    uint64_t Sum1     :8;  // checksum of the first part
-
-    // Byte 8~12
-    uint64_t              :40;
-    // Byte 13~14
-    uint64_t CurrentTime  :11;  // Current time, mins past midnight
-    uint64_t CurrentDay   :3;  // Day of the week (SUN=1, MON=2, ..., SAT=7)
-    uint64_t              :2;
-    // Byte 15
-    uint64_t Sum2         :8;  // checksum of the second part
-
-    // Byte 16~20
-    uint64_t          :40;
-    // Byte 21
-    uint64_t Power    :1;
-    uint64_t OnTimer  :1;
-    uint64_t OffTimer :1;
-    uint64_t          :1;  // always 1
-    uint64_t Mode     :3;
-    uint64_t          :1;
-    // Byte 22
-    uint64_t          :1;
-    uint64_t Temp     :7;  // Temp should be between 10 - 32
-    // Byte 23
-    uint64_t          :8;
-
-    // Byte 24
-    uint64_t SwingV   :4;  // 0000 =  off, 1111 = on
-    uint64_t Fan      :4;
-    // Byte 25
-    uint64_t SwingH   :4;  // 0000 =  off, 1111 = on
-    uint64_t          :4;
-    // Byte 26~28
-    uint64_t OnTime   :12;  // timer mins past midnight
-    uint64_t OffTime  :12;  // timer mins past midnight
-    // Byte 29
-    uint64_t Powerful :1;
-    uint64_t          :4;
-    uint64_t Quiet    :1;
-    uint64_t          :2;
-    // Byte 30~31
-    uint64_t          :0;
-
-    // Byte 32
-    uint8_t             :1;
-    uint8_t Sensor      :1;
-    uint8_t Econo       :1;
-    uint8_t             :4;
-    uint8_t WeeklyTimer :1;
-    // Byte 33
-    uint8_t       :1;
-    uint8_t Mold  :1;
-    uint8_t       :6;
-    // Byte 34
-    uint8_t Sum3  :8;  // checksum of the third part
-  };
+  irutils::BitField<6, 4, 1> Comfort;
+  irutils::BitField<7, 0, 8> Sum1;  // checksum of the first part
+
+  irutils::BitField<13, 0, 11> CurrentTime;  // Current time, mins past midnight
+  // Day of the week (SUN=1, MON=2, ..., SAT=7)
+  irutils::BitField<14, 3, 3> CurrentDay;
+  irutils::BitField<15, 0, 8> Sum2;  // checksum of the second part
+
+  irutils::BitField<21, 0, 1> Power;
+  irutils::BitField<21, 1, 1> OnTimer;
+  irutils::BitField<21, 2, 1> OffTimer;
+  // Byte 21, bit 3 is always 1.
+  irutils::BitField<21, 4, 3> Mode;
+  irutils::BitField<22, 1, 7> Temp;  // Temp should be between 10 - 32
+
+  irutils::BitField<24, 0, 4> SwingV;  // 0000 =  off, 1111 = on
+  irutils::BitField<24, 4, 4> Fan;
+  irutils::BitField<25, 0, 4> SwingH;  // 0000 =  off, 1111 = on
+  irutils::BitField<26, 0, 12> OnTime;  // timer mins past midnight
+  irutils::BitField<27, 4, 12> OffTime;  // timer mins past midnight
+  irutils::BitField<29, 0, 1> Powerful;
+  irutils::BitField<29, 5, 1> Quiet;
+
+  irutils::BitField<32, 1, 1> Sensor;
+  irutils::BitField<32, 2, 1> Econo;
+  irutils::BitField<32, 7, 1> WeeklyTimer;
+  irutils::BitField<33, 1, 1> Mold;
+  irutils::BitField<34, 0, 8> Sum3;  // checksum of the third part
 };
 
 // Constants
@@ -174,93 +139,39 @@ const uint64_t kDaikinFirstHeader64 =
 
 /// Native representation of a Daikin2 A/C message.
 union Daikin2Protocol{
-  struct{
-    uint8_t pad[3];
-    uint8_t raw[kDaikin2StateLength];  ///< The state of the IR remote.
-  };
-  struct {
-    // Byte -3~4
-    uint64_t :64;
-
-    // Byte 5~6
-    uint64_t CurrentTime  :12;
-    uint64_t              :3;
-    uint64_t Power2       :1;
-    // Byte 7
-    uint64_t              :4;
-    uint64_t Light        :2;
-    uint64_t Beep         :2;
-    // Byte 8
-    uint64_t FreshAir     :1;
-    uint64_t              :2;
-    uint64_t Mold         :1;
-    uint64_t              :1;
-    uint64_t Clean        :1;
-    uint64_t              :1;
-    uint64_t FreshAirHigh :1;
-    // Byte 9~12
-    uint64_t              :32;
-
-    // Byte 13
-    uint64_t          :7;
-    uint64_t EyeAuto  :1;
-    // Byte 14~16
-    uint64_t          :24;
-    // Byte 17
-    uint64_t SwingH   :8;
-    // Byte 18
-    uint64_t SwingV   :4;
-    uint64_t          :4;
-    // Byte 19
-    uint64_t Sum1     :8;
-    // Byte 20
-    uint64_t          :8;
-
-    // Byte 21~24
-    uint64_t          :32;
-    // Byte 25
-    uint64_t Power    :1;
-    uint64_t OnTimer  :1;
-    uint64_t OffTimer :1;
-    uint64_t          :1;
-    uint64_t Mode     :3;
-    uint64_t          :1;
-    // Byte 26
-    uint64_t          :1;
-    uint64_t Temp     :7;
-    // Byte 27
-    uint64_t          :8;
-    // Byte 28
-    uint64_t          :4;
-    uint64_t Fan      :4;
-
-    // Byte 29
-    uint64_t            :8;
-    // Byte 30~32
-    /// @see https://github.com/crankyoldgit/IRremoteESP8266/pull/1264
-    uint64_t OnTime     :12;
-    uint64_t OffTime    :12;
-    // Byte 33
-    uint64_t Powerful   :1;
-    uint64_t            :4;
-    uint64_t Quiet      :1;
-    uint64_t            :2;
-    // Byte 34~35
-    uint64_t            :16;
-    // Byte 36
-    uint64_t            :1;
-    uint64_t Eye        :1;
-    uint64_t Econo      :1;
-    uint64_t            :1;
-    uint64_t Purify     :1;
-    uint64_t SleepTimer :1;
-    uint64_t            :2;
-
-    // Byte 37
-    uint8_t       :8;
-    // Byte 38
-    uint8_t Sum2  :8;
-  };
+  uint8_t raw[kDaikin2StateLength];  ///< The state of the IR remote.
+  irutils::BitField<5, 0, 12> CurrentTime;
+  irutils::BitField<6, 7, 1> Power2;
+  irutils::BitField<7, 4, 2> Light;
+  irutils::BitField<7, 6, 2> Beep;
+  irutils::BitField<8, 0, 1> FreshAir;
+  irutils::BitField<8, 3, 1> Mold;
+  irutils::BitField<8, 5, 1> Clean;
+  irutils::BitField<8, 7, 1> FreshAirHigh;
+
+  irutils::BitField<13, 7, 1> EyeAuto;
+  irutils::BitField<17, 0, 8> SwingH;
+  irutils::BitField<18, 0, 4> SwingV;
+  irutils::BitField<19, 0, 8> Sum1;
+
+  irutils::BitField<25, 0, 1> Power;
+  irutils::BitField<25, 1, 1> OnTimer;
+  irutils::BitField<25, 2, 1> OffTimer;
+  irutils::BitField<25, 4, 3> Mode;
+  irutils::BitField<26, 1, 7> Temp;
+  irutils::BitField<28, 4, 4> Fan;
+
+  /// @see https://github.com/crankyoldgit/IRremoteESP8266/pull/1264
+  irutils::BitField<30, 0, 12> OnTime;
+  irutils::BitField<31, 4, 12> OffTime;
+  irutils::BitField<33, 0, 1> Powerful;
+  irutils::BitField<33, 5, 1> Quiet;
+  irutils::BitField<36, 1, 1> Eye;
+  irutils::BitField<36, 2, 1> Econo;
+  irutils::BitField<36, 4, 1> Purify;
+  irutils::BitField<36, 5, 1> SleepTimer;
+
+  irutils::BitField<38, 0, 8> Sum2;
 };
 
 const uint16_t kDaikin2Freq = 36700;  // Modulation Frequency in Hz.
@@ -304,40 +215,15 @@ const uint8_t kDaikin2MinCoolTemp = 18;  // Min temp (in C) when in Cool mode.
 /// Native representation of a Daikin216 A/C message.
 union Daikin216Protocol{
   uint8_t raw[kDaikin216StateLength];  ///< The state of the IR remote.
-  struct {
-    // Byte 0~6
-    uint8_t pad0[7];
-    // Byte 7
-    uint8_t Sum1  :8;
-    // Byte 8~12
-    uint8_t pad1[5];
-    // Byte 13
-    uint8_t Power :1;
-    uint8_t       :3;
-    uint8_t Mode  :3;
-    uint8_t       :1;
-    // Byte 14
-    uint8_t         :1;
-    uint8_t Temp    :6;
-    uint8_t         :1;
-    // Byte 15
-    uint8_t         :8;
-    // Byte 16
-    uint8_t SwingV  :4;
-    uint8_t Fan     :4;
-    // Byte 17
-    uint8_t SwingH  :4;
-    uint8_t         :4;
-    // Byte 18~20
-    uint8_t pad2[3];
-    // Byte 21
-    uint8_t Powerful  :1;
-    uint8_t           :0;
-    // Byte 22~25
-    uint8_t pad3[4];
-    // Byte 26
-    uint8_t Sum2      :8;
-  };
+  irutils::BitField<7, 0, 8> Sum1;
+  irutils::BitField<13, 0, 1> Power;
+  irutils::BitField<13, 4, 3> Mode;
+  irutils::BitField<14, 1, 6> Temp;
+  irutils::BitField<16, 0, 4> SwingV;
+  irutils::BitField<16, 4, 4> Fan;
+  irutils::BitField<17, 0, 4> SwingH;
+  irutils::BitField<21, 0, 1> Powerful;
+  irutils::BitField<26, 0, 8> Sum2;
 };
 
 const uint16_t kDaikin216Freq = 38000;  // Modulation Frequency in Hz.
@@ -358,35 +244,13 @@ const uint8_t kDaikin216SwingOff = 0b0000;
 /// Native representation of a Daikin160 A/C message.
 union Daikin160Protocol{
   uint8_t raw[kDaikin160StateLength];  ///< The state of the IR remote.
-  struct {
-    // Byte 0~5
-    uint8_t pad0[6];
-    // Byte 6
-    uint8_t Sum1 :8;
-    // Byte 7~11
-    uint8_t pad1[5];
-    // Byte 12
-    uint8_t Power   :1;
-    uint8_t         :3;
-    uint8_t Mode    :3;
-    uint8_t         :1;
-    // Byte 13
-    uint8_t         :4;
-    uint8_t SwingV  :4;
-    // Byte 14~15
-    uint8_t pad2[2];
-    // Byte 16
-    uint8_t       :1;
-    uint8_t Temp  :6;
-    uint8_t       :1;
-    // Byte 17
-    uint8_t Fan   :4;
-    uint8_t       :4;
-    // Byte 18
-    uint8_t       :8;
-    // Byte 19
-    uint8_t Sum2  :8;
-  };
+  irutils::BitField<6, 0, 8> Sum1;
+  irutils::BitField<12, 0, 1> Power;
+  irutils::BitField<12, 4, 3> Mode;
+  irutils::BitField<13, 4, 4> SwingV;
+  irutils::BitField<16, 1, 6> Temp;
+  irutils::BitField<17, 0, 4> Fan;
+  irutils::BitField<19, 0, 8> Sum2;
 };
 
 const uint16_t kDaikin160Freq = 38000;  // Modulation Frequency in Hz.
@@ -410,38 +274,15 @@ const uint8_t kDaikin160SwingVAuto =    0xF;
 /// Native representation of a Daikin176 A/C message.
 union Daikin176Protocol{
   uint8_t raw[kDaikin176StateLength];  ///< The state of the IR remote.
-  struct {
-    // Byte 0~5
-    uint8_t pad0[6];
-    // Byte 6
-    uint8_t Sum1 :8;
-    // Byte 7~11
-    uint8_t pad1[5];
-    // Byte 12
-    uint8_t         :4;
-    uint8_t AltMode :3;
-    uint8_t         :1;
-    // Byte 13
-    uint8_t ModeButton  :8;
-    // Byte 14
-    uint8_t Power :1;
-    uint8_t       :3;
-    uint8_t Mode  :3;
-    uint8_t       :1;
-    // Byte 15~16
-    uint8_t pad2[2];
-    // Byte 17
-    uint8_t       :1;
-    uint8_t Temp  :6;
-    uint8_t       :1;
-    // Byte 18
-    uint8_t SwingH  :4;
-    uint8_t Fan     :4;
-    // Byte 19~20
-    uint8_t pad3[2];
-    // Byte 21
-    uint8_t Sum2  :8;
-  };
+  irutils::BitField<6, 0, 8> Sum1;
+  irutils::BitField<12, 4, 3> AltMode;
+  irutils::BitField<13, 0, 8> ModeButton;
+  irutils::BitField<14, 0, 1> Power;
+  irutils::BitField<14, 4, 3> Mode;
+  irutils::BitField<17, 1, 6> Temp;
+  irutils::BitField<18, 0, 4> SwingH;
+  irutils::BitField<18, 4, 4> Fan;
+  irutils::BitField<21, 0, 8> Sum2;
 };
 
 const uint16_t kDaikin176Freq = 38000;  // Modulation Frequency in Hz.
@@ -469,45 +310,26 @@ const uint8_t kDaikin176SwingHOff = 0x6;
 /// Native representation of a Daikin128 A/C message.
 union Daikin128Protocol{
   uint8_t raw[kDaikin128StateLength];  ///< The state of the IR remote.
-  struct {
-    // Byte 0
-    uint8_t       :8;
-    // Byte 1
-    uint8_t Mode  :4;
-    uint8_t Fan   :4;
-    // Byte 2
-    uint8_t ClockMins   :8;
-    // Byte 3
-    uint8_t ClockHours  :8;
-    // Byte 4
-    uint8_t OnHours     :6;
-    uint8_t OnHalfHour  :1;
-    uint8_t OnTimer     :1;
-    // Byte 5
-    uint8_t OffHours    :6;
-    uint8_t OffHalfHour :1;
-    uint8_t OffTimer    :1;
-    // Byte 6
-    uint8_t Temp    :8;
-    // Byte 7
-    uint8_t SwingV  :1;
-    uint8_t Sleep   :1;
-    uint8_t         :1;  // always 1
-    uint8_t Power   :1;
-    uint8_t Sum1    :4;
-    // Byte 8
-    uint8_t         :8;
-    // Byte 9
-    uint8_t Ceiling :1;
-    uint8_t         :1;
-    uint8_t Econo   :1;
-    uint8_t Wall    :1;
-    uint8_t         :4;
-    // Byte 10~14
-    uint8_t pad[5];
-    // Byte 15
-    uint8_t Sum2    :8;
-  };
+  irutils::BitField<1, 0, 4> Mode;
+  irutils::BitField<1, 4, 4> Fan;
+  irutils::BitField<2, 0, 8> ClockMins;
+  irutils::BitField<3, 0, 8> ClockHours;
+  irutils::BitField<4, 0, 6> OnHours;
+  irutils::BitField<4, 6, 1> OnHalfHour;
+  irutils::BitField<4, 7, 1> OnTimer;
+  irutils::BitField<5, 0, 6> OffHours;
+  irutils::BitField<5, 6, 1> OffHalfHour;
+  irutils::BitField<5, 7, 1> OffTimer;
+  irutils::BitField<6, 0, 8> Temp;
+  irutils::BitField<7, 0, 1> SwingV;
+  irutils::BitField<7, 1, 1> Sleep;
+  // Byte 7, bit 2 is always 1.
+  irutils::BitField<7, 3, 1> Power;
+  irutils::BitField<7, 4, 4> Sum1;
+  irutils::BitField<9, 0, 1> Ceiling;
+  irutils::BitField<9, 2, 1> Econo;
+  irutils::BitField<9, 3, 1> Wall;
+  irutils::BitField<15, 0, 8> Sum2;
 };
 
 const uint16_t kDaikin128Freq = 38000;  // Modulation Frequency in Hz.
@@ -541,42 +363,17 @@ const uint8_t kDaikin128BitCeiling =      0b00000001;
 /// Native representation of a Daikin152 A/C message.
 union Daikin152Protocol{
   uint8_t raw[kDaikin152StateLength];  ///< The state of the IR remote.
-  struct {
-    // Byte 0~4
-    uint8_t pad0[5];
-    // Byte 5
-    uint8_t Power :1;
-    uint8_t       :3;
-    uint8_t Mode  :3;
-    uint8_t       :1;
-    // Byte 6
-    uint8_t       :1;
-    uint8_t Temp  :7;
-    // Byte 7
-    uint8_t :8;
-    // Byte 8
-    uint8_t SwingV  :4;
-    uint8_t Fan     :4;
-    // Byte 9~12
-    uint8_t pad1[4];
-    // Byte 13
-    uint8_t Powerful  :1;
-    uint8_t           :4;
-    uint8_t Quiet     :1;
-    uint8_t           :2;
-    // Byte 14~15
-    uint8_t pad2[2];
-    // Byte 16
-    uint8_t         :1;
-    uint8_t Comfort :1;
-    uint8_t Econo   :1;
-    uint8_t Sensor  :1;
-    uint8_t         :4;
-    // Byte 17
-    uint8_t     :8;
-    // Byte 18
-    uint8_t Sum :8;
-  };
+  irutils::BitField<5, 0, 1> Power;
+  irutils::BitField<5, 4, 3> Mode;
+  irutils::BitField<6, 1, 7> Temp;
+  irutils::BitField<8, 0, 4> SwingV;
+  irutils::BitField<8, 4, 4> Fan;
+  irutils::BitField<13, 0, 1> Powerful;
+  irutils::BitField<13, 5, 1> Quiet;
+  irutils::BitField<16, 1, 1> Comfort;
+  irutils::BitField<16, 2, 1> Econo;
+  irutils::BitField<16, 3, 1> Sensor;
+  irutils::BitField<18, 0, 8> Sum;
 };
 
 const uint16_t kDaikin152Freq = 38000;  // Modulation Frequency in Hz.
@@ -642,6 +439,10 @@ const uint8_t kDaikin64MinTemp = 16;  // Celsius
 const uint8_t kDaikin64MaxTemp = 30;  // Celsius
 const uint8_t kDaikin64ChecksumOffset = 60;
 const uint8_t kDaikin64ChecksumSize = 4;  // Mask 0b1111 << 59
+/// Settings a Daikin128 message toggles, rather than sets.
+const uint8_t kDaikin128Toggles = stdAc::kTogglePower | stdAc::kToggleLight;
+/// Settings a Daikin64 message toggles, rather than sets.
+const uint8_t kDaikin64Toggles = stdAc::kTogglePower;
 
 // Legacy defines.
 #define DAIKIN_COOL kDaikinCool
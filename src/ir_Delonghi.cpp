@@ -109,12 +109,8 @@ void IRDelonghiAc::send(const uint16_t repeat) {
 /// @param[in] state The value to calc the checksum of.
 /// @return A valid checksum value.
 uint8_t IRDelonghiAc::calcChecksum(const uint64_t state) {
-  uint8_t sum = 0;
   // Add up all the 8 bit chunks except for Most-significant 8 bits.
-  for (uint8_t offset = 0; offset < kDelonghiAcChecksumOffset; offset += 8) {
-    sum += GETBITS64(state, offset, 8);
-  }
-  return sum;
+  return sumBytes(state, kDelonghiAcChecksumOffset / 8);
 }
 
 /// Verify the checksum is valid for a given state.
@@ -95,12 +95,10 @@ bool IRrecv::decodeEcoclim(decode_results *results, uint16_t offset,
     DPRINTLN("DEBUG: Data section matched okay.");
     offset += used;
     // Compliance
-    if (strict) {
-      if (section) {  // Each section should contain the same data.
-        if (data != results->value) return false;
-      } else {
-        results->value = data;
-      }
+    if (section) {  // Each section should contain the same data.
+      if (strict && data != results->value) return false;
+    } else {
+      results->value = data;
     }
   }
 
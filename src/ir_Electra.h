@@ -92,6 +92,8 @@ const uint8_t kElectraAcLightToggleOn  = 0x15;
 const uint8_t kElectraAcLightToggleMask = 0x11;
 // and known OFF values of 0x08 (0b00001000) & 0x05 (0x00000101)
 const uint8_t kElectraAcLightToggleOff = 0x08;
+/// Settings an Electra message toggles, rather than sets.
+const uint8_t kElectraAcToggles = stdAc::kToggleLight;
 
 
 // Classes
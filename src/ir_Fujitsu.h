@@ -141,6 +141,8 @@ const uint8_t kFujitsuAcSleepTimer =                       0b01;  // 1
 const uint8_t kFujitsuAcOffTimer =                         0b10;  // 2
 const uint8_t kFujitsuAcOnTimer =                          0b11;  // 3
 const uint16_t kFujitsuAcTimerMax = 12 * 60;  ///< Minutes.
+/// Settings a Fujitsu message toggles. (They are separate commands.)
+const uint8_t kFujitsuAcToggles = stdAc::kToggleTurbo | stdAc::kToggleEcono;
 
 // Legacy defines.
 #define FUJITSU_AC_MODE_AUTO kFujitsuAcModeAuto
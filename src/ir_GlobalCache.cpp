@@ -10,7 +10,9 @@
 //   Brand: Global Cache,  Model: Control Tower IR DB
 
 #include <algorithm>
+#include <cstring>
 #include "IRsend.h"
+#include "IRutils.h"
 
 // Constants
 const uint16_t kGlobalCacheMaxRepeat = 50;
@@ -19,6 +21,7 @@ const uint8_t kGlobalCacheFreqIndex = 0;
 const uint8_t kGlobalCacheRptIndex = kGlobalCacheFreqIndex + 1;
 const uint8_t kGlobalCacheRptStartIndex = kGlobalCacheRptIndex + 1;
 const uint8_t kGlobalCacheStartIndex = kGlobalCacheRptStartIndex + 1;
+const uint16_t kGlobalCacheBufferStep = 32;  ///< Growth of the repeat buffer.
 
 #if SEND_GLOBALCACHE
 /// Send a shortened GlobalCache (GC) IRdb/control tower formatted message.
@@ -60,4 +63,76 @@ void IRsend::sendGC(uint16_t buf[], uint16_t len) {
   // It's possible that we've ended on a mark(), thus ensure the LED is off.
   ledOff();
 }
+
+/// Send a shortened GlobalCache (GC) IRdb/control tower formatted message,
+/// converting it from text as it is sent.
+/// Only the part of the message that repeats is kept in memory, and only if
+/// it is to be sent more than once.
+/// Status: BETA / Should produce the same output as the array version.
+/// @param[in,out] reader Where to read the GC values from.
+///   e.g. `irutils::ValueReader reader("38000,1,1,170,170,20,63,20,1798");`
+/// @return true, if the entire message was read & sent. false, if not.
+/// @note Each value is converted just before it is sent, so the reader needs
+///   to supply them promptly. e.g. From a string, or data already received.
+/// @note A repeat offset of 0 is treated as 1.
+/// @see `sendGC(uint16_t buf[], uint16_t len)` for the format.
+bool IRsend::sendGC(irutils::ValueReader *reader) {
+  uint16_t header[kGlobalCacheStartIndex];
+  for (uint8_t i = 0; i < kGlobalCacheStartIndex; i++)
+    if (!reader->next(&header[i])) return false;
+  const uint16_t hz = header[kGlobalCacheFreqIndex];  // GC freq is in Hz.
+  enableIROut(hz);
+  const uint32_t periodic_time = calcUSecPeriod(hz, false);
+  uint8_t emits = std::min(header[kGlobalCacheRptIndex],
+                           (uint16_t)kGlobalCacheMaxRepeat);
+  // Where the repeated part of the message starts.
+  const uint16_t repeat_from = kGlobalCacheStartIndex +
+      std::max(header[kGlobalCacheRptStartIndex], (uint16_t)1) - 1;
+  uint16_t *saved = NULL;  // A copy of the repeated part, if needed.
+  uint16_t saved_size = 0;
+  uint16_t nr_saved = 0;
+  uint16_t offset = kGlobalCacheStartIndex;
+  uint16_t value;
+  // Send the first copy, while reading it.
+  for (; emits && reader->next(&value); offset++) {
+    if (emits > 1 && offset >= repeat_from) {  // Save it for the repeats.
+      if (nr_saved == saved_size) {  // Out of room, so make some more.
+        uint16_t *bigger = new uint16_t[saved_size + kGlobalCacheBufferStep];
+        if (bigger != NULL && saved != NULL)
+          memcpy(bigger, saved, saved_size * sizeof(saved[0]));
+        delete[] saved;
+        saved = bigger;
+        saved_size += kGlobalCacheBufferStep;
+        if (saved == NULL) emits = 1;  // No memory, so don't repeat.
+      }
+      if (saved != NULL) saved[nr_saved++] = value;
+    }
+    // Convert periodic units to microseconds.
+    // Minimum is kGlobalCacheMinUsec for actual GC units.
+    uint32_t microseconds = std::max(value * periodic_time,
+                                     kGlobalCacheMinUsec);
+    // These codes start at an odd index (not even as with sendRaw).
+    if (offset & 1)  // Odd bit.
+      mark(microseconds);
+    else  // Even bit.
+      space(microseconds);
+  }
+  const bool success = !reader->failed();
+  // Send any repeats from the saved copy.
+  if (success && saved != NULL) {
+    for (uint8_t repeat = 1; repeat < emits; repeat++)
+      for (uint16_t i = 0; i < nr_saved; i++) {
+        uint32_t microseconds = std::max(saved[i] * periodic_time,
+                                         kGlobalCacheMinUsec);
+        if ((repeat_from + i) & 1)  // Odd bit.
+          mark(microseconds);
+        else  // Even bit.
+          space(microseconds);
+      }
+  }
+  delete[] saved;
+  // It's possible that we've ended on a mark(), thus ensure the LED is off.
+  ledOff();
+  return success;
+}
 #endif
@@ -43,7 +43,7 @@ void IRsend::sendGoodweather(const uint64_t data, const uint16_t nbits,
     // Data
     for (int16_t i = 0; i < nbits; i += 8) {
       uint16_t chunk = (data >> i) & 0xFF;  // Grab a byte at a time.
-      chunk = (~chunk) << 8 | chunk;  // Prepend a inverted copy of the byte.
+      chunk = (chunk ^ 0xFF) << 8 | chunk;  // Prepend an inverted copy.
       sendData(kGoodweatherBitMark, kGoodweatherOneSpace,
                kGoodweatherBitMark, kGoodweatherZeroSpace,
                chunk, 16, false);
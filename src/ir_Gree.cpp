@@ -38,6 +38,29 @@ using irutils::addFanToString;
 using irutils::addTempToString;
 using irutils::minsToString;
 
+using irutils::AcMapping;
+
+/// How the native modes map to the common ones.
+const AcMapping<stdAc::opmode_t> kGreeModeMap[] = {
+    {kGreeCool, stdAc::opmode_t::kCool},
+    {kGreeHeat, stdAc::opmode_t::kHeat},
+    {kGreeDry, stdAc::opmode_t::kDry},
+    {kGreeFan, stdAc::opmode_t::kFan}};
+/// How the native fan speeds map to the common ones.
+const AcMapping<stdAc::fanspeed_t> kGreeFanMap[] = {
+    {kGreeFanMin, stdAc::fanspeed_t::kMin},
+    {kGreeFanMax - 1, stdAc::fanspeed_t::kMedium},
+    {kGreeFanMax - 1, stdAc::fanspeed_t::kLow},
+    {kGreeFanMax, stdAc::fanspeed_t::kMax},
+    {kGreeFanMax, stdAc::fanspeed_t::kHigh}};
+/// How the native vertical swing positions map to the common ones.
+const AcMapping<stdAc::swingv_t> kGreeSwingVMap[] = {
+    {kGreeSwingUp, stdAc::swingv_t::kHighest},
+    {kGreeSwingMiddleUp, stdAc::swingv_t::kHigh},
+    {kGreeSwingMiddle, stdAc::swingv_t::kMiddle},
+    {kGreeSwingMiddleDown, stdAc::swingv_t::kLow},
+    {kGreeSwingDown, stdAc::swingv_t::kLowest}};
+
 #if SEND_GREE
 /// Send a Gree Heat Pump formatted message.
 /// Status: STABLE / Working.
@@ -237,24 +260,24 @@ bool IRGreeAC::getUseFahrenheit(void) const {
 /// @note The unit actually works in Celsius with a special optional
 ///   "extra degree" when sending Fahrenheit.
 void IRGreeAC::setTemp(const uint8_t temp, const bool fahrenheit) {
-  float safecelsius = temp;
+  int16_t tenths = temp * 10;  // Tenths of a degree Celsius.
   if (fahrenheit)
     // Covert to F, and add a fudge factor to round to the expected degree.
     // Why 0.6 you ask?! Because it works. Ya'd thing 0.5 would be good for
     // rounding, but Noooooo!
-    safecelsius = fahrenheitToCelsius(temp + 0.6);
+    tenths = fahrenheitToCelsiusTenths(temp * 10 + 6);
   setUseFahrenheit(fahrenheit);  // Set the correct Temp units.
 
   // Make sure we have desired temp in the correct range.
-  safecelsius = std::max(static_cast<float>(kGreeMinTempC), safecelsius);
-  safecelsius = std::min(static_cast<float>(kGreeMaxTempC), safecelsius);
+  tenths = std::max(static_cast<int16_t>(kGreeMinTempC * 10), tenths);
+  tenths = std::min(static_cast<int16_t>(kGreeMaxTempC * 10), tenths);
   // An operating mode of Auto locks the temp to a specific value. Do so.
-  if (_.Mode == kGreeAuto) safecelsius = 25;
+  if (_.Mode == kGreeAuto) tenths = 250;
 
   // Set the "main" Celsius degrees.
-  _.Temp = safecelsius - kGreeMinTempC;
-  // Deal with the extra degree fahrenheit difference.
-  _.TempExtraDegreeF = (static_cast<uint8_t>(safecelsius * 2) & 1);
+  _.Temp = tenths / 10 - kGreeMinTempC;
+  // Deal with the extra degree fahrenheit difference. i.e. The half degree.
+  _.TempExtraDegreeF = (tenths / 5) & 1;
 }
 
 /// Get the set temperature
@@ -262,7 +285,7 @@ void IRGreeAC::setTemp(const uint8_t temp, const bool fahrenheit) {
 uint8_t IRGreeAC::getTemp(void) const {
   uint8_t deg = kGreeMinTempC + _.Temp;
   if (_.UseFahrenheit) {
-    deg = celsiusToFahrenheit(deg);
+    deg = celsiusToFahrenheitTenths(deg * 10) / 10;
     // Retrieve the "extra" fahrenheit from elsewhere in the code.
     if (_.TempExtraDegreeF) deg++;
     deg = std::max(deg, kGreeMinTempF);  // Cover the fact that 61F is < 16C
@@ -486,80 +509,42 @@ uint8_t IRGreeAC::getDisplayTempSource(void) const {
 /// @param[in] mode The enum to be converted.
 /// @return The native equivalent of the enum.
 uint8_t IRGreeAC::convertMode(const stdAc::opmode_t mode) {
-  switch (mode) {
-    case stdAc::opmode_t::kCool: return kGreeCool;
-    case stdAc::opmode_t::kHeat: return kGreeHeat;
-    case stdAc::opmode_t::kDry:  return kGreeDry;
-    case stdAc::opmode_t::kFan:  return kGreeFan;
-    default:                     return kGreeAuto;
-  }
+  return irutils::toNative(kGreeModeMap, mode, kGreeAuto);
 }
 
 /// Convert a stdAc::fanspeed_t enum into it's native speed.
 /// @param[in] speed The enum to be converted.
 /// @return The native equivalent of the enum.
 uint8_t IRGreeAC::convertFan(const stdAc::fanspeed_t speed) {
-  switch (speed) {
-    case stdAc::fanspeed_t::kMin:    return kGreeFanMin;
-    case stdAc::fanspeed_t::kLow:
-    case stdAc::fanspeed_t::kMedium: return kGreeFanMax - 1;
-    case stdAc::fanspeed_t::kHigh:
-    case stdAc::fanspeed_t::kMax:    return kGreeFanMax;
-    default:                         return kGreeFanAuto;
-  }
+  return irutils::toNative(kGreeFanMap, speed, kGreeFanAuto);
 }
 
 /// Convert a stdAc::swingv_t enum into it's native setting.
 /// @param[in] swingv The enum to be converted.
 /// @return The native equivalent of the enum.
 uint8_t IRGreeAC::convertSwingV(const stdAc::swingv_t swingv) {
-  switch (swingv) {
-    case stdAc::swingv_t::kHighest: return kGreeSwingUp;
-    case stdAc::swingv_t::kHigh:    return kGreeSwingMiddleUp;
-    case stdAc::swingv_t::kMiddle:  return kGreeSwingMiddle;
-    case stdAc::swingv_t::kLow:     return kGreeSwingMiddleDown;
-    case stdAc::swingv_t::kLowest:  return kGreeSwingDown;
-    default:                        return kGreeSwingAuto;
-  }
+  return irutils::toNative(kGreeSwingVMap, swingv, kGreeSwingAuto);
 }
 
 /// Convert a native mode into its stdAc equivalent.
 /// @param[in] mode The native setting to be converted.
 /// @return The stdAc equivalent of the native setting.
 stdAc::opmode_t IRGreeAC::toCommonMode(const uint8_t mode) {
-  switch (mode) {
-    case kGreeCool: return stdAc::opmode_t::kCool;
-    case kGreeHeat: return stdAc::opmode_t::kHeat;
-    case kGreeDry: return stdAc::opmode_t::kDry;
-    case kGreeFan: return stdAc::opmode_t::kFan;
-    default: return stdAc::opmode_t::kAuto;
-  }
+  return irutils::toCommon(kGreeModeMap, mode, stdAc::opmode_t::kAuto);
 }
 
 /// Convert a native fan speed into its stdAc equivalent.
 /// @param[in] speed The native setting to be converted.
 /// @return The stdAc equivalent of the native setting.
 stdAc::fanspeed_t IRGreeAC::toCommonFanSpeed(const uint8_t speed) {
-  switch (speed) {
-    case kGreeFanMax: return stdAc::fanspeed_t::kMax;
-    case kGreeFanMax - 1: return stdAc::fanspeed_t::kMedium;
-    case kGreeFanMin: return stdAc::fanspeed_t::kMin;
-    default: return stdAc::fanspeed_t::kAuto;
-  }
+  return irutils::toCommon(kGreeFanMap, speed, stdAc::fanspeed_t::kAuto);
 }
 
 /// Convert a native Vertical Swing into its stdAc equivalent.
 /// @param[in] pos The native setting to be converted.
 /// @return The stdAc equivalent of the native setting.
 stdAc::swingv_t IRGreeAC::toCommonSwingV(const uint8_t pos) {
-  switch (pos) {
-    case kGreeSwingUp: return stdAc::swingv_t::kHighest;
-    case kGreeSwingMiddleUp: return stdAc::swingv_t::kHigh;
-    case kGreeSwingMiddle: return stdAc::swingv_t::kMiddle;
-    case kGreeSwingMiddleDown: return stdAc::swingv_t::kLow;
-    case kGreeSwingDown: return stdAc::swingv_t::kLowest;
-    default: return stdAc::swingv_t::kAuto;
-  }
+  return irutils::toCommon(kGreeSwingVMap, pos, stdAc::swingv_t::kAuto);
 }
 
 /// Convert the current internal state into its stdAc::state_t equivalent.
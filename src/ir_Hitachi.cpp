@@ -55,6 +55,7 @@ using irutils::addTempToString;
 using irutils::checkInvertedBytePairs;
 using irutils::invertBytePairs;
 using irutils::minsToString;
+using irutils::reverseByte;
 
 #if (SEND_HITACHI_AC || SEND_HITACHI_AC2 || SEND_HITACHI_AC344)
 /// Send a Hitachi 28-byte/224-bit A/C formatted message. (HITACHI_AC)
@@ -163,8 +164,8 @@ void IRHitachiAc::begin(void) { _irsend.begin(); }
 uint8_t IRHitachiAc::calcChecksum(const uint8_t state[],
                                   const uint16_t length) {
   uint8_t sum = 62;
-  for (uint16_t i = 0; i < length - 1; i++) sum -= reverseBits(state[i], 8);
-  return reverseBits(sum, 8);
+  for (uint16_t i = 0; i < length - 1; i++) sum -= reverseByte(state[i]);
+  return reverseByte(sum);
 }
 
 /// Calculate and set the checksum values for the internal state.
@@ -446,13 +447,13 @@ void IRHitachiAc1::begin(void) { _irsend.begin(); }
 uint8_t IRHitachiAc1::calcChecksum(const uint8_t state[],
                                    const uint16_t length) {
   uint8_t sum = 0;
+  // Reversing the byte also reverses each of its nibbles.
   for (uint16_t i = kHitachiAc1ChecksumStartByte; i < length - 1; i++) {
-    sum += reverseBits(GETBITS8(state[i], kLowNibble, kNibbleSize),
-                       kNibbleSize);
-    sum += reverseBits(GETBITS8(state[i], kHighNibble, kNibbleSize),
-                       kNibbleSize);
+    const uint8_t reversed = reverseByte(state[i]);
+    sum += GETBITS8(reversed, kLowNibble, kNibbleSize) +
+        GETBITS8(reversed, kHighNibble, kNibbleSize);
   }
-  return reverseBits(sum, 8);
+  return reverseByte(sum);
 }
 
 /// Calculate and set the checksum values for the internal state.
@@ -837,16 +838,16 @@ String IRHitachiAc1::toString(void) const {
 ///   Typically kHitachiAcBits, kHitachiAc1Bits, kHitachiAc2Bits,
 ///   kHitachiAc344Bits
 /// @param[in] strict Flag indicating if we should perform strict matching.
-/// @param[in] MSBfirst Is the data per byte stored in MSB First (true) or
-///   LSB First order(false)?
 /// @return True if it can decode it, false if it can't.
+/// @note The data per byte is in MSB First order, except for kHitachiAc344Bits
+///   which is LSB First.
 /// @see https://github.com/crankyoldgit/IRremoteESP8266/issues/417
 /// @see https://github.com/crankyoldgit/IRremoteESP8266/issues/453
 /// @see https://github.com/crankyoldgit/IRremoteESP8266/issues/1134
 bool IRrecv::decodeHitachiAC(decode_results *results, uint16_t offset,
-                             const uint16_t nbits, const bool strict,
-                             const bool MSBfirst) {
+                             const uint16_t nbits, const bool strict) {
   const uint8_t k_tolerance = _tolerance + 5;
+  const bool MSBfirst = nbits != kHitachiAc344Bits;
 
   if (strict) {
     switch (nbits) {
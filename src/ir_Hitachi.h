@@ -30,6 +30,7 @@
 #endif
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
+#include "IRutils.h"
 #ifdef UNIT_TEST
 #include "IRsend_test.h"
 #endif
@@ -37,33 +38,13 @@
 /// Native representation of a Hitachi 224-bit A/C message.
 union HitachiProtocol{
   uint8_t raw[kHitachiAcStateLength];  ///< The state in native code.
-  struct {
-    // Byte 0~9
-    uint8_t pad0[10];
-    // Byte 10
-    uint8_t Mode  :8;
-    // Byte 11
-    uint8_t Temp  :8;
-    // Byte 12
-    uint8_t       :8;
-    // Byte 13
-    uint8_t Fan   :8;
-    // Byte 14
-    uint8_t         :7;
-    uint8_t SwingV  :1;
-    // Byte 15
-    uint8_t         :7;
-    uint8_t SwingH  :1;
-    // Byte 16
-    uint8_t       :8;
-    // Byte 17
-    uint8_t Power :1;
-    uint8_t       :7;
-    // Byte 18~26
-    uint8_t pad1[9];
-    // Byte 27
-    uint8_t Sum   :8;
-  };
+  irutils::BitField<10, 0, 8> Mode;
+  irutils::BitField<11, 0, 8> Temp;
+  irutils::BitField<13, 0, 8> Fan;
+  irutils::BitField<14, 7, 1> SwingV;
+  irutils::BitField<15, 7, 1> SwingH;
+  irutils::BitField<17, 0, 1> Power;
+  irutils::BitField<27, 0, 8> Sum;
 };
 
 // Constants
@@ -84,37 +65,13 @@ const uint8_t kHitachiAcAutoTemp = 23;  // 23C
 /// Native representation of a Hitachi 53-byte/424-bit A/C message.
 union Hitachi424Protocol{
   uint8_t raw[kHitachiAc424StateLength];  ///< The state in native code
-  struct {
-    // Byte 0~10
-    uint8_t pad0[11];
-    // Byte 11
-    uint8_t Button  :8;
-    // Byte 12
-    uint8_t       :8;
-    // Byte 13
-    uint8_t       :2;
-    uint8_t Temp  :6;
-    // Byte 14~24
-    uint8_t pad1[11];
-    // Byte 25
-    uint8_t Mode  :4;
-    uint8_t Fan   :4;
-    // Byte 26
-    uint8_t       :8;
-    // Byte 27
-    uint8_t Power :8;
-    // Byte 28~34
-    uint8_t pad2[7];
-    // Byte 35
-    uint8_t SwingH  :3;
-    uint8_t         :5;
-    // Byte 36
-    uint8_t         :8;
-    // Byte 37
-    uint8_t         :5;
-    uint8_t SwingV  :1;
-    uint8_t         :2;
-  };
+  irutils::BitField<11, 0, 8> Button;
+  irutils::BitField<13, 2, 6> Temp;
+  irutils::BitField<25, 0, 4> Mode;
+  irutils::BitField<25, 4, 4> Fan;
+  irutils::BitField<27, 0, 8> Power;
+  irutils::BitField<35, 0, 3> SwingH;
+  irutils::BitField<37, 5, 1> SwingV;
 };
 
 // HitachiAc424 & HitachiAc344
@@ -174,39 +131,21 @@ const uint8_t kHitachiAc344SwingHLeftMax = 5;           // 0b101
 /// Native representation of a Hitachi 104-bit A/C message.
 union Hitachi1Protocol{
   uint8_t raw[kHitachiAc1StateLength];  ///< The state in native code.
-  struct {
-    // Byte 0~2
-    uint8_t pad[3];
-    // Byte 3
-    uint8_t        :6;
-    uint8_t Model  :2;
-    // Byte 4
-    uint8_t        :8;
-    // Byte 5
-    uint8_t Fan    :4;
-    uint8_t Mode   :4;
-    // Byte 6
-    uint8_t        :2;
-    uint8_t Temp   :5;  // stored in LSB order.
-    uint8_t        :1;
-    // Byte 7
-    uint8_t OffTimerLow :8;  // nr. of minutes
-    // Byte 8
-    uint8_t OffTimerHigh :8;  // & in LSB order.
-    // Byte 9
-    uint8_t OnTimerLow :8;  // nr. of minutes
-    // Byte 10
-    uint8_t OnTimerHigh :8;  // & in LSB order.
-    // Byte 11
-    uint8_t SwingToggle  :1;
-    uint8_t Sleep        :3;
-    uint8_t PowerToggle  :1;
-    uint8_t Power        :1;
-    uint8_t SwingV       :1;
-    uint8_t SwingH       :1;
-    // Byte 12
-    uint8_t Sum :8;
-  };
+  irutils::BitField<3, 6, 2> Model;
+  irutils::BitField<5, 0, 4> Fan;
+  irutils::BitField<5, 4, 4> Mode;
+  irutils::BitField<6, 2, 5> Temp;  // stored in LSB order.
+  irutils::BitField<7, 0, 8> OffTimerLow;  // nr. of minutes
+  irutils::BitField<8, 0, 8> OffTimerHigh;  // & in LSB order.
+  irutils::BitField<9, 0, 8> OnTimerLow;  // nr. of minutes
+  irutils::BitField<10, 0, 8> OnTimerHigh;  // & in LSB order.
+  irutils::BitField<11, 0, 1> SwingToggle;
+  irutils::BitField<11, 1, 3> Sleep;
+  irutils::BitField<11, 4, 1> PowerToggle;
+  irutils::BitField<11, 5, 1> Power;
+  irutils::BitField<11, 6, 1> SwingV;
+  irutils::BitField<11, 7, 1> SwingH;
+  irutils::BitField<12, 0, 8> Sum;
 };
 // HitachiAc1
 // Model
@@ -238,6 +177,10 @@ const uint8_t kHitachiAc1Sleep3 =                            0b011;
 const uint8_t kHitachiAc1Sleep4 =                            0b100;
 // Checksum
 const uint8_t kHitachiAc1ChecksumStartByte = 5;
+/// Settings a HitachiAc344 message toggles, rather than sets.
+const uint8_t kHitachiAc344Toggles = stdAc::kToggleSwingV;
+/// Settings a HitachiAc424 message toggles, rather than sets.
+const uint8_t kHitachiAc424Toggles = stdAc::kToggleSwingV;
 
 
 // Classes
@@ -65,6 +65,8 @@ const int8_t kKelonDryGradeMin = -2;
 const int8_t kKelonDryGradeMax = +2;
 const uint8_t kKelonMinTemp = 18;
 const uint8_t kKelonMaxTemp = 32;
+/// Settings a Kelon message toggles, rather than sets.
+const uint8_t kKelonToggles = stdAc::kTogglePower | stdAc::kToggleSwingV;
 
 
 class IRKelonAc {
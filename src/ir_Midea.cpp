@@ -43,6 +43,7 @@ using irutils::addLabeledString;
 using irutils::addModeToString;
 using irutils::addTempToString;
 using irutils::minsToString;
+using irutils::reverseByte;
 
 #if SEND_MIDEA
 /// Send a Midea message
@@ -195,9 +196,11 @@ void IRMideaAC::setTemp(const uint8_t temp, const bool useCelsius) {
   }
   uint8_t new_temp = std::min(max_temp, std::max(min_temp, temp));
   if (!_.useFahrenheit && !useCelsius)  // Native is in C, new_temp is in F
-    new_temp = fahrenheitToCelsius(new_temp) - kMideaACMinTempC;
+    new_temp = (fahrenheitToCelsiusTenths(new_temp * 10) -
+                kMideaACMinTempC * 10) / 10;
   else if (_.useFahrenheit && useCelsius)  // Native is in F, new_temp is in C
-    new_temp = celsiusToFahrenheit(new_temp) - kMideaACMinTempF;
+    new_temp = (celsiusToFahrenheitTenths(new_temp * 10) -
+                kMideaACMinTempF * 10) / 10;
   else  // Native and desired are the same units.
     new_temp -= min_temp;
   // Set the actual data.
@@ -213,8 +216,10 @@ uint8_t IRMideaAC::getTemp(const bool celsius) const {
     temp += kMideaACMinTempC;
   else
     temp += kMideaACMinTempF;
-  if (celsius && _.useFahrenheit) temp = fahrenheitToCelsius(temp) + 0.5;
-  if (!celsius && !_.useFahrenheit) temp = celsiusToFahrenheit(temp);
+  if (celsius && _.useFahrenheit)  // Rounded to the nearest degree.
+    temp = (fahrenheitToCelsiusTenths(temp * 10) + 5) / 10;
+  if (!celsius && !_.useFahrenheit)
+    temp = celsiusToFahrenheitTenths(temp * 10) / 10;
   return temp;
 }
 
@@ -231,9 +236,11 @@ void IRMideaAC::setSensorTemp(const uint8_t temp, const bool useCelsius) {
   }
   uint8_t new_temp = std::min(max_temp, std::max(min_temp, temp));
   if (!_.useFahrenheit && !useCelsius)  // Native is in C, new_temp is in F
-    new_temp = fahrenheitToCelsius(new_temp) - kMideaACMinSensorTempC;
+    new_temp = (fahrenheitToCelsiusTenths(new_temp * 10) -
+                kMideaACMinSensorTempC * 10) / 10;
   else if (_.useFahrenheit && useCelsius)  // Native is in F, new_temp is in C
-    new_temp = celsiusToFahrenheit(new_temp) - kMideaACMinSensorTempF;
+    new_temp = (celsiusToFahrenheitTenths(new_temp * 10) -
+                kMideaACMinSensorTempF * 10) / 10;
   else  // Native and desired are the same units.
     new_temp -= min_temp;
   // Set the actual data.
@@ -251,8 +258,10 @@ uint8_t IRMideaAC::getSensorTemp(const bool celsius) const {
     temp += kMideaACMinSensorTempC;
   else
     temp += kMideaACMinSensorTempF;
-  if (celsius && _.useFahrenheit) temp = fahrenheitToCelsius(temp) + 0.5;
-  if (!celsius && !_.useFahrenheit) temp = celsiusToFahrenheit(temp);
+  if (celsius && _.useFahrenheit)  // Rounded to the nearest degree.
+    temp = (fahrenheitToCelsiusTenths(temp * 10) + 5) / 10;
+  if (!celsius && !_.useFahrenheit)
+    temp = celsiusToFahrenheitTenths(temp * 10) / 10;
   return temp;
 }
 
@@ -419,10 +428,10 @@ uint8_t IRMideaAC::calcChecksum(const uint64_t state) {
 
   for (uint8_t i = 0; i < 5; i++) {
     temp_state >>= 8;
-    sum += reverseBits((temp_state & 0xFF), 8);
+    sum += reverseByte(temp_state & 0xFF);
   }
   sum = 256 - sum;
-  return reverseBits(sum, 8);
+  return reverseByte(sum);
 }
 
 /// Verify the checksum is valid for a given state.
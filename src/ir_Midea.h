@@ -127,6 +127,9 @@ const uint64_t kMideaACToggleTurbo = 0xA209FFFFFF74;
 const uint8_t kMideaACTypeCommand = 0b001;  ///< Message type
 const uint8_t kMideaACTypeSpecial = 0b010;  ///< Message type
 const uint8_t kMideaACTypeFollow =  0b100;  ///< Message type
+/// Settings a Midea message toggles. (They are separate commands.)
+const uint8_t kMideaToggles = stdAc::kToggleSwingV | stdAc::kToggleTurbo |
+                              stdAc::kToggleEcono | stdAc::kToggleLight;
 
 // Legacy defines. (Deprecated)
 #define MIDEA_AC_COOL kMideaACCool
@@ -44,6 +44,7 @@
 #endif
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
+#include "IRutils.h"
 #ifdef UNIT_TEST
 #include "IRsend_test.h"
 #endif
@@ -51,44 +52,21 @@
 /// Native representation of a Mitsubishi 144-bit A/C message.
 union Mitsubishi144Protocol{
   uint8_t raw[kMitsubishiACStateLength];  ///< The state in code form.
-  struct {
-    // Byte 0~4
-    uint8_t pad0[5];
-    // Byte 5
-    uint8_t       :5;
-    uint8_t Power :1;
-    uint8_t       :2;
-    // Byte 6
-    uint8_t       :3;
-    uint8_t Mode  :3;
-    uint8_t       :2;
-    // Byte 7
-    uint8_t Temp       :4;
-    uint8_t HalfDegree :1;
-    uint8_t            :3;
-    // Byte 8
-    uint8_t         :4;
-    uint8_t WideVane:4;  // SwingH
-    // Byte 9
-    uint8_t Fan     :3;
-    uint8_t Vane    :3;  // SwingV
-    uint8_t VaneBit :1;
-    uint8_t FanAuto :1;
-    // Byte 10
-    uint8_t Clock   :8;
-    // Byte 11
-    uint8_t StopClock :8;
-    // Byte 12
-    uint8_t StartClock:8;
-    // Byte 13
-    uint8_t Timer       :3;
-    uint8_t WeeklyTimer :1;
-    uint8_t             :4;
-    // Byte 14~16
-    uint8_t pad1[3];
-    // Byte 17
-    uint8_t Sum   :8;
-  };
+  irutils::BitField<5, 5, 1> Power;
+  irutils::BitField<6, 3, 3> Mode;
+  irutils::BitField<7, 0, 4> Temp;
+  irutils::BitField<7, 4, 1> HalfDegree;
+  irutils::BitField<8, 4, 4> WideVane;  // SwingH
+  irutils::BitField<9, 0, 3> Fan;
+  irutils::BitField<9, 3, 3> Vane;  // SwingV
+  irutils::BitField<9, 6, 1> VaneBit;
+  irutils::BitField<9, 7, 1> FanAuto;
+  irutils::BitField<10, 0, 8> Clock;
+  irutils::BitField<11, 0, 8> StopClock;
+  irutils::BitField<12, 0, 8> StartClock;
+  irutils::BitField<13, 0, 3> Timer;
+  irutils::BitField<13, 3, 1> WeeklyTimer;
+  irutils::BitField<17, 0, 8> Sum;
 };
 
 // Constants
@@ -127,23 +105,11 @@ const uint8_t kMitsubishiAcStartStopTimer = 7;
 /// Native representation of a Mitsubishi 136-bit A/C message.
 union Mitsubishi136Protocol{
   uint8_t raw[kMitsubishi136StateLength];  ///< The state in code form.
-  struct {
-    // Byte 0~4
-    uint8_t pad[5];
-    // Byte 5
-    uint8_t       :6;
-    uint8_t Power :1;
-    uint8_t       :1;
-    // Byte 6
-    uint8_t Mode  :3;
-    uint8_t       :1;
-    uint8_t Temp  :4;
-    // Byte 7
-    uint8_t         :1;
-    uint8_t Fan     :2;
-    uint8_t         :1;
-    uint8_t SwingV  :4;
-  };
+  irutils::BitField<5, 6, 1> Power;
+  irutils::BitField<6, 0, 3> Mode;
+  irutils::BitField<6, 4, 4> Temp;
+  irutils::BitField<7, 1, 2> Fan;
+  irutils::BitField<7, 4, 4> SwingV;
 };
 
 const uint8_t kMitsubishi136PowerByte = 5;
@@ -168,32 +134,13 @@ const uint8_t kMitsubishi136FanQuiet = kMitsubishi136FanMin;
 /// Native representation of a Mitsubishi 112-bit A/C message.
 union Mitsubishi112Protocol{
   uint8_t raw[kMitsubishi112StateLength];  ///< The state in code form.
-  struct {
-    // Byte 0~4
-    uint8_t pad0[5];
-    // Byte 5
-    uint8_t       :2;
-    uint8_t Power :1;
-    uint8_t       :5;
-    // Byte 6
-    uint8_t Mode  :3;
-    uint8_t       :5;
-    // Byte 7
-    uint8_t Temp  :4;
-    uint8_t       :4;
-    // Byte 8
-    uint8_t Fan     :3;
-    uint8_t SwingV  :3;
-    uint8_t         :2;
-    // Byte 9~11
-    uint8_t pad1[3];
-    // Byte 12
-    uint8_t         :2;
-    uint8_t SwingH  :4;
-    uint8_t         :2;
-    // Byte 13
-    uint8_t Sum :8;
-  };
+  irutils::BitField<5, 2, 1> Power;
+  irutils::BitField<6, 0, 3> Mode;
+  irutils::BitField<7, 0, 4> Temp;
+  irutils::BitField<8, 0, 3> Fan;
+  irutils::BitField<8, 3, 3> SwingV;
+  irutils::BitField<12, 2, 4> SwingH;
+  irutils::BitField<13, 0, 8> Sum;
 };
 
 const uint8_t kMitsubishi112Cool =                        0b011;
@@ -25,6 +25,7 @@
 #endif
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
+#include "IRutils.h"
 #ifdef UNIT_TEST
 #include "IRsend_test.h"
 #endif
@@ -32,46 +33,18 @@
 /// Native representation of a Mitsubishi Heavy 152-bit A/C message.
 union Mitsubishi152Protocol{
   uint8_t raw[kMitsubishiHeavy152StateLength];  ///< State in code form
-  struct {
-    // Byte 0~4
-    uint8_t Sig[5];
-    // Byte 5
-    uint8_t Mode  :3;
-    uint8_t Power :1;
-    uint8_t       :1;
-    uint8_t Clean :1;
-    uint8_t Filter:1;
-    uint8_t       :1;
-    // Byte 6
-    uint8_t       :8;
-    // Byte 7
-    uint8_t Temp  :4;
-    uint8_t       :4;
-    // Byte 8
-    uint8_t       :8;
-    // Byte 9
-    uint8_t Fan   :4;
-    uint8_t       :4;
-    // Byte 10
-    uint8_t       :8;
-    // Byte 11
-    uint8_t         :1;
-    uint8_t Three   :1;
-    uint8_t         :2;
-    uint8_t D       :1;  // binding with "Three"
-    uint8_t SwingV  :3;
-    // Byte 12
-    uint8_t         :8;
-    // Byte 13
-    uint8_t SwingH  :4;
-    uint8_t         :4;
-    // Byte 14
-    uint8_t         :8;
-    // Byte 15
-    uint8_t         :6;
-    uint8_t Night   :1;
-    uint8_t Silent  :1;
-  };
+  irutils::BitField<5, 0, 3> Mode;
+  irutils::BitField<5, 3, 1> Power;
+  irutils::BitField<5, 5, 1> Clean;
+  irutils::BitField<5, 6, 1> Filter;
+  irutils::BitField<7, 0, 4> Temp;
+  irutils::BitField<9, 0, 4> Fan;
+  irutils::BitField<11, 1, 1> Three;
+  irutils::BitField<11, 4, 1> D;  // binding with "Three"
+  irutils::BitField<11, 5, 3> SwingV;
+  irutils::BitField<13, 0, 4> SwingH;
+  irutils::BitField<15, 6, 1> Night;
+  irutils::BitField<15, 7, 1> Silent;
 };
 
 // Constants.
@@ -119,29 +92,15 @@ const uint8_t kMitsubishiHeavy152SwingHOff =       8;  // 0b1000
 /// Native representation of a Mitsubishi Heavy 88-bit A/C message.
 union Mitsubishi88Protocol{
   uint8_t raw[kMitsubishiHeavy88StateLength];  ///< State in code form
-  struct {
-    // Byte 0~4
-    uint8_t Sig[5];
-    // Byte 5
-    uint8_t         :1;
-    uint8_t SwingV5 :1;
-    uint8_t SwingH1 :2;
-    uint8_t         :1;
-    uint8_t Clean   :1;
-    uint8_t SwingH2 :2;
-    // Byte 6
-    uint8_t         :8;
-    // Byte 7
-    uint8_t         :3;
-    uint8_t SwingV7 :2;
-    uint8_t Fan     :3;
-    // Byte 8
-    uint8_t       :8;
-    // Byte 9
-    uint8_t Mode  :3;
-    uint8_t Power :1;
-    uint8_t Temp  :4;
-  };
+  irutils::BitField<5, 1, 1> SwingV5;
+  irutils::BitField<5, 2, 2> SwingH1;
+  irutils::BitField<5, 5, 1> Clean;
+  irutils::BitField<5, 6, 2> SwingH2;
+  irutils::BitField<7, 3, 2> SwingV7;
+  irutils::BitField<7, 5, 3> Fan;
+  irutils::BitField<9, 0, 3> Mode;
+  irutils::BitField<9, 3, 1> Power;
+  irutils::BitField<9, 4, 4> Temp;
 };
 
 // ZJS (88 bit)
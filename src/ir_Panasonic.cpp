@@ -162,6 +162,23 @@ bool IRrecv::decodePanasonic(decode_results *results, uint16_t offset,
 }
 #endif  // (DECODE_PANASONIC || DECODE_DENON)
 
+#if DECODE_PANASONIC
+/// Decode the supplied Panasonic message, as sent by `sendPanasonic64()`.
+/// Status: STABLE / Should be working.
+/// @param[in,out] results Ptr to the data to decode & where to store the result
+/// @param[in] offset The starting index to use when attempting to decode the
+///   raw data. Typically/Defaults to kStartOffset.
+/// @param[in] nbits The number of data bits to expect.
+/// @param[in] strict Flag indicating if we should perform strict matching.
+/// @return True if it can decode it, false if it can't.
+/// @note The same as `decodePanasonic()` with the Panasonic manufacturer code.
+bool IRrecv::decodePanasonic64(decode_results *results, uint16_t offset,
+                               const uint16_t nbits, const bool strict) {
+  return decodePanasonic(results, offset, nbits, strict,
+                         kPanasonicManufacturer);
+}
+#endif  // DECODE_PANASONIC
+
 #if SEND_PANASONIC_AC
 /// Send a Panasonic A/C message.
 /// Status: STABLE / Work with real device(s).
@@ -99,6 +99,10 @@ const uint8_t kPanasonicKnownGoodState[kPanasonicAcStateLength] = {
     0x02, 0x20, 0xE0, 0x04, 0x00, 0x00, 0x00, 0x06, 0x02,
     0x20, 0xE0, 0x04, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00,
     0x00, 0x0E, 0xE0, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00};
+/// Settings a PanasonicAc32 message toggles, rather than sets.
+const uint8_t kPanasonicAc32Toggles = stdAc::kTogglePower;
+/// Settings a Panasonic CKP model message toggles, rather than sets.
+const uint8_t kPanasonicAcCkpToggles = stdAc::kTogglePower;
 
 /// Class for handling detailed Panasonic A/C messages.
 class IRPanasonicAc {
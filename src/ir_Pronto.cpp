@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include "IRsend.h"
+#include "IRutils.h"
 
 // Constants
 const float kProntoFreqFactor = 0.241246;
@@ -104,4 +105,75 @@ void IRsend::sendPronto(uint16_t data[], uint16_t len, uint16_t repeat) {
       }
   }
 }
+
+/// Send a Pronto Code formatted message, converting it from text as it is
+/// sent.
+/// Only the 2nd (repeat) sequence is kept in memory, and only if it is to be
+/// sent more than once.
+/// Status: BETA / Should produce the same output as the array version.
+/// @param[in,out] reader Where to read the Pronto words from.
+///   It should be in base 16. e.g.
+///   `irutils::ValueReader reader("0000 0067 0000 0015 0060 0018 ...", 16);`
+/// @param[in] repeat Nr. of times to repeat the message.
+/// @return true, if the entire message was read & sent. false, if not.
+/// @note Each word is converted just before it is sent, so the reader needs
+///   to supply them promptly. e.g. From a string, or data already received.
+/// @note Unlike the array version, a message that turns out to be too short
+///   has already been partly sent.
+/// @see `sendPronto(uint16_t data[], uint16_t len, uint16_t repeat)`
+bool IRsend::sendPronto(irutils::ValueReader *reader, uint16_t repeat) {
+  uint16_t header[kProntoDataOffset];
+  for (uint16_t i = 0; i < kProntoDataOffset; i++)
+    if (!reader->next(&header[i])) return false;
+
+  // We only know how to deal with 'raw' pronto codes types. Reject all others.
+  if (header[kProntoTypeOffset] != 0) return false;
+  // We need something to send.
+  if (header[kProntoSeq1LenOffset] + header[kProntoSeq2LenOffset] == 0)
+    return false;
+
+  // Pronto frequency is in Hz.
+  uint16_t hz =
+      (uint16_t)(1000000U / (header[kProntoFreqOffset] * kProntoFreqFactor));
+  enableIROut(hz);
+  uint32_t periodic_time_x10 = calcUSecPeriod(hz / 10, false);
+
+  // Grab the length of the two sequences.
+  uint16_t seq_1_len = header[kProntoSeq1LenOffset] * 2;
+  uint16_t seq_2_len = header[kProntoSeq2LenOffset] * 2;
+  // There was no first sequence to send, it is implied that we have to send
+  // the 2nd/repeat sequence an additional time. i.e. At least once.
+  if (seq_1_len == 0) repeat++;
+
+  // Only keep a copy of the 2nd sequence if we need to send it again.
+  uint16_t *saved = NULL;
+  if (repeat > 1 && seq_2_len > 0) saved = new uint16_t[seq_2_len];
+  if (saved == NULL && repeat > 1) repeat = 1;  // No memory, so send it once.
+
+  // Send each sequence as it is read.
+  uint16_t value;
+  for (uint16_t i = 0; i < seq_1_len + (repeat ? seq_2_len : 0); i++) {
+    if (!reader->next(&value)) {  // Ran out of data.
+      delete[] saved;
+      ledOff();
+      return false;
+    }
+    if (saved != NULL && i >= seq_1_len) saved[i - seq_1_len] = value;
+    if (i & 1)  // Odd bit.
+      space((value * periodic_time_x10) / 10);
+    else  // Even bit.
+      mark((value * periodic_time_x10) / 10);
+  }
+
+  // Send the rest of the repeats from the saved copy of the 2nd sequence.
+  if (saved != NULL) {
+    for (uint16_t r = 1; r < repeat; r++)
+      for (uint16_t i = 0; i < seq_2_len; i += 2) {
+        mark((saved[i] * periodic_time_x10) / 10);
+        space((saved[i + 1] * periodic_time_x10) / 10);
+      }
+    delete[] saved;
+  }
+  return true;
+}
 #endif  // SEND_PRONTO
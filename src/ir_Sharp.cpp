@@ -215,6 +215,22 @@ bool IRrecv::decodeSharp(decode_results *results, uint16_t offset,
 }
 #endif  // (DECODE_SHARP || DECODE_DENON)
 
+#if DECODE_SHARP
+/// Decode the supplied Sharp message, as sent by `sendSharpRaw()`.
+/// Status: STABLE / Working fine.
+/// @param[in,out] results Ptr to the data to decode & where to store the result
+/// @param[in] offset The starting index to use when attempting to decode the
+///   raw data. Typically/Defaults to kStartOffset.
+/// @param[in] nbits The number of data bits to expect.
+/// @param[in] strict Flag indicating if we should perform strict matching.
+/// @return True if it can decode it, false if it can't.
+/// @note The same as `decodeSharp()`, expecting the expansion bit to be set.
+bool IRrecv::decodeSharpRaw(decode_results *results, uint16_t offset,
+                            const uint16_t nbits, const bool strict) {
+  return decodeSharp(results, offset, nbits, strict, true);
+}
+#endif  // DECODE_SHARP
+
 #if SEND_SHARP_AC
 /// Send a Sharp A/C message.
 /// Status: Alpha / Untested.
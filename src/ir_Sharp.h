@@ -131,6 +131,8 @@ const uint8_t kSharpAcSpecialFan =                0x05;
 const uint8_t kSharpAcSpecialSwing =              0x06;
 const uint8_t kSharpAcSpecialTimer =              0xC0;
 const uint8_t kSharpAcSpecialTimerHalfHour =      0xDE;
+/// Settings a Sharp A/C message toggles, rather than sets.
+const uint8_t kSharpAcToggles = stdAc::kToggleSwingV | stdAc::kToggleLight;
 
 // Classes
 /// Class for handling detailed Sharp A/C messages.
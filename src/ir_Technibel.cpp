@@ -105,11 +105,10 @@ void IRTechnibelAc::send(const uint16_t repeat) {
 /// @param[in] state A valid code for this protocol.
 /// @return The calculated checksum of the supplied state.
 uint8_t IRTechnibelAc::calcChecksum(const uint64_t state) {
-  uint8_t sum = 0;
   // Add up all the 8 bit data chunks.
-  for (uint8_t offset = kTechnibelAcTimerHoursOffset;
-        offset < kTechnibelAcHeaderOffset; offset += 8)
-    sum += GETBITS64(state, offset, 8);
+  const uint8_t sum = sumBytes(
+      state >> kTechnibelAcTimerHoursOffset,
+      (kTechnibelAcHeaderOffset - kTechnibelAcTimerHoursOffset) / 8);
   return ~sum + 1;
 }
 
@@ -41,6 +41,23 @@ using irutils::addTempToString;
 using irutils::checkInvertedBytePairs;
 using irutils::invertBytePairs;
 
+using irutils::AcMapping;
+
+/// How the native modes map to the common ones.
+const AcMapping<stdAc::opmode_t> kToshibaAcModeMap[] = {
+    {kToshibaAcCool, stdAc::opmode_t::kCool},
+    {kToshibaAcHeat, stdAc::opmode_t::kHeat},
+    {kToshibaAcDry, stdAc::opmode_t::kDry},
+    {kToshibaAcFan, stdAc::opmode_t::kFan},
+    {kToshibaAcOff, stdAc::opmode_t::kOff}};
+/// How the native fan speeds map to the common ones.
+const AcMapping<stdAc::fanspeed_t> kToshibaAcFanMap[] = {
+    {kToshibaAcFanMax - 4, stdAc::fanspeed_t::kMin},
+    {kToshibaAcFanMax - 3, stdAc::fanspeed_t::kLow},
+    {kToshibaAcFanMax - 2, stdAc::fanspeed_t::kMedium},
+    {kToshibaAcFanMax - 1, stdAc::fanspeed_t::kHigh},
+    {kToshibaAcFanMax, stdAc::fanspeed_t::kMax}};
+
 #if SEND_TOSHIBA_AC
 /// Send a Toshiba A/C message.
 /// Status: STABLE / Working.
@@ -343,56 +360,28 @@ void IRToshibaAC::setEcono(const bool on) {
 /// @param[in] mode The enum to be converted.
 /// @return The native equivalent of the enum.
 uint8_t IRToshibaAC::convertMode(const stdAc::opmode_t mode) {
-  switch (mode) {
-    case stdAc::opmode_t::kCool: return kToshibaAcCool;
-    case stdAc::opmode_t::kHeat: return kToshibaAcHeat;
-    case stdAc::opmode_t::kDry:  return kToshibaAcDry;
-    case stdAc::opmode_t::kFan:  return kToshibaAcFan;
-    case stdAc::opmode_t::kOff:  return kToshibaAcOff;
-    default:                     return kToshibaAcAuto;
-  }
+  return irutils::toNative(kToshibaAcModeMap, mode, kToshibaAcAuto);
 }
 
 /// Convert a stdAc::fanspeed_t enum into it's native speed.
 /// @param[in] speed The enum to be converted.
 /// @return The native equivalent of the enum.
 uint8_t IRToshibaAC::convertFan(const stdAc::fanspeed_t speed) {
-  switch (speed) {
-    case stdAc::fanspeed_t::kMin:    return kToshibaAcFanMax - 4;
-    case stdAc::fanspeed_t::kLow:    return kToshibaAcFanMax - 3;
-    case stdAc::fanspeed_t::kMedium: return kToshibaAcFanMax - 2;
-    case stdAc::fanspeed_t::kHigh:   return kToshibaAcFanMax - 1;
-    case stdAc::fanspeed_t::kMax:    return kToshibaAcFanMax;
-    default:                         return kToshibaAcFanAuto;
-  }
+  return irutils::toNative(kToshibaAcFanMap, speed, kToshibaAcFanAuto);
 }
 
 /// Convert a native mode into its stdAc equivalent.
 /// @param[in] mode The native setting to be converted.
 /// @return The stdAc equivalent of the native setting.
 stdAc::opmode_t IRToshibaAC::toCommonMode(const uint8_t mode) {
-  switch (mode) {
-    case kToshibaAcCool: return stdAc::opmode_t::kCool;
-    case kToshibaAcHeat: return stdAc::opmode_t::kHeat;
-    case kToshibaAcDry:  return stdAc::opmode_t::kDry;
-    case kToshibaAcFan:  return stdAc::opmode_t::kFan;
-    case kToshibaAcOff:  return stdAc::opmode_t::kOff;
-    default:             return stdAc::opmode_t::kAuto;
-  }
+  return irutils::toCommon(kToshibaAcModeMap, mode, stdAc::opmode_t::kAuto);
 }
 
 /// Convert a native fan speed into its stdAc equivalent.
 /// @param[in] spd The native setting to be converted.
 /// @return The stdAc equivalent of the native setting.
 stdAc::fanspeed_t IRToshibaAC::toCommonFanSpeed(const uint8_t spd) {
-  switch (spd) {
-    case kToshibaAcFanMax:     return stdAc::fanspeed_t::kMax;
-    case kToshibaAcFanMax - 1: return stdAc::fanspeed_t::kHigh;
-    case kToshibaAcFanMax - 2: return stdAc::fanspeed_t::kMedium;
-    case kToshibaAcFanMax - 3: return stdAc::fanspeed_t::kLow;
-    case kToshibaAcFanMax - 4: return stdAc::fanspeed_t::kMin;
-    default:                   return stdAc::fanspeed_t::kAuto;
-  }
+  return irutils::toCommon(kToshibaAcFanMap, spd, stdAc::fanspeed_t::kAuto);
 }
 
 /// Convert the current internal state into its stdAc::state_t equivalent.
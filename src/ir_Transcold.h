@@ -114,6 +114,10 @@ const uint32_t kTranscoldSwingV = 0b111001110110000101010100;  // NA
 const uint32_t kTranscoldCmdFan = 0b111011110110000101010100;  // NA
 
 const uint32_t kTranscoldKnownGoodState = 0xE96554;
+/// Settings a Transcold message toggles, rather than sets.
+const uint8_t kTranscoldToggles = stdAc::kToggleSwingV | stdAc::kToggleTurbo |
+                                  stdAc::kToggleLight | stdAc::kToggleClean |
+                                  stdAc::kToggleSleep;
 
 // Classes
 /// Class for handling detailed Transcold A/C messages.
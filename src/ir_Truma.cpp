@@ -121,13 +121,7 @@ void IRTrumaAc::send(const uint16_t repeat) {
 /// @param[in] state The value to calc the checksum of.
 /// @return The calculated checksum value.
 uint8_t IRTrumaAc::calcChecksum(const uint64_t state) {
-  uint8_t sum = kTrumaChecksumInit;
-  uint64_t to_checksum = state;
-  for (uint16_t i = 8; i < kTrumaBits; i += 8) {
-    sum += (to_checksum & 0xFF);
-    to_checksum >>= 8;
-  }
-  return sum;
+  return sumBytes(state, (kTrumaBits - 8) / 8, kTrumaChecksumInit);
 }
 
 /// Verify the checksum is valid for a given state.
@@ -126,6 +126,8 @@ const uint8_t kWhirlpoolAcCommandIFeel = 0x0D;
 const uint8_t kWhirlpoolAcCommandFanSpeed = 0x11;
 const uint8_t kWhirlpoolAcCommand6thSense = 0x17;
 const uint8_t kWhirlpoolAcCommandOffTimer = 0x1D;
+/// Settings a Whirlpool message toggles, rather than sets.
+const uint8_t kWhirlpoolAcToggles = stdAc::kTogglePower;
 
 // Classes
 /// Class for handling detailed Whirlpool A/C messages.
@@ -0,0 +1,271 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+#include "IRac.h"
+#include "IRacFleet.h"
+#include "IRrecv.h"
+#include "IRsend_test.h"
+#include "IRremoteESP8266.h"
+#include "IRtimer.h"
+#include "gtest/gtest.h"
+
+// Tests for IRacFleet.
+
+TEST(TestIRacFleet, Basics) {
+  IRac ac0(kGpioUnused);
+  IRac *emitters[2] = {&ac0, NULL};
+  IRacFleet fleet(emitters, 2, 3, 0);
+  EXPECT_EQ(3, fleet.capacity());
+  EXPECT_EQ(0, fleet.count());
+  EXPECT_EQ(0, fleet.pending());
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+
+  // Bad devices.
+  EXPECT_EQ(kAcFleetNone, fleet.add(1, decode_type_t::COOLIX));  // No IRac.
+  EXPECT_EQ(kAcFleetNone, fleet.add(2, decode_type_t::COOLIX));  // Too high.
+  EXPECT_EQ(kAcFleetNone, fleet.add(0, decode_type_t::NEC));  // Not an A/C.
+  EXPECT_EQ(0, fleet.count());
+
+  // Fill it up.
+  EXPECT_EQ(0, fleet.add(0, decode_type_t::COOLIX));
+  EXPECT_EQ(1, fleet.add(0, decode_type_t::DAIKIN));
+  EXPECT_EQ(2, fleet.add(0, decode_type_t::FUJITSU_AC,
+                         fujitsu_ac_remote_model_t::ARREW4E));
+  EXPECT_EQ(kAcFleetNone, fleet.add(0, decode_type_t::COOLIX));  // Full.
+  EXPECT_EQ(3, fleet.count());
+  // Nothing is sent until a state is set.
+  EXPECT_EQ(0, fleet.pending());
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+
+  stdAc::state_t state;
+  EXPECT_FALSE(fleet.getState(3, &state));
+  EXPECT_FALSE(fleet.getSent(0, &state));
+  // Even so, it isn't left uninitialised.
+  EXPECT_EQ(0, memcmp(&fleet._devices[0].desired, &fleet._devices[0].sent,
+                      sizeof(stdAc::packed_state_t)));
+  ASSERT_TRUE(fleet.getState(2, &state));
+  EXPECT_EQ(decode_type_t::FUJITSU_AC, state.protocol);
+  EXPECT_EQ(fujitsu_ac_remote_model_t::ARREW4E, state.model);
+
+  // Setting a state keeps the device's own protocol & model.
+  stdAc::state_t desired;
+  IRac::initState(&desired);
+  desired.protocol = decode_type_t::SAMSUNG_AC;
+  desired.model = 7;
+  desired.power = true;
+  desired.mode = stdAc::opmode_t::kCool;
+  desired.degrees = 22.5;
+  EXPECT_FALSE(fleet.setState(3, desired));
+  EXPECT_TRUE(fleet.setState(2, desired));
+  EXPECT_EQ(1, fleet.pending());
+  ASSERT_TRUE(fleet.getState(2, &state));
+  EXPECT_EQ(decode_type_t::FUJITSU_AC, state.protocol);
+  EXPECT_EQ(fujitsu_ac_remote_model_t::ARREW4E, state.model);
+  EXPECT_TRUE(state.power);
+  EXPECT_EQ(stdAc::opmode_t::kCool, state.mode);
+  EXPECT_EQ(22.5, state.degrees);
+
+  bool success = false;
+  EXPECT_EQ(2, fleet.poll(&success));
+  EXPECT_TRUE(success);
+  EXPECT_EQ(0, fleet.pending());
+  ASSERT_TRUE(fleet.getSent(2, &state));
+  EXPECT_EQ(decode_type_t::FUJITSU_AC, state.protocol);
+  EXPECT_EQ(22.5, state.degrees);
+  // The shared IRac object knows what was sent with it.
+  EXPECT_EQ(decode_type_t::FUJITSU_AC, ac0.getStatePrev().protocol);
+  EXPECT_EQ(22.5, ac0.getStatePrev().degrees);
+
+  // The same state again isn't sent, nor is a change to only the clock.
+  EXPECT_TRUE(fleet.setState(2, desired));
+  desired.clock = 600;
+  EXPECT_TRUE(fleet.setState(2, desired));
+  EXPECT_EQ(0, fleet.pending());
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+  // Unless we ask for it.
+  EXPECT_TRUE(fleet.resend(2));
+  EXPECT_FALSE(fleet.resend(3));
+  EXPECT_EQ(1, fleet.pending());
+  EXPECT_EQ(2, fleet.poll());
+  EXPECT_EQ(0, fleet.pending());
+
+  // A change that is undone before it is sent, isn't sent.
+  desired.degrees = 25;
+  EXPECT_TRUE(fleet.setState(2, desired));
+  EXPECT_EQ(1, fleet.pending());
+  desired.degrees = 22.5;
+  EXPECT_TRUE(fleet.setState(2, desired));
+  EXPECT_EQ(0, fleet.pending());
+
+  fleet.clear();
+  EXPECT_EQ(0, fleet.count());
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+}
+
+TEST(TestIRacFleet, Batches) {
+  IRac ac0(kGpioUnused);
+  IRac ac1(kGpioUnused);
+  IRac *emitters[2] = {&ac0, &ac1};
+  IRacFleet fleet(emitters, 2, 8, 0);
+  EXPECT_EQ(0, fleet.add(0, decode_type_t::COOLIX));
+  EXPECT_EQ(1, fleet.add(1, decode_type_t::MIDEA));
+  EXPECT_EQ(2, fleet.add(0, decode_type_t::DAIKIN));
+  EXPECT_EQ(3, fleet.add(1, decode_type_t::COOLIX));
+
+  stdAc::state_t desired;
+  IRac::initState(&desired);
+  desired.power = true;
+  desired.degrees = 21;
+
+  const uint16_t ids[4] = {0, 3, 9, 3};
+  EXPECT_EQ(3, fleet.setStates(ids, 4, desired));  // 9 doesn't exist.
+  EXPECT_EQ(2, fleet.pending());
+  EXPECT_EQ(1, fleet.pending(0));
+  EXPECT_EQ(1, fleet.pending(1));
+
+  EXPECT_EQ(2, fleet.setAll(desired, 0));
+  EXPECT_EQ(3, fleet.pending());
+  EXPECT_EQ(2, fleet.pending(0));
+  EXPECT_EQ(4, fleet.setAll(desired));
+  EXPECT_EQ(4, fleet.pending());
+  EXPECT_EQ(0, fleet.setAll(desired, 7));
+
+  // Everything gets sent, once.
+  uint8_t sent[4] = {0, 0, 0, 0};
+  int16_t id;
+  while ((id = fleet.poll()) != kAcFleetNone) sent[id]++;
+  for (uint8_t i = 0; i < 4; i++) EXPECT_EQ(1, sent[i]);
+  EXPECT_EQ(0, fleet.pending());
+  stdAc::state_t state;
+  ASSERT_TRUE(fleet.getSent(1, &state));
+  EXPECT_EQ(decode_type_t::MIDEA, state.protocol);
+  EXPECT_EQ(21, state.degrees);
+}
+
+TEST(TestIRacFleet, Scheduling) {
+  const uint32_t gap = 1000000;  // 1s. Much longer than a message.
+  IRac ac0(kGpioUnused);
+  IRac ac1(kGpioUnused);
+  IRac *emitters[2] = {&ac0, &ac1};
+  IRacFleet fleet(emitters, 2, 4, gap);
+  EXPECT_EQ(gap, fleet.getGap(0));
+  EXPECT_EQ(0, fleet.getGap(2));
+  EXPECT_EQ(0, fleet.add(0, decode_type_t::COOLIX));
+  EXPECT_EQ(1, fleet.add(0, decode_type_t::DAIKIN));
+  EXPECT_EQ(2, fleet.add(0, decode_type_t::MIDEA));
+  EXPECT_EQ(3, fleet.add(1, decode_type_t::COOLIX));
+
+  stdAc::state_t desired;
+  IRac::initState(&desired);
+  desired.power = true;
+  EXPECT_EQ(3, fleet.setAll(desired, 0));
+
+  // Each emitter must wait for the gap after a message.
+  EXPECT_EQ(0, fleet.poll());
+  EXPECT_EQ(decode_type_t::COOLIX, ac0.getStatePrev().protocol);
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+  IRtimer::add(gap - 1);
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+  IRtimer::add(1);
+  EXPECT_EQ(1, fleet.poll());
+  EXPECT_EQ(decode_type_t::DAIKIN, ac0.getStatePrev().protocol);
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+  // But other emitters aren't held up by it.
+  EXPECT_TRUE(fleet.setState(3, desired));
+  EXPECT_EQ(3, fleet.poll());
+  EXPECT_EQ(decode_type_t::COOLIX, ac1.getStatePrev().protocol);
+  EXPECT_EQ(kAcFleetNone, fleet.poll());
+  IRtimer::add(gap);
+  EXPECT_EQ(2, fleet.poll());
+  EXPECT_EQ(decode_type_t::MIDEA, ac0.getStatePrev().protocol);
+  EXPECT_EQ(0, fleet.pending());
+
+  // Devices take turns, so a busy one can't starve the others.
+  IRtimer::add(gap);
+  desired.degrees = 20;
+  EXPECT_TRUE(fleet.setState(0, desired));
+  EXPECT_TRUE(fleet.setState(2, desired));
+  EXPECT_EQ(0, fleet.poll());
+  desired.degrees = 19;
+  EXPECT_TRUE(fleet.setState(0, desired));
+  IRtimer::add(gap);
+  EXPECT_EQ(2, fleet.poll());
+  IRtimer::add(gap);
+  EXPECT_EQ(0, fleet.poll());
+  EXPECT_EQ(19, ac0.getStatePrev().degrees);
+
+  // A gap can be set per emitter.
+  fleet.setGap(1, 0);
+  EXPECT_EQ(0, fleet.getGap(1));
+  desired.degrees = 24;
+  EXPECT_EQ(1, fleet.setAll(desired, 1));
+  EXPECT_EQ(3, fleet.poll());
+  EXPECT_TRUE(fleet.resend(3));
+  EXPECT_EQ(3, fleet.poll());
+}
+
+TEST(TestIRacFleet, OutputTiming) {
+  const uint32_t gap = 1000000;  // 1s. Longer than a Daikin message.
+  const uint32_t step = 1000;  // How often `poll()` is called. (1ms)
+  IRac ac0(kGpioUnused);
+  IRac ac1(kGpioUnused);
+  // Keep the Daikin objects, so we can see what each emitter sent.
+  ac0.setIncremental(true);
+  ac1.setIncremental(true);
+  IRac *emitters[2] = {&ac0, &ac1};
+  IRacFleet fleet(emitters, 2, 4, gap);
+  EXPECT_EQ(0, fleet.add(0, decode_type_t::DAIKIN));
+  EXPECT_EQ(1, fleet.add(0, decode_type_t::DAIKIN));
+  EXPECT_EQ(2, fleet.add(1, decode_type_t::DAIKIN));
+  stdAc::state_t desired;
+  IRac::initState(&desired);
+  desired.power = true;
+  desired.mode = stdAc::opmode_t::kCool;
+  for (uint16_t id = 0; id < 3; id++) {
+    desired.degrees = 20 + id;
+    EXPECT_TRUE(fleet.setState(id, desired));
+  }
+
+  IRrecv irrecv(kGpioUnused);
+  uint32_t start[3] = {0};  // When each device's message started. (uSeconds)
+  uint32_t end[3] = {0};  // When each device's message finished. (uSeconds)
+  uint32_t now = 0;  // Time since we started polling. (uSeconds)
+  for (uint16_t polls = 0; fleet.pending() && polls < 2000; polls++) {
+    for (uint8_t i = 0; i < 2; i++)
+      if (emitters[i]->_daikin != NULL) emitters[i]->_daikin->_irsend.reset();
+    const uint32_t before = _IRtimer_unittest_now;
+    const int16_t id = fleet.poll();
+    if (id == kAcFleetNone) {
+      IRtimer::add(step);
+      now += step;
+      continue;
+    }
+    // Sending the message took up the time it lasts, on that emitter alone.
+    IRsendTest *irsend = &emitters[id == 2]->_daikin->_irsend;
+    uint32_t duration = 0;
+    for (uint16_t i = 0; i <= irsend->last; i++) duration += irsend->output[i];
+    EXPECT_EQ(duration, _IRtimer_unittest_now - before) << "Device " << id;
+    IRDaikinESP *other = emitters[id != 2]->_daikin;
+    if (other != NULL) {
+      EXPECT_EQ("", other->_irsend.outputStr()) << "Device " << id;
+    }
+    start[id] = now;
+    now += duration;
+    end[id] = now;
+    // It is the whole message, for the right device.
+    irsend->makeDecodeResult();
+    ASSERT_TRUE(irrecv.decode(&irsend->capture)) << "Device " << id;
+    EXPECT_EQ(decode_type_t::DAIKIN, irsend->capture.decode_type);
+    stdAc::state_t state;
+    ASSERT_TRUE(IRAcUtils::decodeToState(&irsend->capture, &state));
+    EXPECT_EQ(20 + id, state.degrees);
+  }
+  EXPECT_EQ(0, fleet.pending());
+
+  // The two devices on emitter 0 didn't overlap, & the gap was kept, but no
+  // more than that.
+  EXPECT_EQ(0, start[0]);
+  EXPECT_GE(start[1], end[0] + gap);
+  EXPECT_LE(start[1], end[0] + gap + step);
+  // Emitter 1 wasn't held up by emitter 0's gap.
+  EXPECT_EQ(end[0], start[2]);
+}
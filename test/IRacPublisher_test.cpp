@@ -0,0 +1,273 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <string>
+#include <vector>
+#include "IRac.h"
+#include "IRacPublisher.h"
+#include "IRremoteESP8266.h"
+#include "gtest/gtest.h"
+
+// Tests for IRacPublisher.
+
+/// A stand-in for an MQTT broker. It records everything published to it.
+class FakeBroker {
+ public:
+  std::vector<std::string> topics;  ///< In the order they were published.
+  std::vector<std::string> payloads;  ///< Ditto.
+  std::vector<bool> retained;  ///< Ditto.
+  bool up = true;  ///< Is it accepting messages?
+
+  static bool publish(void *context, const String &topic,
+                      const String &payload, const bool retain) {
+    FakeBroker *broker = reinterpret_cast<FakeBroker *>(context);
+    if (!broker->up) return false;
+    broker->topics.push_back(topic);
+    broker->payloads.push_back(payload);
+    broker->retained.push_back(retain);
+    return true;
+  }
+
+  void clear(void) {
+    topics.clear();
+    payloads.clear();
+    retained.clear();
+  }
+
+  /// The payload last published to a topic, or "" if there isn't one.
+  std::string last(const std::string topic) const {
+    for (int16_t i = topics.size() - 1; i >= 0; i--)
+      if (topics[i] == topic) return payloads[i];
+    return "";
+  }
+};
+
+/// A typical state.
+stdAc::state_t typicalState(void) {
+  stdAc::state_t state;
+  IRac::initState(&state);
+  state.protocol = decode_type_t::DAIKIN;
+  state.model = 1;
+  state.power = true;
+  state.mode = stdAc::opmode_t::kCool;
+  state.degrees = 21.5;
+  state.fanspeed = stdAc::fanspeed_t::kHigh;
+  return state;
+}
+
+TEST(TestIRacPublisher, FieldNamesAndValues) {
+  EXPECT_STREQ("protocol", IRacPublisher::fieldName(kAcFieldProtocol));
+  EXPECT_STREQ("use_celsius", IRacPublisher::fieldName(kAcFieldCelsius));
+  EXPECT_STREQ("sleep", IRacPublisher::fieldName(kAcFieldSleep));
+  EXPECT_EQ(NULL, IRacPublisher::fieldName(kAcFieldClock));
+  EXPECT_EQ(NULL, IRacPublisher::fieldName(0));
+  // Every reported field has a name.
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < 32; i++)
+    if (kAcPublisherFields & (1UL << i)) {
+      EXPECT_NE(nullptr, IRacPublisher::fieldName(1UL << i));
+      count++;
+    }
+  EXPECT_EQ(kAcPublisherNrFields, count);
+
+  stdAc::state_t state = typicalState();
+  EXPECT_EQ("DAIKIN", IRacPublisher::fieldValue(state, kAcFieldProtocol));
+  EXPECT_EQ("1", IRacPublisher::fieldValue(state, kAcFieldModel));
+  EXPECT_EQ("on", IRacPublisher::fieldValue(state, kAcFieldPower));
+  EXPECT_EQ("cool", IRacPublisher::fieldValue(state, kAcFieldMode));
+  EXPECT_EQ("21.5", IRacPublisher::fieldValue(state, kAcFieldDegrees));
+  EXPECT_EQ("on", IRacPublisher::fieldValue(state, kAcFieldCelsius));
+  EXPECT_EQ("High", IRacPublisher::fieldValue(state, kAcFieldFanspeed));
+  EXPECT_EQ("Off", IRacPublisher::fieldValue(state, kAcFieldSwingv));
+  EXPECT_EQ("off", IRacPublisher::fieldValue(state, kAcFieldQuiet));
+  EXPECT_EQ("-1", IRacPublisher::fieldValue(state, kAcFieldSleep));
+  EXPECT_EQ("", IRacPublisher::fieldValue(state, kAcFieldClock));
+  state.degrees = 72;
+  EXPECT_EQ("72.0", IRacPublisher::fieldValue(state, kAcFieldDegrees));
+  state.degrees = -0.26;
+  EXPECT_EQ("-0.3", IRacPublisher::fieldValue(state, kAcFieldDegrees));
+  // Home Assistant mode.
+  state.power = false;
+  EXPECT_EQ("cool", IRacPublisher::fieldValue(state, kAcFieldMode));
+  EXPECT_EQ("off", IRacPublisher::fieldValue(state, kAcFieldMode, true));
+}
+
+TEST(TestIRacPublisher, OnlyChangesArePublished) {
+  FakeBroker broker;
+  IRacPublisher publisher(FakeBroker::publish, &broker, "ac/stat/");
+  stdAc::state_t state = typicalState();
+
+  // Everything is published the first time.
+  EXPECT_EQ(kAcPublisherFields, publisher.pending(state));
+  EXPECT_TRUE(publisher.publish(state, true));
+  ASSERT_EQ(kAcPublisherNrFields, broker.topics.size());
+  EXPECT_EQ("ac/stat/protocol", broker.topics[0]);
+  EXPECT_EQ("DAIKIN", broker.payloads[0]);
+  EXPECT_EQ("ac/stat/sleep", broker.topics[kAcPublisherNrFields - 1]);
+  EXPECT_EQ("cool", broker.last("ac/stat/mode"));
+  EXPECT_EQ("21.5", broker.last("ac/stat/temp"));
+  EXPECT_TRUE(broker.retained[0]);
+
+  // Nothing has changed, so nothing is published.
+  broker.clear();
+  EXPECT_EQ(0, publisher.pending(state));
+  EXPECT_TRUE(publisher.publish(state));
+  EXPECT_EQ(0, broker.topics.size());
+  // Not even if the clock changes, as that isn't reported.
+  state.clock = 123;
+  EXPECT_TRUE(publisher.publish(state));
+  EXPECT_EQ(0, broker.topics.size());
+
+  // Only the settings that changed are.
+  state.degrees = 22;
+  state.turbo = true;
+  EXPECT_EQ(kAcFieldDegrees | kAcFieldTurbo, publisher.pending(state));
+  EXPECT_TRUE(publisher.publish(state, false));
+  ASSERT_EQ(2, broker.topics.size());
+  EXPECT_EQ("ac/stat/temp", broker.topics[0]);
+  EXPECT_EQ("22.0", broker.payloads[0]);
+  EXPECT_EQ("ac/stat/turbo", broker.topics[1]);
+  EXPECT_EQ("on", broker.payloads[1]);
+  EXPECT_FALSE(broker.retained[0]);
+
+  // Unless everything is asked for.
+  broker.clear();
+  EXPECT_TRUE(publisher.publish(state, true, true));
+  EXPECT_EQ(kAcPublisherNrFields, broker.topics.size());
+
+  // Or it is told to forget what it has published.
+  broker.clear();
+  publisher.forget();
+  EXPECT_TRUE(publisher.publish(state));
+  EXPECT_EQ(kAcPublisherNrFields, broker.topics.size());
+
+  // Changing the prefix changes all the topics.
+  broker.clear();
+  publisher.setPrefix("ac2/stat/");
+  EXPECT_EQ("ac2/stat/", publisher.getPrefix());
+  state.sleep = 60;
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(1, broker.topics.size());
+  EXPECT_EQ("ac2/stat/sleep", broker.topics[0]);
+  EXPECT_EQ("60", broker.payloads[0]);
+}
+
+TEST(TestIRacPublisher, FailuresAreRetried) {
+  FakeBroker broker;
+  IRacPublisher publisher(FakeBroker::publish, &broker, "ac/");
+  stdAc::state_t state = typicalState();
+  EXPECT_TRUE(publisher.publish(state));
+
+  broker.clear();
+  broker.up = false;
+  state.light = true;
+  EXPECT_FALSE(publisher.publish(state));
+  EXPECT_EQ(kAcFieldLight, publisher.pending(state));
+
+  // It comes back, and something else changes too.
+  broker.up = true;
+  state.beep = true;
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(2, broker.topics.size());
+  EXPECT_EQ("ac/light", broker.topics[0]);
+  EXPECT_EQ("ac/beep", broker.topics[1]);
+  EXPECT_EQ(0, publisher.pending(state));
+}
+
+TEST(TestIRacPublisher, HomeAssistantMode) {
+  FakeBroker broker;
+  IRacPublisher publisher(FakeBroker::publish, &broker, "", false, true);
+  EXPECT_TRUE(publisher.getHaMode());
+  stdAc::state_t state = typicalState();
+  EXPECT_TRUE(publisher.publish(state));
+
+  // Power & mode are always reported together.
+  broker.clear();
+  state.power = false;
+  EXPECT_EQ(kAcFieldPower | kAcFieldMode, publisher.pending(state));
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(2, broker.topics.size());
+  EXPECT_EQ("power", broker.topics[0]);
+  EXPECT_EQ("off", broker.payloads[0]);
+  EXPECT_EQ("mode", broker.topics[1]);
+  EXPECT_EQ("off", broker.payloads[1]);
+
+  broker.clear();
+  state.power = true;
+  state.mode = stdAc::opmode_t::kHeat;
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(2, broker.topics.size());
+  EXPECT_EQ("on", broker.payloads[0]);
+  EXPECT_EQ("heat", broker.payloads[1]);
+}
+
+TEST(TestIRacPublisher, Json) {
+  FakeBroker broker;
+  IRacPublisher publisher(FakeBroker::publish, &broker, "ac/stat/", true);
+  EXPECT_TRUE(publisher.getJson());
+  stdAc::state_t state = typicalState();
+  const std::string full =
+      "{\"protocol\":\"DAIKIN\",\"model\":1,\"power\":\"on\","
+      "\"mode\":\"cool\",\"temp\":21.5,\"use_celsius\":\"on\","
+      "\"fanspeed\":\"High\",\"swingv\":\"Off\",\"swingh\":\"Off\","
+      "\"quiet\":\"off\",\"turbo\":\"off\",\"econo\":\"off\","
+      "\"light\":\"off\",\"filter\":\"off\",\"clean\":\"off\","
+      "\"beep\":\"off\",\"sleep\":-1}";
+
+  // Just the two documents, instead of a topic per setting.
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(2, broker.topics.size());
+  EXPECT_EQ("", broker.last("ac/stat/temp"));
+  EXPECT_EQ("ac/stat/json", broker.topics[0]);
+  EXPECT_EQ(full, broker.payloads[0]);
+  EXPECT_TRUE(broker.retained[0]);
+  EXPECT_EQ("ac/stat/json_delta", broker.topics[1]);
+  EXPECT_EQ(full, broker.payloads[1]);
+  EXPECT_FALSE(broker.retained[1]);
+
+  // The "json" document is always the whole state, the delta only the changes.
+  broker.clear();
+  state.degrees = 19;
+  state.swingv = stdAc::swingv_t::kAuto;
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(2, broker.topics.size());
+  EXPECT_EQ("ac/stat/json", broker.topics[0]);
+  EXPECT_NE(std::string::npos,
+            broker.payloads[0].find("\"temp\":19.0,\"use_celsius\":\"on\""));
+  EXPECT_NE(std::string::npos,
+            broker.payloads[0].find("\"beep\":\"off\",\"sleep\":-1}"));
+  EXPECT_TRUE(broker.retained[0]);
+  EXPECT_EQ("ac/stat/json_delta", broker.topics[1]);
+  EXPECT_EQ("{\"temp\":19.0,\"swingv\":\"Auto\"}", broker.payloads[1]);
+  EXPECT_FALSE(broker.retained[1]);
+
+  // Nothing changed, nothing sent.
+  broker.clear();
+  EXPECT_TRUE(publisher.publish(state));
+  EXPECT_EQ(0, broker.topics.size());
+
+  // A failed change is resent next time.
+  broker.up = false;
+  state.econo = true;
+  EXPECT_FALSE(publisher.publish(state));
+  broker.up = true;
+  state.clean = true;
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(2, broker.topics.size());
+  EXPECT_EQ("{\"econo\":\"on\",\"clean\":\"on\"}",
+            broker.last("ac/stat/json_delta"));
+
+  // Forgetting, e.g. after a reconnect, publishes everything again.
+  broker.clear();
+  publisher.forget();
+  EXPECT_TRUE(publisher.publish(state));
+  EXPECT_EQ(2, broker.topics.size());
+  EXPECT_EQ(broker.last("ac/stat/json"), broker.last("ac/stat/json_delta"));
+
+  // Turning it off leaves just a topic per setting.
+  broker.clear();
+  publisher.setJson(false);
+  state.filter = true;
+  EXPECT_TRUE(publisher.publish(state));
+  ASSERT_EQ(1, broker.topics.size());
+  EXPECT_EQ("ac/stat/filter", broker.topics[0]);
+}
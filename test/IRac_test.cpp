@@ -1,5 +1,6 @@
 // Copyright 2019-2021 David Conran
 
+#include <random>
 #include <string>
 #include "ir_Airwell.h"
 #include "ir_Amcor.h"
@@ -2030,6 +2031,128 @@ TEST(TestIRac, cmpStates) {
   // Now make them different.
   b.power = false;
   ASSERT_TRUE(IRac::cmpStates(a, b));
+
+  // Degrees are compared exactly. i.e. Not like their packed form.
+  b = a;
+  b.degrees = a.degrees + 0.01;
+  EXPECT_TRUE(IRac::cmpStates(a, b));
+}
+
+TEST(TestIRac, packState) {
+  stdAc::state_t a;
+  a.protocol = decode_type_t::DAIKIN;
+  a.model = 3;
+  a.power = true;
+  a.celsius = false;
+  a.degrees = 72.5;
+  a.mode = stdAc::opmode_t::kHeat;
+  a.fanspeed = stdAc::fanspeed_t::kMax;
+  a.swingv = stdAc::swingv_t::kLowest;
+  a.swingh = stdAc::swingh_t::kWide;
+  a.quiet = true;
+  a.turbo = false;
+  a.econo = true;
+  a.light = false;
+  a.filter = true;
+  a.clean = false;
+  a.beep = true;
+  a.sleep = 120;
+  a.clock = 1234;
+
+  EXPECT_EQ(12, sizeof(stdAc::packed_state_t));
+  stdAc::packed_state_t packed = IRac::packState(a);
+  stdAc::state_t b = IRac::unpackState(packed);
+  EXPECT_EQ(a.protocol, b.protocol);
+  EXPECT_EQ(a.model, b.model);
+  EXPECT_EQ(a.power, b.power);
+  EXPECT_EQ(a.celsius, b.celsius);
+  EXPECT_EQ(a.degrees, b.degrees);
+  EXPECT_EQ(a.mode, b.mode);
+  EXPECT_EQ(a.fanspeed, b.fanspeed);
+  EXPECT_EQ(a.swingv, b.swingv);
+  EXPECT_EQ(a.swingh, b.swingh);
+  EXPECT_EQ(a.quiet, b.quiet);
+  EXPECT_EQ(a.turbo, b.turbo);
+  EXPECT_EQ(a.econo, b.econo);
+  EXPECT_EQ(a.light, b.light);
+  EXPECT_EQ(a.filter, b.filter);
+  EXPECT_EQ(a.clean, b.clean);
+  EXPECT_EQ(a.beep, b.beep);
+  EXPECT_EQ(a.sleep, b.sleep);
+  EXPECT_EQ(a.clock, b.clock);
+  EXPECT_FALSE(IRac::cmpStates(a, b));
+  stdAc::packed_state_t repacked = IRac::packState(b);
+  EXPECT_EQ(0, memcmp(&packed, &repacked, sizeof(packed)));
+
+  // Negative & "off" values.
+  a.protocol = decode_type_t::UNKNOWN;
+  a.model = -1;
+  a.degrees = -12.3;
+  a.mode = stdAc::opmode_t::kOff;
+  a.fanspeed = stdAc::fanspeed_t::kAuto;
+  a.swingv = stdAc::swingv_t::kOff;
+  a.swingh = stdAc::swingh_t::kOff;
+  a.sleep = -1;
+  a.clock = -1;
+  b = IRac::unpackState(IRac::packState(a));
+  EXPECT_EQ(a.protocol, b.protocol);
+  EXPECT_EQ(a.model, b.model);
+  EXPECT_NEAR(a.degrees, b.degrees, 0.001);
+  EXPECT_EQ(a.mode, b.mode);
+  EXPECT_EQ(a.fanspeed, b.fanspeed);
+  EXPECT_EQ(a.swingv, b.swingv);
+  EXPECT_EQ(a.swingh, b.swingh);
+  EXPECT_EQ(a.sleep, b.sleep);
+  EXPECT_EQ(a.clock, b.clock);
+
+  // Degrees are kept to a tenth, and are limited in range.
+  a.degrees = 21.04;
+  EXPECT_NEAR(21.0, IRac::unpackState(IRac::packState(a)).degrees, 0.001);
+  a.degrees = 21.06;
+  EXPECT_NEAR(21.1, IRac::unpackState(IRac::packState(a)).degrees, 0.001);
+  a.degrees = 500;
+  EXPECT_NEAR(102.3, IRac::unpackState(IRac::packState(a)).degrees, 0.001);
+  a.degrees = -500;
+  EXPECT_NEAR(-102.4, IRac::unpackState(IRac::packState(a)).degrees, 0.001);
+}
+
+TEST(TestIRac, hashState) {
+  stdAc::state_t a;
+  a.protocol = decode_type_t::COOLIX;
+  a.model = -1;
+  a.power = true;
+  a.celsius = true;
+  a.degrees = 25;
+  a.mode = stdAc::opmode_t::kCool;
+  a.fanspeed = stdAc::fanspeed_t::kAuto;
+  a.swingv = stdAc::swingv_t::kOff;
+  a.swingh = stdAc::swingh_t::kOff;
+  a.quiet = false;
+  a.turbo = false;
+  a.econo = false;
+  a.light = false;
+  a.filter = false;
+  a.clean = false;
+  a.beep = false;
+  a.sleep = -1;
+  a.clock = -1;
+  stdAc::state_t b = a;
+
+  const uint32_t hash = IRac::hashState(IRac::packState(a));
+  EXPECT_EQ(hash, IRac::hashState(IRac::packState(b)));
+  // A known value, so a stored hash stays valid across builds & platforms.
+  stdAc::packed_state_t zero;
+  memset(&zero, 0, sizeof(zero));
+  EXPECT_EQ(0xE23C62B5, IRac::hashState(zero));
+
+  b.degrees = 25.1;
+  EXPECT_NE(hash, IRac::hashState(IRac::packState(b)));
+  b = a;
+  b.beep = true;
+  EXPECT_NE(hash, IRac::hashState(IRac::packState(b)));
+  b = a;
+  b.model = 2;
+  EXPECT_NE(hash, IRac::hashState(IRac::packState(b)));
 }
 
 TEST(TestIRac, handleToggles) {
@@ -2102,6 +2225,47 @@ TEST(TestIRac, handleToggles) {
   ASSERT_NE(stdAc::swingv_t::kOff, result.swingv);  // i.e A toggle.
 }
 
+TEST(TestIRac, toggleMask) {
+  EXPECT_EQ(stdAc::kToggleSwingV | stdAc::kToggleTurbo | stdAc::kToggleLight |
+            stdAc::kToggleClean | stdAc::kToggleSleep,
+            IRac::toggleMask(decode_type_t::COOLIX));
+  EXPECT_EQ(stdAc::kTogglePower, IRac::toggleMask(decode_type_t::AIRWELL));
+  EXPECT_EQ(0, IRac::toggleMask(decode_type_t::DAIKIN));
+  EXPECT_EQ(0, IRac::toggleMask(decode_type_t::UNKNOWN));
+  // Panasonic A/C depends on the model.
+  EXPECT_EQ(0, IRac::toggleMask(decode_type_t::PANASONIC_AC,
+                                panasonic_ac_remote_model_t::kPanasonicDke));
+  EXPECT_EQ(stdAc::kTogglePower,
+            IRac::toggleMask(decode_type_t::PANASONIC_AC,
+                             panasonic_ac_remote_model_t::kPanasonicCkp));
+
+  // Only the settings a protocol toggles are changed, & only if they changed.
+  stdAc::state_t prev, desired, result;
+  prev.protocol = decode_type_t::FUJITSU_AC;
+  prev.model = fujitsu_ac_remote_model_t::ARRAH2E;
+  prev.power = true;
+  prev.swingv = stdAc::swingv_t::kOff;
+  prev.turbo = false;
+  prev.econo = false;
+  prev.light = false;
+  prev.clean = false;
+  prev.sleep = -1;
+  desired = prev;
+  desired.turbo = true;
+  desired.light = true;
+  desired.swingv = stdAc::swingv_t::kAuto;
+  result = IRac::handleToggles(desired, &prev);
+  EXPECT_TRUE(result.power);
+  EXPECT_TRUE(result.turbo);   // Toggled & changed.
+  EXPECT_FALSE(result.econo);  // Toggled, but didn't change.
+  EXPECT_TRUE(result.light);   // Not toggled, so as desired.
+  EXPECT_EQ(stdAc::swingv_t::kAuto, result.swingv);  // Ditto.
+  prev = desired;
+  result = IRac::handleToggles(desired, &prev);
+  EXPECT_FALSE(result.turbo);  // Toggled, but didn't change.
+  EXPECT_TRUE(result.light);
+}
+
 TEST(TestIRac, strToBool) {
   EXPECT_TRUE(IRac::strToBool("ON"));
   EXPECT_TRUE(IRac::strToBool("1"));
@@ -2639,3 +2803,118 @@ TEST(TestIRac, Issue1424) {
   // Confirm the state really did change.
   ASSERT_TRUE(IRac::cmpStates(irac.next, copy_of_next_pre_receive));
 }
+
+TEST(TestIRac, diffStates) {
+  stdAc::state_t a, b;
+  IRac::initState(&a);
+  b = a;
+  EXPECT_EQ(0, IRac::diffStates(a, b));
+  b.degrees += 1;
+  EXPECT_EQ(kAcFieldDegrees, IRac::diffStates(a, b));
+  b.protocol = decode_type_t::DAIKIN2;
+  b.clock = 1234;
+  b.swingh = stdAc::swingh_t::kWide;
+  EXPECT_EQ(kAcFieldDegrees | kAcFieldProtocol | kAcFieldClock |
+            kAcFieldSwingh, IRac::diffStates(a, b));
+  EXPECT_EQ(IRac::diffStates(a, b), IRac::diffStates(b, a));
+  // cmpStates() ignores the clock, diffStates() doesn't.
+  b = a;
+  b.clock = 1234;
+  EXPECT_FALSE(IRac::cmpStates(a, b));
+  EXPECT_EQ(kAcFieldClock, IRac::diffStates(a, b));
+}
+
+// Incremental updates must produce exactly the same message as starting afresh
+// with every setting, no matter what sequence of changes gets us there.
+TEST(TestIRac, IncrementalMatchesFull) {
+  IRac irac(kGpioUnused);
+  IRac ref(kGpioUnused);
+  irac.setIncremental(true);
+  EXPECT_TRUE(irac.getIncremental());
+  std::mt19937 rng(42);
+  stdAc::state_t state;
+  IRac::initState(&state);
+  const decode_type_t protocols[] = {decode_type_t::DAIKIN,
+                                     decode_type_t::DAIKIN2};
+  for (uint16_t i = 0; i < 2000; i++) {
+    // Mostly change one thing at a time, like a thermostat would.
+    switch (rng() % ((i % 50) ? 4 : 16)) {
+      case 0: state.degrees = 10 + rng() % 25; break;
+      case 1: state.fanspeed = (stdAc::fanspeed_t)(rng() % 6); break;
+      case 2: state.clock = (rng() % 8) ? rng() % (24 * 60) : -1; break;
+      case 3: state.quiet = rng() % 2; break;
+      case 4: state.protocol = protocols[rng() % 2]; break;
+      case 5: state.mode = (stdAc::opmode_t)(rng() % 5); break;
+      case 6: state.power = rng() % 2; break;
+      case 7: state.swingv = (stdAc::swingv_t)(rng() % 7 - 1); break;
+      case 8: state.swingh = (stdAc::swingh_t)(rng() % 8 - 1); break;
+      case 9: state.turbo = rng() % 2; break;
+      case 10: state.econo = rng() % 2; break;
+      case 11: state.light = rng() % 2; break;
+      case 12: state.filter = rng() % 2; break;
+      case 13: state.clean = rng() % 2; break;
+      case 14: state.beep = rng() % 2; break;
+      default: state.sleep = (rng() % 2) ? rng() % (24 * 60) : -1;
+    }
+    if (state.protocol != decode_type_t::DAIKIN &&
+        state.protocol != decode_type_t::DAIKIN2)
+      state.protocol = decode_type_t::DAIKIN2;
+    ASSERT_TRUE(irac.sendAc(state));
+    const stdAc::state_t send = ref.cleanState(state);
+    const float degC = send.degrees;
+    if (send.protocol == decode_type_t::DAIKIN) {
+      IRDaikinESP ac(kGpioUnused);
+      ref.daikin(&ac, send.power, send.mode, degC, send.fanspeed,
+                 send.swingv, send.swingh, send.quiet, send.turbo,
+                 send.econo, send.clean);
+      ASSERT_NE(nullptr, irac._daikin);
+      EXPECT_STATE_EQ(ac.getRaw(), irac._daikin->getRaw(), kDaikinBits);
+    } else {
+      IRDaikin2 ac(kGpioUnused);
+      ref.daikin2(&ac, send.power, send.mode, degC, send.fanspeed,
+                  send.swingv, send.swingh, send.quiet, send.turbo,
+                  send.light, send.econo, send.filter, send.clean,
+                  send.beep, send.sleep, send.clock);
+      ASSERT_NE(nullptr, irac._daikin2);
+      EXPECT_STATE_EQ(ac.getRaw(), irac._daikin2->getRaw(), kDaikin2Bits);
+    }
+  }
+}
+
+TEST(TestIRac, IncrementalKeepsObject) {
+  IRac irac(kGpioUnused);
+  stdAc::state_t state;
+  IRac::initState(&state);
+  state.protocol = decode_type_t::DAIKIN2;
+  state.clock = 600;
+  // Off by default, so nothing is kept.
+  EXPECT_FALSE(irac.getIncremental());
+  ASSERT_TRUE(irac.sendAc(state));
+  EXPECT_EQ(nullptr, irac._daikin2);
+
+  irac.setIncremental(true);
+  ASSERT_TRUE(irac.sendAc(state));
+  IRDaikin2 *live = irac._daikin2;
+  ASSERT_NE(nullptr, live);
+  // Temperature & clock changes are applied to the existing object.
+  state.degrees = 21;
+  ASSERT_TRUE(irac.sendAc(state));
+  state.clock = 601;
+  ASSERT_TRUE(irac.sendAc(state));
+  EXPECT_EQ(live, irac._daikin2);
+  EXPECT_EQ(21, live->getTemp());
+  EXPECT_EQ(601, live->getCurrentTime());
+  // Sleep can't be undone in place, so turning it off needs a fresh object.
+  state.sleep = 60;
+  ASSERT_TRUE(irac.sendAc(state));
+  EXPECT_TRUE(irac._daikin2->getSleepTimerEnabled());
+  state.sleep = -1;
+  ASSERT_TRUE(irac.sendAc(state));
+  EXPECT_FALSE(irac._daikin2->getSleepTimerEnabled());
+  EXPECT_EQ(21, irac._daikin2->getTemp());
+  // Unsupported protocols are sent the normal way.
+  state.protocol = decode_type_t::COOLIX;
+  ASSERT_TRUE(irac.sendAc(state));
+  irac.setIncremental(false);
+  EXPECT_EQ(nullptr, irac._daikin2);
+}
@@ -0,0 +1,210 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <stdio.h>
+#include "IRcodeDb.h"
+#include "IRrecv.h"
+#include "IRremoteESP8266.h"
+#include "IRsend.h"
+#include "IRsend_test.h"
+#include "gtest/gtest.h"
+
+// Tests for IRcodeDb.
+
+TEST(TestIRcodeDb, Keys) {
+  // Values of up to 48 bits are kept as they are.
+  EXPECT_EQ(((uint64_t)decode_type_t::NEC << 55) | (32ULL << 48) | 0x00FF00FF,
+            IRcodeDb::key(decode_type_t::NEC, kNECBits, 0x00FF00FF));
+  EXPECT_NE(IRcodeDb::key(decode_type_t::NEC, kNECBits, 0x00FF00FF),
+            IRcodeDb::key(decode_type_t::SONY, kNECBits, 0x00FF00FF));
+  EXPECT_NE(IRcodeDb::key(decode_type_t::NEC, kNECBits, 0x00FF00FF),
+            IRcodeDb::key(decode_type_t::NEC, 16, 0x00FF00FF));
+  EXPECT_EQ(((uint64_t)decode_type_t::PANASONIC << 55) | (48ULL << 48) |
+            0x40040190ED7C,
+            IRcodeDb::key(decode_type_t::PANASONIC, kPanasonicBits,
+                          0x40040190ED7C));
+  EXPECT_EQ(((uint64_t)decode_type_t::KELON << 55) | (48ULL << 48) |
+            0xFFFFFFFFFFFF,
+            IRcodeDb::key(decode_type_t::KELON, kKelonBits, 0xFFFFFFFFFFFF));
+  // Including UNKNOWN ones.
+  EXPECT_EQ((0x1FFULL << 55) | (32ULL << 48) | 0x12345678,
+            IRcodeDb::key(decode_type_t::UNKNOWN, 32, 0x12345678));
+  // Larger ones, & states, are hashed.
+  const uint64_t hashed = IRcodeDb::key(decode_type_t::XMP, 64, 1);
+  EXPECT_EQ((uint64_t)decode_type_t::XMP, hashed >> 55);
+  EXPECT_EQ(0x7F, (hashed >> 48) & 0x7F);
+  EXPECT_NE(hashed, IRcodeDb::key(decode_type_t::XMP, 64, 2));
+  EXPECT_NE(hashed, IRcodeDb::key(decode_type_t::XMP, 63, 1));
+  EXPECT_NE(hashed, IRcodeDb::key(decode_type_t::XMP, 64, 1ULL << 48));
+  const uint8_t state[3] = {1, 2, 3};
+  const uint8_t other[3] = {1, 2, 4};
+  EXPECT_NE(IRcodeDb::key(decode_type_t::DAIKIN, 24, state),
+            IRcodeDb::key(decode_type_t::DAIKIN, 24, other));
+  // Only the bytes within the size are used.
+  EXPECT_EQ(IRcodeDb::key(decode_type_t::DAIKIN, 16, state),
+            IRcodeDb::key(decode_type_t::DAIKIN, 16, other));
+
+  // Straight from a decode.
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  irsend.reset();
+  irsend.sendNEC(0x00FF00FF);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(IRcodeDb::key(decode_type_t::NEC, kNECBits, 0x00FF00FF),
+            IRcodeDb::key(&irsend.capture));
+  const uint8_t daikin[kDaikin2StateLength] = {
+      0x11, 0xDA, 0x27, 0x00, 0x01, 0x7A, 0xC3, 0x70, 0x28, 0x0C, 0x80, 0x04,
+      0xB0, 0x16, 0x24, 0x00, 0x00, 0xBE, 0xD5, 0xF5, 0x11, 0xDA, 0x27, 0x00,
+      0x00, 0x08, 0x26, 0x00, 0xA0, 0x00, 0x00, 0x06, 0x60, 0x00, 0x00, 0xC1,
+      0x80, 0x60, 0xE7};
+  irsend.reset();
+  irsend.sendDaikin2(daikin);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  ASSERT_EQ(decode_type_t::DAIKIN2, irsend.capture.decode_type);
+  EXPECT_EQ(IRcodeDb::key(decode_type_t::DAIKIN2, kDaikin2Bits, daikin),
+            IRcodeDb::key(&irsend.capture));
+}
+
+TEST(TestIRcodeDb, AddLookupRemove) {
+  IRcodeDbRamStore store(64 * kCodeDbRecordSize);
+  IRcodeDb db(&store, 4);
+  const uint64_t power = IRcodeDb::key(decode_type_t::NEC, 32, 0x00FF00FF);
+  const uint64_t mute = IRcodeDb::key(decode_type_t::NEC, 32, 0x00FF807F);
+  EXPECT_FALSE(db.add(power, 1));  // Not ready yet.
+  ASSERT_TRUE(db.begin());
+  EXPECT_EQ(kCodeDbNone, db.lookup(power));
+
+  EXPECT_TRUE(db.add(power, 1));
+  EXPECT_TRUE(db.add(mute, 2));
+  EXPECT_EQ(1, db.lookup(power));
+  EXPECT_EQ(2, db.lookup(mute));
+  EXPECT_EQ(2, db.records());
+  EXPECT_EQ(2, db.pending());
+  // The same again isn't written.
+  EXPECT_TRUE(db.add(power, 1));
+  EXPECT_EQ(2, db.records());
+  // A change is.
+  EXPECT_TRUE(db.add(power, 3));
+  EXPECT_EQ(3, db.lookup(power));
+  EXPECT_EQ(3, db.records());
+  EXPECT_EQ(2, db.pending());
+  EXPECT_TRUE(db.remove(mute));
+  EXPECT_EQ(kCodeDbNone, db.lookup(mute));
+  EXPECT_EQ(4, db.records());
+  EXPECT_TRUE(db.remove(mute));  // Already gone.
+  EXPECT_EQ(4, db.records());
+
+  // The RAM index only holds so many.
+  EXPECT_TRUE(db.add(100, 100));
+  EXPECT_TRUE(db.add(101, 101));
+  EXPECT_FALSE(db.add(102, 102));
+  EXPECT_EQ(kCodeDbNone, db.lookup(102));
+  EXPECT_TRUE(db.add(101, 5));  // Replacing one is fine.
+  EXPECT_EQ(4, db.pending());
+
+  // Everything is found again when the store is re-read.
+  IRcodeDb db2(&store, 4);
+  ASSERT_TRUE(db2.begin());
+  EXPECT_EQ(3, db2.lookup(power));
+  EXPECT_EQ(kCodeDbNone, db2.lookup(mute));
+  EXPECT_EQ(100, db2.lookup(100));
+  EXPECT_EQ(5, db2.lookup(101));
+  // But not if it can't hold them all.
+  IRcodeDb small(&store, 2);
+  EXPECT_FALSE(small.begin());
+  EXPECT_EQ(kCodeDbNone, small.lookup(100));
+
+  // Compacting.
+  IRcodeDbRamStore compacted(64 * kCodeDbRecordSize);
+  EXPECT_FALSE(db.compact(&store));  // Not to itself.
+  ASSERT_TRUE(db.compact(&compacted));
+  EXPECT_EQ(3, db.records());  // Mute is gone.
+  EXPECT_EQ(0, db.pending());
+  EXPECT_EQ(db.records(), db._sorted);
+  EXPECT_EQ(3, db.lookup(power));
+  EXPECT_EQ(kCodeDbNone, db.lookup(mute));
+  EXPECT_EQ(100, db.lookup(100));
+  EXPECT_EQ(5, db.lookup(101));
+  EXPECT_TRUE(db.add(102, 102));  // There's room again.
+  EXPECT_EQ(102, db.lookup(102));
+  EXPECT_TRUE(db.add(100, 6));  // Overrides the sorted run.
+  EXPECT_EQ(6, db.lookup(100));
+  EXPECT_FALSE(db.compact(&compacted));  // Must be empty.
+}
+
+TEST(TestIRcodeDb, Large) {
+  const uint32_t n = 5000;
+  IRcodeDbRamStore store((n + 16) * kCodeDbRecordSize);
+  IRcodeDbRamStore compacted(n * kCodeDbRecordSize);
+  IRcodeDb db(&store, 16);
+  ASSERT_TRUE(db.begin());
+  // Fill it in batches, compacting each time the RAM index is full.
+  IRcodeDbRamStore *stores[2] = {&store, &compacted};
+  uint8_t current = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    const uint64_t key = IRcodeDb::key(decode_type_t::NEC, 32, i * 7919);
+    if (!db.add(key, i)) {
+      // Swap stores. The old one is emptied for next time.
+      stores[current ^ 1]->_size = 0;
+      ASSERT_TRUE(db.compact(stores[current ^ 1]));
+      current ^= 1;
+      ASSERT_TRUE(db.add(key, i));
+    }
+  }
+  EXPECT_EQ(n, db.records());
+  for (uint32_t i = 0; i < n; i += 97)
+    EXPECT_EQ(i, db.lookup(IRcodeDb::key(decode_type_t::NEC, 32, i * 7919)));
+  EXPECT_EQ(kCodeDbNone,
+            db.lookup(IRcodeDb::key(decode_type_t::NEC, 32, 7918)));
+}
+
+TEST(TestIRcodeDb, Damage) {
+  IRcodeDbRamStore store(16 * kCodeDbRecordSize);
+  IRcodeDb db(&store);
+  ASSERT_TRUE(db.begin());
+  EXPECT_TRUE(db.add(1, 10));
+  EXPECT_TRUE(db.add(2, 20));
+  EXPECT_TRUE(db.add(3, 30));
+  // A damaged record is ignored.
+  store._buf[kCodeDbRecordSize + 8] ^= 1;
+  ASSERT_TRUE(db.begin());
+  EXPECT_EQ(10, db.lookup(1));
+  EXPECT_EQ(kCodeDbNone, db.lookup(2));
+  EXPECT_EQ(30, db.lookup(3));
+  // A partly written one makes the store unusable, until it is compacted.
+  store._buf[kCodeDbRecordSize + 8] ^= 1;
+  const uint8_t partial[3] = {1, 2, 3};
+  EXPECT_TRUE(store.append(partial, 3));
+  EXPECT_FALSE(db.begin());
+  EXPECT_FALSE(db.add(4, 40));
+  EXPECT_EQ(kCodeDbNone, db.lookup(1));
+}
+
+TEST(TestIRcodeDb, FileStore) {
+  const char *path = "IRcodeDb_test.db";
+  remove(path);
+  {
+    IRcodeDbFileStore store(path);
+    ASSERT_TRUE(store.isOpen());
+    EXPECT_EQ(0, store.size());
+    IRcodeDb db(&store);
+    ASSERT_TRUE(db.begin());
+    EXPECT_TRUE(db.add(IRcodeDb::key(decode_type_t::SONY, 12, 0x123), 1));
+    EXPECT_TRUE(db.add(IRcodeDb::key(decode_type_t::RC5, 12, 0x456), 2));
+    EXPECT_EQ(2 * kCodeDbRecordSize, store.size());
+  }
+  // It is still there when opened again.
+  IRcodeDbFileStore store(path);
+  ASSERT_TRUE(store.isOpen());
+  IRcodeDb db(&store);
+  ASSERT_TRUE(db.begin());
+  EXPECT_EQ(2, db.records());
+  EXPECT_EQ(1, db.lookup(IRcodeDb::key(decode_type_t::SONY, 12, 0x123)));
+  EXPECT_EQ(2, db.lookup(IRcodeDb::key(decode_type_t::RC5, 12, 0x456)));
+  EXPECT_TRUE(db.add(IRcodeDb::key(decode_type_t::SONY, 12, 0x123), 3));
+  EXPECT_EQ(3, db.lookup(IRcodeDb::key(decode_type_t::SONY, 12, 0x123)));
+  remove(path);
+  EXPECT_FALSE(IRcodeDbFileStore("no/such/dir/IRcodeDb_test.db").isOpen());
+}
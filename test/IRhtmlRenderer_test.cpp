@@ -0,0 +1,246 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <string>
+#include <vector>
+#include "IRac.h"
+#include "IRhtmlRenderer.h"
+#include "IRremoteESP8266.h"
+#include "gtest/gtest.h"
+
+// Tests for IRhtmlRenderer.
+
+/// A stand-in for a web server. It records each chunk written to it.
+class FakeServer {
+ public:
+  std::string page;  ///< Everything written so far.
+  std::vector<uint16_t> chunks;  ///< The size of each chunk, in order.
+  static FakeServer *active;  ///< The one being written to.
+
+  FakeServer(void) { active = this; }
+
+  static void write(const char *data, const uint16_t length) {
+    active->page.append(data, length);
+    active->chunks.push_back(length);
+  }
+};
+FakeServer *FakeServer::active = NULL;
+
+/// The values for the fields used in the tests below.
+void testFields(IRhtmlRenderer *html, void *arg, const uint16_t field) {
+  switch (field) {
+    case 0: html->print("zero"); break;
+    case 1: html->printNumber(*reinterpret_cast<int32_t *>(arg)); break;
+    case 12: html->print('!'); break;
+    default: html->print("?");
+  }
+}
+
+TEST(TestIRhtmlRenderer, Render) {
+  FakeServer server;
+  IRhtmlRenderer html(FakeServer::write);
+  int32_t arg = -42;
+  html.render("<p>{0} & {1}</p>{12}{0", testFields, &arg);
+  // Nothing is written until the buffer fills, or it is flushed.
+  EXPECT_EQ("", server.page);
+  EXPECT_EQ(20, html.length());
+  html.flush();
+  EXPECT_EQ("<p>zero & -42</p>!{0", server.page);
+  EXPECT_EQ(1, server.chunks.size());
+
+  // Things that aren't fields are left alone.
+  server.page.clear();
+  html.render("function x() { return {a:1}; }{} {7 }{99}", testFields, &arg);
+  html.flush();
+  EXPECT_EQ("function x() { return {a:1}; }{} {7 }?", server.page);
+
+  // No callback, no values.
+  server.page.clear();
+  html.render("a{0}b");
+  html.printP("{0}");
+  html.flush();
+  EXPECT_EQ("ab{0}", server.page);
+  // Flushing with nothing to write does nothing.
+  server.chunks.clear();
+  html.flush();
+  EXPECT_EQ(0, server.chunks.size());
+}
+
+TEST(TestIRhtmlRenderer, Print) {
+  FakeServer server;
+  IRhtmlRenderer html(FakeServer::write);
+  html.printNumber(0);
+  html.print(' ');
+  html.printNumber(2147483647);
+  html.print(' ');
+  html.printNumber(-2147483647 - 1);
+  html.print(String(" <b>"));
+  html.printEscaped("<a href='x'>(1 - 2)</a> #&;!={}");
+  html.flush();
+  EXPECT_EQ(
+      "0 2147483647 -2147483648 <b>"
+      "&lt;a href&#equals;&apos;x&apos;&gt;&lpar;1 &dash; 2&rpar;&lt;/a&gt; "
+      "&num;&amp;&semi;&excl;&#equals;&lcub;&rcub;",
+      server.page);
+  EXPECT_EQ(irutils::htmlEscape("<a href='x'>(1 - 2)</a> #&;!={}"),
+            server.page.substr(28));
+}
+
+TEST(TestIRhtmlRenderer, OutputIsChunked) {
+  FakeServer server;
+  IRhtmlRenderer html(FakeServer::write);
+  std::string expected;
+  for (uint16_t i = 0; i < 300; i++) {
+    html.print("0123456789");
+    html.render("{0}", testFields);
+    expected += "0123456789zero";
+  }
+  EXPECT_EQ(expected.size(), html.length());
+  html.flush();
+  EXPECT_EQ(expected, server.page);
+  ASSERT_EQ(9, server.chunks.size());
+  for (uint8_t i = 0; i < 8; i++)
+    EXPECT_EQ(kHtmlRendererBufferSize, server.chunks[i]);
+  EXPECT_EQ(4200 - 8 * kHtmlRendererBufferSize, server.chunks[8]);
+}
+
+TEST(TestIRhtmlRenderer, Options) {
+  EXPECT_EQ(
+      "<option value='Off'>Off</option><option value='On'>On</option>",
+      IRhtmlRenderer::boolOptions());
+  EXPECT_EQ(
+      "<option value='0'>0</option><option value='1'>1</option>"
+      "<option value='2'>2</option>",
+      IRhtmlRenderer::uintOptions(3));
+  EXPECT_EQ("", IRhtmlRenderer::uintOptions(0));
+  EXPECT_EQ(
+      "<option value='-1'>Default</option><option value='0'>Unknown</option>"
+      "<option value='1'>1</option><option value='2'>2</option>"
+      "<option value='3'>3</option><option value='4'>4</option>"
+      "<option value='5'>5</option><option value='6'>6</option>",
+      IRhtmlRenderer::modelOptions());
+  EXPECT_EQ(
+      "<option value='Off'>Off</option><option value='Auto'>Auto</option>"
+      "<option value='Cool'>Cool</option><option value='Heat'>Heat</option>"
+      "<option value='Dry'>Dry</option>"
+      "<option value='fan_only'>fan_only</option>",
+      IRhtmlRenderer::modeOptions());
+
+  // Protocols.
+  const String simple = IRhtmlRenderer::protocolOptions(true);
+  const String complex = IRhtmlRenderer::protocolOptions(false);
+  const String climate = IRhtmlRenderer::climateProtocolOptions();
+  EXPECT_EQ(0, simple.find("<option value='1'>RC5</option>"));
+  EXPECT_NE(std::string::npos, simple.find("<option value='3'>NEC</option>"));
+  EXPECT_EQ(std::string::npos, simple.find(">RAW<"));
+  EXPECT_EQ(std::string::npos, simple.find(">GLOBALCACHE<"));
+  EXPECT_EQ(std::string::npos, simple.find(">DAIKIN<"));
+  EXPECT_NE(std::string::npos, complex.find(">DAIKIN<"));
+  EXPECT_EQ(std::string::npos, complex.find(">NEC<"));
+  EXPECT_EQ(std::string::npos, climate.find(">NEC<"));
+  EXPECT_NE(std::string::npos, climate.find(">COOLIX<"));
+  EXPECT_NE(std::string::npos, climate.find(">DAIKIN<"));
+}
+
+TEST(TestIRhtmlRenderer, Select) {
+  FakeServer server;
+  IRhtmlRenderer html(FakeServer::write);
+  const String models = IRhtmlRenderer::modelOptions();
+  html.printSelect("model", IRhtmlRenderer::uintOptions(3), "1");
+  html.print('|');
+  html.printOptions(models, "-1");
+  html.print('|');
+  // Only an exact match is selected. i.e. Not "-1".
+  html.printOptions(models, "1");
+  html.print('|');
+  // Nothing matches.
+  html.printOptions(IRhtmlRenderer::uintOptions(2), "7");
+  html.print('|');
+  html.printOptions(IRhtmlRenderer::uintOptions(2), "");
+  html.flush();
+  EXPECT_EQ(
+      "<select name='model'>"
+          "<option value='0'>0</option>"
+          "<option value='1' selected='selected'>1</option>"
+          "<option value='2'>2</option>"
+      "</select>|"
+      "<option value='-1' selected='selected'>Default</option>"
+          "<option value='0'>Unknown</option>"
+          "<option value='1'>1</option><option value='2'>2</option>"
+          "<option value='3'>3</option><option value='4'>4</option>"
+          "<option value='5'>5</option><option value='6'>6</option>|"
+      "<option value='-1'>Default</option>"
+          "<option value='0'>Unknown</option>"
+          "<option value='1' selected='selected'>1</option>"
+          "<option value='2'>2</option>"
+          "<option value='3'>3</option><option value='4'>4</option>"
+          "<option value='5'>5</option><option value='6'>6</option>|"
+      "<option value='0'>0</option><option value='1'>1</option>|"
+      "<option value='0'>0</option><option value='1'>1</option>",
+      server.page);
+}
+
+/// A cut down A/C page, in the style of IRMQTTServer's.
+const char kTestAcPage[] =
+    "<table>"
+    "<tr><td>Protocol</td><td>{0}</td></tr>"
+    "<tr><td>Power</td><td>{1}</td></tr>"
+    "<tr><td>Mode</td><td>{2}</td></tr>"
+    "<tr><td>Temp</td><td><input type='number' value='{3}'></td></tr>"
+    "</table>";
+
+void testAcFields(IRhtmlRenderer *html, void *arg, const uint16_t field) {
+  const stdAc::state_t *state = reinterpret_cast<stdAc::state_t *>(arg);
+  switch (field) {
+    case 0:
+      html->printSelect("protocol", IRhtmlRenderer::climateProtocolOptions(),
+                        uint64ToString(state->protocol));
+      break;
+    case 1:
+      html->printSelect("power", IRhtmlRenderer::boolOptions(),
+                        IRac::boolToString(state->power));
+      break;
+    case 2:
+      html->printSelect("mode", IRhtmlRenderer::modeOptions(),
+                        IRac::opmodeToString(state->mode));
+      break;
+    case 3:
+      html->printNumber(state->degrees);
+      break;
+  }
+}
+
+TEST(TestIRhtmlRenderer, GoldenAcPage) {
+  FakeServer server;
+  IRhtmlRenderer html(FakeServer::write);
+  stdAc::state_t state;
+  IRac::initState(&state);
+  state.protocol = decode_type_t::DAIKIN;
+  state.power = true;
+  state.mode = stdAc::opmode_t::kHeat;
+  state.degrees = 24;
+  html.render(kTestAcPage, testAcFields, &state);
+  html.flush();
+  const std::string page = server.page;
+  const std::string protocols = IRhtmlRenderer::climateProtocolOptions();
+  const std::string daikin = "<option value='16'>DAIKIN</option>";
+  const size_t split = protocols.find(daikin) + daikin.size() - 16;
+  EXPECT_EQ(
+      "<table>"
+      "<tr><td>Protocol</td><td><select name='protocol'>" +
+          protocols.substr(0, split) + " selected='selected'" +
+          protocols.substr(split) + "</select></td></tr>"
+      "<tr><td>Power</td><td><select name='power'>"
+          "<option value='Off'>Off</option>"
+          "<option value='On' selected='selected'>On</option>"
+          "</select></td></tr>"
+      "<tr><td>Mode</td><td><select name='mode'>"
+          "<option value='Off'>Off</option><option value='Auto'>Auto</option>"
+          "<option value='Cool'>Cool</option>"
+          "<option value='Heat' selected='selected'>Heat</option>"
+          "<option value='Dry'>Dry</option>"
+          "<option value='fan_only'>fan_only</option>"
+          "</select></td></tr>"
+      "<tr><td>Temp</td><td><input type='number' value='24'></td></tr>"
+      "</table>",
+      page);
+}
@@ -1,10 +1,12 @@
 // Copyright 2017 David Conran
 
+#include <vector>
 #include "IRrecv_test.h"
 #include "IRrecv.h"
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
 #include "IRsend_test.h"
+#include "ir_Daikin.h"
 #include "gtest/gtest.h"
 
 // Tests for the IRrecv object.
@@ -604,6 +606,63 @@ TEST(TestMatchData, ArbitraryEncoded) {
   ASSERT_FALSE(result.success);
 }
 
+// `matchBytesSliced()` is always built for the tests, but `matchBytes()` only
+// uses it if ENABLE_SLICED_MATCH is set. So this compares it to the bit by
+// bit matching the ESP8266 & ESP32 use.
+TEST(TestMatchBytes, SlicedIsBitExact) {
+  IRrecv irrecv(1);
+  uint32_t seed = 1;
+  // A tiny LCG, so the test is repeatable everywhere.
+  auto rand = [&seed](const uint32_t limit) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % limit;
+  };
+  const uint16_t kMaxBytes = 40;
+  uint16_t buf[kMaxBytes * 16 + 1];
+  uint8_t sliced[kMaxBytes];
+  uint8_t scalar[kMaxBytes];
+  uint16_t matched = 0;
+  for (uint16_t n = 0; n < 4000; n++) {
+    const uint16_t nbytes = 1 + rand(kMaxBytes);
+    const uint16_t onemark = 300 + rand(600);
+    const uint32_t onespace = 900 + rand(1200);
+    const uint16_t zeromark = rand(2) ? onemark : 300 + rand(600);
+    const uint32_t zerospace = rand(2) ? 300 + rand(600) : onespace;
+    const uint8_t tolerance = rand(2) ? kUseDefTol : rand(60);
+    const int16_t excess = rand(2) ? kMarkExcess : (int16_t)rand(200) - 100;
+    const bool MSBfirst = rand(2);
+    const bool lastspace = rand(2);
+    const uint16_t remaining = nbytes * 16 + 1 - rand(2);
+    // Mostly good timings, with the odd one that is a bit or a lot off.
+    const uint8_t noise = rand(4) ? 8 : 40;
+    for (uint16_t i = 0; i < nbytes * 8; i++) {
+      const bool one = rand(2);
+      const uint32_t mark = one ? onemark : zeromark;
+      const uint32_t space = one ? onespace : zerospace;
+      buf[i * 2] = mark * (100 - noise / 2 + rand(noise)) / 100 / kRawTick;
+      buf[i * 2 + 1] = space * (100 - noise / 2 + rand(noise)) / 100 /
+          kRawTick;
+    }
+    buf[nbytes * 16] = rand(2) ? 0 : rand(10000);
+    memset(sliced, 0, sizeof(sliced));
+    memset(scalar, 0, sizeof(scalar));
+    const uint16_t used = irrecv.matchBytesSliced(
+        buf, sliced, remaining, nbytes, onemark, onespace, zeromark,
+        zerospace, tolerance, excess, MSBfirst, lastspace);
+    ASSERT_EQ(irrecv.matchBytes(buf, scalar, remaining, nbytes, onemark,
+                                onespace, zeromark, zerospace, tolerance,
+                                excess, MSBfirst, lastspace),
+              used) << "Iteration " << n;
+    if (used) {
+      matched++;
+      ASSERT_EQ(0, memcmp(scalar, sliced, nbytes)) << "Iteration " << n;
+    }
+  }
+  // Make sure both successes & failures were compared.
+  EXPECT_LT(500, matched);
+  EXPECT_GT(3500, matched);
+}
+
 TEST(TestMatchGeneric, NormalWithNoAtleast) {
   IRsendTest irsend(0);
   IRrecv irrecv(1);
@@ -2019,3 +2078,726 @@ TEST(TestMatchManchesterData, SimulateLongFooter) {
   EXPECT_EQ("f38000d50m1000s2000m1000s1000m2000s5000",
             irsend.outputStr());
 }
+
+/// Capture a message, as if our receiver heard it. i.e. Without the trailing
+/// gap, as a real capture doesn't include it.
+void captureNEC(IRsendTest *irsend, const uint32_t data) {
+  irsend->reset();
+  irsend->sendNEC(data);
+  irsend->makeDecodeResult();
+  irsend->capture.rawlen--;
+}
+
+TEST(TestIRrecvEcho, IgnoresWhatWeSent) {
+  uint16_t log[256];
+  IRsendLowLevelTest tx(0);  // Uses the real mark() & space().
+  tx.begin();
+  tx.setEchoLog(log, 256);
+  IRsendTest heard(0);  // What the receiver hears.
+  heard.begin();
+  IRrecv irrecv(0);
+  irrecv.setEchoSource(&tx);
+
+  tx.sendNEC(0x20DF10EF);
+  // Something else is still decoded.
+  captureNEC(&heard, 0x20DF906F);
+  ASSERT_TRUE(irrecv.decode(&heard.capture));
+  EXPECT_EQ(decode_type_t::NEC, heard.capture.decode_type);
+  EXPECT_EQ(0x20DF906F, heard.capture.value);
+  // Our own message isn't.
+  captureNEC(&heard, 0x20DF10EF);
+  EXPECT_FALSE(irrecv.decode(&heard.capture));
+  // But the same message again is, as it must be a real one this time.
+  captureNEC(&heard, 0x20DF10EF);
+  ASSERT_TRUE(irrecv.decode(&heard.capture));
+  EXPECT_EQ(0x20DF10EF, heard.capture.value);
+
+  // Without an echo source, nothing is ignored.
+  tx.sendNEC(0x20DF10EF);
+  irrecv.setEchoSource(NULL);
+  captureNEC(&heard, 0x20DF10EF);
+  EXPECT_TRUE(irrecv.decode(&heard.capture));
+}
+
+TEST(TestIRrecvEcho, EachRepeatIsIgnoredOnce) {
+  uint16_t log[256];
+  IRsendLowLevelTest tx(0);
+  tx.begin();
+  tx.setEchoLog(log, 256);
+  IRsendTest heard(0);
+  heard.begin();
+  IRrecv irrecv(0);
+  irrecv.setEchoSource(&tx);
+
+  tx.sendSony(0x240, kSony12Bits, kSonyMinRepeat);  // 3 frames.
+  for (uint16_t i = 0; i <= kSonyMinRepeat + 1; i++) {
+    heard.reset();
+    heard.sendSony(0x240, kSony12Bits, 0);
+    heard.makeDecodeResult();  // Including the gap after it, which is fine.
+    if (i <= kSonyMinRepeat) {
+      EXPECT_FALSE(irrecv.decode(&heard.capture)) << "Frame " << i;
+    } else {  // We only sent three.
+      EXPECT_TRUE(irrecv.decode(&heard.capture));
+      EXPECT_EQ(decode_type_t::SONY, heard.capture.decode_type);
+    }
+  }
+}
+
+TEST(TestIRrecvEcho, OnlyRecentAndWholeEchos) {
+  uint16_t log[256];
+  IRsendLowLevelTest tx(0);
+  tx.begin();
+  tx.setEchoLog(log, 256);
+  IRsendTest heard(0);
+  heard.begin();
+  IRrecv irrecv(0);
+  irrecv.setEchoSource(&tx);
+
+  // Too long ago to be an echo.
+  tx.sendNEC(0x20DF10EF);
+  IRtimer::add(kEchoTimeout + 200000);  // Plus the last gap sent.
+  captureNEC(&heard, 0x20DF10EF);
+  EXPECT_TRUE(irrecv.decode(&heard.capture));
+
+  // A capture that is only part of what we sent isn't an echo.
+  tx.sendNEC(0x20DF10EF);
+  captureNEC(&heard, 0x20DF10EF);
+  heard.capture.rawlen -= 2;  // Missing the last bit & footer.
+  EXPECT_FALSE(irrecv.matchEcho(&heard.capture));
+
+  // Sending starts a new record, once the old one is stale.
+  IRtimer::add(kEchoTimeout + 200000);  // Plus the last gap sent.
+  tx.sendNEC(0x1);
+  captureNEC(&heard, 0x1);
+  EXPECT_TRUE(irrecv.matchEcho(&heard.capture));
+
+  // A log too small for the message only covers the start of it.
+  uint16_t small[8];
+  tx.setEchoLog(small, 8);
+  tx.sendNEC(0x20DF10EF);
+  captureNEC(&heard, 0x20DF10EF);
+  EXPECT_TRUE(irrecv.decode(&heard.capture));
+
+  // Turning the log off.
+  tx.setEchoLog(NULL, 8);
+  tx.sendNEC(0x20DF10EF);
+  captureNEC(&heard, 0x20DF10EF);
+  EXPECT_TRUE(irrecv.decode(&heard.capture));
+}
+
+TEST(TestIRrecvDuplicates, DropsRepeatedFrames) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  irrecv.setDuplicateWindow(250);
+
+  // A remote sending a Sony message three times, ~45ms apart.
+  for (uint8_t i = 0; i < 3; i++) {
+    irsend.reset();
+    irsend.sendSony(0x240, kSony12Bits, 0);
+    irsend.makeDecodeResult();
+    if (i == 0) {
+      ASSERT_TRUE(irrecv.decode(&irsend.capture));
+      EXPECT_EQ(decode_type_t::SONY, irsend.capture.decode_type);
+      EXPECT_FALSE(irsend.capture.repeat);
+    } else {
+      EXPECT_FALSE(irrecv.decode(&irsend.capture)) << "Frame " << i;
+    }
+  }
+  // A different message isn't a duplicate.
+  irsend.reset();
+  irsend.sendSony(0x241, kSony12Bits, 0);
+  irsend.makeDecodeResult();
+  EXPECT_TRUE(irrecv.decode(&irsend.capture));
+  // Nor is the same size & value with a different protocol.
+  irsend.reset();
+  irsend.sendSony(0x240, kSony15Bits, 0);
+  irsend.makeDecodeResult();
+  EXPECT_TRUE(irrecv.decode(&irsend.capture));
+
+  // After the window, it is new again. The window starts when it is first
+  // seen, so holding a button down still produces a message every so often.
+  IRtimer::add(250000);
+  irsend.reset();
+  irsend.sendSony(0x240, kSony12Bits, 0);
+  irsend.makeDecodeResult();
+  EXPECT_TRUE(irrecv.decode(&irsend.capture));
+}
+
+TEST(TestIRrecvDuplicates, ForgetsBeforeTheTimerWraps) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  irrecv.setDuplicateWindow(250);
+  // Fill the cache. The one we care about is the last.
+  for (uint16_t value = 0x243; value >= 0x240; value--) {
+    irsend.reset();
+    irsend.sendSony(value, kSony12Bits, 0);
+    irsend.makeDecodeResult();
+    ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  }
+  // Polling after the window forgets them all. (Something else arrives here.)
+  IRtimer::add(300000);
+  irsend.reset();
+  irsend.sendSony(0x244, kSony12Bits, 0);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  // ~71 minutes later, the uSecond timer of the first one has wrapped around,
+  // & would say it was only seen 100ms ago. It must still be new.
+  IRtimer::add(UINT32_MAX - 200000);
+  irsend.reset();
+  irsend.sendSony(0x240, kSony12Bits, 0);
+  irsend.makeDecodeResult();
+  EXPECT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_FALSE(irsend.capture.repeat);
+}
+
+TEST(TestIRrecvDuplicates, FlagOnlyAndStates) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  irrecv.setDuplicateWindow(250, false);  // Only flag them.
+  const uint8_t state[kKelvinatorStateLength] = {
+      0x19, 0x0B, 0x80, 0x50, 0x00, 0x00, 0x00, 0xE0,
+      0x19, 0x0B, 0x80, 0x70, 0x00, 0x00, 0x10, 0xF0};
+  irsend.reset();
+  irsend.sendKelvinator(state);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::KELVINATOR, irsend.capture.decode_type);
+  EXPECT_FALSE(irsend.capture.repeat);
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_TRUE(irsend.capture.repeat);
+  // A different state isn't a duplicate.
+  uint8_t other[kKelvinatorStateLength];
+  memcpy(other, state, kKelvinatorStateLength);
+  other[1] = 0x0C;
+  other[7] = 0xF0;
+  irsend.reset();
+  irsend.sendKelvinator(other);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_FALSE(irsend.capture.repeat);
+
+  // Only the most recent few are remembered.
+  for (uint8_t i = 0; i < kDuplicateCacheSize; i++) {
+    irsend.reset();
+    irsend.sendNEC(i);
+    irsend.makeDecodeResult();
+    ASSERT_TRUE(irrecv.decode(&irsend.capture));
+    EXPECT_FALSE(irsend.capture.repeat);
+  }
+  irsend.reset();
+  irsend.sendKelvinator(state);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_FALSE(irsend.capture.repeat);
+
+  // Turned off.
+  irrecv.setDuplicateWindow(0);
+  EXPECT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_FALSE(irsend.capture.repeat);
+}
+
+TEST(TestIRrecvLearning, PulseDistance) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  learned_code_t code;
+  ASSERT_TRUE(irrecv.analyseRaw(&irsend.capture, &code));
+  // Near enough, given the resolution of a capture.
+  EXPECT_NEAR(9000, code.hdrmark, kRawTick * 20);
+  EXPECT_NEAR(4500, code.hdrspace, kRawTick * 20);
+  EXPECT_NEAR(560, code.onemark, kRawTick * 20);
+  EXPECT_NEAR(1690, code.onespace, kRawTick * 20);
+  EXPECT_NEAR(560, code.zeromark, kRawTick * 20);
+  EXPECT_NEAR(560, code.zerospace, kRawTick * 20);
+  EXPECT_NEAR(560, code.footermark, kRawTick * 20);
+  EXPECT_LT(kLearnMinGap, code.gap);
+  EXPECT_EQ(32, code.nbits);
+  EXPECT_EQ(0, code.repeat);
+  EXPECT_EQ(0x80, code.data[0]);
+  EXPECT_EQ(0x7F, code.data[1]);
+  EXPECT_EQ(0x40, code.data[2]);
+  EXPECT_EQ(0xBF, code.data[3]);
+
+  // Sending it again should be the same message.
+  irsend.reset();
+  irsend.sendLearned(&code);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::NEC, irsend.capture.decode_type);
+  EXPECT_EQ(0x807F40BF, irsend.capture.value);
+}
+
+TEST(TestIRrecvLearning, PulseWidthWithRepeats) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  irsend.reset();
+  irsend.sendSony(0x240, kSony12Bits, 2);
+  irsend.makeDecodeResult();
+  learned_code_t code;
+  ASSERT_TRUE(irrecv.analyseRaw(&irsend.capture, &code));
+  EXPECT_EQ(2400, code.hdrmark);
+  EXPECT_EQ(600, code.hdrspace);
+  EXPECT_EQ(1200, code.onemark);
+  EXPECT_EQ(600, code.onespace);
+  EXPECT_EQ(600, code.zeromark);
+  EXPECT_EQ(600, code.zerospace);
+  // Sony has no footer, so the last bit's mark is used as one.
+  EXPECT_EQ(11, code.nbits);
+  EXPECT_EQ(600, code.footermark);
+  EXPECT_EQ(2, code.repeat);
+  EXPECT_LT(kLearnMinGap, code.gap);
+
+  irsend.reset();
+  irsend.sendLearned(&code);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::SONY, irsend.capture.decode_type);
+  EXPECT_EQ(kSony12Bits, irsend.capture.bits);
+  EXPECT_EQ(0x240, irsend.capture.value);
+}
+
+TEST(TestIRrecvLearning, LargeState) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  const uint8_t state[kMitsubishiACStateLength] = {
+      0x23, 0xCB, 0x26, 0x01, 0x00, 0x20, 0x08, 0x06, 0x30,
+      0x45, 0x67, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F};
+  irsend.reset();
+  irsend.sendMitsubishiAC(state);
+  irsend.makeDecodeResult();
+  learned_code_t code;
+  ASSERT_TRUE(irrecv.analyseRaw(&irsend.capture, &code));
+  EXPECT_EQ(kMitsubishiACBits, code.nbits);
+  EXPECT_EQ(1, code.repeat);
+  // 88 bytes instead of 583 raw timings.
+  EXPECT_GT(irsend.capture.rawlen * sizeof(uint16_t) / 10, sizeof(code));
+
+  irsend.reset();
+  irsend.sendLearned(&code);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::MITSUBISHI_AC, irsend.capture.decode_type);
+  EXPECT_STATE_EQ(state, irsend.capture.state, kMitsubishiACBits);
+}
+
+TEST(TestIRrecvLearning, CantLearn) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  learned_code_t code;
+  // Manchester coded.
+  irsend.reset();
+  irsend.sendRC6(0x1FFFF, kRC6Mode0Bits);
+  irsend.makeDecodeResult();
+  EXPECT_FALSE(irrecv.analyseRaw(&irsend.capture, &code));
+  // Frames that differ. i.e. A NEC message, then a NEC repeat.
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF, kNECBits, 1);
+  irsend.makeDecodeResult();
+  EXPECT_FALSE(irrecv.analyseRaw(&irsend.capture, &code));
+  // Too short.
+  irsend.reset();
+  irsend.mark(500);
+  irsend.makeDecodeResult();
+  EXPECT_FALSE(irrecv.analyseRaw(&irsend.capture, &code));
+  // Marks too long to send. i.e. Longer than 65535us.
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.analyseRaw(&irsend.capture, &code));
+  irsend.capture.rawbuf[1] = 70000 / kRawTick;  // The header mark.
+  EXPECT_FALSE(irrecv.analyseRaw(&irsend.capture, &code));
+  irsend.capture.rawbuf[1] = 9000 / kRawTick;
+  irsend.capture.rawbuf[irsend.capture.rawlen - 2] = 70000 / kRawTick;
+  EXPECT_FALSE(irrecv.analyseRaw(&irsend.capture, &code));
+  irsend.capture.rawbuf[irsend.capture.rawlen - 2] = 560 / kRawTick;
+  ASSERT_TRUE(irrecv.analyseRaw(&irsend.capture, &code));
+  for (uint16_t i = 3; i < irsend.capture.rawlen - 1; i += 2)
+    irsend.capture.rawbuf[i] = 70000 / kRawTick;  // Every data mark.
+  EXPECT_FALSE(irrecv.analyseRaw(&irsend.capture, &code));
+}
+
+TEST(TestDecodeHash, LogBuckets) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  EXPECT_EQ(kHashLegacy, irrecv.getHashMode());
+  irrecv.setHashMode(kHashLogBuckets);
+  EXPECT_EQ(kHashLogBuckets, irrecv.getHashMode());
+  irrecv.setHashMode(255);  // Unknown modes get the legacy one.
+  EXPECT_EQ(kHashLegacy, irrecv.getHashMode());
+
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decodeHash(&irsend.capture));
+  const uint64_t legacy = irsend.capture.value;
+  EXPECT_EQ(0, legacy >> 32);
+  irrecv.setHashMode(kHashLogBuckets);
+  ASSERT_TRUE(irrecv.decodeHash(&irsend.capture));
+  EXPECT_EQ(UNKNOWN, irsend.capture.decode_type);
+  EXPECT_EQ(irsend.capture.rawlen / 2, irsend.capture.bits);
+  const uint64_t hash = irsend.capture.value;
+  EXPECT_NE(legacy, hash);
+  EXPECT_NE(0, hash >> 32);  // It really is 64 bits.
+
+  // Timings that are all a bit off hash the same.
+  for (uint16_t i = 1; i < irsend.capture.rawlen; i++)
+    irsend.capture.rawbuf[i] = irsend.capture.rawbuf[i] * 108 / 100;
+  ASSERT_TRUE(irrecv.decodeHash(&irsend.capture));
+  EXPECT_EQ(hash, irsend.capture.value);
+  // As does a (remote with a) slightly faster clock.
+  irsend.makeDecodeResult();
+  for (uint16_t i = 1; i < irsend.capture.rawlen; i++)
+    irsend.capture.rawbuf[i] = irsend.capture.rawbuf[i] * 92 / 100;
+  ASSERT_TRUE(irrecv.decodeHash(&irsend.capture));
+  EXPECT_EQ(hash, irsend.capture.value);
+
+  // A single different bit doesn't.
+  irsend.reset();
+  irsend.sendNEC(0x807F40BE);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decodeHash(&irsend.capture));
+  EXPECT_NE(hash, irsend.capture.value);
+  // Nor does swapping a mark & a space.
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  const uint16_t mark = irsend.capture.rawbuf[3];
+  irsend.capture.rawbuf[3] = irsend.capture.rawbuf[4];
+  irsend.capture.rawbuf[4] = mark;
+  ASSERT_TRUE(irrecv.decodeHash(&irsend.capture));
+  EXPECT_NE(hash, irsend.capture.value);
+
+  // The threshold still applies.
+  irrecv.setUnknownThreshold(irsend.capture.rawlen + 1);
+  EXPECT_FALSE(irrecv.decodeHash(&irsend.capture));
+}
+
+// Make a capture look like it came from a sloppy receiver or remote.
+// i.e. Marks longer & spaces shorter by `excess` uSecs, then scaled by
+// `percent`.
+void distortCapture(decode_results *capture, const int16_t excess,
+                    const uint16_t percent) {
+  for (uint16_t i = 1; i < capture->rawlen; i++) {
+    int32_t usecs = capture->rawbuf[i] * kRawTick;
+    usecs += (i & 1) ? excess : -excess;
+    capture->rawbuf[i] = usecs * percent / 100 / kRawTick;
+  }
+}
+
+TEST(TestIRrecvAdaptiveTiming, LearnsExcess) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  EXPECT_FALSE(irrecv.getAdaptiveTiming());
+  timing_calibration_t table[kCalibrationSlots];
+  EXPECT_EQ(0, irrecv.getCalibration(table));
+
+  irsend.sendNEC(0x807F40BF);
+  // Marks are 150us too long, & spaces 150us too short. Too much for 10%.
+  irrecv.setTolerance(10);
+  irsend.makeDecodeResult();
+  distortCapture(&irsend.capture, 150, 100);
+  irrecv.decode(&irsend.capture);
+  EXPECT_NE(decode_type_t::NEC, irsend.capture.decode_type);
+
+  // Learn what this receiver does, with the usual tolerance.
+  irrecv.setTolerance(kTolerance);
+  irrecv.setAdaptiveTiming(true);
+  EXPECT_TRUE(irrecv.getAdaptiveTiming());
+  for (uint8_t i = 0; i < kCalibrationMinSamples; i++) {
+    irsend.makeDecodeResult();
+    distortCapture(&irsend.capture, 150, 100);
+    ASSERT_TRUE(irrecv.decode(&irsend.capture));
+    EXPECT_EQ(decode_type_t::NEC, irsend.capture.decode_type);
+  }
+  ASSERT_EQ(1, irrecv.getCalibration(table));
+  EXPECT_EQ(kCalibrationMinSamples, table[0].samples);
+  EXPECT_NEAR(150, table[0].excess, 5);
+  EXPECT_NEAR(kCalibrationUnity, table[0].scale, 5);
+
+  // Now 10% is enough.
+  irrecv.setTolerance(10);
+  irsend.makeDecodeResult();
+  distortCapture(&irsend.capture, 150, 100);
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::NEC, irsend.capture.decode_type);
+  EXPECT_EQ(0x807F40BF, irsend.capture.value);
+  // The usual timings aren't used any more, so a message from a better
+  // receiver doesn't match.
+  irsend.makeDecodeResult();
+  irrecv.decode(&irsend.capture);
+  EXPECT_NE(decode_type_t::NEC, irsend.capture.decode_type);
+
+  // Until it is all forgotten.
+  irrecv.setCalibration(NULL, 0);
+  EXPECT_EQ(0, irrecv.getCalibration(table));
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::NEC, irsend.capture.decode_type);
+}
+
+TEST(TestIRrecvAdaptiveTiming, LearnsScaleAndRestores) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  irrecv.setAdaptiveTiming(true);
+  // A remote with a clock that is 10% slow.
+  irsend.sendSAMSUNG(0xE0E09966);
+  for (uint8_t i = 0; i < 5; i++) {
+    irsend.makeDecodeResult();
+    distortCapture(&irsend.capture, 0, 110);
+    ASSERT_TRUE(irrecv.decode(&irsend.capture));
+    EXPECT_EQ(decode_type_t::SAMSUNG, irsend.capture.decode_type);
+  }
+  timing_calibration_t table[kCalibrationSlots];
+  ASSERT_EQ(1, irrecv.getCalibration(table));
+  EXPECT_EQ(5, table[0].samples);
+  EXPECT_NEAR(kCalibrationUnity * 110 / 100, table[0].scale, 5);
+  EXPECT_NEAR(0, table[0].excess, 5);
+
+  // Forget it, & be far more strict.
+  irrecv.setCalibration(NULL, 0);
+  irrecv.setTolerance(5);
+  irsend.makeDecodeResult();
+  distortCapture(&irsend.capture, 0, 110);
+  irrecv.decode(&irsend.capture);
+  EXPECT_NE(decode_type_t::SAMSUNG, irsend.capture.decode_type);
+  // Restore what was learnt. It is only used if adaptive timing is on.
+  irrecv.setAdaptiveTiming(false);
+  irrecv.setCalibration(table, kCalibrationSlots);
+  irrecv.decode(&irsend.capture);
+  EXPECT_NE(decode_type_t::SAMSUNG, irsend.capture.decode_type);
+  irrecv.setAdaptiveTiming(true);
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::SAMSUNG, irsend.capture.decode_type);
+  EXPECT_EQ(0xE0E09966, irsend.capture.value);
+}
+
+TEST(TestIRrecvAdaptiveTiming, RestoreLimitsWhatIsUsed) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  irrecv.setAdaptiveTiming(true);
+  irsend.sendSAMSUNG(0xE0E09966);
+  for (uint8_t i = 0; i < 2; i++) {
+    irsend.makeDecodeResult();
+    ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  }
+  timing_calibration_t table[kCalibrationSlots];
+  ASSERT_EQ(1, irrecv.getCalibration(table));
+  // A corrupt saved copy. e.g. A scaled header mark would wrap around.
+  table[0].scale = UINT16_MAX;
+  table[0].excess = INT16_MIN;
+  irrecv.setCalibration(table, 1);
+  ASSERT_EQ(1, irrecv.getCalibration(table));
+  EXPECT_EQ(kCalibrationUnity + kCalibrationMaxSkew, table[0].scale);
+  EXPECT_EQ(-kCalibrationMaxExcess, table[0].excess);
+  table[0].scale = 0;
+  table[0].excess = INT16_MAX;
+  irrecv.setCalibration(table, 1);
+  ASSERT_EQ(1, irrecv.getCalibration(table));
+  EXPECT_EQ(kCalibrationUnity - kCalibrationMaxSkew, table[0].scale);
+  EXPECT_EQ(kCalibrationMaxExcess, table[0].excess);
+}
+
+TEST(TestIRrecvAdaptiveTiming, OnlyLearnsFromAcceptedMessages) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  irrecv.setAdaptiveTiming(true);
+  timing_calibration_t table[kCalibrationSlots];
+  uint8_t state[kDaikinStateLength] = {
+      0x11, 0xDA, 0x27, 0x00, 0xC5, 0x00, 0x00, 0xD7, 0x11, 0xDA, 0x27, 0x00,
+      0x42, 0xE3, 0x0B, 0x42, 0x11, 0xDA, 0x27, 0x00, 0x00, 0x68, 0x32, 0x00,
+      0x30, 0x00, 0x00, 0x06, 0x60, 0x00, 0x00, 0xC1, 0x00, 0x00, 0x03};
+  irsend.sendDaikin(state);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  ASSERT_EQ(decode_type_t::DAIKIN, irsend.capture.decode_type);
+  ASSERT_EQ(1, irrecv.getCalibration(table));
+  EXPECT_EQ(3, table[0].samples);  // One per section.
+
+  // Its frames match the Daikin timings, but the checksum is wrong.
+  irrecv.setCalibration(NULL, 0);
+  state[kDaikinStateLength - 1]++;
+  irsend.reset();
+  irsend.sendDaikin(state);
+  irsend.makeDecodeResult();
+  irrecv.decode(&irsend.capture);
+  EXPECT_NE(decode_type_t::DAIKIN, irsend.capture.decode_type);
+  EXPECT_EQ(0, irrecv.getCalibration(table));
+}
+
+TEST(TestIRrecvAutoSize, Values) {
+  // Everything is enabled for the tests, so the largest needs win.
+  EXPECT_EQ(855, kRawBufAuto);  // HITACHI_AC424
+  EXPECT_EQ(101, kTimeoutMsAuto);  // LUTRON
+  EXPECT_LT(kRawBuf, kRawBufAuto);
+  EXPECT_LE(kRawBufAuto, 1024);  // IRMQTTServer etc's usual buffer size.
+}
+
+// Split a capture into what a receiver with a short timeout would capture.
+// i.e. A new capture after each space longer than `timeout` mSeconds.
+// Each one starts with the silence before it, & ends with a mark.
+std::vector<std::vector<uint16_t>> splitCapture(const decode_results *capture,
+                                                const uint8_t timeout) {
+  std::vector<std::vector<uint16_t>> result;
+  std::vector<uint16_t> section = {UINT16_MAX};
+  for (uint16_t i = kStartOffset; i < capture->rawlen; i++) {
+    if (!(i & 1) && capture->rawbuf[i] * kRawTick > timeout * 1000U) {
+      result.push_back(section);
+      section = {(uint16_t)capture->rawbuf[i]};
+    } else {
+      section.push_back((uint16_t)capture->rawbuf[i]);
+    }
+  }
+  if (section.size() > 1) result.push_back(section);
+  return result;
+}
+
+// Decode a capture made by `splitCapture()`.
+bool decodeSection(IRrecv *irrecv, std::vector<uint16_t> *section,
+                   decode_results *results) {
+  results->rawbuf = section->data();
+  results->rawlen = section->size();
+  results->overflow = false;
+  return irrecv->decode(results);
+}
+
+TEST(TestIRrecvAssembly, JoinsSplitMessages) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  IRDaikinESP ac(0);
+  ac.setTemp(23);
+  irsend.reset();
+  irsend.sendDaikin(ac.getRaw());
+  irsend.makeDecodeResult();
+  // Daikin has 29ms gaps, so a 15ms timeout splits it into four.
+  std::vector<std::vector<uint16_t>> sections = splitCapture(&irsend.capture,
+                                                             15);
+  ASSERT_EQ(4, sections.size());
+  decode_results results;
+
+  // Normally, none of them decode as Daikin.
+  for (uint8_t i = 0; i < sections.size(); i++)
+    EXPECT_FALSE(decodeSection(&irrecv, &sections[i], &results) &&
+                 results.decode_type == decode_type_t::DAIKIN);
+
+  // Joined together, they do.
+  ASSERT_TRUE(irrecv.setAssembly(kRawBufAuto));
+  for (uint8_t i = 0; i < sections.size() - 1; i++)
+    EXPECT_FALSE(decodeSection(&irrecv, &sections[i], &results) &&
+                 results.decode_type != decode_type_t::UNKNOWN);
+  ASSERT_TRUE(decodeSection(&irrecv, &sections.back(), &results));
+  EXPECT_EQ(decode_type_t::DAIKIN, results.decode_type);
+  EXPECT_EQ(kDaikinBits, results.bits);
+  EXPECT_STATE_EQ(ac.getRaw(), results.state, kDaikinBits);
+  EXPECT_EQ(0, irrecv._asm_sections);  // Used up.
+
+  // Junk just before it is skipped over.
+  std::vector<uint16_t> junk = {UINT16_MAX, 1000, 600, 1000};
+  decodeSection(&irrecv, &junk, &results);
+  sections[0][0] = 20000 / kRawTick;
+  for (uint8_t i = 0; i < sections.size() - 1; i++)
+    decodeSection(&irrecv, &sections[i], &results);
+  ASSERT_TRUE(decodeSection(&irrecv, &sections.back(), &results));
+  EXPECT_EQ(decode_type_t::DAIKIN, results.decode_type);
+
+  // A protocol with a leader & two sections, with a different timeout.
+  IRDaikin2 ac2(0);
+  irsend.reset();
+  irsend.sendDaikin2(ac2.getRaw());
+  irsend.makeDecodeResult();
+  sections = splitCapture(&irsend.capture, 20);
+  ASSERT_EQ(3, sections.size());
+  decodeSection(&irrecv, &sections[0], &results);
+  decodeSection(&irrecv, &sections[1], &results);
+  ASSERT_TRUE(decodeSection(&irrecv, &sections[2], &results));
+  EXPECT_EQ(decode_type_t::DAIKIN2, results.decode_type);
+  EXPECT_STATE_EQ(ac2.getRaw(), results.state, kDaikin2Bits);
+
+  // A whole message by itself is decoded as normal.
+  irsend.reset();
+  irsend.sendNEC(0x00FF00FF);
+  irsend.makeDecodeResult();
+  ASSERT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(decode_type_t::NEC, irsend.capture.decode_type);
+  EXPECT_EQ(0, irrecv._asm_sections);
+}
+
+TEST(TestIRrecvAssembly, Limits) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  IRDaikinESP ac(0);
+  irsend.reset();
+  irsend.sendDaikin(ac.getRaw());
+  irsend.makeDecodeResult();
+  std::vector<std::vector<uint16_t>> sections = splitCapture(&irsend.capture,
+                                                             15);
+  ASSERT_EQ(4, sections.size());
+  decode_results results;
+
+  // Sections too far apart aren't joined.
+  ASSERT_TRUE(irrecv.setAssembly(kRawBufAuto, 25));
+  for (uint8_t i = 0; i < sections.size(); i++)
+    EXPECT_FALSE(decodeSection(&irrecv, &sections[i], &results) &&
+                 results.decode_type == decode_type_t::DAIKIN);
+  EXPECT_EQ(1, irrecv._asm_sections);
+
+  // Nor are more than fit in the buffer.
+  ASSERT_TRUE(irrecv.setAssembly(irsend.capture.rawlen - 20));
+  for (uint8_t i = 0; i < sections.size(); i++)
+    EXPECT_FALSE(decodeSection(&irrecv, &sections[i], &results) &&
+                 results.decode_type == decode_type_t::DAIKIN);
+  EXPECT_GT(irrecv._asm_len, 0);
+  EXPECT_LE(irrecv._asm_len, irsend.capture.rawlen - 20);
+
+  // It can be turned off.
+  ASSERT_TRUE(irrecv.setAssembly(0));
+  EXPECT_EQ(NULL, irrecv._asm_buf);
+  for (uint8_t i = 0; i < sections.size(); i++)
+    EXPECT_FALSE(decodeSection(&irrecv, &sections[i], &results) &&
+                 results.decode_type == decode_type_t::DAIKIN);
+  EXPECT_EQ(0, irrecv._asm_sections);
+}
+
+TEST(TestIRrecvDecodeAs, OnlyThatProtocolsDecoder) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  IRrecv irrecv(0);
+  // A NEC message whose command isn't followed by its inverse.
+  irsend.sendNEC(0x12345678);
+  irsend.makeDecodeResult();
+  EXPECT_FALSE(irrecv.decodeAs(&irsend.capture, decode_type_t::NEC, kNECBits));
+  ASSERT_TRUE(irrecv.decodeAs(&irsend.capture, decode_type_t::NEC, kNECBits,
+                              false));
+  EXPECT_EQ(decode_type_t::NEC, irsend.capture.decode_type);
+  EXPECT_EQ(kNECBits, irsend.capture.bits);
+  EXPECT_EQ(0x12345678, irsend.capture.value);
+  // Other protocols' decoders aren't tried.
+  EXPECT_FALSE(irrecv.decodeAs(&irsend.capture, decode_type_t::SONY,
+                               kSony20Bits, false));
+  // Protocols that share a decoder decode as the one it finds.
+  ASSERT_TRUE(irrecv.decodeAs(&irsend.capture, decode_type_t::SHERWOOD,
+                              kNECBits, false));
+  EXPECT_EQ(decode_type_t::NEC, irsend.capture.decode_type);
+  // Nothing to decode with.
+  EXPECT_FALSE(irrecv.decodeAs(&irsend.capture, decode_type_t::UNKNOWN,
+                               kNECBits, false));
+  EXPECT_FALSE(irrecv.decodeAs(&irsend.capture, decode_type_t::PRONTO,
+                               kNECBits, false));
+  EXPECT_FALSE(irrecv.decodeAs(&irsend.capture,
+                               (decode_type_t)(kLastDecodeType + 1),
+                               kNECBits, false));
+}
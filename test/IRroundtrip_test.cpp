@@ -0,0 +1,348 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+// A generic send -> decode -> compare property test for every protocol.
+//
+// For every `decode_type_t` that `IRsend::send()` knows how to send, random
+// values/states of `IRsend::defaultBits()` size are sent (with the protocol's
+// `IRsend::minRepeats()`) via `IRsendTest`, decoded by that protocol's own
+// decoder via `IRrecv::decodeAs()`, and must come back exactly as they were
+// sent. Decoding isn't strict (e.g. No checksums), as the data is random.
+//
+// The protocols are spread across several processes, so thousands of cases
+// per protocol stay quick. The time spent in each phase is reported.
+//
+// Environment variables:
+//   IR_ROUNDTRIP_CASES: Nr. of cases per protocol. (Default: 200)
+//   IR_ROUNDTRIP_JOBS: Nr. of worker processes. (Default: Nr. of CPUs)
+//   IR_ROUNDTRIP_SEED: Random seed. (Default: 0)
+//   IR_ROUNDTRIP_VERBOSE: If set, report per-protocol timings.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "IRrecv.h"
+#include "IRrecv_test.h"
+#include "IRsend.h"
+#include "IRsend_test.h"
+#include "IRutils.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// The phases of a round trip we time.
+enum RoundTripPhase {
+  kPhaseGenerate = 0,
+  kPhaseSend,
+  kPhaseDecode,
+  kPhaseCompare,
+  kPhaseCount,  // Must be last.
+};
+
+const char * const kPhaseNames[kPhaseCount] = {
+    "generate", "send", "decode", "compare"};
+
+// What a worker reports back to the parent for each protocol.
+struct RoundTripResult {
+  int16_t protocol;
+  uint32_t cases;
+  uint32_t failures;
+  uint64_t nanos[kPhaseCount];
+  char first_failure[200];
+};
+
+uint32_t envOrDefault(const char *name, const uint32_t def) {
+  const char *str = getenv(name);
+  return (str != NULL && *str) ? strtoul(str, NULL, 10) : def;
+}
+
+uint64_t nanosSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+/// Some protocols can't be told apart from another one on the receiving end.
+/// @param[in] protocol The protocol that was sent.
+/// @return The protocol we expect it to be decoded as.
+decode_type_t decodesAs(const decode_type_t protocol) {
+  switch (protocol) {
+    case NEC_LIKE:
+    case SHERWOOD: return NEC;  // `decode()` decides if it is really NEC.
+    case SONY_38K: return SONY;  // Only the modulation frequency differs.
+    default: return protocol;
+  }
+}
+
+/// Turn random data into a message the protocol is actually able to carry.
+/// i.e. Fixed signatures or bits that the decoders rely on.
+/// @param[in] protocol The protocol to be sent.
+/// @param[in,out] value The random value to be sent.
+/// @param[in,out] state The random state to be sent.
+/// @param[in] nbits The nr. of bits to be sent.
+void makeValid(const decode_type_t protocol, uint64_t *value, uint8_t *state,
+               const uint16_t nbits) {
+  switch (protocol) {
+    case DENON:  // Sharp style, without the expansion or check bits set.
+      *value &= ~0b11ULL;
+      break;
+    case DOSHISHA:  // Only the last byte isn't a fixed signature.
+      *value = 0x800B304800 | (*value & 0xFF);
+      break;
+    case FUJITSU_AC:  // Signature bytes, & the long (full state) form.
+      state[0] = 0x14;
+      state[1] = 0x63;
+      state[5] = 0xFE;
+      state[kFujitsuAcStateLength - 1] = -sumBytes(
+          state + kFujitsuAcStateLengthShort,
+          kFujitsuAcStateLength - 1 - kFujitsuAcStateLengthShort);
+      break;
+    case LASERTAG:  // A leading 1 starts with a space, which can't be seen.
+      *value &= ~(1ULL << (nbits - 1));
+      break;
+    case LUTRON:  // Trailing 0s merge into a gap too long to be captured.
+      *value |= 1;
+      break;
+    case MWM:  // Commands have the nr. of payload bytes in the 1st byte.
+      state[0] = (state[0] & 0xF0) | (nbits / 8 - 3);
+      // A set MSB in the last byte is a space, which is lost in the gap.
+      state[nbits / 8 - 1] &= 0x7F;
+      break;
+    case RC5X:  // A clear MSB sets the field bit, making it a plain RC5 msg.
+      *value |= 1ULL << (nbits - 1);
+      break;
+    case SAMSUNG_AC:  // Signature bytes.
+      state[0] = 0x02;
+      state[2] = 0x0F;
+      break;
+    default:
+      break;
+  }
+}
+
+/// Run a number of random round trips for a single protocol.
+/// @param[in] protocol The protocol to test.
+/// @param[in] cases The nr. of random values/states to try.
+/// @param[in] seed The random seed for this protocol.
+/// @return The results of the run.
+RoundTripResult roundTrip(const decode_type_t protocol, const uint32_t cases,
+                          const uint32_t seed) {
+  RoundTripResult result = {};
+  result.protocol = protocol;
+  const uint16_t nbits = IRsend::defaultBits(protocol);
+  const bool isAC = hasACState(protocol);
+  const uint16_t nbytes = nbits / 8;
+  std::mt19937 rng(seed);
+  IRsendTest irsend(0);
+  IRrecv irrecv(0);
+  irsend.begin();
+  for (; result.cases < cases; result.cases++) {
+    // Generate
+    auto start = std::chrono::steady_clock::now();
+    uint64_t value = 0;
+    uint8_t state[kStateSizeMax] = {0};
+    if (isAC) {
+      for (uint16_t i = 0; i < nbytes; i++) state[i] = rng();
+    } else {
+      value = ((uint64_t)rng() << 32) | rng();
+      if (nbits < 64) value &= (1ULL << nbits) - 1;
+    }
+    makeValid(protocol, &value, state, nbits);
+    result.nanos[kPhaseGenerate] += nanosSince(start);
+    // Send
+    start = std::chrono::steady_clock::now();
+    irsend.reset();
+    bool sent = isAC ? irsend.send(protocol, state, nbytes)
+                     : irsend.send(protocol, value, nbits);
+    irsend.makeDecodeResult();
+    result.nanos[kPhaseSend] += nanosSince(start);
+    // Decode
+    start = std::chrono::steady_clock::now();
+    bool decoded = irrecv.decodeAs(&irsend.capture, protocol, nbits, false);
+    result.nanos[kPhaseDecode] += nanosSince(start);
+    // Compare
+    start = std::chrono::steady_clock::now();
+    bool same = sent && decoded &&
+        irsend.capture.decode_type == decodesAs(protocol) &&
+        irsend.capture.bits == nbits &&
+        (isAC ? !memcmp(irsend.capture.state, state, nbytes)
+              : irsend.capture.value == value);
+    result.nanos[kPhaseCompare] += nanosSince(start);
+    if (!same && !result.failures++) {
+      String sent_str = "0x";
+      if (isAC)
+        for (uint16_t i = 0; i < nbytes; i++) {
+          if (state[i] < 0x10) sent_str += '0';
+          sent_str += uint64ToString(state[i], 16);
+        }
+      else
+        sent_str += uint64ToString(value, 16);
+      snprintf(result.first_failure, sizeof(result.first_failure),
+               "%s: sent %s (%s) decoded as %s (%d bits, %s)",
+               typeToString(protocol).c_str(), sent_str.c_str(),
+               sent ? "ok" : "send failed",
+               typeToString(irsend.capture.decode_type).c_str(),
+               irsend.capture.bits, decoded ? "accepted" : "rejected");
+    }
+  }
+  return result;
+}
+
+/// Run round trips for every protocol, spread across `jobs` processes.
+/// @param[in] cases The nr. of cases per protocol.
+/// @param[in] jobs The nr. of worker processes.
+/// @param[in] seed The random seed.
+/// @return The results, one per protocol that can be sent.
+std::vector<RoundTripResult> roundTripAll(const uint32_t cases,
+                                          const uint16_t jobs,
+                                          const uint32_t seed) {
+  std::vector<decode_type_t> protocols;
+  for (int16_t i = 1; i <= kLastDecodeType; i++)
+    if (IRsend::defaultBits((decode_type_t)i))
+      protocols.push_back((decode_type_t)i);
+
+  std::vector<RoundTripResult> results;
+  std::vector<pid_t> pids;
+  std::vector<int> fds;
+  for (uint16_t job = 0; job < jobs; job++) {
+    int fd[2];
+    if (pipe(fd) != 0) break;
+    pid_t pid = fork();
+    if (pid == 0) {  // Worker.
+      close(fd[0]);
+      for (size_t i = job; i < protocols.size(); i += jobs) {
+        RoundTripResult result = roundTrip(protocols[i], cases,
+                                           seed + protocols[i]);
+        if (write(fd[1], &result, sizeof(result)) != sizeof(result)) _exit(1);
+      }
+      close(fd[1]);
+      _exit(0);
+    }
+    close(fd[1]);
+    if (pid < 0) {
+      close(fd[0]);
+      break;
+    }
+    pids.push_back(pid);
+    fds.push_back(fd[0]);
+  }
+  for (size_t i = 0; i < fds.size(); i++) {
+    RoundTripResult result;
+    while (read(fds[i], &result, sizeof(result)) == sizeof(result))
+      results.push_back(result);
+    close(fds[i]);
+    waitpid(pids[i], NULL, 0);
+  }
+  return results;
+}
+
+TEST(TestRoundTrip, EveryProtocol) {
+  const uint32_t cases = envOrDefault("IR_ROUNDTRIP_CASES", 200);
+  const uint32_t seed = envOrDefault("IR_ROUNDTRIP_SEED", 0);
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT(runtime/int)
+  const uint16_t jobs = std::max(
+      envOrDefault("IR_ROUNDTRIP_JOBS", cpus > 0 ? cpus : 1), (uint32_t)1);
+  const bool verbose = getenv("IR_ROUNDTRIP_VERBOSE") != NULL;
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<RoundTripResult> results = roundTripAll(cases, jobs, seed);
+  const double wall = nanosSince(start) / 1e9;
+
+  uint16_t expected = 0;
+  for (int16_t i = 1; i <= kLastDecodeType; i++)
+    if (IRsend::defaultBits((decode_type_t)i)) expected++;
+  ASSERT_EQ(expected, results.size()) << "A worker process failed.";
+
+  uint64_t total[kPhaseCount] = {0};
+  uint64_t total_cases = 0;
+  for (const RoundTripResult &result : results) {
+    EXPECT_EQ(0, result.failures)
+        << result.failures << " of " << result.cases << " failed. e.g. "
+        << result.first_failure;
+    EXPECT_EQ(cases, result.cases);
+    total_cases += result.cases;
+    for (uint8_t phase = 0; phase < kPhaseCount; phase++)
+      total[phase] += result.nanos[phase];
+    if (verbose) {
+      std::cout << std::setw(20) << std::left
+                << typeToString((decode_type_t)result.protocol) << std::right;
+      for (uint8_t phase = 0; phase < kPhaseCount; phase++)
+        std::cout << " " << kPhaseNames[phase] << " "
+                  << std::setw(8) << result.nanos[phase] / result.cases
+                  << "ns";
+      std::cout << std::endl;
+    }
+  }
+  std::cout << "Round trips: " << total_cases << " over " << results.size()
+            << " protocols, " << jobs << " job(s), " << wall << "s wall."
+            << std::endl << "Avg. per case:";
+  for (uint8_t phase = 0; phase < kPhaseCount; phase++)
+    std::cout << " " << kPhaseNames[phase] << " "
+              << total[phase] / std::max(total_cases, (uint64_t)1) << "ns";
+  std::cout << std::endl;
+}
+
+// Check `kCaptureNeeds` against what `IRsend` produces for each protocol.
+// i.e. A capture using a protocol's `timeout` still decodes, and it fits in
+// a buffer of its `bufsize`. Every enabled entry must be checked.
+TEST(TestIRrecvAutoSize, CaptureNeedsAreEnough) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(0, kRawBufAuto, kTimeoutMsAuto);
+  irsend.begin();
+  for (uint16_t i = 0; i < kCaptureNeedsSize; i++) {
+    const capture_needs_t needs = kCaptureNeeds[i];
+    if (!needs.enabled) continue;
+    const decode_type_t protocol = needs.protocol;
+    const String name = typeToString(protocol);
+    EXPECT_LE(needs.bufsize, kRawBufAuto) << name;
+    EXPECT_LE(needs.timeout, kTimeoutMsAuto) << name;
+    // MWM can't be sent via `IRsend::send()`, so use its estimated size.
+    // FUJITSU_AC has no default size, so use its largest.
+    uint16_t nbits = IRsend::defaultBits(protocol);
+    if (protocol == MWM) nbits = 16 * 8;
+    if (protocol == FUJITSU_AC) nbits = kFujitsuAcBits;
+    // All 0s & all 1s. i.e. The most entries for Manchester coded protocols.
+    for (uint8_t fill = 0; fill < 2; fill++) {
+      uint64_t value = fill ? UINT64_MAX : 0;
+      if (nbits < 64) value &= (1ULL << nbits) - 1;
+      uint8_t state[kStateSizeMax];
+      memset(state, fill ? 0xFF : 0, kStateSizeMax);
+      makeValid(protocol, &value, state, nbits);
+      irsend.reset();
+      bool sent = true;
+      if (protocol == MWM)
+        irsend.sendMWM(state, nbits / 8);
+      else if (hasACState(protocol))
+        sent = irsend.send(protocol, state, nbits / 8);
+      else
+        sent = irsend.send(protocol, value, nbits);
+      irsend.makeDecodeResult();
+      // The whole capture decodes.
+      if (!sent || !irrecv.decodeAs(&irsend.capture, protocol, nbits, false) ||
+          irsend.capture.decode_type != decodesAs(protocol)) {
+        ADD_FAILURE() << name << " fill " << (uint16_t)fill
+                      << " can't be checked.";
+        continue;
+      }
+      // Cut it off where a capture with this timeout would have stopped.
+      uint16_t end = kStartOffset;
+      while (end < irsend.capture.rawlen &&
+             (end % 2 || irsend.capture.rawbuf[end] * kRawTick <
+                             MS_TO_USEC(needs.timeout)))
+        end++;
+      EXPECT_LT(end, needs.bufsize) << name << " fill " << (uint16_t)fill;
+      irsend.capture.rawlen = end;
+      EXPECT_TRUE(irrecv.decodeAs(&irsend.capture, protocol, nbits, false))
+          << name << " fill " << (uint16_t)fill;
+      EXPECT_EQ(decodesAs(protocol), irsend.capture.decode_type) << name;
+    }
+  }
+}
@@ -0,0 +1,297 @@
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <string>
+#include "IRac.h"
+#include "IRsendQueue.h"
+#include "IRsend_test.h"
+#include "IRremoteESP8266.h"
+#include "IRtimer.h"
+#include "gtest/gtest.h"
+
+// Tests for IRsendQueue.
+
+/// The output of sending a simple message directly.
+std::string directCode(const decode_type_t protocol, const uint64_t value,
+                       const uint16_t nbits) {
+  IRsendTest irsend(kGpioUnused);
+  irsend.begin();
+  irsend.reset();
+  irsend.send(protocol, value, nbits);
+  return irsend.outputStr();
+}
+
+TEST(TestIRsendQueue, Basics) {
+  IRsendTest tx0(kGpioUnused);
+  IRsendTest tx1(kGpioUnused);
+  IRsend *senders[3] = {&tx0, &tx1, NULL};
+  IRsendQueue queue(senders, 3, 4, 0);
+  EXPECT_EQ(4, queue.capacity());
+  EXPECT_EQ(0, queue.size());
+  EXPECT_FALSE(queue.ready());
+  EXPECT_EQ(kSendQueueNone, queue.poll());
+
+  // Bad channels.
+  EXPECT_FALSE(queue.addCode(2, decode_type_t::NEC, 0x1234));  // No sender.
+  EXPECT_FALSE(queue.addCode(3, decode_type_t::NEC, 0x1234));  // Too high.
+  // Wrong sort of protocol for the message.
+  EXPECT_FALSE(queue.addCode(0, decode_type_t::DAIKIN, 0x1234));
+  EXPECT_FALSE(queue.addText(0, decode_type_t::NEC, "1,2,3"));
+  EXPECT_EQ(0, queue.size());
+
+  // Fill it up.
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x1));
+  EXPECT_TRUE(queue.addCode(1, decode_type_t::SONY, 0x2, 12));
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x3));
+  EXPECT_TRUE(queue.addPause(1, 100));
+  EXPECT_FALSE(queue.addCode(0, decode_type_t::NEC, 0x4));  // Full.
+  EXPECT_EQ(4, queue.size());
+  EXPECT_EQ(2, queue.size(0));
+  EXPECT_EQ(2, queue.size(1));
+  EXPECT_TRUE(queue.ready());
+  uint8_t channel = 7;
+  EXPECT_EQ(kSendQueueCode, queue.peek(&channel));
+  EXPECT_EQ(0, channel);
+  EXPECT_EQ(4, queue.size());  // Nothing was sent.
+
+  // Sent in the order they were queued, one per call.
+  tx0.reset();
+  bool success = false;
+  EXPECT_EQ(kSendQueueCode, queue.poll(&success));
+  EXPECT_TRUE(success);
+  EXPECT_EQ(directCode(decode_type_t::NEC, 0x1, kNECBits), tx0.outputStr());
+  tx1.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  // Sony is sent at least the minimum nr. of times.
+  IRsendTest sony(kGpioUnused);
+  sony.begin();
+  sony.reset();
+  sony.sendSony(0x2, 12, kSonyMinRepeat);
+  EXPECT_EQ(sony.outputStr(), tx1.outputStr());
+  tx0.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(directCode(decode_type_t::NEC, 0x3, kNECBits), tx0.outputStr());
+  EXPECT_EQ(kSendQueuePause, queue.peek(&channel));
+  EXPECT_EQ(1, channel);
+  EXPECT_EQ(kSendQueuePause, queue.poll());
+  EXPECT_EQ(0, queue.size());
+  EXPECT_EQ(kSendQueueNone, queue.poll());
+  EXPECT_EQ(kSendQueueNone, queue.peek());
+
+  // Clearing it.
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x1));
+  queue.clear();
+  EXPECT_EQ(0, queue.size());
+  EXPECT_FALSE(queue.ready());
+}
+
+TEST(TestIRsendQueue, Priority) {
+  IRsendTest tx0(kGpioUnused);
+  IRsend *senders[1] = {&tx0};
+  IRsendQueue queue(senders, 1, 8, 0);
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x1));
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x2, kNECBits, kNoRepeat,
+                            kSendQueuePriorityHigh));
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x3));
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x4, kNECBits, kNoRepeat,
+                            kSendQueuePriorityHigh));
+  const uint64_t expected[4] = {0x2, 0x4, 0x1, 0x3};
+  for (uint8_t i = 0; i < 4; i++) {
+    tx0.reset();
+    EXPECT_EQ(kSendQueueCode, queue.poll());
+    EXPECT_EQ(directCode(decode_type_t::NEC, expected[i], kNECBits),
+              tx0.outputStr());
+  }
+}
+
+TEST(TestIRsendQueue, GapsAndPauses) {
+  IRsendTest tx0(kGpioUnused);
+  IRsendTest tx1(kGpioUnused);
+  IRsend *senders[2] = {&tx0, &tx1};
+  IRsendQueue queue(senders, 2, 8, 200000);  // 200ms
+  queue.setGap(1, 500000);  // 500ms
+  EXPECT_EQ(200000, queue.getGap(0));
+  EXPECT_EQ(500000, queue.getGap(1));
+  EXPECT_EQ(0, queue.getGap(2));
+
+  // Sending takes (fake) time, so work out how long a message takes, and what
+  // they look like, before we start.
+  std::string expected[7];
+  const uint32_t start = _IRtimer_unittest_now;
+  for (uint8_t i = 1; i < 7; i++)
+    expected[i] = directCode(decode_type_t::NEC, i, kNECBits);
+  const uint32_t frame = (_IRtimer_unittest_now - start) / 6;
+
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x1));
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x2));
+  EXPECT_TRUE(queue.addCode(1, decode_type_t::NEC, 0x3));
+  EXPECT_TRUE(queue.addCode(1, decode_type_t::NEC, 0x4));
+  tx0.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(expected[1], tx0.outputStr());
+  // Channel 0 must wait, but channel 1 needn't.
+  tx1.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(expected[3], tx1.outputStr());
+  // Now both must wait. The gap starts when the message has been sent.
+  EXPECT_FALSE(queue.ready());
+  EXPECT_EQ(kSendQueueNone, queue.poll());
+  IRtimer::add(200000 - frame - 1);
+  EXPECT_FALSE(queue.ready());
+  IRtimer::add(1);
+  EXPECT_TRUE(queue.ready());
+  tx0.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(expected[2], tx0.outputStr());
+  EXPECT_FALSE(queue.ready());
+  IRtimer::add(300000 - 1);
+  EXPECT_FALSE(queue.ready());
+  IRtimer::add(1);
+  tx1.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(expected[4], tx1.outputStr());
+  EXPECT_EQ(0, queue.size());
+
+  // A pause only holds up its own channel.
+  IRtimer::add(500000);
+  EXPECT_TRUE(queue.addPause(0, 300));  // 300ms
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x5));
+  EXPECT_TRUE(queue.addCode(1, decode_type_t::NEC, 0x6));
+  EXPECT_EQ(kSendQueuePause, queue.poll());
+  tx1.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(expected[6], tx1.outputStr());
+  TimerMs::add(300 - 1);
+  EXPECT_FALSE(queue.ready());
+  TimerMs::add(1);
+  tx0.reset();
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(expected[5], tx0.outputStr());
+
+  // Long pauses, more than a uSecond timer can count (~71 minutes), work too.
+  IRtimer::add(500000);
+  const uint32_t hours = 5 * 60 * 60 * 1000;  // 5 hours in mSeconds.
+  EXPECT_TRUE(queue.addPause(0, hours));
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x5));
+  EXPECT_EQ(kSendQueuePause, queue.poll());
+  TimerMs::add(hours - 1);
+  EXPECT_FALSE(queue.ready());
+  TimerMs::add(1);
+  EXPECT_TRUE(queue.ready());
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+}
+
+TEST(TestIRsendQueue, StateAndText) {
+  IRsendTest tx0(kGpioUnused);
+  IRsend *senders[1] = {&tx0};
+  IRsendQueue queue(senders, 1, 8, 0);
+  IRsendTest direct(kGpioUnused);
+  direct.begin();
+
+  // State based.
+  const uint8_t state[kKelvinatorStateLength] = {
+      0x19, 0x0B, 0x80, 0x50, 0x00, 0x00, 0x00, 0xE0,
+      0x19, 0x0B, 0x80, 0x70, 0x00, 0x00, 0x10, 0xF0};
+  EXPECT_FALSE(queue.addState(0, decode_type_t::NEC, state, 4));
+  EXPECT_FALSE(queue.addState(0, decode_type_t::KELVINATOR, state,
+                              kStateSizeMax + 1));
+  EXPECT_TRUE(queue.addState(0, decode_type_t::KELVINATOR, state,
+                             kKelvinatorStateLength));
+  tx0.reset();
+  bool success = false;
+  EXPECT_EQ(kSendQueueState, queue.poll(&success));
+  EXPECT_TRUE(success);
+  direct.reset();
+  direct.sendKelvinator(state);
+  EXPECT_EQ(direct.outputStr(), tx0.outputStr());
+
+  // Raw.
+  EXPECT_TRUE(queue.addText(0, decode_type_t::RAW, "38000,9000,4500,560,560"));
+  tx0.reset();
+  EXPECT_EQ(kSendQueueText, queue.poll(&success));
+  EXPECT_TRUE(success);
+  EXPECT_EQ("f38000d50m9000s4500m560s560", tx0.outputStr());
+
+  // GlobalCache.
+  const char gc[] = "38000,1,1,170,170,20,63,20,21,20,1798";
+  const uint16_t gc_values[11] = {38000, 1, 1, 170, 170, 20, 63, 20, 21, 20,
+                                  1798};
+  EXPECT_TRUE(queue.addText(0, decode_type_t::GLOBALCACHE, gc));
+  tx0.reset();
+  EXPECT_EQ(kSendQueueText, queue.poll(&success));
+  EXPECT_TRUE(success);
+  direct.reset();
+  direct.sendGC(const_cast<uint16_t *>(gc_values), 11);
+  EXPECT_EQ(direct.outputStr(), tx0.outputStr());
+
+  // Pronto. Hexadecimal values.
+  const char pronto[] = "0000,0067,0000,0002,0060,0018,0030,0018";
+  const uint16_t pronto_values[8] = {0x0000, 0x0067, 0x0000, 0x0002,
+                                     0x0060, 0x0018, 0x0030, 0x0018};
+  EXPECT_TRUE(queue.addText(0, decode_type_t::PRONTO, pronto, 1));
+  tx0.reset();
+  EXPECT_EQ(kSendQueueText, queue.poll(&success));
+  EXPECT_TRUE(success);
+  direct.reset();
+  direct.sendPronto(const_cast<uint16_t *>(pronto_values), 8, 1);
+  EXPECT_EQ(direct.outputStr(), tx0.outputStr());
+
+  // Malformed text is dropped, but reported as a failure.
+  EXPECT_TRUE(queue.addText(0, decode_type_t::RAW, "38000,x"));
+  EXPECT_EQ(kSendQueueText, queue.poll(&success));
+  EXPECT_FALSE(success);
+  EXPECT_EQ(0, queue.size());
+}
+
+TEST(TestIRsendQueue, ClimateIsCoalesced) {
+  IRsendTest tx0(kGpioUnused);
+  IRsendTest tx1(kGpioUnused);
+  IRsend *senders[2] = {&tx0, &tx1};
+  IRsendQueue queue(senders, 2, 8, 0);
+  IRac ac0(kGpioUnused);
+  IRac ac1(kGpioUnused);
+  stdAc::state_t prev, first, second, third;
+  IRac::initState(&prev);
+  prev.protocol = decode_type_t::COOLIX;
+  first = prev;
+  first.power = true;
+  second = first;
+  second.degrees = 20;
+  third = second;
+  third.degrees = 18;
+
+  EXPECT_FALSE(queue.addClimate(0, NULL, first));
+  EXPECT_TRUE(queue.addClimate(0, &ac0, first, &prev));
+  EXPECT_TRUE(queue.addCode(0, decode_type_t::NEC, 0x1));
+  EXPECT_TRUE(queue.addClimate(1, &ac1, first));  // A different channel.
+  EXPECT_EQ(3, queue.size());
+  // Later states replace the waiting one.
+  EXPECT_TRUE(queue.addClimate(0, &ac0, second, &first));
+  EXPECT_TRUE(queue.addClimate(0, &ac0, third, &second));
+  EXPECT_EQ(3, queue.size());
+  EXPECT_EQ(2, queue.size(0));
+
+  // Check what is waiting for channel 0.
+  sendqueue_entry_t *entry = queue.next();
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(kSendQueueClimate, entry->kind);
+  EXPECT_EQ(0, entry->channel);
+  EXPECT_EQ(&ac0, entry->ac);
+  EXPECT_EQ(18, entry->climate.desired.degrees);
+  EXPECT_TRUE(entry->climate.has_prev);
+  // The A/C is still in the state before the first one.
+  EXPECT_FALSE(IRac::cmpStates(prev, entry->climate.prev));
+  EXPECT_FALSE(entry->climate.prev.power);
+
+  // Climate goes before the normal priority code.
+  EXPECT_EQ(kSendQueueClimate, queue.poll());
+  EXPECT_EQ(kSendQueueClimate, queue.poll());
+  EXPECT_EQ(kSendQueueCode, queue.poll());
+  EXPECT_EQ(0, queue.size());
+
+  // Once sent, a new state is queued separately.
+  EXPECT_TRUE(queue.addClimate(0, &ac0, first));
+  EXPECT_EQ(1, queue.size());
+  entry = queue.next();
+  ASSERT_NE(nullptr, entry);
+  EXPECT_FALSE(entry->climate.has_prev);
+}
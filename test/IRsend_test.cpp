@@ -208,6 +208,44 @@ TEST(TestSendRaw, GeneralUse) {
       irsend.outputStr());
 }
 
+// Test sending raw data straight from a string.
+TEST(TestSendRaw, FromString) {
+  IRsendTest irsend(4);
+  irsend.begin();
+  // NEC C3E0E0E8 as measured in #204
+  const uint16_t rawData[67] = {
+      8950, 4500, 550, 1650, 600, 1650, 550, 550,  600, 500,  600, 550,
+      550,  550,  600, 1650, 550, 1650, 600, 1650, 600, 1650, 550, 1700,
+      550,  550,  600, 550,  550, 550,  600, 500,  600, 550,  550, 1650,
+      600,  1650, 600, 1650, 550, 550,  600, 500,  600, 500,  600, 550,
+      550,  550,  600, 1650, 550, 1650, 600, 1650, 600, 500,  650, 1600,
+      600,  500,  600, 550,  550, 550,  600};
+  const char *rawStr =
+      "8950,4500,550,1650,600,1650,550,550,600,500,600,550,"
+      "550,550,600,1650,550,1650,600,1650,600,1650,550,1700,"
+      "550,550,600,550,550,550,600,500,600,550,550,1650,"
+      "600,1650,600,1650,550,550,600,500,600,500,600,550,"
+      "550,550,600,1650,550,1650,600,1650,600,500,650,1600,"
+      "600,500,600,550,550,550,600";
+
+  irsend.reset();
+  irsend.sendRaw(rawData, 67, 38);
+  const std::string expected = irsend.outputStr();
+
+  irsend.reset();
+  irutils::ValueReader reader(rawStr);
+  EXPECT_EQ(67, irsend.sendRaw(&reader, 38));
+  EXPECT_FALSE(reader.failed());
+  EXPECT_EQ(expected, irsend.outputStr());
+
+  // Malformed input stops at the last good value.
+  irsend.reset();
+  irutils::ValueReader bad("8950,4500,550,oops,600");
+  EXPECT_EQ(3, irsend.sendRaw(&bad, 38));
+  EXPECT_TRUE(bad.failed());
+  EXPECT_EQ("f38000d50m8950s4500m550", irsend.outputStr());
+}
+
 // Incorrect handling of decodes from Raw. i.e. There is no gap recorded at
 // the end of a command when using the interrupt code. sendRaw() best emulates
 // this for unit testing purposes. sendGC() and sendXXX() will add the trailing
@@ -787,6 +825,53 @@ TEST(TestSend, defaultBits) {
   }
 }
 
+TEST(TestSend, protocolInfo) {
+  for (int i = 0; i <= kLastDecodeType; i++) {
+    const decode_type_t protocol = (decode_type_t)i;
+    const protocol_info_t *info = IRsend::protocolInfo(protocol);
+    EXPECT_EQ(protocol, info->protocol);
+    EXPECT_EQ(IRsend::defaultBits(protocol), info->bits);
+    EXPECT_EQ(IRsend::minRepeats(protocol), info->repeats);
+    EXPECT_EQ(hasACState(protocol), info->state);
+  }
+  // Protocols we don't know about.
+  EXPECT_EQ(UNUSED, IRsend::protocolInfo(UNKNOWN)->protocol);
+  const decode_type_t too_big = (decode_type_t)(kLastDecodeType + 1);
+  EXPECT_EQ(UNUSED, IRsend::protocolInfo(too_big)->protocol);
+  EXPECT_FALSE(IRsend::protocolInfo(UNKNOWN)->ac);
+  // Some we do.
+  EXPECT_EQ(kNECBits, IRsend::protocolInfo(NEC)->bits);
+  EXPECT_FALSE(IRsend::protocolInfo(NEC)->state);
+  EXPECT_FALSE(IRsend::protocolInfo(NEC)->ac);
+  EXPECT_EQ(kSingleRepeat, IRsend::protocolInfo(TOSHIBA_AC)->repeats);
+  EXPECT_TRUE(IRsend::protocolInfo(TOSHIBA_AC)->state);
+  EXPECT_TRUE(IRsend::protocolInfo(TOSHIBA_AC)->ac);
+}
+
+TEST(TestSend, SendByType) {
+  IRsendTest irsend(4);
+  irsend.begin();
+  const uint8_t state[kGreeStateLength] = {0};
+  // Protocols we don't know about send nothing.
+  EXPECT_FALSE(irsend.send(UNKNOWN, (uint64_t)0, 32));
+  EXPECT_FALSE(irsend.send(UNKNOWN, state, kGreeStateLength));
+  const decode_type_t too_big = (decode_type_t)(kLastDecodeType + 1);
+  EXPECT_FALSE(irsend.send(too_big, (uint64_t)0, 32));
+  EXPECT_FALSE(irsend.send(too_big, state, kGreeStateLength));
+  EXPECT_EQ("", irsend.outputStr());
+  // A value protocol can't be sent as a state[].
+  EXPECT_FALSE(irsend.send(NEC, state, kGreeStateLength));
+  EXPECT_TRUE(irsend.send(NEC, (uint64_t)0, kNECBits));
+  EXPECT_NE("", irsend.outputStr());
+  // Gree can be sent either way.
+  irsend.reset();
+  EXPECT_TRUE(irsend.send(GREE, (uint64_t)0, kGreeBits));
+  EXPECT_NE("", irsend.outputStr());
+  irsend.reset();
+  EXPECT_TRUE(irsend.send(GREE, state, kGreeStateLength));
+  EXPECT_NE("", irsend.outputStr());
+}
+
 // Tests sendManchester().
 
 // Test sending zero bits.
@@ -863,3 +948,48 @@ TEST(TestSendManchester, SendOverLargeData) {
       "m300",
       irsend.outputStr());
 }
+
+// Test sending a learned message.
+TEST(TestSendLearned, SendLearned) {
+  IRsendTest irsend(4);
+  irsend.begin();
+  learned_code_t code;
+  code.hdrmark = 9000;
+  code.hdrspace = 4500;
+  code.onemark = 600;
+  code.onespace = 1600;
+  code.zeromark = 600;
+  code.zerospace = 500;
+  code.footermark = 600;
+  code.gap = 40000;
+  code.nbits = 12;  // Not a whole nr. of bytes.
+  code.repeat = 1;
+  code.data[0] = 0xA5;
+  code.data[1] = 0xC0;  // Only the top 4 bits are used.
+  irsend.reset();
+  irsend.sendLearned(&code);
+  EXPECT_EQ(
+      "f38000d50"
+      "m9000s4500"
+      "m600s1600m600s500m600s1600m600s500m600s500m600s1600m600s500m600s1600"
+      "m600s1600m600s1600m600s500m600s500"
+      "m600s40000"
+      "m9000s4500"
+      "m600s1600m600s500m600s1600m600s500m600s500m600s1600m600s500m600s1600"
+      "m600s1600m600s1600m600s500m600s500"
+      "m600s40000",
+      irsend.outputStr());
+  // No header or footer.
+  code.hdrmark = 0;
+  code.hdrspace = 0;
+  code.footermark = 0;
+  code.nbits = 8;
+  code.repeat = 0;
+  irsend.reset();
+  irsend.sendLearned(&code, 40000);
+  EXPECT_EQ(
+      "f40000d50"
+      "m600s1600m600s500m600s1600m600s500m600s500m600s1600m600s500"
+      "m600s41600",  // The last bit's space & the gap.
+      irsend.outputStr());
+}
@@ -433,6 +433,25 @@ TEST(TestUtils, TemperatureConversion) {
   ASSERT_EQ(-40.0, fahrenheitToCelsius(-40.0));
 }
 
+TEST(TestUtils, TemperatureConversionTenths) {
+  EXPECT_EQ(320, celsiusToFahrenheitTenths(0));
+  EXPECT_EQ(0, fahrenheitToCelsiusTenths(320));
+  EXPECT_EQ(2120, celsiusToFahrenheitTenths(1000));
+  EXPECT_EQ(1000, fahrenheitToCelsiusTenths(2120));
+  EXPECT_EQ(-400, fahrenheitToCelsiusTenths(-400));
+  EXPECT_EQ(-400, celsiusToFahrenheitTenths(-400));
+  // Half degrees etc.
+  EXPECT_EQ(725, celsiusToFahrenheitTenths(225));  // 22.5C == 72.5F
+  EXPECT_EQ(166, fahrenheitToCelsiusTenths(620));  // 62F == 16.67C
+  // Matches the truncated float versions for whole degrees.
+  for (int16_t deg = -40; deg <= 100; deg++) {
+    EXPECT_EQ(static_cast<int16_t>(celsiusToFahrenheit(deg) * 10),
+              celsiusToFahrenheitTenths(deg * 10));
+    EXPECT_EQ(static_cast<int16_t>(fahrenheitToCelsius(deg) * 10),
+              fahrenheitToCelsiusTenths(deg * 10));
+  }
+}
+
 TEST(TestResultToRawArray, TypicalCase) {
   IRsendTest irsend(0);
   IRrecv irrecv(1);
@@ -552,6 +571,58 @@ TEST(TestUtils, sumNibbles) {
   EXPECT_EQ(0x22, irutils::sumNibbles(0x88C0051, 255, 0, false));
 }
 
+// The checksum helpers work on several bytes at a time, so compare them to
+// the obvious byte at a time versions for every length & alignment.
+TEST(TestUtils, ChecksumsMatchSimpleLoops) {
+  uint8_t data[1100];
+  uint32_t seed = 1;
+  for (uint16_t i = 0; i < sizeof(data); i++) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = seed >> 16;
+  }
+  for (uint16_t start = 0; start < 4; start++) {
+    uint8_t sum = 7;
+    uint8_t xored = 7;
+    uint8_t nibbles = 7;
+    uint16_t ones = 7;
+    for (uint16_t len = 0; len + start < sizeof(data); len++) {
+      ASSERT_EQ(sum, sumBytes(data + start, len, 7)) << len;
+      ASSERT_EQ(xored, xorBytes(data + start, len, 7)) << len;
+      ASSERT_EQ(nibbles, irutils::sumNibbles(data + start, len, 7)) << len;
+      ASSERT_EQ(ones, countBits(data + start, len, true, 7)) << len;
+      const uint8_t next = data[start + len];
+      sum += next;
+      xored ^= next;
+      nibbles += (next >> 4) + (next & 0xF);
+      for (uint8_t bits = next; bits; bits >>= 1) ones += bits & 1;
+    }
+  }
+  // All 0xFF is the worst case for overflowing the internal accumulators.
+  memset(data, 0xFF, sizeof(data));
+  EXPECT_EQ((uint8_t)(0xFF * sizeof(data)), sumBytes(data, sizeof(data)));
+  EXPECT_EQ((uint8_t)(0x1E * sizeof(data)),
+            irutils::sumNibbles(data, sizeof(data)));
+  EXPECT_EQ(sizeof(data) * 8, countBits(data, sizeof(data)));
+  EXPECT_EQ(0, countBits(data, sizeof(data), false));
+}
+
+TEST(TestUtils, sumBytesInteger) {
+  EXPECT_EQ(0, sumBytes((uint64_t)0x0102030405060708, 0));
+  EXPECT_EQ(0x08, sumBytes((uint64_t)0x0102030405060708, 1));
+  EXPECT_EQ(0x0F, sumBytes((uint64_t)0x0102030405060708, 2));
+  EXPECT_EQ(0x24, sumBytes((uint64_t)0x0102030405060708, 8));
+  EXPECT_EQ(0x24, sumBytes((uint64_t)0x0102030405060708, 255));
+  EXPECT_EQ(0x34, sumBytes((uint64_t)0x0102030405060708, 8, 0x10));
+  EXPECT_EQ(0xFE, sumBytes((uint64_t)0xFFFF, 2));
+}
+
+TEST(TestUtils, reverseByte) {
+  for (uint16_t i = 0; i <= 0xFF; i++)
+    EXPECT_EQ(reverseBits(i, 8), irutils::reverseByte(i));
+  EXPECT_EQ(0b10000000, irutils::reverseByte(0b00000001));
+  EXPECT_EQ(0b00110101, irutils::reverseByte(0b10101100));
+}
+
 TEST(TestUtils, BCD) {
   EXPECT_EQ(0, irutils::uint8ToBcd(0));
   EXPECT_EQ(0, irutils::bcdToUint8(0));
@@ -777,6 +848,170 @@ TEST(TestUtils, InvertedBytePairs) {
   EXPECT_STATE_EQ(correct, wrong, 6 * 8);
 }
 
+union TestBitFieldProtocol {
+  uint8_t raw[4];
+  irutils::BitField<0, 0, 1> Bit;
+  irutils::BitField<0, 4, 3> Nibbleish;
+  irutils::BitField<1, 0, 8> Byte;
+  irutils::BitField<2, 4, 12> Spanning;
+};
+
+TEST(TestUtils, BitField) {
+  TestBitFieldProtocol p;
+  memset(p.raw, 0, sizeof(p.raw));
+  p.Bit = true;
+  EXPECT_EQ(1, p.Bit);
+  EXPECT_EQ(0x01, p.raw[0]);
+  p.Nibbleish = 0b101;
+  EXPECT_EQ(0b101, p.Nibbleish);
+  EXPECT_EQ(0x51, p.raw[0]);
+  // Excess bits are discarded & don't touch the neighbouring bits.
+  p.Nibbleish = 0xFF;
+  EXPECT_EQ(0b111, p.Nibbleish);
+  EXPECT_EQ(0x71, p.raw[0]);
+  p.Bit = 0;
+  EXPECT_EQ(0x70, p.raw[0]);
+  p.Byte = 0x1AB;
+  EXPECT_EQ(0xAB, p.Byte);
+  // Fields spanning bytes are stored lowest byte first.
+  p.raw[2] = 0x0C;
+  p.Spanning = 0xDEF;
+  EXPECT_EQ(0xDEF, p.Spanning);
+  EXPECT_EQ(0xFC, p.raw[2]);
+  EXPECT_EQ(0xDE, p.raw[3]);
+  p.raw[3] = 0x12;
+  EXPECT_EQ(0x12F, p.Spanning);
+  // Behaves like an int, the same as a bit-field would.
+  EXPECT_EQ(-0x12E, 1 - p.Spanning);
+  EXPECT_EQ(sizeof(p.raw), sizeof(p));
+}
+
+TEST(TestUtils, AcMapping) {
+  const irutils::AcMapping<stdAc::fanspeed_t> map[] = {
+      {1, stdAc::fanspeed_t::kMin},
+      {2, stdAc::fanspeed_t::kMedium},
+      {2, stdAc::fanspeed_t::kLow},
+      {3, stdAc::fanspeed_t::kMax}};
+  EXPECT_EQ(1, irutils::toNative(map, stdAc::fanspeed_t::kMin, 0));
+  EXPECT_EQ(2, irutils::toNative(map, stdAc::fanspeed_t::kLow, 0));
+  EXPECT_EQ(2, irutils::toNative(map, stdAc::fanspeed_t::kMedium, 0));
+  EXPECT_EQ(3, irutils::toNative(map, stdAc::fanspeed_t::kMax, 0));
+  // Not in the map.
+  EXPECT_EQ(0, irutils::toNative(map, stdAc::fanspeed_t::kHigh, 0));
+  EXPECT_EQ(stdAc::fanspeed_t::kMin,
+            irutils::toCommon(map, 1, stdAc::fanspeed_t::kAuto));
+  // The first matching entry wins.
+  EXPECT_EQ(stdAc::fanspeed_t::kMedium,
+            irutils::toCommon(map, 2, stdAc::fanspeed_t::kAuto));
+  EXPECT_EQ(stdAc::fanspeed_t::kMax,
+            irutils::toCommon(map, 3, stdAc::fanspeed_t::kAuto));
+  EXPECT_EQ(stdAc::fanspeed_t::kAuto,
+            irutils::toCommon(map, 0, stdAc::fanspeed_t::kAuto));
+}
+
+TEST(TestUtils, ValueReader) {
+  uint16_t value = 0;
+  irutils::ValueReader decimal("38000, 1,1 170\t170,\r\n65535");
+  const uint16_t expected[6] = {38000, 1, 1, 170, 170, 65535};
+  for (uint16_t i = 0; i < 6; i++) {
+    ASSERT_TRUE(decimal.next(&value));
+    EXPECT_EQ(expected[i], value);
+  }
+  EXPECT_FALSE(decimal.next(&value));
+  EXPECT_FALSE(decimal.failed());
+  EXPECT_EQ(6, decimal.count());
+
+  irutils::ValueReader hex("0000 006D 0x22,0Xff ab", 16);
+  const uint16_t expected_hex[5] = {0x0000, 0x006D, 0x22, 0xFF, 0xAB};
+  for (uint16_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(hex.next(&value));
+    EXPECT_EQ(expected_hex[i], value);
+  }
+  EXPECT_FALSE(hex.next(&value));
+  EXPECT_FALSE(hex.failed());
+
+  // Switching base part way through.
+  irutils::ValueReader mixed("10,10");
+  ASSERT_TRUE(mixed.next(&value));
+  EXPECT_EQ(10, value);
+  mixed.setBase(16);
+  ASSERT_TRUE(mixed.next(&value));
+  EXPECT_EQ(0x10, value);
+
+  // Empty input.
+  irutils::ValueReader empty("  ");
+  EXPECT_FALSE(empty.next(&value));
+  EXPECT_FALSE(empty.failed());
+  EXPECT_EQ(0, empty.count());
+  irutils::ValueReader null(NULL);
+  EXPECT_FALSE(null.next(&value));
+  EXPECT_FALSE(null.failed());
+
+  // Malformed input.
+  const char *bad[] = {"1,2,", "1,,2", ",1", "65536", "123456789", "12a,3",
+                       "1;2", "-1", "0x10", "1 x"};
+  for (uint8_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+    irutils::ValueReader reader(bad[i]);
+    while (reader.next(&value)) {}
+    EXPECT_TRUE(reader.failed()) << "Input: \"" << bad[i] << "\"";
+    // Nothing more is read after a failure.
+    EXPECT_FALSE(reader.next(&value));
+  }
+  irutils::ValueReader badhex("0x,1", 16);
+  EXPECT_FALSE(badhex.next(&value));
+  EXPECT_TRUE(badhex.failed());
+}
+
+/// A `ValueReader::CharSource` that returns the chars of a string one by one.
+/// @param[in,out] context A pointer to a `const char *`.
+/// @return The next char, or -1 at the end.
+int16_t stringSource(void *context) {
+  const char **str = reinterpret_cast<const char **>(context);
+  if (!**str) return -1;
+  return *((*str)++);
+}
+
+TEST(TestUtils, ValueReaderCharSource) {
+  const char *str = "9000,4500 , 600";
+  irutils::ValueReader reader(stringSource, &str);
+  uint16_t value = 0;
+  ASSERT_TRUE(reader.next(&value));
+  EXPECT_EQ(9000, value);
+  ASSERT_TRUE(reader.next(&value));
+  EXPECT_EQ(4500, value);
+  ASSERT_TRUE(reader.next(&value));
+  EXPECT_EQ(600, value);
+  EXPECT_FALSE(reader.next(&value));
+  EXPECT_FALSE(reader.failed());
+  EXPECT_EQ(3, reader.count());
+
+  const char *bad = "1,2,";
+  irutils::ValueReader badreader(stringSource, &bad);
+  while (badreader.next(&value)) {}
+  EXPECT_TRUE(badreader.failed());
+  EXPECT_EQ(2, badreader.count());
+}
+
+TEST(TestUtils, countAndParseValues) {
+  EXPECT_EQ(0, irutils::countValues(""));
+  EXPECT_EQ(1, irutils::countValues("1"));
+  EXPECT_EQ(4, irutils::countValues("1,2, 3 4"));
+  EXPECT_EQ(0, irutils::countValues("1,2,"));
+  EXPECT_EQ(3, irutils::countValues("0000 006d FFFF", 16));
+  EXPECT_EQ(0, irutils::countValues("0000 006d FFFF"));
+
+  uint16_t values[4] = {0, 0, 0, 0};
+  EXPECT_EQ(3, irutils::parseValues("38000,1,69", values, 4));
+  EXPECT_EQ(38000, values[0]);
+  EXPECT_EQ(1, values[1]);
+  EXPECT_EQ(69, values[2]);
+  EXPECT_EQ(4, irutils::parseValues("a b c d", values, 4, 16));
+  EXPECT_EQ(0xD, values[3]);
+  // Too many values for the array.
+  EXPECT_EQ(0, irutils::parseValues("1,2,3,4,5", values, 4));
+  EXPECT_EQ(0, irutils::parseValues("1,2,X", values, 4));
+}
+
 TEST(TestUtils, lowLevelSanityCheck) {
   ASSERT_EQ(0, irutils::lowLevelSanityCheck());
 }
@@ -2,6 +2,7 @@
 
 #include "IRsend.h"
 #include "IRsend_test.h"
+#include "IRutils.h"
 #include "gtest/gtest.h"
 
 // Tests for sendGlobalCache().
@@ -71,3 +72,53 @@ TEST(TestSendGlobalCache, RepeatCode) {
       "m8866s2210m546s94822",
       irsend.outputStr());
 }
+
+// Test sending from a string gives the same result as from an array.
+TEST(TestSendGlobalCache, FromString) {
+  IRsendTest irsend(4);
+  irsend.begin();
+
+  // Sherwood (NEC-like) "Power On" from Global Cache with 2 repeats
+  uint16_t gc_test[75] = {
+      38000, 2,  69, 341, 171, 21, 64, 21, 64, 21, 21,   21,  21, 21, 21,
+      21,    21, 21, 21,  21,  64, 21, 64, 21, 21, 21,   64,  21, 21, 21,
+      21,    21, 21, 21,  64,  21, 21, 21, 64, 21, 21,   21,  21, 21, 21,
+      21,    64, 21, 21,  21,  21, 21, 21, 21, 21, 21,   64,  21, 64, 21,
+      64,    21, 21, 21,  64,  21, 64, 21, 64, 21, 1600, 341, 85, 21, 3647};
+  const char *gc_str =
+      "38000,2,69,341,171,21,64,21,64,21,21,21,21,21,21,"
+      "21,21,21,21,21,64,21,64,21,21,21,64,21,21,21,"
+      "21,21,21,21,64,21,21,21,64,21,21,21,21,21,21,"
+      "21,64,21,21,21,21,21,21,21,21,21,64,21,64,21,"
+      "64,21,21,21,64,21,64,21,64,21,1600,341,85,21,3647";
+  irsend.reset();
+  irsend.sendGC(gc_test, 75);
+  std::string expected = irsend.outputStr();
+  irsend.reset();
+  irutils::ValueReader reader(gc_str);
+  EXPECT_TRUE(irsend.sendGC(&reader));
+  EXPECT_EQ(expected, irsend.outputStr());
+
+  // Repeat the whole message, so it all needs to be kept.
+  gc_test[1] = 3;
+  gc_test[2] = 1;
+  irsend.reset();
+  irsend.sendGC(gc_test, 75);
+  expected = irsend.outputStr();
+  irsend.reset();
+  std::string str = "38000,3,1,";
+  str += (gc_str + 11);  // Skip "38000,2,69,".
+  irutils::ValueReader repeated(str.c_str());
+  EXPECT_TRUE(irsend.sendGC(&repeated));
+  EXPECT_EQ(expected, irsend.outputStr());
+
+  // Malformed & short messages.
+  irsend.reset();
+  irutils::ValueReader header_only("38000,1");
+  EXPECT_FALSE(irsend.sendGC(&header_only));
+  EXPECT_EQ("", irsend.outputStr());
+  irsend.reset();
+  irutils::ValueReader bad("38000,2,1,341,171,21,x");
+  EXPECT_FALSE(irsend.sendGC(&bad));
+  EXPECT_EQ("f38000d50m8866s4446m546", irsend.outputStr());  // No repeats.
+}
@@ -1,6 +1,7 @@
 // Copyright 2017 David Conran
 #include "IRsend.h"
 #include "IRsend_test.h"
+#include "IRutils.h"
 #include "gtest/gtest.h"
 
 // Tests for sendPronto().
@@ -435,3 +436,63 @@ TEST(TestSendPronto, Issue1103) {
       "f38028d50m20066s20435m15069s30665m20066s20435m15069s29982",
       irsend.outputStr());
 }
+
+// Test sending from a string gives the same result as from an array.
+TEST(TestSendPronto, FromString) {
+  IRsendTest irsend(4);
+  irsend.begin();
+
+  // NEC 32 bit power on command. (Normal plus repeat sequences)
+  uint16_t pronto_test[76] = {
+      0x0000, 0x006D, 0x0022, 0x0002, 0x0156, 0x00AB, 0x0015, 0x0015, 0x0015,
+      0x0015, 0x0015, 0x0015, 0x0015, 0x0040, 0x0015, 0x0040, 0x0015, 0x0015,
+      0x0015, 0x0015, 0x0015, 0x0015, 0x0015, 0x0040, 0x0015, 0x0040, 0x0015,
+      0x0040, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015, 0x0040, 0x0015, 0x0040,
+      0x0015, 0x0040, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015,
+      0x0040, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015, 0x0015,
+      0x0015, 0x0040, 0x0015, 0x0040, 0x0015, 0x0040, 0x0015, 0x0015, 0x0015,
+      0x0040, 0x0015, 0x0040, 0x0015, 0x0040, 0x0015, 0x0040, 0x0015, 0x05FD,
+      0x0156, 0x0055, 0x0015, 0x0E4E};
+  std::string pronto_str;
+  for (uint16_t i = 0; i < 76; i++) {
+    if (i) pronto_str += ' ';
+    pronto_str += uint64ToString(pronto_test[i], 16);
+  }
+  for (uint16_t repeats = 0; repeats < 4; repeats++) {
+    irsend.reset();
+    irsend.sendPronto(pronto_test, 76, repeats);
+    const std::string expected = irsend.outputStr();
+    irsend.reset();
+    irutils::ValueReader reader(pronto_str.c_str(), 16);
+    EXPECT_TRUE(irsend.sendPronto(&reader, repeats));
+    EXPECT_EQ(expected, irsend.outputStr()) << "Repeats: " << repeats;
+  }
+
+  // Sony 20-bit command. (Repeat sequence only)
+  irutils::ValueReader sony(
+      "0000 0067 0000 0015 0060 0018 0018 0018 0030 0018 0030 0018 0030 0018 "
+      "0018 0018 0030 0018 0018 0018 0018 0018 0030 0018 0018 0018 0030 0018 "
+      "0030 0018 0030 0018 0018 0018 0018 0018 0030 0018 0018 0018 0018 0018 "
+      "0030 0018 0018 03f6", 16);
+  irsend.reset();
+  EXPECT_TRUE(irsend.sendPronto(&sony, 1));
+  irsend.makeDecodeResult();
+  IRrecv irrecv(4);
+  EXPECT_TRUE(irrecv.decode(&irsend.capture));
+  EXPECT_EQ(SONY, irsend.capture.decode_type);
+  EXPECT_EQ(20, irsend.capture.bits);
+  EXPECT_EQ(0x74B92, irsend.capture.value);
+
+  // Unsupported, short & malformed codes.
+  irsend.reset();
+  irutils::ValueReader learnt("0100 006D 0001 0000 0015 0015", 16);
+  EXPECT_FALSE(irsend.sendPronto(&learnt));
+  irutils::ValueReader header_only("0000 006D 0001", 16);
+  EXPECT_FALSE(irsend.sendPronto(&header_only));
+  irutils::ValueReader empty("0000 006D 0000 0000 0015 0015", 16);
+  EXPECT_FALSE(irsend.sendPronto(&empty));
+  EXPECT_EQ("", irsend.outputStr());
+  irutils::ValueReader too_short("0000 006D 0002 0000 0156 00AB 0015", 16);
+  EXPECT_FALSE(irsend.sendPronto(&too_short));
+  EXPECT_EQ("f38028d50m8994s4497m552", irsend.outputStr());
+}
@@ -0,0 +1,112 @@
+// Quick and dirty tool to compare the cost of accessing A/C settings via
+// `irutils::BitField` versus a compiler bit-field, as used to be done in
+// e.g. `DaikinESPProtocol`.
+//
+// Build & run with `make run_bench`. It is compiled with optimisation, as
+// the results are meaningless without it.
+//
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iostream>
+#include "IRutils.h"
+
+const uint16_t kBenchStateLength = 35;  // Same as kDaikinStateLength.
+
+/// The layout being tested, using `irutils::BitField`.
+union BenchFieldProtocol {
+  uint8_t raw[kBenchStateLength];
+  irutils::BitField<13, 0, 11> CurrentTime;
+  irutils::BitField<21, 0, 1> Power;
+  irutils::BitField<21, 4, 3> Mode;
+  irutils::BitField<22, 1, 7> Temp;
+  irutils::BitField<24, 4, 4> Fan;
+  irutils::BitField<27, 4, 12> OffTime;
+};
+
+/// The same layout, using a compiler bit-field.
+union BenchBitProtocol {
+  uint8_t raw[kBenchStateLength];
+  struct {
+    // Byte 0~12
+    uint64_t              :64;
+    uint64_t              :40;
+    // Byte 13~14
+    uint64_t CurrentTime  :11;
+    uint64_t              :5;
+    // Byte 15~20
+    uint64_t              :48;
+    // Byte 21
+    uint64_t Power    :1;
+    uint64_t          :3;
+    uint64_t Mode     :3;
+    uint64_t          :1;
+    // Byte 22
+    uint64_t          :1;
+    uint64_t Temp     :7;
+    // Byte 23
+    uint64_t          :8;
+    // Byte 24
+    uint64_t          :4;
+    uint64_t Fan      :4;
+    // Byte 25~26
+    uint64_t          :16;
+    // Byte 27~28
+    uint64_t          :4;
+    uint64_t OffTime  :12;
+  };
+};
+
+/// Set & then get every field in the state, a given number of times.
+/// @param[in,out] s The union to use.
+/// @param[in] iterations How many times to do it.
+/// @return A checksum of every value read, so nothing gets optimised out.
+template <typename T>
+uint32_t exercise(T *s, const uint32_t iterations) {
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    s->CurrentTime = i;
+    s->Power = i >> 1;
+    s->Mode = i >> 2;
+    s->Temp = i >> 3;
+    s->Fan = i >> 4;
+    s->OffTime = i >> 5;
+    sum += s->CurrentTime + s->Power + s->Mode + s->Temp + s->Fan + s->OffTime;
+    // Stop the compiler from keeping the state in registers.
+    __asm__ __volatile__("" : : "r"(s) : "memory");
+  }
+  return sum;
+}
+
+/// Time how long `exercise()` takes for a given layout.
+/// @param[in] name What to call it in the report.
+/// @param[in] iterations How many times to access each field.
+/// @return The checksum of every value read.
+template <typename T>
+uint32_t bench(const char *name, const uint32_t iterations) {
+  T state;
+  memset(&state, 0, sizeof(state));
+  auto start = std::chrono::steady_clock::now();
+  uint32_t sum = exercise(&state, iterations);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << name << ": " << elapsed.count() * 1e9 / (iterations * 6)
+            << " ns per set & get (" << elapsed.count() << "s)" << std::endl;
+  return sum;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t iterations = 50000000;
+  if (argc > 1) iterations = strtoul(argv[1], NULL, 10);
+  uint32_t bits = bench<BenchBitProtocol>("Bit-field          ", iterations);
+  uint32_t field = bench<BenchFieldProtocol>("irutils::BitField  ",
+                                             iterations);
+  if (bits != field) {
+    std::cerr << "Results differ! " << bits << " != " << field << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,141 @@
+// Quick and dirty tool to compare the ways `IRrecv::decodeHash()` can hash
+// UNKNOWN messages. i.e. `kHashLegacy` & `kHashLogBuckets`.
+//
+// It makes a corpus of random messages of every protocol that can be sent,
+// then reports for each way:
+//   * Collisions: Different captures that hashed the same.
+//   * Stability: How often a capture still hashes the same after its timings
+//     are changed a little. e.g. A remote with a slow clock, or a noisy
+//     receiver. Ideally, a button should always produce the same hash.
+//   * Speed: How long it takes to hash a capture.
+//
+// Build & run with `make run_bench`. It is compiled with optimisation, as
+// the results are meaningless without it.
+//
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+#include "IRrecv.h"
+#include "IRsend.h"
+#include "IRsend_test.h"
+#include "IRutils.h"
+
+typedef std::vector<uint16_t> capture_t;
+
+// Big, so not on the stack.
+IRsendTest irsend(0);
+IRrecv irrecv(0);
+
+/// Hash a capture.
+/// @param[in] raw The capture. raw[0] is ignored like `rawbuf[0]`.
+/// @return The hash `decodeHash()` made of it.
+uint64_t hash(capture_t *raw) {
+  decode_results results;
+  results.rawbuf = raw->data();
+  results.rawlen = raw->size();
+  results.overflow = false;
+  irrecv.decodeHash(&results);
+  return results.value;
+}
+
+/// Make a corpus of random messages of every protocol we can send.
+/// @param[in] rng The random number generator to use.
+/// @param[in] per_protocol Nr. of messages to make of each protocol.
+/// @return The captures of the messages. Each one is different.
+std::vector<capture_t> makeCorpus(std::mt19937 *rng,
+                                  const uint16_t per_protocol) {
+  std::set<capture_t> seen;
+  std::vector<capture_t> corpus;
+  for (uint16_t p = 1; p <= kLastDecodeType; p++) {
+    const decode_type_t protocol = (decode_type_t)p;
+    const uint16_t nbits = IRsend::defaultBits(protocol);
+    if (!nbits) continue;
+    const bool isAC = hasACState(protocol);
+    if (isAC && nbits / 8 > kStateSizeMax) continue;
+    for (uint16_t n = 0; n < per_protocol; n++) {
+      uint64_t value = ((uint64_t)(*rng)() << 32) | (*rng)();
+      if (nbits < 64) value &= (1ULL << nbits) - 1;
+      uint8_t state[kStateSizeMax] = {0};
+      for (uint16_t i = 0; isAC && i < nbits / 8; i++) state[i] = (*rng)();
+      irsend.reset();
+      bool sent = isAC ? irsend.send(protocol, state, nbits / 8)
+                       : irsend.send(protocol, value, nbits);
+      if (!sent || !irsend.last) break;
+      irsend.makeDecodeResult();
+      if (irsend.capture.overflow) break;
+      capture_t raw(irsend.rawbuf, irsend.rawbuf + irsend.capture.rawlen);
+      if (seen.insert(raw).second) corpus.push_back(raw);
+    }
+  }
+  return corpus;
+}
+
+/// Report on a way of hashing the corpus.
+/// @param[in] name What to call it in the report.
+/// @param[in] mode The hash mode to use.
+/// @param[in] corpus The captures to hash.
+/// @param[in] rng The random number generator to use.
+/// @param[in] iterations How many times to hash the corpus for timing.
+void report(const char *name, const uint8_t mode,
+            std::vector<capture_t> *corpus, std::mt19937 *rng,
+            const uint32_t iterations) {
+  irrecv.setHashMode(mode);
+  // Collisions
+  std::map<uint64_t, uint32_t> hashes;
+  uint32_t collisions = 0;
+  for (capture_t &raw : *corpus)
+    if (hashes[hash(&raw)]++) collisions++;
+  // Stability
+  uint32_t drift_ok = 0;
+  uint32_t noise_ok = 0;
+  std::uniform_int_distribution<int> drift(92, 108);  // Whole capture +/-8%
+  std::uniform_int_distribution<int> noise(95, 105);  // Each entry +/-5%
+  for (capture_t &raw : *corpus) {
+    const uint64_t expected = hash(&raw);
+    capture_t changed = raw;
+    const int percent = drift(*rng);
+    for (size_t i = 1; i < changed.size(); i++)
+      changed[i] = changed[i] * percent / 100;
+    if (hash(&changed) == expected) drift_ok++;
+    changed = raw;
+    for (size_t i = 1; i < changed.size(); i++)
+      changed[i] = changed[i] * noise(*rng) / 100;
+    if (hash(&changed) == expected) noise_ok++;
+  }
+  // Speed
+  uint64_t sum = 0;
+  uint64_t entries = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < iterations; n++)
+    for (capture_t &raw : *corpus) {
+      sum += hash(&raw);
+      entries += raw.size();
+    }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << name << ": " << collisions << " collisions, "
+            << 100.0 * drift_ok / corpus->size() << "% same after +/-8% drift, "
+            << 100.0 * noise_ok / corpus->size() << "% same after +/-5% noise, "
+            << elapsed.count() * 1e9 / entries << " ns per entry"
+            << " (checksum " << uint64ToString(sum & 0xFFFF, 16) << ")"
+            << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t iterations = 20;
+  if (argc > 1) iterations = strtoul(argv[1], NULL, 10);
+  std::mt19937 rng(42);  // Repeatable.
+  std::vector<capture_t> corpus = makeCorpus(&rng, 100);
+  std::cout << "Corpus: " << corpus.size() << " different captures."
+            << std::endl;
+  report("kHashLegacy    ", kHashLegacy, &corpus, &rng, iterations);
+  report("kHashLogBuckets", kHashLogBuckets, &corpus, &rng, iterations);
+  return 0;
+}
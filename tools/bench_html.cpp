@@ -0,0 +1,176 @@
+// Quick and dirty tool to compare the speed of making IRMQTTServer's A/C web
+// page via `IRhtmlRenderer`, versus how it used to be made. i.e. Building the
+// whole page in a String, and remaking every `<select>` menu for each request.
+//
+// Build & run with `make run_bench`. It is compiled with optimisation, as
+// the results are meaningless without it.
+//
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iostream>
+#include <string>
+#include "IRac.h"
+#include "IRhtmlRenderer.h"
+#include "IRutils.h"
+
+/// The old way of making a menu item.
+String htmlOptionItem(const String value, const String text, bool selected) {
+  String html = "<option value='";
+  html += value + '\'';
+  if (selected) html += " selected='selected'";
+  html += '>' + text + "</option>";
+  return html;
+}
+
+/// The old way of making the protocol menu.
+String htmlSelectClimateProtocol(const String name, const decode_type_t def) {
+  String html = "<select name='" + name + "'>";
+  for (uint8_t i = 1; i <= decode_type_t::kLastDecodeType; i++) {
+    if (IRac::isProtocolSupported((decode_type_t)i)) {
+      html += htmlOptionItem(uint64ToString(i), typeToString((decode_type_t)i),
+                             i == def);
+    }
+  }
+  html += "</select>";
+  return html;
+}
+
+/// The old way of making the mode menu.
+String htmlSelectMode(const String name, const stdAc::opmode_t def) {
+  String html = "<select name='" + name + "'>";
+  for (int8_t i = -1; i <= (int8_t)stdAc::opmode_t::kLastOpmodeEnum; i++) {
+    String mode = IRac::opmodeToString((stdAc::opmode_t)i);
+    html += htmlOptionItem(mode, mode, (stdAc::opmode_t)i == def);
+  }
+  html += "</select>";
+  return html;
+}
+
+/// The old way of making an on/off menu.
+String htmlSelectBool(const String name, const bool def) {
+  String html = "<select name='" + name + "'>";
+  for (uint16_t i = 0; i < 2; i++)
+    html += htmlOptionItem(IRac::boolToString(i), IRac::boolToString(i),
+                           i == def);
+  html += "</select>";
+  return html;
+}
+
+/// (Most of) the A/C page, the old way.
+String oldPage(const stdAc::state_t &state) {
+  return "<table>"
+      "<tr><td>Protocol</td><td>" +
+          htmlSelectClimateProtocol("protocol", state.protocol) +
+          "</td></tr>"
+      "<tr><td>Power</td><td>" + htmlSelectBool("power", state.power) +
+          "</td></tr>"
+      "<tr><td>Mode</td><td>" + htmlSelectMode("mode", state.mode) +
+          "</td></tr>"
+      "<tr><td>Quiet</td><td>" + htmlSelectBool("quiet", state.quiet) +
+          "</td></tr>"
+      "<tr><td>Turbo</td><td>" + htmlSelectBool("turbo", state.turbo) +
+          "</td></tr>"
+      "<tr><td>Econo</td><td>" + htmlSelectBool("econo", state.econo) +
+          "</td></tr>"
+      "</table>";
+}
+
+/// (Most of) the A/C page, as a template.
+const char kPage[] =
+    "<table>"
+    "<tr><td>Protocol</td><td>{0}</td></tr>"
+    "<tr><td>Power</td><td>{1}</td></tr>"
+    "<tr><td>Mode</td><td>{2}</td></tr>"
+    "<tr><td>Quiet</td><td>{3}</td></tr>"
+    "<tr><td>Turbo</td><td>{4}</td></tr>"
+    "<tr><td>Econo</td><td>{5}</td></tr>"
+    "</table>";
+
+// Made once.
+const String kProtocols = IRhtmlRenderer::climateProtocolOptions();
+const String kModes = IRhtmlRenderer::modeOptions();
+const String kBools = IRhtmlRenderer::boolOptions();
+
+void pageFields(IRhtmlRenderer *html, void *arg, const uint16_t field) {
+  const stdAc::state_t *state = reinterpret_cast<stdAc::state_t *>(arg);
+  switch (field) {
+    case 0:
+      html->printSelect("protocol", kProtocols,
+                        uint64ToString(state->protocol));
+      break;
+    case 1:
+      html->printSelect("power", kBools, IRac::boolToString(state->power));
+      break;
+    case 2:
+      html->printSelect("mode", kModes, IRac::opmodeToString(state->mode));
+      break;
+    case 3:
+      html->printSelect("quiet", kBools, IRac::boolToString(state->quiet));
+      break;
+    case 4:
+      html->printSelect("turbo", kBools, IRac::boolToString(state->turbo));
+      break;
+    case 5:
+      html->printSelect("econo", kBools, IRac::boolToString(state->econo));
+      break;
+  }
+}
+
+/// The checksum of what has been "sent" so far.
+uint32_t sink_sum = 0;
+
+/// Somewhere to "send" the page to. Just checksums it.
+void sink(const char *data, const uint16_t length) {
+  for (uint16_t i = 0; i < length; i++) sink_sum += data[i];
+}
+
+/// Time a way of making the page a given number of times.
+/// @param[in] name What to call it in the report.
+/// @param[in] iterations How many times to make it.
+/// @param[in] make The way to make it. Returns a checksum of the page.
+/// @return The checksum of every page made.
+template <typename F>
+uint32_t bench(const char *name, const uint32_t iterations, F make) {
+  uint32_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++) sum += make();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << name << ": " << elapsed.count() * 1e6 / iterations
+            << " us per page (" << elapsed.count() << "s)" << std::endl;
+  return sum;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t iterations = 20000;
+  if (argc > 1) iterations = strtoul(argv[1], NULL, 10);
+
+  stdAc::state_t state;
+  IRac::initState(&state);
+  state.protocol = decode_type_t::DAIKIN;
+  state.power = true;
+  state.mode = stdAc::opmode_t::kCool;
+
+  uint32_t old_sum = bench("String concatenation", iterations, [&]() {
+    sink_sum = 0;
+    const String page = oldPage(state);
+    sink(page.c_str(), page.length());
+    return sink_sum;
+  });
+  uint32_t new_sum = bench("IRhtmlRenderer      ", iterations, [&]() {
+    sink_sum = 0;
+    IRhtmlRenderer html(sink);
+    html.render(kPage, pageFields, &state);
+    html.flush();
+    return sink_sum;
+  });
+  if (old_sum != new_sum) {
+    std::cerr << "Results differ! " << old_sum << " vs " << new_sum
+              << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Quick and dirty tool to compare matching the data of long (byte based)
+// messages bit by bit with `IRrecv::matchData()`, the original way, and many
+// bits at a time with `IRrecv::matchBytesSliced()`.
+//
+// It makes a corpus of random A/C like data sections, checks both ways give
+// exactly the same results, then reports how long each takes.
+//
+// Build & run with `make run_bench`. It is compiled with optimisation, as
+// the results are meaningless without it.
+//
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <stdint.h>
+#include <string.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iostream>
+#include <random>
+#include <vector>
+#include "IRrecv.h"
+
+// Typical A/C timings. (uSeconds)
+const uint16_t kOneMark = 430;
+const uint32_t kOneSpace = 1300;
+const uint16_t kZeroMark = 430;
+const uint32_t kZeroSpace = 430;
+
+/// A data section, & the nr. of bytes in it.
+typedef struct {
+  std::vector<uint16_t> raw;
+  uint16_t nbytes;
+} section_t;
+
+IRrecv irrecv(0);
+
+/// Match bytes the original way. i.e. Bit by bit with `matchData()`.
+uint16_t scalar(section_t *section, uint8_t *result) {
+  uint16_t offset = 0;
+  for (uint16_t i = 0; i < section->nbytes; i++) {
+    match_result_t data = irrecv.matchData(section->raw.data() + offset, 8,
+                                           kOneMark, kOneSpace,
+                                           kZeroMark, kZeroSpace);
+    if (!data.success) return 0;
+    result[i] = data.data;
+    offset += data.used;
+  }
+  return offset;
+}
+
+/// Match bytes many bits at a time.
+uint16_t sliced(section_t *section, uint8_t *result) {
+  return irrecv.matchBytesSliced(section->raw.data(), result,
+                                 section->raw.size(), section->nbytes,
+                                 kOneMark, kOneSpace, kZeroMark, kZeroSpace,
+                                 kUseDefTol, kMarkExcess, true, true);
+}
+
+/// Time a way of matching the corpus.
+/// @param[in] name What to call it in the report.
+/// @param[in] match The way to match.
+/// @param[in] corpus The data sections to match.
+/// @param[in] iterations How many times to match the corpus.
+void report(const char *name, uint16_t (*match)(section_t *, uint8_t *),
+            std::vector<section_t> *corpus, const uint32_t iterations) {
+  uint8_t result[kStateSizeMax];
+  uint64_t sum = 0;
+  uint64_t bits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < iterations; n++)
+    for (section_t &section : *corpus) {
+      sum += match(&section, result) + result[0];
+      bits += section.nbytes * 8;
+    }
+  auto end = std::chrono::steady_clock::now();
+  const double ns = std::chrono::duration<double, std::nano>(end - start)
+      .count();
+  std::cout << name << ": " << ns / bits << " ns/bit (checksum " << sum
+            << ")" << std::endl;
+}
+
+int main() {
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> nbytes(8, kStateSizeMax);
+  std::uniform_int_distribution<int> noise(92, 108);  // Each entry +/-8%
+  std::vector<section_t> corpus;
+  for (uint16_t n = 0; n < 2000; n++) {
+    section_t section;
+    section.nbytes = nbytes(rng);
+    for (uint16_t i = 0; i < section.nbytes * 8; i++) {
+      const bool one = rng() & 1;
+      section.raw.push_back((one ? kOneMark : kZeroMark) * noise(rng) / 100 /
+                            kRawTick);
+      section.raw.push_back((one ? kOneSpace : kZeroSpace) * noise(rng) / 100 /
+                            kRawTick);
+    }
+    section.raw.push_back(0);
+    corpus.push_back(section);
+  }
+  // Both ways must agree exactly.
+  uint32_t matched = 0;
+  for (section_t &section : corpus) {
+    uint8_t a[kStateSizeMax] = {0};
+    uint8_t b[kStateSizeMax] = {0};
+    const uint16_t used = scalar(&section, a);
+    if (used != sliced(&section, b) ||
+        (used && memcmp(a, b, section.nbytes))) {
+      std::cerr << "Mismatch!" << std::endl;
+      return 1;
+    }
+    if (used) matched++;
+  }
+  std::cout << "Corpus: " << corpus.size() << " data sections, " << matched
+            << " matched." << std::endl;
+  report("matchData() bit by bit", scalar, &corpus, 50);
+  report("matchBytesSliced()    ", sliced, &corpus, 50);
+  return 0;
+}
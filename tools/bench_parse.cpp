@@ -0,0 +1,103 @@
+// Quick and dirty tool to compare the throughput of `irutils::ValueReader`
+// versus how IRMQTTServer used to parse raw/GC/Pronto codes. i.e. Count the
+// commas, then convert each value via a temporary (sub)string.
+//
+// Build & run with `make run_bench`. It is compiled with optimisation, as
+// the results are meaningless without it.
+//
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iostream>
+#include <string>
+#include "IRutils.h"
+
+const uint16_t kBenchValues = 1000;
+
+/// The old way. Two passes, and a temporary string per value.
+/// @param[in] str The comma separated values.
+/// @param[out] count The nr. of values found.
+/// @return A malloc'ed array of the values. The caller must free() it.
+uint16_t *oldParse(const std::string &str, uint16_t *count) {
+  // countValuesInStr()
+  *count = 1;
+  for (size_t index = str.find(','); index != std::string::npos;
+       index = str.find(',', index + 1))
+    (*count)++;
+  uint16_t *result = reinterpret_cast<uint16_t *>(
+      malloc(*count * sizeof(uint16_t)));
+  size_t start_from = 0;
+  size_t index;
+  uint16_t i = 0;
+  do {
+    index = str.find(',', start_from);
+    result[i++] = atoi(str.substr(start_from, index - start_from).c_str());
+    start_from = index + 1;
+  } while (index != std::string::npos);
+  return result;
+}
+
+/// Time a way of parsing the string a given number of times.
+/// @param[in] name What to call it in the report.
+/// @param[in] iterations How many times to parse it.
+/// @param[in] parse The way to parse it. Returns a checksum of the values.
+/// @return The checksum of every value read.
+template <typename F>
+uint32_t bench(const char *name, const uint32_t iterations, F parse) {
+  uint32_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++) sum += parse();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << name << ": " << elapsed.count() * 1e9 /
+                               ((double)iterations * kBenchValues)
+            << " ns per value (" << elapsed.count() << "s)" << std::endl;
+  return sum;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t iterations = 20000;
+  if (argc > 1) iterations = strtoul(argv[1], NULL, 10);
+
+  // A typical looking raw code of 1000 values.
+  std::string str;
+  for (uint16_t i = 0; i < kBenchValues; i++) {
+    if (i) str += ',';
+    str += std::to_string(i == 0 ? 38000 : (i & 1) ? 560 : 1690 - (i % 7));
+  }
+  const char *cstr = str.c_str();
+
+  uint32_t old_sum = bench("Count & substring   ", iterations, [&]() {
+    uint16_t count;
+    uint16_t *values = oldParse(str, &count);
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < count; i++) sum += values[i];
+    free(values);
+    return sum;
+  });
+  uint32_t array_sum = bench("countValues & parse ", iterations, [&]() {
+    uint16_t count = irutils::countValues(cstr);
+    uint16_t *values = reinterpret_cast<uint16_t *>(
+        malloc(count * sizeof(uint16_t)));
+    irutils::parseValues(cstr, values, count);
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < count; i++) sum += values[i];
+    free(values);
+    return sum;
+  });
+  uint32_t stream_sum = bench("ValueReader (stream)", iterations, [&]() {
+    irutils::ValueReader reader(cstr);
+    uint32_t sum = 0;
+    uint16_t value;
+    while (reader.next(&value)) sum += value;
+    return sum;
+  });
+  if (old_sum != array_sum || old_sum != stream_sum) {
+    std::cerr << "Results differ! " << old_sum << " vs " << array_sum
+              << " vs " << stream_sum << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,260 @@
+// Quick and dirty tool to fuzz & differentially test the IR decoders.
+//
+// Feeds random, mutated, and genuine (IRsend generated) captures into
+// `IRrecv::decode()` & `IRAcUtils::decodeToState()`, and checks that every
+// protocol that can be sent decodes back to what was sent.
+//
+// Every capture is copied into a heap buffer of exactly the size a real
+// capture would have (i.e. `rawlen` entries, plus the zero terminator the
+// library appends when the capture didn't overflow). Build with
+// `make SANITIZE=1 fuzz_decode` to have AddressSanitizer report any
+// out-of-bounds read of the capture buffer (e.g. Issue #1516).
+//
+// Alternatively, build it as a libFuzzer target with clang++:
+//   make clean; make CXX=clang++ LIBFUZZER=1 fuzz_decode
+//
+// Copyright 2021 IRremoteESP8266 authors
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <iostream>
+#include <random>
+#include <string>
+#include "IRac.h"
+#include "IRrecv.h"
+#include "IRsend.h"
+#include "IRsend_test.h"
+#include "IRutils.h"
+
+const uint16_t kFuzzMaxRawLen = 1024;  // Largest capture we will generate.
+
+// Global objects shared by the fuzzing modes. They are big, so don't put
+// them on the stack.
+IRsendTest irsend(0);
+IRrecv irrecv(0, kFuzzMaxRawLen + 1);
+
+// Counters for the final report.
+uint64_t execs = 0;
+uint64_t decoded = 0;
+uint64_t roundtrips = 0;
+uint64_t mismatches = 0;
+
+/// Decode a capture held in an exactly sized heap buffer.
+/// @param[in] data The raw capture data. data[0] is ignored like `rawbuf[0]`.
+/// @param[in] rawlen The nr. of entries in `data`.
+/// @param[in] overflow Was the capture buffer full? i.e. No terminator.
+/// @param[in] max_skip Value to pass to `decode()`.
+/// @param[out] result Where to store the decode result.
+/// @note `result->rawbuf` is NULL on return as the heap buffer is freed.
+void fuzzOne(const uint16_t *data, const uint16_t rawlen, const bool overflow,
+             const uint8_t max_skip, decode_results *result) {
+  // A real capture buffer is `bufsize` big, & `decode()` writes a zero at
+  // `rawbuf[rawlen]` when it didn't overflow. Allocate no more than that.
+  uint16_t size = rawlen + (overflow ? 0 : 1);
+  volatile uint16_t *buf = new uint16_t[size ? size : 1];
+  for (uint16_t i = 0; i < rawlen; i++) buf[i] = data[i];
+  if (!overflow) buf[rawlen] = 0;
+  result->rawbuf = buf;
+  result->rawlen = rawlen;
+  result->overflow = overflow;
+  execs++;
+  if (irrecv.decode(result, NULL, max_skip) && result->decode_type > UNKNOWN) {
+    decoded++;
+    stdAc::state_t state;
+    IRAcUtils::decodeToState(result, &state);
+    IRAcUtils::resultAcToString(result);
+  }
+  delete[] buf;
+  result->rawbuf = NULL;
+}
+
+/// Generate a completely random capture.
+/// @param[in] rng The random number generator to use.
+/// @param[in] max_len The largest `rawlen` to generate.
+void fuzzRandom(std::mt19937 *rng, const uint16_t max_len) {
+  uint16_t data[kFuzzMaxRawLen];
+  uint16_t rawlen = (*rng)() % (max_len + 1);
+  // Mostly use plausible timings, occasionally anything at all.
+  bool wild = ((*rng)() % 8) == 0;
+  for (uint16_t i = 0; i < rawlen; i++)
+    data[i] = wild ? (*rng)() : 1 + (*rng)() % (10000 / kRawTick);
+  decode_results result;
+  fuzzOne(data, rawlen, ((*rng)() % 4) == 0, (*rng)() % 3, &result);
+}
+
+/// Damage the contents of a capture in some small random way.
+/// @param[in] rng The random number generator to use.
+/// @param[in,out] data The capture to mutate.
+/// @param[in,out] rawlen The nr. of entries in `data`.
+void mutate(std::mt19937 *rng, uint16_t *data, uint16_t *rawlen) {
+  if (*rawlen < 2) return;
+  uint16_t pos = 1 + (*rng)() % (*rawlen - 1);
+  switch ((*rng)() % 6) {
+    case 0:  // Replace an entry with anything.
+      data[pos] = (*rng)();
+      break;
+    case 1:  // Stretch or shrink an entry by up to +/-50%.
+      data[pos] = data[pos] * (50 + (*rng)() % 101) / 100;
+      break;
+    case 2:  // Truncate the capture.
+      *rawlen = pos;
+      break;
+    case 3:  // Delete an entry.
+      memmove(data + pos, data + pos + 1,
+              (*rawlen - pos - 1) * sizeof(data[0]));
+      (*rawlen)--;
+      break;
+    case 4:  // Duplicate an entry.
+      if (*rawlen >= kFuzzMaxRawLen) break;
+      memmove(data + pos + 1, data + pos, (*rawlen - pos) * sizeof(data[0]));
+      (*rawlen)++;
+      break;
+    default:  // Zero an entry. Real captures can contain these. ;-)
+      data[pos] = 0;
+  }
+}
+
+/// Send a random message of the given protocol & check it decodes the same.
+/// Then throw a mutated copy of it at the decoders too.
+/// @param[in] rng The random number generator to use.
+/// @param[in] protocol The protocol to test.
+/// @param[in] verbose Report each mismatch in detail.
+void fuzzRoundTrip(std::mt19937 *rng, const decode_type_t protocol,
+                   const bool verbose) {
+  const uint16_t nbits = IRsend::defaultBits(protocol);
+  if (!nbits) return;  // No idea how big a message should be.
+  const bool isAC = hasACState(protocol);
+  uint64_t value = 0;
+  uint8_t state[kStateSizeMax] = {0};
+  if (isAC) {
+    if (nbits / 8 > kStateSizeMax) return;
+    for (uint16_t i = 0; i < nbits / 8; i++) state[i] = (*rng)();
+  } else {
+    value = ((uint64_t)(*rng)() << 32) | (*rng)();
+    if (nbits < 64) value &= (1ULL << nbits) - 1;
+  }
+  irsend.reset();
+  bool sent = isAC ? irsend.send(protocol, state, nbits / 8)
+                   : irsend.send(protocol, value, nbits);
+  if (!sent || !irsend.last) return;
+  irsend.makeDecodeResult();
+  uint16_t rawlen = irsend.capture.rawlen;
+  if (rawlen > kFuzzMaxRawLen) rawlen = kFuzzMaxRawLen;
+  uint16_t data[kFuzzMaxRawLen];
+  for (uint16_t i = 0; i < rawlen; i++) data[i] = irsend.rawbuf[i];
+
+  decode_results result;
+  fuzzOne(data, rawlen, rawlen == kFuzzMaxRawLen, 0, &result);
+  // Only a decode as the same protocol & size can be compared. Invalid
+  // random data (e.g. a bad checksum) may legitimately not decode at all.
+  if (result.decode_type == protocol && result.bits == nbits) {
+    roundtrips++;
+    bool same = isAC ? !memcmp(result.state, state, nbits / 8)
+                     : result.value == value;
+    if (!same) {
+      mismatches++;
+      if (verbose) {
+        std::cout << "MISMATCH: " << typeToString(protocol) << " sent 0x";
+        if (isAC)
+          for (uint16_t i = 0; i < nbits / 8; i++) printf("%02X", state[i]);
+        else
+          std::cout << uint64ToString(value, 16);
+        std::cout << " got 0x";
+        if (isAC)
+          for (uint16_t i = 0; i < nbits / 8; i++)
+            printf("%02X", result.state[i]);
+        else
+          std::cout << uint64ToString(result.value, 16);
+        std::cout << std::endl;
+      }
+    }
+  }
+  // Now a damaged copy of a genuine message.
+  uint8_t rounds = 1 + (*rng)() % 4;
+  for (uint8_t i = 0; i < rounds; i++) mutate(rng, data, &rawlen);
+  fuzzOne(data, rawlen, false, (*rng)() % 3, &result);
+}
+
+#ifdef LIBFUZZER
+/// libFuzzer entry point. The input is treated as a little-endian array of
+/// raw capture ticks.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *input, size_t size) {
+  uint16_t data[kFuzzMaxRawLen];
+  uint16_t rawlen = std::min(size / 2, (size_t)kFuzzMaxRawLen);
+  for (uint16_t i = 0; i < rawlen; i++)
+    data[i] = input[i * 2] | (input[i * 2 + 1] << 8);
+  // Use any odd trailing byte as the decode options.
+  uint8_t opts = (size % 2) ? input[size - 1] : 0;
+  decode_results result;
+  fuzzOne(data, rawlen, opts & 0x80, opts % 3, &result);
+  return 0;
+}
+#else  // LIBFUZZER
+void usage_error(char *name) {
+  std::cerr << "Usage: " << name << " [-seed num] [-iterations num]"
+            << " [-maxlen num] [-protocol name] [-verbose]" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t seed = 0;
+  uint64_t iterations = 100000;
+  uint16_t max_len = 200;
+  decode_type_t only = decode_type_t::UNKNOWN;
+  bool verbose = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp("-verbose", argv[i]) == 0) {
+      verbose = true;
+    } else if (i + 1 >= argc) {
+      usage_error(argv[0]);
+      return 1;
+    } else if (strcmp("-seed", argv[i]) == 0) {
+      seed = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp("-iterations", argv[i]) == 0) {
+      iterations = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp("-maxlen", argv[i]) == 0) {
+      max_len = std::min(strtoul(argv[++i], NULL, 10),
+                         (unsigned long)kFuzzMaxRawLen);  // NOLINT(runtime/int)
+    } else if (strcmp("-protocol", argv[i]) == 0) {
+      only = strToDecodeType(argv[++i]);
+      if (only <= decode_type_t::UNUSED) {
+        std::cerr << "Unknown protocol: " << argv[i] << std::endl;
+        return 1;
+      }
+    } else {
+      usage_error(argv[0]);
+      return 1;
+    }
+  }
+
+  std::mt19937 rng(seed);
+  irsend.begin();
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < iterations; i++) {
+    if (only > decode_type_t::UNUSED) {
+      fuzzRoundTrip(&rng, only, verbose);
+    } else if (i % 2) {
+      fuzzRandom(&rng, max_len);
+    } else {
+      fuzzRoundTrip(&rng, (decode_type_t)(1 + rng() % kLastDecodeType),
+                    verbose);
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << "Seed           " << seed << std::endl
+            << "Executions     " << execs << std::endl
+            << "Decoded        " << decoded << std::endl
+            << "Round trips    " << roundtrips << std::endl
+            << "Mismatches     " << mismatches << std::endl
+            << "Elapsed (s)    " << elapsed.count() << std::endl
+            << "Execs/sec      "
+            << (uint64_t)(execs / std::max(elapsed.count(), 1e-9))
+            << std::endl;
+  return mismatches ? 2 : 0;
+}
+#endif  // LIBFUZZER